@@ -0,0 +1,508 @@
+// Copyright 2026:
+//   GobySoft, LLC (2013-)
+//   Community contributors (see AUTHORS file)
+// File authors:
+//   Toby Schneider <toby@gobysoft.org>
+//
+//
+// This file is part of the Dynamic Compact Control Language Library
+// ("DCCL").
+//
+// DCCL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 2.1 of the License, or
+// (at your option) any later version.
+//
+// DCCL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DCCL.  If not, see <http://www.gnu.org/licenses/>.
+//
+// For the 'dccl_arithmetic_train' tool: loading non-GPL shared libraries for the purpose of
+// using this tool does *not* violate the GPL license terms of DCCL.
+//
+
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+#include <google/protobuf/descriptor.h>
+#include <google/protobuf/text_format.h>
+
+#include "../../arithmetic/field_codec_arithmetic.h"
+#include "../../arithmetic/model_trainer.h"
+#include "../../binary.h"
+#include "../../cli_option.h"
+#include "../../codec.h"
+
+#include "dccl/version.h"
+
+// for realpath
+#include <climits>
+#include <cstdlib>
+
+enum Format
+{
+    TEXT,
+    BINARY,
+    HEX
+};
+
+namespace dccl
+{
+namespace tool
+{
+struct TrainConfig
+{
+    std::set<std::string> include;
+    std::vector<std::string> dlopen;
+    std::set<std::string> message;
+    std::set<std::string> proto_file;
+    std::vector<std::string> model_file;
+    Format format{TEXT};
+    std::string output_dir;
+    dccl::arith::Model::freq_type max_total_frequency{dccl::arith::Model::MAX_FREQUENCY};
+    bool verbose{false};
+};
+} // namespace tool
+} // namespace dccl
+
+std::vector<std::shared_ptr<google::protobuf::Message>> read_corpus(dccl::Codec& dccl,
+                                                                    dccl::tool::TrainConfig& cfg);
+std::size_t encoded_size(dccl::Codec& dccl,
+                         const std::vector<std::shared_ptr<google::protobuf::Message>>& corpus);
+void load_desc(dccl::Codec* dccl, const std::string& name);
+void configure_codec(dccl::Codec* dccl, const dccl::tool::TrainConfig& cfg,
+                     const std::vector<dccl::arith::protobuf::ArithmeticModel>& models);
+void parse_options(int argc, char* argv[], dccl::tool::TrainConfig* cfg);
+
+int main(int argc, char* argv[])
+{
+    dccl::tool::TrainConfig cfg;
+    parse_options(argc, argv, &cfg);
+
+    if (!cfg.verbose)
+        dccl::dlog.connect(dccl::logger::WARN_PLUS, &std::cerr);
+    else
+        dccl::dlog.connect(dccl::logger::DEBUG1_PLUS, &std::cerr);
+
+    if (cfg.model_file.empty())
+    {
+        std::cerr << "You must give the models to train with -M. Try --help." << std::endl;
+        exit(EXIT_FAILURE);
+    }
+
+    dccl::DynamicProtobufManager::enable_compilation();
+    for (const auto& it : cfg.include) dccl::DynamicProtobufManager::add_include_path(it);
+
+    std::vector<dccl::arith::protobuf::ArithmeticModel> models;
+    for (const auto& it : cfg.model_file)
+    {
+        std::ifstream fin(it);
+        if (!fin.is_open())
+        {
+            std::cerr << "failed to open model file: " << it << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        std::stringstream ss;
+        ss << fin.rdbuf();
+
+        dccl::arith::protobuf::ArithmeticModel model;
+        if (!google::protobuf::TextFormat::ParseFromString(ss.str(), &model))
+        {
+            std::cerr << "failed to parse model file: " << it << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        models.push_back(model);
+    }
+
+    dccl::Codec dccl;
+    configure_codec(&dccl, cfg, models);
+
+    bool no_messages_specified = cfg.message.empty();
+    for (const auto& it : cfg.proto_file)
+    {
+        const google::protobuf::FileDescriptor* file_desc =
+            dccl::DynamicProtobufManager::load_from_proto_file(it);
+
+        if (!file_desc)
+        {
+            std::cerr << "failed to read in: " << it << std::endl;
+            exit(EXIT_FAILURE);
+        }
+
+        // if no messages explicitly specified, load them all.
+        if (no_messages_specified)
+        {
+            for (int i = 0, n = file_desc->message_type_count(); i < n; ++i)
+                cfg.message.insert(file_desc->message_type(i)->full_name());
+        }
+    }
+
+    for (const auto& it : cfg.message) load_desc(&dccl, it);
+
+    std::vector<std::shared_ptr<google::protobuf::Message>> corpus = read_corpus(dccl, cfg);
+    if (corpus.empty())
+    {
+        std::cerr << "No messages read from STDIN" << std::endl;
+        exit(EXIT_FAILURE);
+    }
+
+    dccl::arith::ModelTrainer trainer(dccl);
+    for (const auto& msg : corpus) trainer.add(*msg);
+
+    std::cerr << "Read " << trainer.message_count() << " messages" << std::endl;
+    std::cerr << std::fixed << std::setprecision(1);
+
+    double total_bits_before = 0, total_bits_after = 0;
+    std::vector<dccl::arith::protobuf::ArithmeticModel> trained_models;
+    for (const std::string& name : trainer.model_names())
+    {
+        dccl::arith::protobuf::ArithmeticModel trained =
+            trainer.train(name, cfg.max_total_frequency);
+        double bits_before = trainer.bits(name, trainer.current_model(name));
+        double bits_after = trainer.bits(name, trained);
+
+        std::cerr << "Model '" << name << "': " << bits_before / trainer.message_count()
+                  << " bits/message before, " << bits_after / trainer.message_count()
+                  << " bits/message after" << std::endl;
+        total_bits_before += bits_before;
+        total_bits_after += bits_after;
+        trained_models.push_back(trained);
+    }
+
+    std::cerr << "All models: " << total_bits_before / trainer.message_count()
+              << " bits/message before, " << total_bits_after / trainer.message_count()
+              << " bits/message after" << std::endl;
+
+    // load the messages into a new codec with the trained models, which checks that they
+    // still fit within (dccl.msg).max_bytes
+    dccl::Codec trained_dccl;
+    configure_codec(&trained_dccl, cfg, models);
+    for (const auto& trained : trained_models)
+        dccl::arith::ModelManager::set_model(trained_dccl, trained);
+
+    // the adaptive models start from the frequencies given
+    dccl::arith::ModelManager::reset(dccl);
+    bool all_fit = true;
+    for (const auto& id_desc_pair : dccl.loaded())
+    {
+        const google::protobuf::Descriptor* desc = id_desc_pair.second;
+        std::cerr << "Message '" << desc->full_name() << "': " << dccl.max_size(desc)
+                  << " max bytes before, " << trained_dccl.max_size(desc)
+                  << " max bytes after (max_bytes: "
+                  << desc->options().GetExtension(dccl::msg).max_bytes() << ")" << std::endl;
+        try
+        {
+            trained_dccl.load(desc);
+        }
+        catch (std::exception& e)
+        {
+            std::cerr << "The trained models do not fit " << desc->full_name()
+                      << " within its max_bytes: " << e.what() << std::endl;
+            all_fit = false;
+        }
+    }
+    if (!all_fit)
+        exit(EXIT_FAILURE);
+
+    // the actual encoded size (whole messages, rounded up to bytes)
+    std::size_t bytes_before = encoded_size(dccl, corpus);
+    std::size_t bytes_after = encoded_size(trained_dccl, corpus);
+    std::cerr << "Encoded messages: " << static_cast<double>(bytes_before) / corpus.size()
+              << " bytes/message before, " << static_cast<double>(bytes_after) / corpus.size()
+              << " bytes/message after" << std::endl;
+
+    for (const auto& trained : trained_models)
+    {
+        std::string output;
+        google::protobuf::TextFormat::PrintToString(trained, &output);
+
+        if (cfg.output_dir.empty())
+        {
+            std::cout << "# " << trained.name() << "\n" << output << std::endl;
+        }
+        else
+        {
+            std::string path = cfg.output_dir + "/" + trained.name() + ".pb.txt";
+            std::ofstream fout(path);
+            if (!fout.is_open())
+            {
+                std::cerr << "failed to open output file: " << path << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            fout << output;
+            std::cerr << "Wrote " << path << std::endl;
+        }
+    }
+}
+
+std::vector<std::shared_ptr<google::protobuf::Message>> read_corpus(dccl::Codec& dccl,
+                                                                    dccl::tool::TrainConfig& cfg)
+{
+    std::vector<std::shared_ptr<google::protobuf::Message>> corpus;
+
+    if (cfg.format == TEXT)
+    {
+        while (!std::cin.eof())
+        {
+            std::string input;
+            std::getline(std::cin, input);
+            if (input.find_first_not_of(" \t\r") == std::string::npos)
+                continue;
+
+            // same as the input to 'dccl --encode': [|name|] TextFormat message
+            std::string name;
+            std::string::size_type start = input.find_first_not_of(" \t");
+            if (input[start] == '|')
+            {
+                std::string::size_type close_bracket_pos = input.find('|', start + 1);
+                if (close_bracket_pos == std::string::npos)
+                {
+                    std::cerr << "Incorrectly formatted input: expected '|'" << std::endl;
+                    exit(EXIT_FAILURE);
+                }
+                name = input.substr(start + 1, close_bracket_pos - start - 1);
+                input = input.substr(close_bracket_pos + 1);
+                if (!cfg.message.count(name))
+                {
+                    load_desc(&dccl, name);
+                    cfg.message.insert(name);
+                }
+            }
+            else if (cfg.message.size() == 1)
+            {
+                name = *cfg.message.begin();
+            }
+            else
+            {
+                std::cerr << "Message name not given with (a single) -m or in the input (i.e. "
+                             "'|Name| field1: value field2: value')."
+                          << std::endl;
+                exit(EXIT_FAILURE);
+            }
+
+            std::shared_ptr<google::protobuf::Message> msg =
+                dccl::DynamicProtobufManager::new_protobuf_message(
+                    dccl::DynamicProtobufManager::find_descriptor(name));
+            if (!google::protobuf::TextFormat::ParseFromString(input, msg.get()))
+            {
+                std::cerr << "Failed to parse message: " << input << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            corpus.push_back(msg);
+        }
+    }
+    else
+    {
+        std::string input;
+        if (cfg.format == BINARY)
+        {
+            std::ifstream fin("/dev/stdin", std::ios::binary);
+            std::ostringstream ostrm;
+            ostrm << fin.rdbuf();
+            input = ostrm.str();
+        }
+        else
+        {
+            while (!std::cin.eof())
+            {
+                std::string line;
+                std::getline(std::cin, line);
+                input += dccl::hex_decode(line);
+            }
+        }
+
+        // decoded in order, so that adaptive models follow the encoder
+        dccl::arith::ModelManager::reset(dccl);
+        while (!input.empty())
+            corpus.push_back(dccl.decode<std::shared_ptr<google::protobuf::Message>>(&input));
+    }
+    return corpus;
+}
+
+std::size_t encoded_size(dccl::Codec& dccl,
+                         const std::vector<std::shared_ptr<google::protobuf::Message>>& corpus)
+{
+    dccl::arith::ModelManager::reset(dccl);
+    std::size_t size = 0;
+    for (const auto& msg : corpus)
+    {
+        std::string encoded;
+        dccl.encode(&encoded, *msg);
+        size += encoded.size();
+    }
+    return size;
+}
+
+void configure_codec(dccl::Codec* dccl, const dccl::tool::TrainConfig& cfg,
+                     const std::vector<dccl::arith::protobuf::ArithmeticModel>& models)
+{
+    dccl_arithmetic_load(dccl);
+    for (const auto& it : cfg.dlopen) dccl->load_library(it);
+    for (const auto& model : models) dccl::arith::ModelManager::set_model(*dccl, model);
+}
+
+void load_desc(dccl::Codec* dccl, const std::string& name)
+{
+    const google::protobuf::Descriptor* desc = dccl::DynamicProtobufManager::find_descriptor(name);
+    if (!desc)
+    {
+        std::cerr << "No descriptor with name " << name
+                  << " found! Make sure you have loaded all the necessary .proto files and/or "
+                     "shared libraries. Try --help."
+                  << std::endl;
+        exit(EXIT_FAILURE);
+    }
+
+    try
+    {
+        dccl->load(desc);
+    }
+    catch (std::exception& e)
+    {
+        std::cerr << "Not a valid DCCL message: " << desc->full_name() << "\nWhy: " << e.what()
+                  << std::endl;
+    }
+}
+
+void parse_options(int argc, char* argv[], dccl::tool::TrainConfig* cfg)
+{
+    std::vector<dccl::Option> options;
+    options.emplace_back('h', "help", no_argument,
+                         "Gives help on the usage of 'dccl_arithmetic_train'");
+    options.emplace_back('I', "proto_path", required_argument,
+                         "Add another search directory for .proto files");
+    options.emplace_back('l', "dlopen", required_argument,
+                         "Open this shared library containing compiled DCCL messages.");
+    options.emplace_back('m', "message", required_argument,
+                         "Message name of the corpus (if not given in the input).");
+    options.emplace_back('f', "proto_file", required_argument, ".proto file to load.");
+    options.emplace_back('M', "model", required_argument,
+                         "ArithmeticModel (TextFormat) file of a model to train. The models' "
+                         "value_bound are kept, and their frequencies replaced.");
+    options.emplace_back(0, "format", required_argument,
+                         "Format of the corpus on STDIN: 'text' (default) is one TextFormat "
+                         "message per line, as the input to 'dccl --encode'; 'hex' is one "
+                         "ascii-encoded hexadecimal encoded message per line; 'bin' is raw binary "
+                         "encoded messages.");
+    options.emplace_back('o', "output_dir", required_argument,
+                         "Write each trained model to {output_dir}/{name}.pb.txt rather than to "
+                         "STDOUT.");
+    options.emplace_back(0, "max_total_frequency", required_argument,
+                         "Maximum sum of the trained frequencies of each model (default and "
+                         "largest allowed: " +
+                             std::to_string(dccl::arith::Model::MAX_FREQUENCY) +
+                             "). Smaller values let adaptive models adapt faster.");
+    options.emplace_back('v', "verbose", no_argument, "Display extra debugging information.");
+    options.emplace_back('V', "version", no_argument, "DCCL Version");
+
+    std::vector<option> long_options;
+    std::string opt_string;
+    dccl::Option::convert_vector(options, &long_options, &opt_string);
+
+    while (1)
+    {
+        int option_index = 0;
+
+        int c = getopt_long(argc, argv, opt_string.c_str(), &long_options[0], &option_index);
+        if (c == -1)
+            break;
+
+        switch (c)
+        {
+            case 0:
+                // If this option set a flag, do nothing else now.
+                if (long_options[option_index].flag != nullptr)
+                    break;
+
+                if (!strcmp(long_options[option_index].name, "format"))
+                {
+                    if (!strcmp(optarg, "text"))
+                        cfg->format = TEXT;
+                    else if (!strcmp(optarg, "hex"))
+                        cfg->format = HEX;
+                    else if (!strcmp(optarg, "bin"))
+                        cfg->format = BINARY;
+                    else
+                    {
+                        std::cerr << "Invalid format '" << optarg << "'" << std::endl;
+                        exit(EXIT_FAILURE);
+                    }
+                }
+                else if (!strcmp(long_options[option_index].name, "max_total_frequency"))
+                {
+                    char* end_ptr = nullptr;
+                    auto number = strtoul(optarg, &end_ptr, 10);
+                    if (optarg == end_ptr || *end_ptr != 0 || number == 0 ||
+                        number > dccl::arith::Model::MAX_FREQUENCY)
+                    {
+                        std::cerr << "Invalid max_total_frequency '" << optarg << "'"
+                                  << std::endl;
+                        exit(EXIT_FAILURE);
+                    }
+                    cfg->max_total_frequency = number;
+                }
+                else
+                {
+                    std::cerr << "Try --help for valid options." << std::endl;
+                    exit(EXIT_FAILURE);
+                }
+
+                break;
+
+            case 'I': cfg->include.insert(optarg); break;
+            case 'l': cfg->dlopen.emplace_back(optarg); break;
+            case 'm': cfg->message.insert(optarg); break;
+            case 'M': cfg->model_file.emplace_back(optarg); break;
+            case 'o': cfg->output_dir = optarg; break;
+            case 'f':
+            {
+                char* proto_file_canonical_path = realpath(optarg, nullptr);
+                if (proto_file_canonical_path)
+                {
+                    cfg->proto_file.insert(proto_file_canonical_path);
+                    free(proto_file_canonical_path);
+                }
+                else
+                {
+                    std::cerr << "Invalid proto file path: '" << optarg << "'" << std::endl;
+                    exit(EXIT_FAILURE);
+                }
+                break;
+            }
+            case 'v': cfg->verbose = true; break;
+
+            case 'h':
+                std::cout << "Usage of the DCCL arithmetic model training tool "
+                             "('dccl_arithmetic_train'): "
+                          << std::endl;
+                std::cout << "  Reads a corpus of messages on STDIN, and writes the models given "
+                             "with -M with the frequencies of the values in the corpus."
+                          << std::endl;
+                for (auto& option : options) std::cout << "  " << option.usage() << std::endl;
+                exit(EXIT_SUCCESS);
+                break;
+
+            case 'V':
+                std::cout << dccl::VERSION_STRING << std::endl;
+                exit(EXIT_SUCCESS);
+                break;
+
+            case '?': std::cerr << "Try --help for valid options." << std::endl; exit(EXIT_FAILURE);
+            default: exit(EXIT_FAILURE);
+        }
+    }
+
+    if (optind < argc)
+    {
+        std::cerr << "Unknown arguments: \n";
+        while (optind < argc) std::cerr << argv[optind++];
+        std::cerr << std::endl;
+        std::cerr << "Try --help for valid options." << std::endl;
+        exit(EXIT_FAILURE);
+    }
+}
@@ -0,0 +1,1042 @@
+// Copyright 2026:
+//   GobySoft, LLC (2013-)
+//   Community contributors (see AUTHORS file)
+// File authors:
+//   Toby Schneider <toby@gobysoft.org>
+//
+//
+// This file is part of the Dynamic Compact Control Language Library
+// ("DCCL").
+//
+// DCCL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 2.1 of the License, or
+// (at your option) any later version.
+//
+// DCCL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DCCL.  If not, see <http://www.gnu.org/licenses/>.
+#ifndef GenStaticCodecPlugin20261018H
+#define GenStaticCodecPlugin20261018H
+
+// requires the (dccl.field) and (dccl.msg) extensions (option_extensions.pb.h) to be included first
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <iomanip>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <google/protobuf/descriptor.h>
+
+#include "dccl/static_codec.h"
+
+///////////////////////////////////////////////////////////////////////////////////
+// Generates reflection-free encode / decode / size functions for messages
+// using the default DCCL codecs (versions 2, 3 and 4)
+///////////////////////////////////////////////////////////////////////////////////
+
+namespace dccl
+{
+namespace static_codec
+{
+/// \brief Generates C++ functions that encode and decode DCCL messages directly through the protobuf generated accessors, with all bounds, resolutions and field sizes computed at generation time. The encoded bytes are identical to those produced by dccl::Codec.
+///
+/// For each message with a (dccl.msg).id in the .proto file, the generated header (<name>.dccl.h) provides (in the message's package namespace):
+/// - std::size_t dccl_encode(const Msg& msg, char* buf, std::size_t max_len)
+/// - std::string dccl_encode(const Msg& msg)
+/// - std::size_t dccl_size(const Msg& msg)
+/// - std::size_t dccl_decode(Msg* msg, const std::uint8_t* bytes, std::size_t len)
+/// - std::size_t dccl_decode(Msg* msg, const std::string& bytes)
+///
+/// These behave as dccl::Codec does with the default settings (non-strict, no encryption, DefaultIdentifierCodec). Messages that use anything other than the default numeric, bool, enum, string, bytes and message codecs (e.g. custom codecs, dynamic conditions) are skipped with a comment giving the reason.
+class Generator
+{
+  public:
+    /// \param file .proto file to generate functions for
+    /// \param pb_h_name Name of the header generated by protoc for this file (e.g. "foo.pb.h")
+    Generator(const google::protobuf::FileDescriptor* file, std::string pb_h_name)
+        : file_(file), pb_h_name_(std::move(pb_h_name))
+    {
+    }
+
+    /// \brief Contents of the generated header
+    std::string generate()
+    {
+        std::stringstream out;
+        std::string guard = pb_h_name_;
+        for (char& c : guard)
+            if (!std::isalnum(static_cast<unsigned char>(c)))
+                c = '_';
+        guard = "DCCL_STATIC_CODEC_" + guard + "_H";
+        std::transform(guard.begin(), guard.end(), guard.begin(), ::toupper);
+
+        out << "// Generated by protoc-gen-dccl (static_codec) from " << file_->name()
+            << ". DO NOT EDIT!\n"
+            << "#ifndef " << guard << "\n"
+            << "#define " << guard << "\n\n"
+            << "#include <cstddef>\n"
+            << "#include <cstdint>\n"
+            << "#include <string>\n\n"
+            << "#include <dccl/static_codec.h>\n\n"
+            << "#include \"" << pb_h_name_ << "\"\n\n";
+
+        std::vector<std::string> namespaces;
+        std::stringstream package(file_->package());
+        for (std::string ns; std::getline(package, ns, '.');) namespaces.push_back(ns);
+
+        for (const auto& ns : namespaces) out << "namespace " << ns << "\n{\n";
+
+        for (int i = 0, n = file_->message_type_count(); i < n; ++i)
+            generate_message(file_->message_type(i), out);
+
+        for (auto it = namespaces.rbegin(); it != namespaces.rend(); ++it)
+            out << "} // namespace " << *it << "\n";
+
+        out << "\n#endif\n";
+        return out.str();
+    }
+
+  private:
+    enum Part
+    {
+        HEAD,
+        BODY,
+        UNKNOWN
+    };
+
+    /// \brief Where a message's fields are being encoded
+    struct Context
+    {
+        /// pass (HEAD or BODY) being encoded
+        Part pass;
+        /// part explicitly set by (dccl.field).in_head of the containing fields, or UNKNOWN
+        Part current_part;
+        /// field containing this message (nullptr for the root message)
+        const google::protobuf::FieldDescriptor* field;
+    };
+
+    struct Unsupported : std::runtime_error
+    {
+        explicit Unsupported(const std::string& reason) : std::runtime_error(reason) {}
+    };
+
+    void generate_message(const google::protobuf::Descriptor* desc, std::stringstream& out)
+    {
+        for (int i = 0, n = desc->nested_type_count(); i < n; ++i)
+            generate_message(desc->nested_type(i), out);
+
+        const dccl::DCCLMessageOptions& msg_options = desc->options().GetExtension(dccl::msg);
+        if (!msg_options.has_id())
+            return;
+
+        try
+        {
+            std::stringstream code;
+            generate_root(desc, code);
+            out << code.str();
+        }
+        catch (Unsupported& e)
+        {
+            out << "\n// " << desc->full_name() << ": no static codec (" << e.what() << ")\n";
+        }
+    }
+
+    void generate_root(const google::protobuf::Descriptor* desc, std::stringstream& out)
+    {
+        const dccl::DCCLMessageOptions& msg_options = desc->options().GetExtension(dccl::msg);
+
+        if (file_->syntax() != google::protobuf::FileDescriptor::SYNTAX_PROTO2)
+            throw Unsupported("only proto2 files are supported");
+
+        version_ = msg_options.codec_version();
+        if (version_ < 2 || version_ > 4)
+            throw Unsupported("unknown codec_version " + std::to_string(version_));
+
+        // same rules as FieldCodecManagerLocal::find() and FieldCodecBase::codec_group()
+        codec_name_ = version_ == 2 ? "dccl.default2" : "dccl.default" + std::to_string(version_);
+        has_codec_group_ = msg_options.has_codec_group() || msg_options.has_codec_version();
+        if (msg_options.has_codec_group() && msg_options.codec_group() != codec_name_)
+            throw Unsupported("codec_group " + msg_options.codec_group());
+        if (msg_options.has_codec() && msg_options.codec() != codec_name_)
+            throw Unsupported("codec " + msg_options.codec());
+
+        unsigned id = msg_options.id();
+        const unsigned two_byte_max_id = (1 << 15) - 1;
+        if (id > two_byte_max_id)
+            throw Unsupported("dccl.id exceeds maximum");
+        const unsigned id_bits = (id <= (1 << 7) - 1) ? 8 : 16;
+
+        Context head{HEAD, UNKNOWN, nullptr}, body{BODY, UNKNOWN, nullptr};
+        const unsigned head_bytes = (id_bits + fields_max_size(desc, head) + 7) / 8;
+
+        std::string type = cpp_type(desc);
+        var_ = 0;
+
+        std::stringstream encode_head, encode_body, decode_head, decode_body;
+        encode_fields(desc, head, "msg", encode_head, 1);
+        encode_fields(desc, body, "msg", encode_body, 1);
+        decode_fields(desc, head, "msg", "reader", decode_head, 1);
+        decode_fields(desc, body, "msg", "reader", decode_body, 1);
+
+        out << "\n// " << desc->full_name() << " (dccl.id = " << id << ", codec_version = "
+            << version_ << ")\n"
+            << "template <typename Writer> void dccl_encode_bits(const " << type
+            << "& msg, Writer* writer)\n"
+            << "{\n"
+            << "    if (!msg.IsInitialized())\n"
+            << "        throw(dccl::Exception(\"Message is not properly initialized. All "
+               "`required` fields must be set. Fields with errors: \\n\" +\n"
+            << "                              msg.InitializationErrorString()));\n\n"
+            << "    dccl::static_codec::write_id(writer, " << id << ");\n"
+            << encode_head.str() << "    writer->align();\n"
+            << encode_body.str() << "}\n\n"
+            << "inline std::size_t dccl_encode(const " << type
+            << "& msg, char* buf, std::size_t max_len)\n"
+            << "{\n"
+            << "    dccl::BitWriter writer(buf, max_len);\n"
+            << "    dccl_encode_bits(msg, &writer);\n"
+            << "    return writer.byte_size();\n"
+            << "}\n\n"
+            << "inline std::string dccl_encode(const " << type << "& msg)\n"
+            << "{\n"
+            << "    std::string bytes;\n"
+            << "    dccl::BitWriter writer(&bytes);\n"
+            << "    dccl_encode_bits(msg, &writer);\n"
+            << "    return bytes;\n"
+            << "}\n\n"
+            << "inline std::size_t dccl_size(const " << type << "& msg)\n"
+            << "{\n"
+            << "    dccl::static_codec::BitCounter counter;\n"
+            << "    dccl_encode_bits(msg, &counter);\n"
+            << "    return counter.byte_size();\n"
+            << "}\n\n"
+            << "inline std::size_t dccl_decode(" << type
+            << "* msg, const std::uint8_t* bytes, std::size_t len)\n"
+            << "{\n"
+            << "    const std::size_t head_len = std::min<std::size_t>(" << head_bytes
+            << ", len);\n"
+            << "    dccl::BitReader head(bytes, head_len);\n"
+            << "    dccl::BitReader* reader = &head;\n"
+            << "    dccl::static_codec::read_id(reader, " << id << ");\n"
+            << decode_head.str()
+            << "    dccl::BitReader body(bytes + head_len, len - head_len);\n"
+            << "    reader = &body;\n"
+            << decode_body.str() << "    return head_len + body.byte_position();\n"
+            << "}\n\n"
+            << "inline std::size_t dccl_decode(" << type << "* msg, const std::string& bytes)\n"
+            << "{\n"
+            << "    return dccl_decode(msg, reinterpret_cast<const std::uint8_t*>(bytes.data()), "
+               "bytes.size());\n"
+            << "}\n";
+    }
+
+    //
+    // field properties (mirroring the default codecs)
+    //
+
+    static const dccl::DCCLFieldOptions& options(const google::protobuf::FieldDescriptor* field)
+    {
+        return field->options().GetExtension(dccl::field);
+    }
+
+    bool use_required(const google::protobuf::FieldDescriptor* field) const
+    {
+        if (version_ > 3)
+            return field->is_required() || field->is_repeated() || field->containing_oneof();
+        else if (version_ > 2)
+            return field->is_required() || field->is_repeated();
+        else
+            return field->is_required();
+    }
+
+    // message fields with a presence bit
+    bool is_optional(const google::protobuf::FieldDescriptor* field) const
+    {
+        if (!field || version_ < 3)
+            return false;
+        else if (version_ > 3)
+            return field->is_optional() && !use_required(field);
+        else
+            return field->is_optional();
+    }
+
+    bool included(const google::protobuf::FieldDescriptor* field, const Context& ctx) const
+    {
+        if (ctx.current_part == UNKNOWN)
+        {
+            // version 2 default message codec always expands
+            if (version_ == 2 &&
+                field->cpp_type() == google::protobuf::FieldDescriptor::CPPTYPE_MESSAGE)
+                return true;
+            return (ctx.pass == HEAD) == options(field).in_head();
+        }
+        else
+        {
+            return ctx.current_part == ctx.pass;
+        }
+    }
+
+    Context child_context(const google::protobuf::FieldDescriptor* field, const Context& ctx) const
+    {
+        Part part = ctx.current_part;
+        if (options(field).has_in_head())
+            part = options(field).in_head() ? HEAD : BODY;
+        return {ctx.pass, part, field};
+    }
+
+    void check_field(const google::protobuf::FieldDescriptor* field) const
+    {
+        const dccl::DCCLFieldOptions& opts = options(field);
+        std::string codec = has_codec_group_ ? codec_name_ : "dccl.default2";
+        if (opts.has_codec())
+            codec = opts.codec();
+        else if (field->cpp_type() == google::protobuf::FieldDescriptor::CPPTYPE_MESSAGE &&
+                 field->message_type()->options().GetExtension(dccl::msg).has_codec())
+            codec = field->message_type()->options().GetExtension(dccl::msg).codec();
+
+        if (codec != codec_name_)
+            throw Unsupported(field->full_name() + " uses codec " + codec);
+        if (opts.has_dynamic_conditions())
+            throw Unsupported(field->full_name() + " uses dynamic_conditions");
+        if (field->is_repeated() && (!opts.has_max_repeat() || opts.max_repeat() < 1 ||
+                                     opts.max_repeat() < opts.min_repeat()))
+            throw Unsupported(field->full_name() + " has invalid max_repeat");
+        if (is_keyword(field->lowercase_name()))
+            throw Unsupported(field->full_name() + " is named with a C++ keyword");
+
+        switch (field->cpp_type())
+        {
+            case google::protobuf::FieldDescriptor::CPPTYPE_INT32:
+            case google::protobuf::FieldDescriptor::CPPTYPE_INT64:
+            case google::protobuf::FieldDescriptor::CPPTYPE_UINT32:
+            case google::protobuf::FieldDescriptor::CPPTYPE_UINT64:
+            case google::protobuf::FieldDescriptor::CPPTYPE_DOUBLE:
+            case google::protobuf::FieldDescriptor::CPPTYPE_FLOAT:
+                if (!opts.has_min() || !opts.has_max())
+                    throw Unsupported(field->full_name() + " is missing min or max");
+                break;
+            case google::protobuf::FieldDescriptor::CPPTYPE_STRING:
+                if (!opts.has_max_length())
+                    throw Unsupported(field->full_name() + " is missing max_length");
+                if (version_ == 2 &&
+                    field->type() == google::protobuf::FieldDescriptor::TYPE_STRING &&
+                    opts.max_length() > v2_max_string_length)
+                    throw Unsupported(field->full_name() + " has invalid max_length");
+                // as FieldCodecBase::field_validate
+                if (opts.in_head() && bytes_size(field, false) != bytes_size(field, true))
+                    throw Unsupported(field->full_name() + " is variable size in the header");
+                break;
+            case google::protobuf::FieldDescriptor::CPPTYPE_BOOL:
+            case google::protobuf::FieldDescriptor::CPPTYPE_ENUM:
+            case google::protobuf::FieldDescriptor::CPPTYPE_MESSAGE: break;
+            default: throw Unsupported(field->full_name() + " has an unsupported type");
+        }
+    }
+
+    static bool is_keyword(const std::string& name)
+    {
+        static const std::set<std::string> keywords = {
+            "alignas",   "alignof",   "and",      "and_eq",   "asm",          "auto",
+            "bitand",    "bitor",     "bool",     "break",    "case",         "catch",
+            "char",      "class",     "compl",    "const",    "constexpr",    "const_cast",
+            "continue",  "decltype",  "default",  "delete",   "do",           "double",
+            "else",      "enum",      "explicit", "export",   "extern",       "false",
+            "float",     "for",       "friend",   "goto",     "if",           "inline",
+            "int",       "long",      "mutable",  "namespace", "new",         "noexcept",
+            "not",       "not_eq",    "nullptr",  "operator", "or",           "or_eq",
+            "private",   "protected", "public",   "register", "reinterpret_cast",
+            "return",    "short",     "signed",   "sizeof",   "static",       "static_assert",
+            "static_cast", "struct",  "switch",   "template", "this",         "thread_local",
+            "throw",     "true",      "try",      "typedef",  "typeid",       "typename",
+            "union",     "unsigned",  "using",    "virtual",  "void",         "volatile",
+            "wchar_t",   "while",     "xor",      "xor_eq"};
+        return keywords.count(name);
+    }
+
+    // bounds of a numeric or enum field (as DefaultNumericFieldCodec / DefaultEnumCodec)
+    struct Numeric
+    {
+        double min;
+        double max;
+        double resolution;
+        bool use_required;
+        unsigned size;
+    };
+
+    Numeric numeric(const google::protobuf::FieldDescriptor* field) const
+    {
+        const dccl::DCCLFieldOptions& opts = options(field);
+        Numeric n;
+        if (field->cpp_type() == google::protobuf::FieldDescriptor::CPPTYPE_ENUM)
+        {
+            const google::protobuf::EnumDescriptor* e = field->enum_type();
+            if (version_ == 2 || opts.packed_enum())
+            {
+                n.min = 0;
+                n.max = e->value_count() - 1;
+            }
+            else
+            {
+                int min = e->value(0)->number(), max = e->value(0)->number();
+                for (int i = 1; i < e->value_count(); ++i)
+                {
+                    min = std::min(min, e->value(i)->number());
+                    max = std::max(max, e->value(i)->number());
+                }
+                n.min = min;
+                n.max = max;
+            }
+        }
+        else
+        {
+            n.min = opts.min();
+            n.max = opts.max();
+        }
+        n.resolution = opts.has_precision() ? std::pow(10.0, -opts.precision()) : opts.resolution();
+        n.use_required = use_required(field);
+        n.size = numeric_size(n.min, n.max, n.resolution, n.use_required);
+        return n;
+    }
+
+    unsigned bool_size(const google::protobuf::FieldDescriptor* field) const
+    {
+        return dccl::ceil_log2(2 + (use_required(field) ? 0 : 1));
+    }
+
+    // v2::DefaultStringCodec::MAX_STRING_LENGTH
+    static const unsigned v2_max_string_length = 255;
+
+    // string and bytes fields: length-prefixed (v2 / v3 DefaultStringCodec, v3::VarBytesCodec) or
+    // fixed length (v2 DefaultBytesCodec)
+    bool is_var_bytes(const google::protobuf::FieldDescriptor* field) const
+    {
+        return version_ > 3 || field->type() == google::protobuf::FieldDescriptor::TYPE_STRING;
+    }
+
+    // presence bit (v2 DefaultBytesCodec and v3::VarBytesCodec only)
+    bool has_bytes_presence(const google::protobuf::FieldDescriptor* field) const
+    {
+        return (version_ > 3 || field->type() == google::protobuf::FieldDescriptor::TYPE_BYTES) &&
+               !use_required(field);
+    }
+
+    unsigned length_prefix_size(const google::protobuf::FieldDescriptor* field) const
+    {
+        unsigned max_length = version_ == 2 ? v2_max_string_length : options(field).max_length();
+        return dccl::ceil_log2(max_length + 1);
+    }
+
+    unsigned bytes_size(const google::protobuf::FieldDescriptor* field, bool max) const
+    {
+        unsigned presence = has_bytes_presence(field) ? 1 : 0;
+        unsigned body = options(field).max_length() * 8;
+        if (is_var_bytes(field))
+        {
+            if (max)
+                return presence + length_prefix_size(field) + body;
+            else
+                return presence ? presence : length_prefix_size(field);
+        }
+        else
+        {
+            return (max || !presence) ? presence + body : presence;
+        }
+    }
+
+    unsigned repeat_prefix_size(const google::protobuf::FieldDescriptor* field) const
+    {
+        return dccl::ceil_log2(options(field).max_repeat() - options(field).min_repeat() + 1);
+    }
+
+    //
+    // sizes (in bits), computed here so they are constants in the generated code
+    //
+
+    // size of a single (non-repeated) value of field
+    unsigned value_size(const google::protobuf::FieldDescriptor* field, const Context& ctx,
+                        bool max) const
+    {
+        switch (field->cpp_type())
+        {
+            case google::protobuf::FieldDescriptor::CPPTYPE_BOOL: return bool_size(field);
+            case google::protobuf::FieldDescriptor::CPPTYPE_STRING: return bytes_size(field, max);
+            case google::protobuf::FieldDescriptor::CPPTYPE_MESSAGE:
+            {
+                Context child = child_context(field, ctx);
+                // repeated messages have no presence bit
+                bool presence = is_optional(field) && !field->is_repeated();
+                if (max)
+                    return fields_max_size(field->message_type(), child) + (presence ? 1 : 0);
+                else
+                    return presence ? 1 : fields_min_size(field->message_type(), child);
+            }
+            default: return numeric(field).size;
+        }
+    }
+
+    unsigned field_size(const google::protobuf::FieldDescriptor* field, const Context& ctx,
+                        bool max) const
+    {
+        check_field(field);
+        unsigned size = value_size(field, ctx, max);
+        if (!field->is_repeated())
+            return size;
+
+        const dccl::DCCLFieldOptions& opts = options(field);
+        if (version_ > 2)
+            return repeat_prefix_size(field) + size * (max ? opts.max_repeat() : opts.min_repeat());
+        else
+            return size * opts.max_repeat();
+    }
+
+    unsigned fields_min_size(const google::protobuf::Descriptor* desc, const Context& ctx) const
+    {
+        unsigned size = 0;
+        if (version_ > 3 && ctx.pass != HEAD)
+            for (int i = 0, n = desc->oneof_decl_count(); i < n; ++i)
+                size += dccl::ceil_log2(desc->oneof_decl(i)->field_count() + 1);
+
+        for (int i = 0, n = desc->field_count(); i < n; ++i)
+        {
+            const google::protobuf::FieldDescriptor* field = desc->field(i);
+            if (options(field).omit() || !included(field, ctx))
+                continue;
+            // minimum size of a field belonging to oneof is zero
+            if (field->containing_oneof())
+                continue;
+            size += field_size(field, ctx, false);
+        }
+        return size;
+    }
+
+    unsigned fields_max_size(const google::protobuf::Descriptor* desc, const Context& ctx) const
+    {
+        unsigned size = 0;
+        std::vector<unsigned> oneof_max(desc->oneof_decl_count(), 0);
+        for (int i = 0, n = desc->field_count(); i < n; ++i)
+        {
+            const google::protobuf::FieldDescriptor* field = desc->field(i);
+            if (options(field).omit() || !included(field, ctx))
+                continue;
+            unsigned field_max = field_size(field, ctx, true);
+            if (field->containing_oneof())
+            {
+                unsigned& m = oneof_max[field->containing_oneof()->index()];
+                m = std::max(m, field_max);
+            }
+            else
+            {
+                size += field_max;
+            }
+        }
+
+        if (version_ > 3 && ctx.pass != HEAD)
+            for (int i = 0, n = desc->oneof_decl_count(); i < n; ++i)
+                size += dccl::ceil_log2(desc->oneof_decl(i)->field_count() + 1) + oneof_max[i];
+        return size;
+    }
+
+    void check_oneofs(const google::protobuf::Descriptor* desc, const Context& ctx) const
+    {
+        if (desc->oneof_decl_count() == 0)
+            return;
+        if (version_ < 4)
+            throw Unsupported(desc->full_name() + " uses oneof (requires codec_version 4)");
+
+        for (int i = 0, n = desc->field_count(); i < n; ++i)
+        {
+            const google::protobuf::FieldDescriptor* field = desc->field(i);
+            if (field->containing_oneof() && !options(field).omit() &&
+                (options(field).in_head() || (ctx.pass == HEAD && included(field, ctx))))
+                throw Unsupported(field->full_name() + " is a oneof field in the header");
+        }
+    }
+
+    //
+    // code generation
+    //
+
+    static std::string cpp_type(const google::protobuf::Descriptor* desc)
+    {
+        std::string name = "::" + desc->full_name();
+        for (std::string::size_type pos = 0; (pos = name.find('.', pos)) != std::string::npos;)
+            name.replace(pos, 1, "::");
+        return name;
+    }
+
+    static std::string cpp_type(const google::protobuf::EnumDescriptor* desc)
+    {
+        std::string name = "::" + desc->full_name();
+        for (std::string::size_type pos = 0; (pos = name.find('.', pos)) != std::string::npos;)
+            name.replace(pos, 1, "::");
+        return name;
+    }
+
+    static std::string wire_type(const google::protobuf::FieldDescriptor* field)
+    {
+        switch (field->cpp_type())
+        {
+            case google::protobuf::FieldDescriptor::CPPTYPE_INT32: return "dccl::int32";
+            case google::protobuf::FieldDescriptor::CPPTYPE_INT64: return "dccl::int64";
+            case google::protobuf::FieldDescriptor::CPPTYPE_UINT32: return "dccl::uint32";
+            case google::protobuf::FieldDescriptor::CPPTYPE_UINT64: return "dccl::uint64";
+            case google::protobuf::FieldDescriptor::CPPTYPE_DOUBLE: return "double";
+            case google::protobuf::FieldDescriptor::CPPTYPE_FLOAT: return "float";
+            default: return "dccl::int32"; // enumerations
+        }
+    }
+
+    static std::string literal(double d)
+    {
+        std::stringstream ss;
+        ss << std::setprecision(17) << d;
+        return ss.str();
+    }
+
+    static std::string boolean(bool b) { return b ? "true" : "false"; }
+
+    static std::string indent(int level) { return std::string(4 * level, ' '); }
+
+    std::string var(const std::string& base) { return base + std::to_string(++var_); }
+
+    // the numbers of the enumeration values, in declaration order
+    std::string enum_numbers(const google::protobuf::FieldDescriptor* field, std::stringstream& out,
+                             int level)
+    {
+        const google::protobuf::EnumDescriptor* e = field->enum_type();
+        std::string numbers = var("numbers");
+        out << indent(level) << "static const int " << numbers << "[] = {";
+        for (int i = 0; i < e->value_count(); ++i)
+            out << (i ? ", " : "") << e->value(i)->number();
+        out << "};\n";
+        return numbers;
+    }
+
+    // encode a single value (expression) of field
+    void encode_value(const google::protobuf::FieldDescriptor* field, const Context& ctx,
+                      const std::string& value, std::stringstream& out, int level)
+    {
+        switch (field->cpp_type())
+        {
+            case google::protobuf::FieldDescriptor::CPPTYPE_BOOL:
+                out << indent(level) << "dccl::static_codec::write_bool(writer, " << value << ", "
+                    << boolean(use_required(field)) << ", " << bool_size(field) << ");\n";
+                break;
+
+            case google::protobuf::FieldDescriptor::CPPTYPE_STRING:
+                if (is_var_bytes(field))
+                    out << indent(level) << "dccl::static_codec::write_var_bytes(writer, " << value
+                        << ", " << options(field).max_length() << ", "
+                        << length_prefix_size(field) << ", "
+                        << boolean(has_bytes_presence(field)) << ");\n";
+                else
+                    out << indent(level) << "dccl::static_codec::write_fixed_bytes(writer, "
+                        << value << ", " << options(field).max_length() << ", "
+                        << boolean(has_bytes_presence(field)) << ");\n";
+                break;
+
+            case google::protobuf::FieldDescriptor::CPPTYPE_MESSAGE:
+            {
+                std::string m = var("m");
+                if (is_optional(field) && !field->is_repeated())
+                    out << indent(level) << "writer->append(1, 1);\n";
+                // only bind the message if it has fields in this part
+                std::stringstream fields;
+                encode_fields(field->message_type(), child_context(field, ctx), m, fields, level);
+                if (!fields.str().empty())
+                    out << indent(level) << "const " << cpp_type(field->message_type()) << "& "
+                        << m << " = " << value << ";\n"
+                        << fields.str();
+                break;
+            }
+
+            case google::protobuf::FieldDescriptor::CPPTYPE_ENUM:
+            {
+                Numeric n = numeric(field);
+                std::string wire = value;
+                if (version_ == 2 || options(field).packed_enum())
+                {
+                    std::string numbers = enum_numbers(field, out, level);
+                    wire = "dccl::static_codec::enum_index(" + value + ", " + numbers + ", " +
+                           std::to_string(field->enum_type()->value_count()) + ")";
+                }
+                out << indent(level) << "dccl::static_codec::write_numeric<dccl::int32>(writer, "
+                    << wire << ", " << literal(n.min) << ", " << literal(n.max) << ", "
+                    << literal(n.resolution) << ", " << boolean(n.use_required) << ", " << n.size
+                    << ");\n";
+                break;
+            }
+
+            default:
+            {
+                Numeric n = numeric(field);
+                out << indent(level) << "dccl::static_codec::write_numeric<" << wire_type(field)
+                    << ">(writer, " << value << ", " << literal(n.min) << ", "
+                    << literal(n.max) << ", " << literal(n.resolution) << ", "
+                    << boolean(n.use_required) << ", " << n.size << ");\n";
+                break;
+            }
+        }
+    }
+
+    // encode the value that represents "not set"
+    void encode_empty(const google::protobuf::FieldDescriptor* field, const Context& ctx,
+                      std::stringstream& out, int level)
+    {
+        out << indent(level) << "writer->append(0, " << value_size(field, ctx, false) << ");\n";
+    }
+
+    // encode field's value (if set) or the "not set" value, omitting anything that writes no bits
+    void encode_or_empty(const google::protobuf::FieldDescriptor* field, const Context& ctx,
+                         const std::string& has, const std::string& value,
+                         std::stringstream& out, int level)
+    {
+        std::stringstream set;
+        encode_value(field, ctx, value, set, level + 1);
+        // fields belonging to a oneof are not encoded at all if not set
+        bool empty = !field->containing_oneof() && value_size(field, ctx, false) > 0;
+        if (set.str().empty() && !empty)
+            return;
+
+        out << indent(level) << "if (" << has << ")\n"
+            << indent(level) << "{\n"
+            << set.str() << indent(level) << "}\n";
+        if (empty)
+        {
+            out << indent(level) << "else\n";
+            encode_empty(field, ctx, out, level + 1);
+        }
+    }
+
+    void encode_fields(const google::protobuf::Descriptor* desc, const Context& ctx,
+                       const std::string& msg, std::stringstream& out, int level)
+    {
+        check_oneofs(desc, ctx);
+
+        // oneof cases: 0 if not set, the index of the field set + 1 otherwise
+        if (version_ > 3 && ctx.pass != HEAD)
+        {
+            for (int i = 0, n = desc->oneof_decl_count(); i < n; ++i)
+            {
+                const google::protobuf::OneofDescriptor* oneof = desc->oneof_decl(i);
+                out << indent(level) << "writer->append(";
+                for (int j = 0; j < oneof->field_count(); ++j)
+                    out << msg << ".has_" << oneof->field(j)->lowercase_name() << "() ? "
+                        << j + 1 << " : ";
+                out << "0, " << dccl::ceil_log2(oneof->field_count() + 1) << ");\n";
+            }
+        }
+
+        for (int i = 0, n = desc->field_count(); i < n; ++i)
+        {
+            const google::protobuf::FieldDescriptor* field = desc->field(i);
+            if (options(field).omit() || !included(field, ctx))
+                continue;
+            check_field(field);
+
+            const std::string name = field->lowercase_name();
+            std::stringstream code;
+            if (field->is_repeated())
+            {
+                const dccl::DCCLFieldOptions& opts = options(field);
+                std::string count = var("n"), index = var("i");
+                std::stringstream element;
+                encode_or_empty(field, ctx, index + " < " + msg + "." + name + "_size()",
+                                msg + "." + name + "(" + index + ")", element, level + 2);
+                if (version_ > 2)
+                {
+                    code << indent(level + 1) << "const int " << count << " = std::max("
+                         << opts.min_repeat() << ", std::min(" << opts.max_repeat() << ", "
+                         << msg << "." << name << "_size()));\n"
+                         << indent(level + 1) << "writer->append(" << count << " - "
+                         << opts.min_repeat() << ", " << repeat_prefix_size(field) << ");\n";
+                }
+                else if (!element.str().empty())
+                {
+                    code << indent(level + 1) << "const int " << count << " = "
+                         << opts.max_repeat() << ";\n";
+                }
+                if (!element.str().empty())
+                    code << indent(level + 1) << "for (int " << index << " = 0; " << index
+                         << " < " << count << "; ++" << index << ")\n"
+                         << indent(level + 1) << "{\n"
+                         << element.str() << indent(level + 1) << "}\n";
+                if (!code.str().empty())
+                    code.str(indent(level) + "{\n" + code.str() + indent(level) + "}\n");
+            }
+            else
+            {
+                encode_or_empty(field, ctx, msg + ".has_" + name + "()", msg + "." + name + "()",
+                                code, level);
+            }
+
+            if (!code.str().empty())
+                out << indent(level) << "// " << name << "\n" << code.str();
+        }
+    }
+
+    // decode a single value of field, calling "setter(value)" if not null
+    void decode_value(const google::protobuf::FieldDescriptor* field, const std::string& reader,
+                      const std::string& setter, std::stringstream& out, int level)
+    {
+        switch (field->cpp_type())
+        {
+            case google::protobuf::FieldDescriptor::CPPTYPE_BOOL:
+            {
+                std::string v = var("v");
+                out << indent(level) << "bool " << v << ";\n"
+                    << indent(level) << "if (dccl::static_codec::read_bool(" << reader << ", "
+                    << boolean(use_required(field)) << ", " << bool_size(field) << ", &" << v
+                    << "))\n"
+                    << indent(level + 1) << setter << "(" << v << ");\n";
+                break;
+            }
+
+            case google::protobuf::FieldDescriptor::CPPTYPE_STRING:
+            {
+                std::string v = var("v");
+                // DefaultStringCodec (but not VarBytesCodec) decodes an empty string as not set
+                bool empty_is_null =
+                    version_ < 4 && field->type() == google::protobuf::FieldDescriptor::TYPE_STRING;
+                out << indent(level) << "std::string " << v << ";\n";
+                if (is_var_bytes(field))
+                    out << indent(level) << "if (dccl::static_codec::read_var_bytes(" << reader
+                        << ", " << length_prefix_size(field) << ", "
+                        << boolean(has_bytes_presence(field)) << ", " << boolean(empty_is_null)
+                        << ", &" << v << "))\n";
+                else
+                    out << indent(level) << "if (dccl::static_codec::read_fixed_bytes(" << reader
+                        << ", " << options(field).max_length() << ", "
+                        << boolean(has_bytes_presence(field)) << ", &" << v << "))\n";
+                out << indent(level + 1) << setter << "(" << v << ");\n";
+                break;
+            }
+
+            case google::protobuf::FieldDescriptor::CPPTYPE_ENUM:
+            {
+                Numeric n = numeric(field);
+                std::string numbers = enum_numbers(field, out, level);
+                std::string v = var("v");
+                int count = field->enum_type()->value_count();
+                out << indent(level) << "dccl::int32 " << v << ";\n"
+                    << indent(level) << "if (dccl::static_codec::read_numeric<dccl::int32>("
+                    << reader << ", " << literal(n.min) << ", " << literal(n.resolution) << ", "
+                    << boolean(n.use_required) << ", " << n.size << ", &" << v << ")";
+                if (version_ == 2 || options(field).packed_enum())
+                    out << " && " << v << " < " << count << ")\n"
+                        << indent(level + 1) << setter << "(static_cast<"
+                        << cpp_type(field->enum_type()) << ">(" << numbers << "[" << v
+                        << "]));\n";
+                else
+                    out << " &&\n"
+                        << indent(level + 1) << "dccl::static_codec::enum_index(" << v << ", "
+                        << numbers << ", " << count << ") >= 0)\n"
+                        << indent(level + 1) << setter << "(static_cast<"
+                        << cpp_type(field->enum_type()) << ">(" << v << "));\n";
+                break;
+            }
+
+            default:
+            {
+                Numeric n = numeric(field);
+                std::string v = var("v");
+                out << indent(level) << wire_type(field) << " " << v << ";\n"
+                    << indent(level) << "if (dccl::static_codec::read_numeric<" << wire_type(field)
+                    << ">(" << reader << ", " << literal(n.min) << ", " << literal(n.resolution)
+                    << ", " << boolean(n.use_required) << ", " << n.size << ", &" << v << "))\n"
+                    << indent(level + 1) << setter << "(" << v << ");\n";
+                break;
+            }
+        }
+    }
+
+    // expression that is true if any field of the message is set (as Reflection::ListFields)
+    static std::string has_fields(const google::protobuf::Descriptor* desc, const std::string& msg)
+    {
+        std::string expr;
+        for (int i = 0, n = desc->field_count(); i < n; ++i)
+        {
+            const google::protobuf::FieldDescriptor* field = desc->field(i);
+            expr += expr.empty() ? "" : " || ";
+            if (field->is_repeated())
+                expr += msg + "->" + field->lowercase_name() + "_size()";
+            else
+                expr += msg + "->has_" + field->lowercase_name() + "()";
+        }
+        return expr.empty() ? "false" : expr;
+    }
+
+    // decode the fields of the message field returned by expr, naming it m only if that is used
+    // (by the decoded fields, or by the check for an empty message if check_empty)
+    void decode_message(const google::protobuf::FieldDescriptor* field, const Context& ctx,
+                        const std::string& m, const std::string& expr, const std::string& reader,
+                        bool check_empty, std::stringstream& out, int level)
+    {
+        std::stringstream fields;
+        decode_fields(field->message_type(), child_context(field, ctx), m, reader, fields, level);
+        if (!fields.str().empty() || (check_empty && field->message_type()->field_count() > 0))
+            out << indent(level) << cpp_type(field->message_type()) << "* " << m << " = " << expr
+                << ";\n";
+        else
+            out << indent(level) << expr << ";\n";
+        out << fields.str();
+    }
+
+    void decode_fields(const google::protobuf::Descriptor* desc, const Context& ctx,
+                       const std::string& msg, const std::string& reader, std::stringstream& out,
+                       int level)
+    {
+        check_oneofs(desc, ctx);
+
+        std::vector<std::string> oneof_cases;
+        if (version_ > 3 && ctx.pass != HEAD)
+        {
+            for (int i = 0, n = desc->oneof_decl_count(); i < n; ++i)
+            {
+                oneof_cases.push_back(var("oneof_case"));
+                out << indent(level) << "const int " << oneof_cases.back()
+                    << " = static_cast<int>(" << reader << "->read("
+                    << dccl::ceil_log2(desc->oneof_decl(i)->field_count() + 1) << ")) - 1;\n";
+            }
+        }
+
+        for (int i = 0, n = desc->field_count(); i < n; ++i)
+        {
+            const google::protobuf::FieldDescriptor* field = desc->field(i);
+            if (options(field).omit() || !included(field, ctx))
+                continue;
+            check_field(field);
+
+            const std::string name = field->lowercase_name();
+            const bool is_message =
+                field->cpp_type() == google::protobuf::FieldDescriptor::CPPTYPE_MESSAGE;
+            out << indent(level) << "// " << name << "\n";
+
+            if (field->is_repeated())
+            {
+                const dccl::DCCLFieldOptions& opts = options(field);
+                std::string count = var("n"), index = var("i");
+                out << indent(level) << "{\n"
+                    << indent(level + 1) << "const int " << count << " = ";
+                if (version_ > 2)
+                    out << "static_cast<int>(" << reader << "->read("
+                        << repeat_prefix_size(field) << ")) + " << opts.min_repeat() << ";\n";
+                else
+                    out << opts.max_repeat() << ";\n";
+
+                if (is_message && version_ == 2)
+                {
+                    // as v2::DefaultMessageCodec: add max_repeat messages, then remove one
+                    // (from the end) for each that decoded empty
+                    std::string first = var("first"), empty = var("empty");
+                    out << indent(level + 1) << "const int " << first << " = " << msg << "->"
+                        << name << "_size();\n"
+                        << indent(level + 1) << "int " << empty << " = 0;\n"
+                        << indent(level + 1) << "for (int " << index << " = 0; " << index
+                        << " < " << count << "; ++" << index << ") " << msg << "->add_" << name
+                        << "();\n"
+                        << indent(level + 1) << "for (int " << index << " = 0; " << index
+                        << " < " << count << "; ++" << index << ")\n"
+                        << indent(level + 1) << "{\n";
+                    std::string m = var("m");
+                    decode_message(field, ctx, m,
+                                   msg + "->mutable_" + name + "(" + first + " + " + index + ")",
+                                   reader, true, out, level + 2);
+                    out << indent(level + 2) << "if (!(" << has_fields(field->message_type(), m)
+                        << "))\n"
+                        << indent(level + 3) << "++" << empty << ";\n"
+                        << indent(level + 1) << "}\n"
+                        << indent(level + 1) << "for (; " << empty << " > 0; --" << empty
+                        << ") " << msg << "->mutable_" << name << "()->RemoveLast();\n";
+                }
+                else if (is_message)
+                {
+                    std::string m = var("m");
+                    out << indent(level + 1) << "for (int " << index << " = 0; " << index
+                        << " < " << count << "; ++" << index << ")\n"
+                        << indent(level + 1) << "{\n";
+                    decode_message(field, ctx, m, msg + "->add_" + name + "()", reader, false,
+                                   out, level + 2);
+                    out << indent(level + 1) << "}\n";
+                }
+                else
+                {
+                    out << indent(level + 1) << "for (int " << index << " = 0; " << index
+                        << " < " << count << "; ++" << index << ")\n"
+                        << indent(level + 1) << "{\n";
+                    decode_value(field, reader, msg + "->add_" + name, out, level + 2);
+                    out << indent(level + 1) << "}\n";
+                }
+                out << indent(level) << "}\n";
+            }
+            else
+            {
+                int block = level;
+                if (field->containing_oneof())
+                {
+                    out << indent(level) << "if ("
+                        << oneof_cases[field->containing_oneof()->index()]
+                        << " == " << field->index_in_oneof() << ")\n";
+                }
+                out << indent(level) << "{\n";
+                ++block;
+
+                if (is_message)
+                {
+                    std::string m = var("m");
+                    if (is_optional(field))
+                    {
+                        // presence bit
+                        out << indent(block) << "if (" << reader << "->read(1))\n"
+                            << indent(block) << "{\n";
+                        decode_message(field, ctx, m, msg + "->mutable_" + name + "()", reader,
+                                       false, out, block + 1);
+                        out << indent(block) << "}\n"
+                            << indent(block) << "else\n"
+                            << indent(block + 1) << msg << "->clear_" << name << "();\n";
+                    }
+                    else
+                    {
+                        decode_message(field, ctx, m, msg + "->mutable_" + name + "()", reader,
+                                       version_ == 2, out, block);
+                        // as v2::DefaultMessageCodec: messages with no fields set are cleared
+                        if (version_ == 2)
+                            out << indent(block) << "if (!("
+                                << has_fields(field->message_type(), m) << "))\n"
+                                << indent(block + 1) << msg << "->clear_" << name << "();\n";
+                    }
+                }
+                else
+                {
+                    decode_value(field, reader, msg + "->set_" + name, out, block);
+                }
+                out << indent(level) << "}\n";
+            }
+        }
+    }
+
+  private:
+    const google::protobuf::FileDescriptor* file_;
+    std::string pb_h_name_;
+
+    // settings of the message currently being generated
+    int version_{2};
+    std::string codec_name_;
+    bool has_codec_group_{false};
+    // counter for unique variable names
+    int var_{0};
+};
+
+} // namespace static_codec
+} // namespace dccl
+
+#endif
@@ -24,6 +24,9 @@
 // along with DCCL.  If not, see <http://www.gnu.org/licenses/>.
 #include "gen_units_class_plugin.h"
 #include "option_extensions.pb.h"
+
+#include "gen_static_codec_plugin.h"
+
 #include <boost/algorithm/string.hpp>
 #include <fstream>
 #include <google/protobuf/compiler/code_generator.h>
@@ -41,6 +44,7 @@ std::set<std::string> base_units_to_include_;
 std::string filename_h_;
 std::string load_file_cpp_;
 std::shared_ptr<std::fstream> load_file_output_;
+bool static_codec_{false};
 
 std::string load_file_base_{
     R"DEL(#include <dccl/codec.h>
@@ -96,6 +100,10 @@ class DCCLGenerator : public google::protobuf::compiler::CodeGenerator
 
     void generate_load_file_headers() const;
     void generate_load_file_message_loader(const google::protobuf::Descriptor* desc) const;
+
+    void
+    generate_static_codec(const google::protobuf::FileDescriptor* file,
+                          google::protobuf::compiler::GeneratorContext* generator_context) const;
 };
 
 bool DCCLGenerator::check_field_type(const google::protobuf::FieldDescriptor* field) const
@@ -139,6 +147,10 @@ bool DCCLGenerator::Generate(const google::protobuf::FileDescriptor* file,
                 return false;
             }
         }
+        else if (key == "static_codec")
+        {
+            static_codec_ = true;
+        }
         else
         {
             *error = "Unknown parameter: " + key;
@@ -184,6 +196,9 @@ bool DCCLGenerator::Generate(const google::protobuf::FileDescriptor* file,
         { include_base_unit_headers(it, includes_ss); }
         include_printer.Print(includes_ss.str().c_str());
 
+        if (static_codec_)
+            generate_static_codec(file, generator_context);
+
         return true;
     }
     catch (std::exception& e)
@@ -429,6 +444,26 @@ void DCCLGenerator::generate_load_file_message_loader(
         *load_file_output_ << "DCCLLoader<" << cpp_name << "> " << loader_name << ";" << std::endl;
 }
 
+void DCCLGenerator::generate_static_codec(
+    const google::protobuf::FileDescriptor* file,
+    google::protobuf::compiler::GeneratorContext* generator_context) const
+{
+    // e.g. foo.proto -> foo.dccl.h
+    const std::string& filename = file->name();
+    std::string filename_dccl_h = filename.substr(0, filename.find(".proto")) + ".dccl.h";
+
+    // the generated header includes foo.pb.h from the same directory
+    std::string pb_h_name = filename_h_.substr(filename_h_.find_last_of('/') + 1);
+
+    std::shared_ptr<google::protobuf::io::ZeroCopyOutputStream> output(
+        generator_context->Open(filename_dccl_h));
+    google::protobuf::io::Printer printer(output.get(), '$');
+
+    dccl::static_codec::Generator generator(file, pb_h_name);
+    std::string code = generator.generate();
+    printer.WriteRaw(code.data(), code.size());
+}
+
 int main(int argc, char* argv[])
 {
     DCCLGenerator generator;
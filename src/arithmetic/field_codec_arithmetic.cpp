@@ -24,6 +24,7 @@
 
 #include "field_codec_arithmetic.h"
 #include "../codec.h"
+#include "field_codec_range.h"
 #include "../field_codec_manager.h"
 
 using dccl::dlog;
@@ -36,11 +37,6 @@ const int dccl::arith::Model::CODE_VALUE_BITS;
 const int dccl::arith::Model::FREQUENCY_BITS;
 const dccl::arith::Model::freq_type dccl::arith::Model::MAX_FREQUENCY;
 
-#if DCCL_THREAD_SUPPORT
-std::recursive_mutex dccl::arith::Model::last_bits_map_mutex;
-#endif
-std::map<std::string, std::map<std::string, dccl::Bitset>> dccl::arith::Model::last_bits_map;
-
 // shared library load
 extern "C"
 {
@@ -70,6 +66,16 @@ extern "C"
         dccl->manager().add<ArithmeticFieldCodec<bool>>("dccl.arithmetic");
         dccl->manager().add<ArithmeticFieldCodec<const google::protobuf::EnumValueDescriptor*>>(
             "dccl.arithmetic");
+
+        dccl->manager().add<RangeFieldCodec<int32>>("dccl.range");
+        dccl->manager().add<RangeFieldCodec<int64>>("dccl.range");
+        dccl->manager().add<RangeFieldCodec<uint32>>("dccl.range");
+        dccl->manager().add<RangeFieldCodec<uint64>>("dccl.range");
+        dccl->manager().add<RangeFieldCodec<double>>("dccl.range");
+        dccl->manager().add<RangeFieldCodec<float>>("dccl.range");
+        dccl->manager().add<RangeFieldCodec<bool>>("dccl.range");
+        dccl->manager().add<RangeFieldCodec<const google::protobuf::EnumValueDescriptor*>>(
+            "dccl.range");
     }
     void dccl3_unload(dccl::Codec* dccl) { dccl_arithmetic_unload(dccl); }
 
@@ -97,6 +103,16 @@ extern "C"
         dccl->manager().remove<ArithmeticFieldCodec<bool>>("dccl.arithmetic");
         dccl->manager().remove<ArithmeticFieldCodec<const google::protobuf::EnumValueDescriptor*>>(
             "dccl.arithmetic");
+
+        dccl->manager().remove<RangeFieldCodec<int32>>("dccl.range");
+        dccl->manager().remove<RangeFieldCodec<int64>>("dccl.range");
+        dccl->manager().remove<RangeFieldCodec<uint32>>("dccl.range");
+        dccl->manager().remove<RangeFieldCodec<uint64>>("dccl.range");
+        dccl->manager().remove<RangeFieldCodec<double>>("dccl.range");
+        dccl->manager().remove<RangeFieldCodec<float>>("dccl.range");
+        dccl->manager().remove<RangeFieldCodec<bool>>("dccl.range");
+        dccl->manager().remove<RangeFieldCodec<const google::protobuf::EnumValueDescriptor*>>(
+            "dccl.range");
     }
 }
 
@@ -137,33 +153,116 @@ dccl::arith::Model::value_type dccl::arith::Model::symbol_to_value(symbol_type s
     return value;
 }
 
-std::pair<dccl::arith::Model::freq_type, dccl::arith::Model::freq_type>
-dccl::arith::Model::symbol_to_cumulative_freq(symbol_type symbol, ModelState state) const
+void dccl::arith::CumulativeFrequencyTable::assign(const std::vector<freq_type>& freqs,
+                                                   bool adaptive)
+{
+    adaptive_ = adaptive;
+    freqs_ = freqs;
+    c_freqs_.clear();
+    tree_.clear();
+
+    total_ = 0;
+    for (freq_type freq : freqs_) total_ += freq;
+
+    if (adaptive_)
+    {
+        // build the Fenwick tree in O(n): each node adds itself to its parent
+        tree_.assign(freqs_.size() + 1, 0);
+        for (index_type i = 1, n = freqs_.size(); i <= n; ++i)
+        {
+            tree_[i] += freqs_[i - 1];
+            index_type parent = i + (i & -i);
+            if (parent <= n)
+                tree_[parent] += tree_[i];
+        }
+    }
+    else
+    {
+        freq_type cumulative_freq = 0;
+        for (freq_type freq : freqs_)
+        {
+            cumulative_freq += freq;
+            c_freqs_.push_back(cumulative_freq);
+        }
+        build_lookup();
+    }
+}
+
+void dccl::arith::CumulativeFrequencyTable::build_lookup()
+{
+    lookup_.clear();
+    lookup_shift_ = 0;
+    if (total_ == 0)
+        return;
+
+    while (((total_ - 1) >> lookup_shift_) >= (1u << LOOKUP_BITS)) ++lookup_shift_;
+
+    index_type index = 0;
+    for (freq_type m = 0, n = ((total_ - 1) >> lookup_shift_) + 1; m < n; ++m)
+    {
+        while (c_freqs_[index] <= (m << lookup_shift_)) ++index;
+        lookup_.push_back(index);
+    }
+}
+
+dccl::arith::CumulativeFrequencyTable::index_type
+dccl::arith::CumulativeFrequencyTable::find(freq_type c_freq) const
+{
+    if (!adaptive_)
+    {
+        if (c_freq >= total_)
+            return c_freqs_.size();
+
+        index_type index = lookup_[c_freq >> lookup_shift_];
+        while (c_freqs_[index] <= c_freq) ++index;
+        return index;
+    }
+
+    // descend the tree to find the largest number of symbols whose
+    // frequencies sum to no more than c_freq: the next symbol is the one we want
+    index_type n = freqs_.size();
+    index_type step = 1;
+    while (step * 2 <= n) step *= 2;
+
+    index_type index = 0;
+    for (; step > 0; step /= 2)
+    {
+        if (index + step <= n && tree_[index + step] <= c_freq)
+        {
+            index += step;
+            c_freq -= tree_[index];
+        }
+    }
+    return index;
+}
+
+void dccl::arith::CumulativeFrequencyTable::increment(index_type index)
 {
-    const auto& c_freqs =
-        (state == ENCODER) ? encoder_cumulative_freqs_ : decoder_cumulative_freqs_;
+    ++freqs_[index];
+    ++total_;
 
-    auto c_freq_it = c_freqs.find(symbol);
-    std::pair<freq_type, freq_type> c_freq_range;
-    c_freq_range.second = c_freq_it->second;
-    if (c_freq_it == c_freqs.begin())
+    if (adaptive_)
     {
-        c_freq_range.first = 0;
+        for (index_type i = index + 1, n = freqs_.size(); i <= n; i += i & -i) ++tree_[i];
     }
     else
     {
-        c_freq_it--;
-        c_freq_range.first = c_freq_it->second;
+        for (index_type i = index, n = c_freqs_.size(); i < n; ++i) ++c_freqs_[i];
+        build_lookup();
     }
-    return c_freq_range;
+}
+
+std::pair<dccl::arith::Model::freq_type, dccl::arith::Model::freq_type>
+dccl::arith::Model::symbol_to_cumulative_freq(symbol_type symbol, ModelState state) const
+{
+    return cumulative_freqs(state).range(symbol - MIN_SYMBOL);
 }
 
 std::pair<dccl::arith::Model::symbol_type, dccl::arith::Model::symbol_type>
 dccl::arith::Model::cumulative_freq_to_symbol(std::pair<freq_type, freq_type> c_freq_pair,
                                               ModelState state) const
 {
-    const auto& c_freqs =
-        (state == ENCODER) ? encoder_cumulative_freqs_ : decoder_cumulative_freqs_;
+    const CumulativeFrequencyTable& c_freqs = cumulative_freqs(state);
 
     std::pair<symbol_type, symbol_type> symbol_pair;
 
@@ -174,19 +273,12 @@ dccl::arith::Model::cumulative_freq_to_symbol(std::pair<freq_type, freq_type> c_
     // symbol: 2   freq: 10   c_freq: 35 [25 ... 35)
     // searching for c_freq of 30 should return symbol 2
     // searching for c_freq of 10 should return symbol 1
-    auto search = c_freq_pair.first;
-    for (const auto& p : c_freqs)
-    {
-        if (search < p.second)
-        {
-            symbol_pair.first = p.first;
-            break;
-        }
-    }
+    CumulativeFrequencyTable::index_type index = c_freqs.find(c_freq_pair.first);
+    symbol_pair.first = index + MIN_SYMBOL;
 
-    if (symbol_pair.first == c_freqs.rbegin()->first)
+    if (index == c_freqs.size() - 1)
         symbol_pair.second = symbol_pair.first; // last symbol can't be ambiguous on the low end
-    else if (c_freqs.find(symbol_pair.first)->second > c_freq_pair.second)
+    else if (c_freqs.range(index).second > c_freq_pair.second)
         symbol_pair.second = symbol_pair.first; // unambiguously this symbol
     else
         symbol_pair.second = symbol_pair.first + 1;
@@ -201,44 +293,52 @@ void dccl::arith::Model::update_model(symbol_type symbol, ModelState state)
 
     auto& c_freqs = (state == ENCODER) ? encoder_cumulative_freqs_ : decoder_cumulative_freqs_;
 
-    if (dlog.check(DEBUG3))
+    if (DCCL_LOG_CHECK(DEBUG3))
     {
-        dlog.is(DEBUG3) && dlog << "Model was: " << std::endl;
+        DCCL_LOG_IS(DEBUG3, GENERAL) && dlog << "Model was: " << std::endl;
         for (symbol_type i = MIN_SYMBOL, n = max_symbol(); i <= n; ++i)
-        {
-            auto it = c_freqs.find(i);
-            if (it != c_freqs.end())
-                dlog.is(DEBUG3) && dlog << "Symbol: " << it->first << ", c_freq: " << it->second
-                                        << std::endl;
-        }
+            DCCL_LOG_IS(DEBUG3, GENERAL) &&
+                dlog << "Symbol: " << i << ", c_freq: " << c_freqs.range(i - MIN_SYMBOL).second
+                     << std::endl;
     }
 
-    for (symbol_type i = max_symbol(), n = symbol; i >= n; --i)
-    {
-        auto it = c_freqs.find(i);
-        if (it != c_freqs.end())
-            ++it->second;
-    }
+    c_freqs.increment(symbol - MIN_SYMBOL);
 
-    if (dlog.check(DEBUG3))
+    if (DCCL_LOG_CHECK(DEBUG3))
     {
-        dlog.is(DEBUG3) && dlog << "Model is now: " << std::endl;
+        DCCL_LOG_IS(DEBUG3, GENERAL) && dlog << "Model is now: " << std::endl;
         for (symbol_type i = MIN_SYMBOL, n = max_symbol(); i <= n; ++i)
-        {
-            auto it = c_freqs.find(i);
-            if (it != c_freqs.end())
-                dlog.is(DEBUG3) && dlog << "Symbol: " << it->first << ", c_freq: " << it->second
-                                        << std::endl;
-        }
+            DCCL_LOG_IS(DEBUG3, GENERAL) &&
+                dlog << "Symbol: " << i << ", c_freq: " << c_freqs.range(i - MIN_SYMBOL).second
+                     << std::endl;
     }
 
-    dlog.is(DEBUG3) && dlog << "total freq: " << total_freq(state) << std::endl;
+    DCCL_LOG_IS(DEBUG3, GENERAL) && dlog << "total freq: " << total_freq(state) << std::endl;
 }
 
 void dccl::arith::ModelManager::set_model(dccl::Codec& codec,
                                           const protobuf::ArithmeticModel& model)
 {
     model_manager(codec.manager())._set_model(model);
+    // the sizes of the messages using this model have changed
+    codec.manager().configuration_changed();
+    // start adapting again from the new model
+    model_state(codec.manager()).adaptive_models_.erase(model.name());
+}
+
+dccl::arith::ModelState dccl::arith::ModelManager::snapshot(dccl::Codec& codec)
+{
+    return model_state(codec.manager());
+}
+
+void dccl::arith::ModelManager::restore(dccl::Codec& codec, const ModelState& state)
+{
+    model_state(codec.manager()) = state;
+}
+
+void dccl::arith::ModelManager::reset(dccl::Codec& codec)
+{
+    model_state(codec.manager()).adaptive_models_.clear();
 }
 
 dccl::arith::ModelManager& dccl::arith::model_manager(FieldCodecManagerLocal& manager)
@@ -252,3 +352,12 @@ dccl::arith::ModelManager& dccl::arith::model_manager(FieldCodecManagerLocal& ma
     return dccl::any_cast<ModelManager&>(
         *manager.codec_data().template codec_specific_data<ArithmeticFieldCodecBase<>>());
 }
+
+dccl::arith::ModelState& dccl::arith::model_state(FieldCodecManagerLocal& manager)
+{
+    std::shared_ptr<dccl::any>& state =
+        manager.codec_data().template codec_specific_state<ArithmeticFieldCodecBase<>>();
+    if (!state)
+        state = std::make_shared<dccl::any>(ModelState());
+    return dccl::any_cast<ModelState&>(*state);
+}
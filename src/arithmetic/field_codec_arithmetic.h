@@ -29,6 +29,7 @@
 #include <algorithm>
 #include <limits>
 #include <utility>
+#include <vector>
 
 #include "../field_codec_typed.h"
 
@@ -38,7 +39,6 @@
 #include "../logger.h"
 
 #include "../binary.h"
-#include "../thread_safety.h"
 
 extern "C"
 {
@@ -54,8 +54,67 @@ namespace dccl
 namespace arith
 {
 class ModelManager;
+class ModelTrainer;
+class ModelState;
 
 ModelManager& model_manager(FieldCodecManagerLocal& manager);
+ModelState& model_state(FieldCodecManagerLocal& manager);
+
+/// \brief Cumulative frequencies of a model's symbols, stored contiguously by symbol index (symbol - Model::MIN_SYMBOL).
+///
+/// Fixed tables keep the cumulative frequency of each symbol in an array (O(1) lookup), with an index of the symbols by cumulative frequency so that decoding usually finds a symbol in one step rather than by binary search. Adaptive tables use a Fenwick (binary indexed) tree so that incrementing a symbol's frequency is O(log n) rather than rewriting every cumulative frequency above it.
+class CumulativeFrequencyTable
+{
+  public:
+    using freq_type = uint32;
+    using index_type = int;
+
+    /// \brief Build the table from the frequency of each symbol
+    void assign(const std::vector<freq_type>& freqs, bool adaptive);
+
+    index_type size() const { return freqs_.size(); }
+    freq_type total() const { return total_; }
+
+    /// \brief Cumulative frequency range [low, high) of the symbol at index
+    std::pair<freq_type, freq_type> range(index_type index) const
+    {
+        freq_type low = adaptive_ ? prefix(index) : (index == 0 ? 0 : c_freqs_[index - 1]);
+        return std::make_pair(low, low + freqs_[index]);
+    }
+
+    /// \brief Index of the first symbol whose range ends above c_freq
+    index_type find(freq_type c_freq) const;
+
+    /// \brief Add one to the frequency of the symbol at index
+    void increment(index_type index);
+
+  private:
+    // sum of the frequencies of the symbols before index
+    freq_type prefix(index_type index) const
+    {
+        freq_type sum = 0;
+        for (; index > 0; index -= index & -index) sum += tree_[index];
+        return sum;
+    }
+
+    void build_lookup();
+
+  private:
+    // maximum number of entries in lookup_
+    static constexpr int LOOKUP_BITS = 12;
+
+    bool adaptive_{false};
+    freq_type total_{0};
+    std::vector<freq_type> freqs_;
+    // fixed tables: cumulative frequency up to and including each symbol
+    std::vector<freq_type> c_freqs_;
+    // fixed tables: for each multiple m of 2^lookup_shift_ below total_, the index of the symbol
+    // containing m, from which find() searches upwards
+    std::vector<index_type> lookup_;
+    int lookup_shift_{0};
+    // adaptive tables: Fenwick tree (1-based)
+    std::vector<freq_type> tree_;
+};
 
 class Model
 {
@@ -73,16 +132,6 @@ class Model
 
     static constexpr freq_type MAX_FREQUENCY = (1 << FREQUENCY_BITS) - 1;
 
-#if DCCL_THREAD_SUPPORT
-    static std::recursive_mutex last_bits_map_mutex;
-#define LOCK_LAST_BITS_MAP_MUTEX \
-    std::lock_guard<std::recursive_mutex> l(dccl::arith::Model::last_bits_map_mutex);
-#else
-#define LOCK_LAST_BITS_MAP_MUTEX
-#endif
-    // maps message name -> map of field name -> last size (bits)
-    static std::map<std::string, std::map<std::string, Bitset>> last_bits_map;
-
     Model(protobuf::ArithmeticModel user) : user_model_(std::move(user)) {}
 
     enum ModelState
@@ -102,13 +151,7 @@ class Model
 
     symbol_type max_symbol() const { return user_model_.frequency_size() - 1; }
 
-    freq_type total_freq(ModelState state) const
-    {
-        const auto& c_freqs =
-            (state == ENCODER) ? encoder_cumulative_freqs_ : decoder_cumulative_freqs_;
-
-        return c_freqs.at(max_symbol());
-    }
+    freq_type total_freq(ModelState state) const { return cumulative_freqs(state).total(); }
 
     void update_model(symbol_type symbol, ModelState state);
 
@@ -117,12 +160,24 @@ class Model
     std::pair<symbol_type, symbol_type>
     cumulative_freq_to_symbol(std::pair<freq_type, freq_type> c_freq_pair, ModelState state) const;
 
+    /// \brief The symbol whose cumulative frequency range contains c_freq
+    symbol_type cumulative_freq_to_symbol(freq_type c_freq, ModelState state) const
+    {
+        return cumulative_freqs(state).find(c_freq) + MIN_SYMBOL;
+    }
+
     friend class ModelManager;
 
+  private:
+    const CumulativeFrequencyTable& cumulative_freqs(ModelState state) const
+    {
+        return (state == ENCODER) ? encoder_cumulative_freqs_ : decoder_cumulative_freqs_;
+    }
+
   private:
     protobuf::ArithmeticModel user_model_;
-    std::map<symbol_type, freq_type> encoder_cumulative_freqs_;
-    std::map<symbol_type, freq_type> decoder_cumulative_freqs_;
+    CumulativeFrequencyTable encoder_cumulative_freqs_;
+    CumulativeFrequencyTable decoder_cumulative_freqs_;
 };
 
 class ModelManager
@@ -130,6 +185,15 @@ class ModelManager
   public:
     static void set_model(dccl::Codec& codec, const protobuf::ArithmeticModel& model);
 
+    /// \brief Copy the state of the adaptive models of codec (or of the CodecSession for codec active on the calling thread), for example to return to it with restore() if a message is lost.
+    static ModelState snapshot(dccl::Codec& codec);
+
+    /// \brief Replace the state of the adaptive models of codec (or of the CodecSession for codec active on the calling thread) with one taken by snapshot()
+    static void restore(dccl::Codec& codec, const ModelState& state);
+
+    /// \brief Return the adaptive models of codec (or of the CodecSession for codec active on the calling thread) to the frequencies given to set_model()
+    static void reset(dccl::Codec& codec);
+
     Model& find(const std::string& name)
     {
         auto it = arithmetic_models_.find(name);
@@ -140,6 +204,7 @@ class ModelManager
     }
 
   private:
+    friend class ModelTrainer;
     void _set_model(const protobuf::ArithmeticModel& model)
     {
         Model new_model(model);
@@ -157,7 +222,7 @@ class ModelManager
                             "Missing fields: " + model->user_model_.InitializationErrorString()));
         }
 
-        Model::freq_type cumulative_freq = 0;
+        std::vector<Model::freq_type> freqs;
         for (Model::symbol_type symbol = Model::MIN_SYMBOL, n = model->user_model_.frequency_size();
              symbol < n; ++symbol)
         {
@@ -174,9 +239,9 @@ class ModelManager
                 throw(Exception("Invalid model: " + model->user_model_.DebugString() +
                                 "All frequencies must be nonzero."));
             }
-            cumulative_freq += freq;
-            model->encoder_cumulative_freqs_.insert(std::make_pair(symbol, cumulative_freq));
+            freqs.push_back(freq);
         }
+        model->encoder_cumulative_freqs_.assign(freqs, model->user_model_.is_adaptive());
 
         // must have separate models for adaptive encoding.
         model->decoder_cumulative_freqs_ = model->encoder_cumulative_freqs_;
@@ -210,6 +275,38 @@ class ModelManager
     std::map<std::string, Model> arithmetic_models_;
 };
 
+/// \brief State of the arithmetic models that changes as messages are encoded and decoded, kept by each Codec and each CodecSession (so that sessions on different threads never share it): the frequencies of the adaptive models and, for (dccl.field).arithmetic.debug_assert, the bits last encoded for each field.
+///
+/// The models themselves (ModelManager) are configuration, shared by a Codec and its sessions.
+class ModelState
+{
+  public:
+    /// \brief The model to encode or decode with: for adaptive models, this state's copy of the model (made when it is first used), otherwise the model in manager
+    Model& model(ModelManager& manager, const std::string& name)
+    {
+        Model& shared_model = manager.find(name);
+        if (!shared_model.user_model().is_adaptive())
+            return shared_model;
+
+        auto it = adaptive_models_.find(name);
+        if (it == adaptive_models_.end())
+            it = adaptive_models_.insert(std::make_pair(name, shared_model)).first;
+        return it->second;
+    }
+
+    /// \brief Bits last encoded for a field (for debug_assert)
+    Bitset& last_bits(const std::string& message_name, const std::string& field_name)
+    {
+        return last_bits_map_[message_name][field_name];
+    }
+
+  private:
+    friend class ModelManager;
+    std::map<std::string, Model> adaptive_models_;
+    // maps message name -> map of field name -> last size (bits)
+    std::map<std::string, std::map<std::string, Bitset>> last_bits_map_;
+};
+
 template <typename FieldType = Model::value_type>
 class ArithmeticFieldCodecBase : public RepeatedTypedFieldCodec<Model::value_type, FieldType>
 {
@@ -244,8 +341,8 @@ class ArithmeticFieldCodecBase : public RepeatedTypedFieldCodec<Model::value_typ
             if (wire_value.size() > value_index)
             {
                 Model::value_type value = wire_value[value_index];
-                dlog.is(DEBUG3) && dlog << "(ArithmeticFieldCodec) value is : " << value
-                                        << std::endl;
+                DCCL_LOG_IS(DEBUG3, GENERAL) &&
+                    dlog << "(ArithmeticFieldCodec) value is : " << value << std::endl;
 
                 symbol = model.value_to_symbol(value);
             }
@@ -254,9 +351,10 @@ class ArithmeticFieldCodecBase : public RepeatedTypedFieldCodec<Model::value_typ
             if (symbol == Model::OUT_OF_RANGE_SYMBOL &&
                 model.user_model().out_of_range_frequency() == 0)
             {
-                dlog.is(DEBUG2) && dlog << "(ArithmeticFieldCodec) out of range symbol, but no "
-                                           "frequency given; ending encoding"
-                                        << std::endl;
+                DCCL_LOG_IS(DEBUG2, GENERAL) &&
+                    dlog << "(ArithmeticFieldCodec) out of range symbol, but no frequency given; "
+                            "ending encoding"
+                         << std::endl;
 
                 symbol = Model::EOF_SYMBOL;
             }
@@ -264,46 +362,50 @@ class ArithmeticFieldCodecBase : public RepeatedTypedFieldCodec<Model::value_typ
             // if EOF_SYMBOL is given no frequency, use most probable symbol and give a warning
             if (symbol == Model::EOF_SYMBOL && model.user_model().eof_frequency() == 0)
             {
-                dlog.is(DEBUG2) && dlog << "(ArithmeticFieldCodec) end of file, but no frequency "
-                                           "given; filling with most probable symbol"
-                                        << std::endl;
+                DCCL_LOG_IS(DEBUG2, GENERAL) &&
+                    dlog << "(ArithmeticFieldCodec) end of file, but no frequency given; filling "
+                            "with most probable symbol"
+                         << std::endl;
                 symbol = *std::max_element(model.user_model().frequency().begin(),
                                            model.user_model().frequency().end());
             }
 
-            dlog.is(DEBUG3) && dlog << "(ArithmeticFieldCodec) symbol is : " << symbol << std::endl;
+            DCCL_LOG_IS(DEBUG3, GENERAL) &&
+                dlog << "(ArithmeticFieldCodec) symbol is : " << symbol << std::endl;
 
-            dlog.is(DEBUG3) && dlog << "(ArithmeticFieldCodec) current interval: ["
-                                    << (double)low / TOP_VALUE << "," << (double)high / TOP_VALUE
-                                    << ")" << std::endl;
+            DCCL_LOG_IS(DEBUG3, GENERAL) &&
+                dlog << "(ArithmeticFieldCodec) current interval: [" << (double)low / TOP_VALUE
+                     << "," << (double)high / TOP_VALUE << ")" << std::endl;
 
             uint64 range = (high - low) + 1;
 
             std::pair<Model::freq_type, Model::freq_type> c_freq_range =
                 model.symbol_to_cumulative_freq(symbol, Model::ENCODER);
 
-            dlog.is(DEBUG3) && dlog << "(ArithmeticFieldCodec) input symbol (" << symbol
-                                    << ") cumulative freq: [" << c_freq_range.first << ","
-                                    << c_freq_range.second << ")" << std::endl;
+            DCCL_LOG_IS(DEBUG3, GENERAL) &&
+                dlog << "(ArithmeticFieldCodec) input symbol (" << symbol << ") cumulative freq: ["
+                     << c_freq_range.first << "," << c_freq_range.second << ")" << std::endl;
 
             high = low + (range * c_freq_range.second) / model.total_freq(Model::ENCODER) - 1;
             low += (range * c_freq_range.first) / model.total_freq(Model::ENCODER);
 
-            dlog.is(DEBUG3) && dlog << "(ArithmeticFieldCodec) input symbol (" << symbol
-                                    << ") interval: [" << (double)low / TOP_VALUE << ","
-                                    << (double)high / TOP_VALUE << ")" << std::endl;
+            DCCL_LOG_IS(DEBUG3, GENERAL) &&
+                dlog << "(ArithmeticFieldCodec) input symbol (" << symbol << ") interval: ["
+                     << (double)low / TOP_VALUE << "," << (double)high / TOP_VALUE << ")"
+                     << std::endl;
 
-            dlog.is(DEBUG3) &&
+            DCCL_LOG_IS(DEBUG3, GENERAL) &&
                 dlog << "(ArithmeticFieldCodec) Q1: " << Bitset(Model::CODE_VALUE_BITS, FIRST_QTR)
-                     << ", Q2: " << Bitset(Model::CODE_VALUE_BITS, HALF)
-                     << ", Q3 : " << Bitset(Model::CODE_VALUE_BITS, THIRD_QTR)
-                     << ", top: " << Bitset(Model::CODE_VALUE_BITS, TOP_VALUE) << std::endl;
+                     << ", Q2: " << Bitset(Model::CODE_VALUE_BITS, HALF) << ", Q3 : "
+                     << Bitset(Model::CODE_VALUE_BITS, THIRD_QTR) << ", top: "
+                     << Bitset(Model::CODE_VALUE_BITS, TOP_VALUE) << std::endl;
 
-            dlog.is(DEBUG3) && dlog << "(ArithmeticFieldCodec) low:  "
-                                    << Bitset(Model::CODE_VALUE_BITS, low).to_string() << std::endl;
-            dlog.is(DEBUG3) && dlog << "(ArithmeticFieldCodec) high: "
-                                    << Bitset(Model::CODE_VALUE_BITS, high).to_string()
-                                    << std::endl;
+            DCCL_LOG_IS(DEBUG3, GENERAL) &&
+                dlog << "(ArithmeticFieldCodec) low:  "
+                     << Bitset(Model::CODE_VALUE_BITS, low).to_string() << std::endl;
+            DCCL_LOG_IS(DEBUG3, GENERAL) &&
+                dlog << "(ArithmeticFieldCodec) high: "
+                     << Bitset(Model::CODE_VALUE_BITS, high).to_string() << std::endl;
 
             if (update_model)
                 model.update_model(symbol, Model::ENCODER);
@@ -313,7 +415,7 @@ class ArithmeticFieldCodecBase : public RepeatedTypedFieldCodec<Model::value_typ
                 if (high < HALF)
                 {
                     bit_plus_follow(&bits, &bits_to_follow, 0);
-                    dlog.is(DEBUG3) &&
+                    DCCL_LOG_IS(DEBUG3, GENERAL) &&
                         dlog << "(ArithmeticFieldCodec): completely in [0, 0.5): EXPAND"
                              << std::endl;
                 }
@@ -322,13 +424,13 @@ class ArithmeticFieldCodecBase : public RepeatedTypedFieldCodec<Model::value_typ
                     bit_plus_follow(&bits, &bits_to_follow, 1);
                     low -= HALF;
                     high -= HALF;
-                    dlog.is(DEBUG3) &&
+                    DCCL_LOG_IS(DEBUG3, GENERAL) &&
                         dlog << "(ArithmeticFieldCodec): completely in [0.5, 1): EXPAND"
                              << std::endl;
                 }
                 else if (low >= FIRST_QTR && high < THIRD_QTR)
                 {
-                    dlog.is(DEBUG3) &&
+                    DCCL_LOG_IS(DEBUG3, GENERAL) &&
                         dlog << "(ArithmeticFieldCodec): straddle middle [0.25, 0.75): EXPAND"
                              << std::endl;
 
@@ -343,16 +445,16 @@ class ArithmeticFieldCodecBase : public RepeatedTypedFieldCodec<Model::value_typ
                 high <<= 1;
                 high += 1;
 
-                dlog.is(DEBUG3) && dlog << "(ArithmeticFieldCodec) low:  "
-                                        << Bitset(Model::CODE_VALUE_BITS, low).to_string()
-                                        << std::endl;
-                dlog.is(DEBUG3) && dlog << "(ArithmeticFieldCodec) high: "
-                                        << Bitset(Model::CODE_VALUE_BITS, high).to_string()
-                                        << std::endl;
+                DCCL_LOG_IS(DEBUG3, GENERAL) &&
+                    dlog << "(ArithmeticFieldCodec) low:  "
+                         << Bitset(Model::CODE_VALUE_BITS, low).to_string() << std::endl;
+                DCCL_LOG_IS(DEBUG3, GENERAL) &&
+                    dlog << "(ArithmeticFieldCodec) high: "
+                         << Bitset(Model::CODE_VALUE_BITS, high).to_string() << std::endl;
 
-                dlog.is(DEBUG3) && dlog << "(ArithmeticFieldCodec) current interval: ["
-                                        << (double)low / TOP_VALUE << ","
-                                        << (double)high / TOP_VALUE << ")" << std::endl;
+                DCCL_LOG_IS(DEBUG3, GENERAL) &&
+                    dlog << "(ArithmeticFieldCodec) current interval: [" << (double)low / TOP_VALUE
+                         << "," << (double)high / TOP_VALUE << ")" << std::endl;
             }
 
             // nothing more to do, we're encoding all the data and an EOF
@@ -387,10 +489,9 @@ class ArithmeticFieldCodecBase : public RepeatedTypedFieldCodec<Model::value_typ
 
         if (FieldCodecBase::dccl_field_options().GetExtension(arithmetic).debug_assert())
         {
-            LOCK_LAST_BITS_MAP_MUTEX
             // bit of a hack so I can get at the exact bit field sizes
-            Model::last_bits_map[FieldCodecBase::this_descriptor()->full_name()]
-                                [FieldCodecBase::this_field()->name()] = bits;
+            model_state().last_bits(FieldCodecBase::this_descriptor()->full_name(),
+                                    FieldCodecBase::this_field()->name()) = bits;
         }
 
         return bits;
@@ -399,12 +500,12 @@ class ArithmeticFieldCodecBase : public RepeatedTypedFieldCodec<Model::value_typ
     void bit_plus_follow(Bitset* bits, int* bits_to_follow, bool bit)
     {
         bits->push_back(bit);
-        dccl::dlog.is(dccl::logger::DEBUG3) &&
+        DCCL_LOG_IS(DEBUG3, GENERAL) &&
             dccl::dlog << "(ArithmeticFieldCodec): emitted bit: " << bit << std::endl;
 
         while (*bits_to_follow)
         {
-            dccl::dlog.is(dccl::logger::DEBUG3) &&
+            DCCL_LOG_IS(DEBUG3, GENERAL) &&
                 dccl::dlog << "(ArithmeticFieldCodec): emitted bit (from follow): " << !bit
                            << std::endl;
 
@@ -436,8 +537,9 @@ class ArithmeticFieldCodecBase : public RepeatedTypedFieldCodec<Model::value_typ
                     (static_cast<uint64>((*bits)[bits->size() - (i - bit_stream_offset) - 1]) << i);
         }
 
-        dlog.is(DEBUG3) && dlog << "(ArithmeticFieldCodec): starting value: "
-                                << Bitset(Model::CODE_VALUE_BITS, value).to_string() << std::endl;
+        DCCL_LOG_IS(DEBUG3, GENERAL) &&
+            dlog << "(ArithmeticFieldCodec): starting value: "
+                 << Bitset(Model::CODE_VALUE_BITS, value).to_string() << std::endl;
 
         for (unsigned value_index = 0, n = max_repeat(); value_index < n; ++value_index)
         {
@@ -445,14 +547,15 @@ class ArithmeticFieldCodecBase : public RepeatedTypedFieldCodec<Model::value_typ
 
             Model::symbol_type symbol = bits_to_symbol(bits, value, bit_stream_offset, low, range);
 
-            dlog.is(DEBUG3) && dlog << "(ArithmeticFieldCodec) symbol is: " << symbol << std::endl;
+            DCCL_LOG_IS(DEBUG3, GENERAL) &&
+                dlog << "(ArithmeticFieldCodec) symbol is: " << symbol << std::endl;
 
             std::pair<Model::freq_type, Model::freq_type> c_freq_range =
                 model.symbol_to_cumulative_freq(symbol, Model::DECODER);
 
-            dlog.is(DEBUG3) && dlog << "(ArithmeticFieldCodec) input symbol (" << symbol
-                                    << ") cumulative freq: [" << c_freq_range.first << ","
-                                    << c_freq_range.second << ")" << std::endl;
+            DCCL_LOG_IS(DEBUG3, GENERAL) &&
+                dlog << "(ArithmeticFieldCodec) input symbol (" << symbol << ") cumulative freq: ["
+                     << c_freq_range.first << "," << c_freq_range.second << ")" << std::endl;
 
             high = low + (range * c_freq_range.second) / model.total_freq(Model::DECODER) - 1;
             low += (range * c_freq_range.first) / model.total_freq(Model::DECODER);
@@ -464,8 +567,8 @@ class ArithmeticFieldCodecBase : public RepeatedTypedFieldCodec<Model::value_typ
 
             values.push_back(model.symbol_to_value(symbol));
 
-            dlog.is(DEBUG3) && dlog << "(ArithmeticFieldCodec) value is: " << values.back()
-                                    << std::endl;
+            DCCL_LOG_IS(DEBUG3, GENERAL) &&
+                dlog << "(ArithmeticFieldCodec) value is: " << values.back() << std::endl;
 
             for (;;)
             {
@@ -499,15 +602,16 @@ class ArithmeticFieldCodecBase : public RepeatedTypedFieldCodec<Model::value_typ
         // for debugging / testing
         if (FieldCodecBase::dccl_field_options().GetExtension(arithmetic).debug_assert())
         {
-            LOCK_LAST_BITS_MAP_MUTEX
             // must consume same bits as encoded makes
-            Bitset in = Model::last_bits_map[FieldCodecBase::this_descriptor()->full_name()]
-                                            [FieldCodecBase::this_field()->name()];
+            Bitset in = model_state().last_bits(FieldCodecBase::this_descriptor()->full_name(),
+                                                FieldCodecBase::this_field()->name());
 
-            dlog.is(DEBUG3) && dlog << "(ArithmeticFieldCodec) bits used is (" << bits->size()
-                                    << "):     " << *bits << std::endl;
-            dlog.is(DEBUG3) && dlog << "(ArithmeticFieldCodec) bits original is (" << in.size()
-                                    << "): " << in << std::endl;
+            DCCL_LOG_IS(DEBUG3, GENERAL) &&
+                dlog << "(ArithmeticFieldCodec) bits used is (" << bits->size() << "):     "
+                     << *bits << std::endl;
+            DCCL_LOG_IS(DEBUG3, GENERAL) &&
+                dlog << "(ArithmeticFieldCodec) bits original is (" << in.size() << "): " << in
+                     << std::endl;
 
             assert(in == *bits);
         }
@@ -528,6 +632,10 @@ class ArithmeticFieldCodecBase : public RepeatedTypedFieldCodec<Model::value_typ
         using dccl::log2;
         Model& model = current_model();
 
+        // the total frequency of an adaptive model grows as messages are encoded
+        if (model.user_model().is_adaptive())
+            FieldCodecBase::set_size_uses_state();
+
         // if user doesn't provide out_of_range frequency, set it to max to force this
         // calculation to return the lowest probability symbol in use
         Model::freq_type out_of_range_freq = model.user_model().out_of_range_frequency();
@@ -542,7 +650,7 @@ class ArithmeticFieldCodecBase : public RepeatedTypedFieldCodec<Model::value_typ
         auto size_least_probable = (unsigned)(std::ceil(
             max_repeat() * (log2(model.total_freq(Model::ENCODER)) - log2(lowest_frequency))));
 
-        dccl::dlog.is(dccl::logger::DEBUG3) &&
+        DCCL_LOG_IS(DEBUG3, GENERAL) &&
             dccl::dlog << "(ArithmeticFieldCodec) size_least_probable: " << size_least_probable
                        << std::endl;
 
@@ -554,7 +662,7 @@ class ArithmeticFieldCodecBase : public RepeatedTypedFieldCodec<Model::value_typ
                                        (max_repeat() - 1) * log2(lowest_frequency) - log2(eof_freq))
                            : 0);
 
-        dccl::dlog.is(dccl::logger::DEBUG3) &&
+        DCCL_LOG_IS(DEBUG3, GENERAL) &&
             dccl::dlog << "(ArithmeticFieldCodec) size_least_probable_plus_eof: "
                        << size_least_probable_plus_eof << std::endl;
 
@@ -582,7 +690,7 @@ class ArithmeticFieldCodecBase : public RepeatedTypedFieldCodec<Model::value_typ
                            ? std::ceil(log2(model.total_freq(Model::ENCODER)) - log2(eof_freq))
                            : std::numeric_limits<unsigned>::max());
 
-        dccl::dlog.is(dccl::logger::DEBUG3) &&
+        DCCL_LOG_IS(DEBUG3, GENERAL) &&
             dccl::dlog << "(ArithmeticFieldCodec) size_empty: " << size_empty << std::endl;
 
         // full with most probable symbol
@@ -593,7 +701,7 @@ class ArithmeticFieldCodecBase : public RepeatedTypedFieldCodec<Model::value_typ
         auto size_most_probable = (unsigned)(std::ceil(
             max_repeat() * (log2(model.total_freq(Model::ENCODER)) - log2(highest_frequency))));
 
-        dccl::dlog.is(dccl::logger::DEBUG3) &&
+        DCCL_LOG_IS(DEBUG3, GENERAL) &&
             dccl::dlog << "(ArithmeticFieldCodec) size_most_probable: " << size_most_probable
                        << std::endl;
 
@@ -631,7 +739,7 @@ class ArithmeticFieldCodecBase : public RepeatedTypedFieldCodec<Model::value_typ
                                     ? value + ((static_cast<uint64>(1) << bit_stream_offset) - 1)
                                     : value;
 
-            dccl::dlog.is(dccl::logger::DEBUG3) &&
+            DCCL_LOG_IS(DEBUG3, GENERAL) &&
                 dccl::dlog << "(ArithmeticFieldCodec): value range: ["
                            << Bitset(Model::CODE_VALUE_BITS, value) << ","
                            << Bitset(Model::CODE_VALUE_BITS, value_high) << ")" << std::endl;
@@ -641,7 +749,7 @@ class ArithmeticFieldCodecBase : public RepeatedTypedFieldCodec<Model::value_typ
             Model::freq_type cumulative_freq_high =
                 ((value_high - low + 1) * model.total_freq(Model::DECODER) - 1) / range;
 
-            dccl::dlog.is(dccl::logger::DEBUG3) &&
+            DCCL_LOG_IS(DEBUG3, GENERAL) &&
                 dccl::dlog << "(ArithmeticFieldCodec): c_freq: " << cumulative_freq
                            << ", c_freq_high: " << cumulative_freq_high << std::endl;
 
@@ -649,7 +757,7 @@ class ArithmeticFieldCodecBase : public RepeatedTypedFieldCodec<Model::value_typ
                 model.cumulative_freq_to_symbol(
                     std::make_pair(cumulative_freq, cumulative_freq_high), Model::DECODER);
 
-            dccl::dlog.is(dccl::logger::DEBUG3) &&
+            DCCL_LOG_IS(DEBUG3, GENERAL) &&
                 dccl::dlog << "(ArithmeticFieldCodec): symbol: " << symbol_pair.first << ", "
                            << symbol_pair.second << std::endl;
 
@@ -659,13 +767,13 @@ class ArithmeticFieldCodecBase : public RepeatedTypedFieldCodec<Model::value_typ
             // add another bit to disambiguate
             bits->get_more_bits(1);
 
-            dccl::dlog.is(dccl::logger::DEBUG3) &&
+            DCCL_LOG_IS(DEBUG3, GENERAL) &&
                 dccl::dlog << "(ArithmeticFieldCodec): bits: " << *bits << std::endl;
 
             --bit_stream_offset;
             value |= static_cast<uint64>(bits->back()) << bit_stream_offset;
 
-            dccl::dlog.is(dccl::logger::DEBUG3) &&
+            DCCL_LOG_IS(DEBUG3, GENERAL) &&
                 dccl::dlog << "(ArithmeticFieldCodec): ambiguous (symbol could be "
                            << symbol_pair.first << " or " << symbol_pair.second << ")" << std::endl;
         }
@@ -683,10 +791,11 @@ class ArithmeticFieldCodecBase : public RepeatedTypedFieldCodec<Model::value_typ
     Model& current_model()
     {
         std::string name = FieldCodecBase::dccl_field_options().GetExtension(arithmetic).model();
-        return model_manager().find(name);
+        return model_state().model(model_manager(), name);
     }
 
     ModelManager& model_manager() { return dccl::arith::model_manager(this->manager()); }
+    ModelState& model_state() { return dccl::arith::model_state(this->manager()); }
 };
 
 // constant integer definitions
@@ -0,0 +1,573 @@
+// Copyright 2026:
+//   GobySoft, LLC (2013-)
+//   Community contributors (see AUTHORS file)
+// File authors:
+//   Toby Schneider <toby@gobysoft.org>
+//
+//
+// This file is part of the Dynamic Compact Control Language Library
+// ("DCCL").
+//
+// DCCL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 2.1 of the License, or
+// (at your option) any later version.
+//
+// DCCL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DCCL.  If not, see <http://www.gnu.org/licenses/>.
+#ifndef DCCLFIELDCODECRANGE20261018H
+#define DCCLFIELDCODECRANGE20261018H
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "../static_codec.h"
+#include "field_codec_arithmetic.h"
+
+namespace dccl
+{
+namespace arith
+{
+/// \brief Range coder ("dccl.range") using the same models as ArithmeticFieldCodecBase ((dccl.field).arithmetic.model, set with ModelManager::set_model()).
+///
+/// Rather than emitting (and, on decoding, examining) one bit at a time, the coder keeps a 48 bit window on the code value and shifts out a byte whenever the range falls below 2^40, so each symbol costs one division and a lookup in the model's cumulative frequency table. The decoder reads the encoded bytes ahead of the symbols it has decoded and afterwards returns the bits it read past the end of the field to the BitReader. The encoding ends with the fewest bits that identify the final range, so the encoded size is within a small fraction of a bit per symbol of ArithmeticFieldCodecBase (the encoded bits are not compatible with it).
+template <typename FieldType = Model::value_type>
+class RangeFieldCodecBase : public RepeatedTypedFieldCodec<Model::value_type, FieldType>
+{
+  public:
+    static constexpr int RANGE_BITS = 48;
+    static constexpr int SHIFT_BITS = 8;
+    static constexpr uint64 TOP = static_cast<uint64>(1) << RANGE_BITS;
+    static constexpr uint64 BOTTOM = TOP >> SHIFT_BITS;
+
+    Bitset encode_repeated(const std::vector<Model::value_type>& wire_value) override
+    {
+        Bitset bits;
+        BitWriter writer(&bits);
+        encode_repeated(&writer, wire_value, true);
+        return bits;
+    }
+
+    /// \brief Encode a repeated field directly into writer
+    ///
+    /// \param writer BitWriter, or static_codec::BitCounter to find the encoded size
+    /// \param wire_value Values to encode
+    /// \param update_model Update adaptive models with the encoded symbols
+    template <typename Writer>
+    void encode_repeated(Writer* writer, const std::vector<Model::value_type>& wire_value,
+                         bool update_model)
+    {
+        Model& model = current_model();
+
+        ByteWriter<Writer> bytes(writer);
+        // may reach TOP or above (a carry into the bytes already shifted out)
+        uint64 low = 0;
+        uint64 range = TOP;
+
+        for (unsigned value_index = 0, n = max_repeat(); value_index < n; ++value_index)
+        {
+            Model::symbol_type symbol = Model::EOF_SYMBOL;
+            if (wire_value.size() > value_index)
+                symbol = model.value_to_symbol(wire_value[value_index]);
+
+            // as for ArithmeticFieldCodecBase: out-of-range values with no frequency end the
+            // encoding, and an EOF with no frequency is filled with the most probable symbol
+            if (symbol == Model::OUT_OF_RANGE_SYMBOL &&
+                model.user_model().out_of_range_frequency() == 0)
+                symbol = Model::EOF_SYMBOL;
+
+            if (symbol == Model::EOF_SYMBOL && model.user_model().eof_frequency() == 0)
+                symbol = std::max_element(model.user_model().frequency().begin(),
+                                          model.user_model().frequency().end()) -
+                         model.user_model().frequency().begin();
+
+            std::pair<Model::freq_type, Model::freq_type> c_freq_range =
+                model.symbol_to_cumulative_freq(symbol, Model::ENCODER);
+
+            uint64 r = range / model.total_freq(Model::ENCODER);
+            low += r * c_freq_range.first;
+            range = r * (c_freq_range.second - c_freq_range.first);
+
+            while (range < BOTTOM)
+            {
+                bytes.shift(low);
+                low = (low << SHIFT_BITS) & (TOP - 1);
+                range <<= SHIFT_BITS;
+            }
+
+            if (update_model)
+                model.update_model(symbol, Model::ENCODER);
+
+            // nothing more to do, we're encoding all the data and an EOF (without an EOF, the
+            // remaining values are filled in, as for ArithmeticFieldCodecBase)
+            if (symbol == Model::EOF_SYMBOL)
+                break;
+        }
+
+        // end with the fewest bits for which every continuation lies within [low, low + range)
+        int final_bits = 0;
+        uint64 value = low;
+        for (; final_bits < RANGE_BITS; ++final_bits)
+        {
+            uint64 unit = static_cast<uint64>(1) << (RANGE_BITS - final_bits);
+            value = (low + unit - 1) / unit * unit;
+            if (value + unit - 1 <= low + range - 1)
+                break;
+            value = low;
+        }
+        bytes.finish(value, final_bits);
+
+        DCCL_LOG_IS(DEBUG3, GENERAL) &&
+            dccl::dlog << "(RangeFieldCodec) encoded " << wire_value.size() << " values"
+                       << std::endl;
+    }
+
+    using RepeatedTypedFieldCodec<Model::value_type, FieldType>::encode;
+    void encode(BitWriter* writer) override
+    {
+        encode_repeated(writer, std::vector<Model::value_type>(), true);
+    }
+
+    void encode(BitWriter* writer, const Model::value_type& wire_value) override
+    {
+        encode_repeated(writer, std::vector<Model::value_type>(1, wire_value), true);
+    }
+
+    // Bitset::get_more_bits() cannot give bits back to the parent, so this (unlike
+    // decode_repeated(BitReader*), which dccl::Codec uses) examines the bits one at a time
+    std::vector<Model::value_type> decode_repeated(Bitset* bits) override
+    {
+        Bitset::size_type bits_read = 0;
+        return decode_values([&]() {
+            if (bits_read == bits->size())
+                bits->get_more_bits(1);
+            return static_cast<bool>((*bits)[bits_read++]);
+        });
+    }
+
+    /// \brief Decode a repeated field directly from the encoded bytes, consuming only the bits used
+    std::vector<Model::value_type> decode_repeated(BitReader* reader)
+    {
+        std::vector<Model::value_type> values;
+        Model& model = current_model();
+
+        const std::size_t start = reader->position();
+        // the most recent RANGE_BITS bits read; bits past the end of the message are zeros
+        uint64 window = 0;
+        auto read_byte = [&]() {
+            std::size_t n = std::min<std::size_t>(SHIFT_BITS, reader->remaining());
+            window = ((window << SHIFT_BITS) | reverse(reader->read(n))) & (TOP - 1);
+        };
+        for (int i = 0; i < RANGE_BITS / SHIFT_BITS; ++i) read_byte();
+
+        // the code value less the encoder's low value
+        uint64 code = window;
+        uint64 range = TOP;
+        // bits shifted out of the window
+        std::size_t shifted_bits = 0;
+
+        for (unsigned value_index = 0, n = max_repeat(); value_index < n; ++value_index)
+        {
+            Model::freq_type total = model.total_freq(Model::DECODER);
+            uint64 r = range / total;
+
+            Model::symbol_type symbol = model.cumulative_freq_to_symbol(
+                static_cast<Model::freq_type>(std::min<uint64>(code / r, total - 1)),
+                Model::DECODER);
+
+            std::pair<Model::freq_type, Model::freq_type> c_freq_range =
+                model.symbol_to_cumulative_freq(symbol, Model::DECODER);
+
+            code -= r * c_freq_range.first;
+            range = r * (c_freq_range.second - c_freq_range.first);
+            if (code >= range)
+                throw(Exception("Invalid range coded field: code value outside the range"));
+
+            while (range < BOTTOM)
+            {
+                read_byte();
+                code = (code << SHIFT_BITS) | (window & ((1 << SHIFT_BITS) - 1));
+                range <<= SHIFT_BITS;
+                shifted_bits += SHIFT_BITS;
+            }
+
+            model.update_model(symbol, Model::DECODER);
+
+            if (symbol == Model::EOF_SYMBOL)
+                break;
+
+            values.push_back(model.symbol_to_value(symbol));
+        }
+
+        // the encoding ended with the fewest bits of the window for which every continuation
+        // lies within the final range
+        int final_bits = 0;
+        for (; final_bits < RANGE_BITS; ++final_bits)
+        {
+            uint64 unread = window & ((static_cast<uint64>(1) << (RANGE_BITS - final_bits)) - 1);
+            uint64 unit = static_cast<uint64>(1) << (RANGE_BITS - final_bits);
+            if (code >= unread && code - unread + unit - 1 <= range - 1)
+                break;
+        }
+
+        std::size_t used = shifted_bits + final_bits;
+        std::size_t read = reader->position() - start;
+        if (used > read)
+            throw(Exception("Invalid range coded field: more bits required than encoded"));
+        reader->rewind(read - used);
+
+        return values;
+    }
+
+    using RepeatedTypedFieldCodec<Model::value_type, FieldType>::decode;
+    Model::value_type decode(BitReader* reader) override
+    {
+        std::vector<Model::value_type> values = decode_repeated(reader);
+        if (values.empty())
+            throw dccl::NullValueException();
+        else
+            return values.at(0);
+    }
+
+    unsigned size_repeated(const std::vector<Model::value_type>& wire_values) override
+    {
+        static_codec::BitCounter counter;
+        encode_repeated(&counter, wire_values, false);
+        return counter.size();
+    }
+
+    // bounded by ceil(log_2(1/P)) + 1 where P is the probability of the least probable set of
+    // symbols, reduced by rounding the range to a multiple of the total frequency
+    unsigned max_size_repeated() override
+    {
+        using dccl::log2;
+        const Model& model = current_model();
+        double total = model.total_freq(Model::ENCODER);
+
+        // the total frequency of an adaptive model grows as messages are encoded
+        if (model.user_model().is_adaptive())
+            FieldCodecBase::set_size_uses_state();
+
+        double lowest_frequency = *std::min_element(model.user_model().frequency().begin(),
+                                                    model.user_model().frequency().end());
+        if (model.user_model().out_of_range_frequency() != 0)
+            lowest_frequency = std::min<double>(lowest_frequency,
+                                                model.user_model().out_of_range_frequency());
+
+        // full of least probable symbols
+        double size = max_repeat() * (log2(total) - log2(lowest_frequency));
+
+        // almost full of least probable symbols plus EOF
+        Model::freq_type eof_freq = model.user_model().eof_frequency();
+        if (eof_freq != 0)
+            size = std::max(size, (max_repeat() - 1) * (log2(total) - log2(lowest_frequency)) +
+                                      log2(total) - log2(eof_freq));
+
+        double rounding_loss = -std::log1p(-total / BOTTOM) / std::log(2.0);
+        return static_cast<unsigned>(std::ceil(size + max_repeat() * rounding_loss + 1e-9)) + 1;
+    }
+
+    unsigned min_size_repeated() override
+    {
+        using dccl::log2;
+        const Model& model = current_model();
+
+        if (model.user_model().is_adaptive())
+            return 0; // force examining bits from the beginning on decode
+
+        double total = model.total_freq(Model::ENCODER);
+
+        // full with most probable symbol
+        double highest_frequency = std::max<double>(
+            model.user_model().out_of_range_frequency(),
+            *std::max_element(model.user_model().frequency().begin(),
+                              model.user_model().frequency().end()));
+        double size = max_repeat() * (log2(total) - log2(highest_frequency));
+
+        // just EOF
+        Model::freq_type eof_freq = model.user_model().eof_frequency();
+        if (eof_freq != 0)
+            size = std::min(size, log2(total) - log2(eof_freq));
+
+        return static_cast<unsigned>(std::max(0.0, std::ceil(size - 1e-9)));
+    }
+
+    void validate() override
+    {
+        FieldCodecBase::require(FieldCodecBase::dccl_field_options().HasExtension(arithmetic),
+                                "missing (dccl.field).arithmetic");
+
+        std::string model_name =
+            FieldCodecBase::dccl_field_options().GetExtension(arithmetic).model();
+        try
+        {
+            model_manager().find(model_name);
+        }
+        catch (Exception& e)
+        {
+            FieldCodecBase::require(false, "no such (dccl.field).arithmetic.model called \"" +
+                                               model_name + "\" loaded.");
+        }
+    }
+
+    // end inherited methods
+
+    dccl::int32 max_repeat()
+    {
+        return FieldCodecBase::this_field()->is_repeated()
+                   ? FieldCodecBase::dccl_field_options().max_repeat()
+                   : 1;
+    }
+
+    Model& current_model()
+    {
+        std::string name = FieldCodecBase::dccl_field_options().GetExtension(arithmetic).model();
+        return model_state().model(model_manager(), name);
+    }
+
+    ModelManager& model_manager() { return dccl::arith::model_manager(this->manager()); }
+    ModelState& model_state() { return dccl::arith::model_state(this->manager()); }
+
+  private:
+    void any_encode_repeated(BitWriter* writer, const std::vector<dccl::any>& wire_values) override
+    {
+        std::vector<Model::value_type> values;
+        try
+        {
+            for (const auto& wire_value : wire_values)
+                values.push_back(dccl::any_cast<Model::value_type>(wire_value));
+        }
+        catch (dccl::bad_any_cast&)
+        {
+            throw(type_error("encode_repeated", typeid(Model::value_type),
+                             wire_values.at(0).type()));
+        }
+        encode_repeated(writer, values, true);
+    }
+
+    void any_decode_repeated(BitReader* reader, std::vector<dccl::any>* wire_values) override
+    {
+        std::vector<Model::value_type> values = decode_repeated(reader);
+        wire_values->assign(values.begin(), values.end());
+    }
+
+    // read_bit() returns the next bit of the encoded field
+    template <typename ReadBit> std::vector<Model::value_type> decode_values(ReadBit read_bit)
+    {
+        std::vector<Model::value_type> values;
+        Model& model = current_model();
+
+        // the code value less the encoder's low value, with the unknown (unread) bits at the
+        // bottom of the window taken as zeros
+        std::int64_t code = 0;
+        int unknown_bits = RANGE_BITS;
+        uint64 range = TOP;
+
+        auto next_bit = [&]() {
+            if (unknown_bits == 0)
+                throw(Exception("Invalid range coded field: more bits required than encoded"));
+            --unknown_bits;
+            if (read_bit())
+                code += static_cast<std::int64_t>(1) << unknown_bits;
+        };
+
+        for (unsigned value_index = 0, n = max_repeat(); value_index < n; ++value_index)
+        {
+            Model::freq_type total = model.total_freq(Model::DECODER);
+            uint64 r = range / total;
+
+            // read only as many bits as needed to tell which symbol the code value is in
+            Model::symbol_type symbol;
+            for (;;)
+            {
+                std::int64_t code_high = code + ((static_cast<std::int64_t>(1) << unknown_bits) - 1);
+                Model::freq_type c_freq =
+                    (code <= 0) ? 0 : std::min<uint64>(code / r, total - 1);
+                Model::freq_type c_freq_high =
+                    (code_high <= 0) ? 0 : std::min<uint64>(code_high / r, total - 1);
+
+                std::pair<Model::symbol_type, Model::symbol_type> symbol_pair =
+                    model.cumulative_freq_to_symbol(std::make_pair(c_freq, c_freq_high),
+                                                    Model::DECODER);
+                if (symbol_pair.first == symbol_pair.second)
+                {
+                    symbol = symbol_pair.first;
+                    break;
+                }
+
+                // the code value is in the first symbol's range unless it turns out to be at or
+                // above the end of that range, so only compare with that until we know which
+                std::int64_t first_end = r * model.symbol_to_cumulative_freq(
+                                                 symbol_pair.first, Model::DECODER)
+                                                 .second;
+                do
+                {
+                    next_bit();
+                    code_high = code + ((static_cast<std::int64_t>(1) << unknown_bits) - 1);
+                } while (code < first_end && code_high >= first_end);
+
+                if (code_high < first_end)
+                {
+                    symbol = symbol_pair.first;
+                    break;
+                }
+            }
+
+            std::pair<Model::freq_type, Model::freq_type> c_freq_range =
+                model.symbol_to_cumulative_freq(symbol, Model::DECODER);
+
+            code -= static_cast<std::int64_t>(r * c_freq_range.first);
+            range = r * (c_freq_range.second - c_freq_range.first);
+
+            while (range < BOTTOM)
+            {
+                code *= (1 << SHIFT_BITS);
+                unknown_bits += SHIFT_BITS;
+                range <<= SHIFT_BITS;
+            }
+
+            // bits shifted out of the window were always written by the encoder
+            while (unknown_bits > RANGE_BITS) next_bit();
+
+            model.update_model(symbol, Model::DECODER);
+
+            if (symbol == Model::EOF_SYMBOL)
+                break;
+
+            values.push_back(model.symbol_to_value(symbol));
+        }
+
+        // consume the bits that ended the encoding
+        while (code < 0 || code + ((static_cast<std::int64_t>(1) << unknown_bits) - 1) >
+                               static_cast<std::int64_t>(range - 1))
+            next_bit();
+
+        return values;
+    }
+
+    // the code is written most significant bit first (so that the decoder of the Bitset can
+    // read only as many bits as it needs), so each byte is written with its bits reversed
+    static std::uint8_t reverse(std::uint64_t byte)
+    {
+        static const std::array<std::uint8_t, 256> reversed = []() {
+            std::array<std::uint8_t, 256> table;
+            for (int i = 0; i < 256; ++i)
+            {
+                table[i] = 0;
+                for (int bit = 0; bit < 8; ++bit)
+                    if (i & (1 << bit))
+                        table[i] |= 1 << (7 - bit);
+            }
+            return table;
+        }();
+        return reversed[byte & 0xff];
+    }
+
+    // writes the bytes shifted out of the encoder's window, holding back the last one (and any
+    // 0xff bytes after it) until it is known whether a carry propagates into them
+    template <typename Writer> class ByteWriter
+    {
+      public:
+        explicit ByteWriter(Writer* writer) : writer_(writer) {}
+
+        // shift out the top byte of the window, where (low >> RANGE_BITS) is the carry
+        void shift(uint64 low)
+        {
+            unsigned carry = low >> RANGE_BITS;
+            unsigned byte = (low >> (RANGE_BITS - SHIFT_BITS)) & 0xff;
+            if (byte == 0xff && !carry)
+            {
+                ++pending_ff_;
+            }
+            else
+            {
+                flush(carry);
+                cache_ = byte;
+                has_cache_ = true;
+            }
+        }
+
+        // write the held back bytes and the top num_bits of value
+        void finish(uint64 value, int num_bits)
+        {
+            flush(value >> RANGE_BITS);
+            for (int i = 0; i < num_bits; i += SHIFT_BITS)
+            {
+                int n = std::min(SHIFT_BITS, num_bits - i);
+                std::uint8_t byte = reverse(value >> (RANGE_BITS - SHIFT_BITS - i));
+                writer_->append(byte & ((1u << n) - 1), n);
+            }
+        }
+
+      private:
+        void flush(unsigned carry)
+        {
+            if (has_cache_)
+                writer_->append(reverse(cache_ + carry), SHIFT_BITS);
+            for (; pending_ff_ > 0; --pending_ff_)
+                writer_->append(reverse(0xff + carry), SHIFT_BITS);
+            has_cache_ = false;
+        }
+
+      private:
+        Writer* writer_;
+        bool has_cache_{false};
+        unsigned cache_{0};
+        unsigned pending_ff_{0};
+    };
+};
+
+template <typename FieldType> const int RangeFieldCodecBase<FieldType>::RANGE_BITS;
+template <typename FieldType> const int RangeFieldCodecBase<FieldType>::SHIFT_BITS;
+template <typename FieldType> const uint64 RangeFieldCodecBase<FieldType>::TOP;
+template <typename FieldType> const uint64 RangeFieldCodecBase<FieldType>::BOTTOM;
+
+template <typename FieldType> class RangeFieldCodec : public RangeFieldCodecBase<FieldType>
+{
+    Model::value_type pre_encode(const FieldType& field_value) override
+    {
+        return static_cast<Model::value_type>(field_value);
+    }
+
+    FieldType post_decode(const Model::value_type& wire_value) override
+    {
+        return static_cast<FieldType>(wire_value);
+    }
+};
+
+template <>
+class RangeFieldCodec<const google::protobuf::EnumValueDescriptor*>
+    : public RangeFieldCodecBase<const google::protobuf::EnumValueDescriptor*>
+{
+  public:
+    Model::value_type
+    pre_encode(const google::protobuf::EnumValueDescriptor* const& field_value) override
+    {
+        return field_value->number();
+    }
+
+    const google::protobuf::EnumValueDescriptor*
+    post_decode(const Model::value_type& wire_value) override
+    {
+        const google::protobuf::EnumDescriptor* e = FieldCodecBase::this_field()->enum_type();
+        const google::protobuf::EnumValueDescriptor* return_value =
+            e->FindValueByNumber((int)wire_value);
+
+        if (return_value)
+            return return_value;
+        else
+            throw NullValueException();
+    }
+};
+
+} // namespace arith
+} // namespace dccl
+
+#endif
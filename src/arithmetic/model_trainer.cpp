@@ -0,0 +1,284 @@
+// Copyright 2026:
+//   GobySoft, LLC (2013-)
+//   Community contributors (see AUTHORS file)
+// File authors:
+//   Toby Schneider <toby@gobysoft.org>
+//
+//
+// This file is part of the Dynamic Compact Control Language Library
+// ("DCCL").
+//
+// DCCL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 2.1 of the License, or
+// (at your option) any later version.
+//
+// DCCL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DCCL.  If not, see <http://www.gnu.org/licenses/>.
+#include <cmath>
+
+#include "../codec.h"
+#include "model_trainer.h"
+
+namespace
+{
+dccl::arith::Model::value_type field_value(const google::protobuf::Message& msg,
+                                           const google::protobuf::FieldDescriptor* field_desc,
+                                           int index)
+{
+    const google::protobuf::Reflection* refl = msg.GetReflection();
+    bool repeated = field_desc->is_repeated();
+    switch (field_desc->cpp_type())
+    {
+        case google::protobuf::FieldDescriptor::CPPTYPE_DOUBLE:
+            return repeated ? refl->GetRepeatedDouble(msg, field_desc, index)
+                            : refl->GetDouble(msg, field_desc);
+        case google::protobuf::FieldDescriptor::CPPTYPE_FLOAT:
+            return repeated ? refl->GetRepeatedFloat(msg, field_desc, index)
+                            : refl->GetFloat(msg, field_desc);
+        case google::protobuf::FieldDescriptor::CPPTYPE_INT32:
+            return repeated ? refl->GetRepeatedInt32(msg, field_desc, index)
+                            : refl->GetInt32(msg, field_desc);
+        case google::protobuf::FieldDescriptor::CPPTYPE_INT64:
+            return repeated ? refl->GetRepeatedInt64(msg, field_desc, index)
+                            : refl->GetInt64(msg, field_desc);
+        case google::protobuf::FieldDescriptor::CPPTYPE_UINT32:
+            return repeated ? refl->GetRepeatedUInt32(msg, field_desc, index)
+                            : refl->GetUInt32(msg, field_desc);
+        case google::protobuf::FieldDescriptor::CPPTYPE_UINT64:
+            return repeated ? refl->GetRepeatedUInt64(msg, field_desc, index)
+                            : refl->GetUInt64(msg, field_desc);
+        case google::protobuf::FieldDescriptor::CPPTYPE_BOOL:
+            return repeated ? refl->GetRepeatedBool(msg, field_desc, index)
+                            : refl->GetBool(msg, field_desc);
+        case google::protobuf::FieldDescriptor::CPPTYPE_ENUM:
+            return repeated ? refl->GetRepeatedEnum(msg, field_desc, index)->number()
+                            : refl->GetEnum(msg, field_desc)->number();
+        default:
+            throw(dccl::Exception("Field " + field_desc->full_name() +
+                                  " has a type that cannot be arithmetic coded"));
+    }
+}
+} // namespace
+
+void dccl::arith::ModelTrainer::add(const google::protobuf::Message& msg)
+{
+    add_message(msg);
+    ++message_count_;
+}
+
+void dccl::arith::ModelTrainer::add_message(const google::protobuf::Message& msg)
+{
+    const google::protobuf::Descriptor* desc = msg.GetDescriptor();
+    const google::protobuf::Reflection* refl = msg.GetReflection();
+
+    for (int i = 0, n = desc->field_count(); i < n; ++i)
+    {
+        const google::protobuf::FieldDescriptor* field_desc = desc->field(i);
+        const dccl::DCCLFieldOptions& dccl_field_options =
+            field_desc->options().GetExtension(dccl::field);
+
+        if (dccl_field_options.omit())
+            continue;
+
+        if (dccl_field_options.HasExtension(arithmetic))
+        {
+            FieldValues field;
+            field.max_repeat = field_desc->is_repeated() ? dccl_field_options.max_repeat() : 1;
+            field.coder = dccl_field_options.codec() == "dccl.range" ? Coder::RANGE
+                                                                    : Coder::ARITHMETIC;
+            if (field_desc->is_repeated())
+            {
+                for (int j = 0, m = refl->FieldSize(msg, field_desc); j < m; ++j)
+                    field.values.push_back(field_value(msg, field_desc, j));
+            }
+            else if (refl->HasField(msg, field_desc))
+            {
+                field.values.push_back(field_value(msg, field_desc, -1));
+            }
+            corpus_[dccl_field_options.GetExtension(arithmetic).model()].push_back(field);
+        }
+        else if (field_desc->cpp_type() == google::protobuf::FieldDescriptor::CPPTYPE_MESSAGE)
+        {
+            if (field_desc->is_repeated())
+            {
+                for (int j = 0, m = refl->FieldSize(msg, field_desc); j < m; ++j)
+                    add_message(refl->GetRepeatedMessage(msg, field_desc, j));
+            }
+            else if (refl->HasField(msg, field_desc))
+            {
+                add_message(refl->GetMessage(msg, field_desc));
+            }
+        }
+    }
+}
+
+std::vector<std::string> dccl::arith::ModelTrainer::model_names() const
+{
+    std::vector<std::string> names;
+    for (const auto& model_values : corpus_) names.push_back(model_values.first);
+    return names;
+}
+
+const dccl::arith::protobuf::ArithmeticModel&
+dccl::arith::ModelTrainer::current_model(const std::string& name) const
+{
+    return model_manager(codec_.manager()).find(name).user_model();
+}
+
+dccl::arith::protobuf::ArithmeticModel
+dccl::arith::ModelTrainer::train(const std::string& name,
+                                 Model::freq_type max_total_frequency) const
+{
+    auto it = corpus_.find(name);
+    if (it == corpus_.end())
+        throw(Exception("No values were added for model: " + name));
+
+    if (max_total_frequency > Model::MAX_FREQUENCY)
+        throw(Exception("Total frequency must not exceed " +
+                        std::to_string(Model::MAX_FREQUENCY)));
+
+    const protobuf::ArithmeticModel& current = current_model(name);
+    Model model = make_model(current);
+
+    // indexed by symbol - Model::MIN_SYMBOL
+    std::vector<uint64> counts(model.max_symbol() + 1 - Model::MIN_SYMBOL, 0);
+    for (const FieldValues& field : it->second)
+    {
+        for (Model::symbol_type symbol :
+             symbols(model, field.values, field.max_repeat, field.coder))
+            ++counts[symbol - Model::MIN_SYMBOL];
+    }
+
+    // a zero EOF or out-of-range frequency changes how the codec encodes, so keep it; every
+    // other symbol must remain encodable
+    auto enabled = [&current](Model::symbol_type symbol)
+    {
+        if (symbol == Model::EOF_SYMBOL)
+            return current.eof_frequency() != 0;
+        else if (symbol == Model::OUT_OF_RANGE_SYMBOL)
+            return current.out_of_range_frequency() != 0;
+        else
+            return true;
+    };
+
+    uint64 total = 0;
+    uint64 num_enabled = 0;
+    for (Model::symbol_type symbol = Model::MIN_SYMBOL; symbol <= model.max_symbol(); ++symbol)
+    {
+        uint64& count = counts[symbol - Model::MIN_SYMBOL];
+        if (enabled(symbol))
+        {
+            count = std::max<uint64>(count, 1);
+            ++num_enabled;
+        }
+        else
+        {
+            count = 0;
+        }
+        total += count;
+    }
+
+    if (num_enabled > max_total_frequency)
+        throw(Exception("Total frequency " + std::to_string(max_total_frequency) +
+                        " is too small for the " + std::to_string(num_enabled) +
+                        " symbols of model: " + name));
+
+    if (total > max_total_frequency)
+    {
+        // scale the counts above the minimum of one
+        double scale = static_cast<double>(max_total_frequency - num_enabled) /
+                       static_cast<double>(total - num_enabled);
+        total = 0;
+        for (uint64& count : counts)
+        {
+            if (count > 0)
+                count = 1 + static_cast<uint64>(std::floor((count - 1) * scale));
+            total += count;
+        }
+
+        // in case of floating point rounding
+        while (total > max_total_frequency)
+        {
+            --(*std::max_element(counts.begin(), counts.end()));
+            --total;
+        }
+    }
+
+    protobuf::ArithmeticModel trained = current;
+    trained.clear_frequency();
+    for (Model::symbol_type symbol = 0; symbol <= model.max_symbol(); ++symbol)
+        trained.add_frequency(counts[symbol - Model::MIN_SYMBOL]);
+    trained.set_eof_frequency(counts[Model::EOF_SYMBOL - Model::MIN_SYMBOL]);
+    trained.set_out_of_range_frequency(counts[Model::OUT_OF_RANGE_SYMBOL - Model::MIN_SYMBOL]);
+    return trained;
+}
+
+double dccl::arith::ModelTrainer::bits(const std::string& name,
+                                       const protobuf::ArithmeticModel& user_model) const
+{
+    auto it = corpus_.find(name);
+    if (it == corpus_.end())
+        return 0;
+
+    Model model = make_model(user_model);
+    double bits = 0;
+    for (const FieldValues& field : it->second)
+    {
+        for (Model::symbol_type symbol :
+             symbols(model, field.values, field.max_repeat, field.coder))
+        {
+            std::pair<Model::freq_type, Model::freq_type> c_freq_range =
+                model.symbol_to_cumulative_freq(symbol, Model::ENCODER);
+            bits -= std::log2(static_cast<double>(c_freq_range.second - c_freq_range.first) /
+                              model.total_freq(Model::ENCODER));
+            model.update_model(symbol, Model::ENCODER);
+        }
+    }
+    return bits;
+}
+
+std::vector<dccl::arith::Model::symbol_type>
+dccl::arith::ModelTrainer::symbols(const Model& model, const std::vector<Model::value_type>& values,
+                                   int max_repeat, Coder coder)
+{
+    std::vector<Model::symbol_type> symbols;
+    for (unsigned value_index = 0, n = max_repeat; value_index < n; ++value_index)
+    {
+        Model::symbol_type symbol = Model::EOF_SYMBOL;
+        if (values.size() > value_index)
+        {
+            symbol = model.value_to_symbol(values[value_index]);
+            if (symbol > model.max_symbol())
+                symbol = Model::OUT_OF_RANGE_SYMBOL;
+        }
+
+        if (symbol == Model::OUT_OF_RANGE_SYMBOL &&
+            model.user_model().out_of_range_frequency() == 0)
+            symbol = Model::EOF_SYMBOL;
+
+        if (symbol == Model::EOF_SYMBOL && model.user_model().eof_frequency() == 0)
+            symbol = std::max_element(model.user_model().frequency().begin(),
+                                      model.user_model().frequency().end()) -
+                     model.user_model().frequency().begin();
+
+        symbols.push_back(symbol);
+
+        if (coder == Coder::RANGE ? symbol == Model::EOF_SYMBOL : value_index == values.size())
+            break;
+    }
+    return symbols;
+}
+
+dccl::arith::Model
+dccl::arith::ModelTrainer::make_model(const protobuf::ArithmeticModel& user_model)
+{
+    Model model(user_model);
+    ModelManager()._create_and_validate_model(&model);
+    return model;
+}
@@ -0,0 +1,108 @@
+// Copyright 2026:
+//   GobySoft, LLC (2013-)
+//   Community contributors (see AUTHORS file)
+// File authors:
+//   Toby Schneider <toby@gobysoft.org>
+//
+//
+// This file is part of the Dynamic Compact Control Language Library
+// ("DCCL").
+//
+// DCCL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 2.1 of the License, or
+// (at your option) any later version.
+//
+// DCCL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DCCL.  If not, see <http://www.gnu.org/licenses/>.
+#ifndef DCCLARITHMETICMODELTRAINER20261018H
+#define DCCLARITHMETICMODELTRAINER20261018H
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "field_codec_arithmetic.h"
+
+namespace dccl
+{
+class Codec;
+
+namespace arith
+{
+/// \brief Estimates the frequencies of arithmetic models (ArithmeticModel) from a corpus of messages.
+///
+/// The values of every field with (dccl.field).(arithmetic).model set (dccl.arithmetic and dccl.range codecs), including those in embedded messages, are collected for each model. train() then replaces the model's frequencies with the observed symbol counts (keeping `value_bound`, `is_adaptive` and a zero `eof_frequency` or `out_of_range_frequency` as they were), and bits() gives the information content of the corpus under a given model, so that the existing and trained models can be compared.
+class ModelTrainer
+{
+  public:
+    /// \brief Trainer for the models already given to codec with ModelManager::set_model()
+    explicit ModelTrainer(dccl::Codec& codec) : codec_(codec) {}
+
+    /// \brief Add the values of msg's arithmetic coded fields to the corpus
+    void add(const google::protobuf::Message& msg);
+
+    /// \brief Number of messages added
+    int message_count() const { return message_count_; }
+
+    /// \brief Names of the models used by the messages added
+    std::vector<std::string> model_names() const;
+
+    /// \brief The model in codec given to set_model() (before any adaptation)
+    const protobuf::ArithmeticModel& current_model(const std::string& name) const;
+
+    /// \brief Model with the frequencies observed in the corpus
+    ///
+    /// Symbols that were never observed are given a frequency of one so that they remain encodable. If the sum of the frequencies would exceed max_total_frequency, the observed counts are scaled down to fit.
+    /// \throw Exception if the model was not used by any message added, or max_total_frequency is smaller than the number of symbols
+    protobuf::ArithmeticModel
+    train(const std::string& name,
+          Model::freq_type max_total_frequency = Model::MAX_FREQUENCY) const;
+
+    /// \brief Total information content (in bits) of the values in the corpus that use the model called name, if they were encoded (in order) with model
+    ///
+    /// This excludes the (at most two) bits per field needed to terminate the arithmetic code.
+    double bits(const std::string& name, const protobuf::ArithmeticModel& model) const;
+
+  private:
+    void add_message(const google::protobuf::Message& msg);
+
+    // how the codec ends the symbols of a field
+    enum class Coder
+    {
+        // ArithmeticFieldCodecBase: after the symbol following the last value
+        ARITHMETIC,
+        // RangeFieldCodecBase: at the first EOF (including an out-of-range value without a
+        // frequency), otherwise after max_repeat symbols
+        RANGE
+    };
+
+    // symbols encoded for one field's values, as in the encode_repeated() of the coder
+    static std::vector<Model::symbol_type> symbols(const Model& model,
+                                                   const std::vector<Model::value_type>& values,
+                                                   int max_repeat, Coder coder);
+
+    static Model make_model(const protobuf::ArithmeticModel& user_model);
+
+  private:
+    dccl::Codec& codec_;
+    int message_count_{0};
+
+    struct FieldValues
+    {
+        int max_repeat;
+        Coder coder;
+        std::vector<Model::value_type> values;
+    };
+    // model name -> values of each field (in the order added)
+    std::map<std::string, std::vector<FieldValues>> corpus_;
+};
+} // namespace arith
+} // namespace dccl
+
+#endif
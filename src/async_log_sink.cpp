@@ -0,0 +1,182 @@
+// Copyright 2026:
+//   GobySoft, LLC (2013-)
+//   Community contributors (see AUTHORS file)
+// File authors:
+//   Toby Schneider <toby@gobysoft.org>
+//
+//
+// This file is part of the Dynamic Compact Control Language Library
+// ("DCCL").
+//
+// DCCL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 2.1 of the License, or
+// (at your option) any later version.
+//
+// DCCL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DCCL.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <chrono>
+
+#include "async_log_sink.h"
+
+dccl::AsyncLogSink::AsyncLogSink(Slot slot, std::size_t capacity /* = 8192 */,
+                                 Overflow overflow /* = Overflow::DROP */)
+    : slot_(std::move(slot)), overflow_(overflow)
+{
+    std::size_t size = 2;
+    while (size < capacity) size <<= 1;
+    mask_ = size - 1;
+
+    cells_.reset(new Cell[size]);
+    for (std::size_t i = 0; i < size; ++i)
+        cells_[i].sequence.store(i, std::memory_order_relaxed);
+
+    thread_ = std::thread([this]() { run(); });
+}
+
+dccl::AsyncLogSink::AsyncLogSink(std::ostream* os, bool add_timestamp /* = true */,
+                                 std::size_t capacity /* = 8192 */,
+                                 Overflow overflow /* = Overflow::DROP */)
+    : AsyncLogSink(std::bind(to_ostream, std::placeholders::_1, std::placeholders::_2,
+                             std::placeholders::_3, os, add_timestamp),
+                   capacity, overflow)
+{
+}
+
+dccl::AsyncLogSink::~AsyncLogSink()
+{
+    {
+        std::lock_guard<std::mutex> lock(wake_mutex_);
+        stop_ = true;
+    }
+    wake_.notify_one();
+    thread_.join();
+}
+
+void dccl::AsyncLogSink::operator()(const std::string& msg, logger::Verbosity vrb,
+                                    logger::Group grp)
+{
+    while (!try_push(msg, vrb, grp))
+    {
+        if (overflow_ == Overflow::DROP)
+        {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        std::this_thread::yield();
+    }
+
+    // pairs with the fence in run(), so that either this thread sees idle_ or the background
+    // thread sees the new message
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (idle_.load(std::memory_order_relaxed))
+    {
+        std::lock_guard<std::mutex> lock(wake_mutex_);
+        wake_.notify_one();
+    }
+}
+
+void dccl::AsyncLogSink::flush()
+{
+    const std::size_t queued = enqueue_pos_.load(std::memory_order_acquire);
+    while (processed_.load(std::memory_order_acquire) < queued)
+    {
+        {
+            std::lock_guard<std::mutex> lock(wake_mutex_);
+            wake_.notify_one();
+        }
+        std::this_thread::yield();
+    }
+}
+
+bool dccl::AsyncLogSink::try_push(const std::string& msg, logger::Verbosity vrb,
+                                  logger::Group grp)
+{
+    std::size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+    for (;;)
+    {
+        Cell& cell = cells_[pos & mask_];
+        std::size_t sequence = cell.sequence.load(std::memory_order_acquire);
+        auto diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos);
+        if (diff == 0)
+        {
+            // claim this position
+            if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+            {
+                cell.record.msg = msg;
+                cell.record.vrb = vrb;
+                cell.record.grp = grp;
+                cell.sequence.store(pos + 1, std::memory_order_release);
+                return true;
+            }
+        }
+        else if (diff < 0)
+        {
+            // full
+            return false;
+        }
+        else
+        {
+            // another producer claimed this position
+            pos = enqueue_pos_.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+bool dccl::AsyncLogSink::ready() const
+{
+    return cells_[dequeue_pos_ & mask_].sequence.load(std::memory_order_acquire) ==
+           dequeue_pos_ + 1;
+}
+
+bool dccl::AsyncLogSink::try_pop(Record* record)
+{
+    if (!ready())
+        return false;
+
+    Cell& cell = cells_[dequeue_pos_ & mask_];
+    std::swap(*record, cell.record);
+    // ready to be written again, one lap later
+    cell.sequence.store(dequeue_pos_ + mask_ + 1, std::memory_order_release);
+    ++dequeue_pos_;
+    return true;
+}
+
+void dccl::AsyncLogSink::run()
+{
+    Record record;
+    for (;;)
+    {
+        while (try_pop(&record))
+        {
+            slot_(record.msg, record.vrb, record.grp);
+            processed_.fetch_add(1, std::memory_order_release);
+        }
+
+        std::unique_lock<std::mutex> lock(wake_mutex_);
+        if (stop_)
+        {
+            lock.unlock();
+            // messages queued while stopping
+            while (try_pop(&record))
+            {
+                slot_(record.msg, record.vrb, record.grp);
+                processed_.fetch_add(1, std::memory_order_release);
+            }
+            return;
+        }
+
+        idle_.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        // check again for a message pushed before idle_ was set
+        if (!ready())
+            wake_.wait_for(lock, std::chrono::milliseconds(100));
+        idle_.store(false, std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,144 @@
+// Copyright 2026:
+//   GobySoft, LLC (2013-)
+//   Community contributors (see AUTHORS file)
+// File authors:
+//   Toby Schneider <toby@gobysoft.org>
+//
+//
+// This file is part of the Dynamic Compact Control Language Library
+// ("DCCL").
+//
+// DCCL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 2.1 of the License, or
+// (at your option) any later version.
+//
+// DCCL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DCCL.  If not, see <http://www.gnu.org/licenses/>.
+#ifndef DCCLASYNCLOGSINK20261018H
+#define DCCLASYNCLOGSINK20261018H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "logger.h"
+
+namespace dccl
+{
+/// \brief A dccl::dlog slot that queues log messages and passes them to another slot (e.g. one writing to std::cerr) on a background thread, so that the threads logging do not wait on the output.
+///
+/// The messages are queued in a fixed size lock-free ring buffer. When the ring buffer is full, new messages are either dropped (and counted, see dropped()) or the logging thread waits for space, depending on the Overflow setting. The typical usage is
+/// \code
+/// dccl::AsyncLogSink sink(&std::cerr);
+/// dccl::dlog.connect(dccl::logger::DEBUG2_PLUS, sink.slot());
+/// // ...
+/// dccl::dlog.disconnect(dccl::logger::ALL);
+/// \endcode
+/// The sink must be disconnected from dccl::dlog before it is destroyed. Remaining messages are written when the sink is destroyed.
+class AsyncLogSink
+{
+  public:
+    using Slot = std::function<void(const std::string& msg, logger::Verbosity vrb,
+                                    logger::Group grp)>;
+
+    /// \brief Behavior when the ring buffer is full
+    enum class Overflow
+    {
+        DROP, ///< discard the new message, and increment dropped()
+        BLOCK ///< wait until the background thread makes space for the new message
+    };
+
+    /// \brief Pass messages to the given slot (called only on the background thread)
+    ///
+    /// \param slot Function pointer or like object of type (void*) (const std::string& msg, logger::Verbosity vrb, logger::Group grp)
+    /// \param capacity Number of messages that can be queued (rounded up to a power of two)
+    /// \param overflow Behavior when capacity messages are already queued
+    explicit AsyncLogSink(Slot slot, std::size_t capacity = 8192,
+                          Overflow overflow = Overflow::DROP);
+
+    /// \brief Write messages to a std::ostream (in the same format as dccl::Logger::connect(int, std::ostream*, bool))
+    explicit AsyncLogSink(std::ostream* os, bool add_timestamp = true, std::size_t capacity = 8192,
+                          Overflow overflow = Overflow::DROP);
+
+    ~AsyncLogSink();
+
+    AsyncLogSink(const AsyncLogSink&) = delete;
+    AsyncLogSink& operator=(const AsyncLogSink&) = delete;
+
+    /// \brief Queue a message (may be called from any thread)
+    void operator()(const std::string& msg, logger::Verbosity vrb, logger::Group grp);
+
+    /// \brief Slot that queues messages on this sink, for use with dccl::Logger::connect()
+    Slot slot()
+    {
+        return [this](const std::string& msg, logger::Verbosity vrb, logger::Group grp)
+        { (*this)(msg, vrb, grp); };
+    }
+
+    /// \brief Wait until all the messages queued so far have been passed to the slot
+    void flush();
+
+    /// \brief Number of messages dropped so far because the ring buffer was full (with Overflow::DROP)
+    std::uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+    /// \brief Maximum number of queued messages
+    std::size_t capacity() const { return mask_ + 1; }
+
+  private:
+    struct Record
+    {
+        std::string msg;
+        logger::Verbosity vrb{logger::UNKNOWN};
+        logger::Group grp{logger::GENERAL};
+    };
+
+    // one element of the ring buffer: sequence indicates whether the cell is ready to be
+    // written (== position) or read (== position + 1) for the position in the queue that maps to it
+    struct Cell
+    {
+        std::atomic<std::size_t> sequence;
+        Record record;
+    };
+
+    bool try_push(const std::string& msg, logger::Verbosity vrb, logger::Group grp);
+    // next message is ready to be read (background thread only)
+    bool ready() const;
+    bool try_pop(Record* record);
+    void run();
+
+  private:
+    Slot slot_;
+    Overflow overflow_;
+
+    std::size_t mask_;
+    std::unique_ptr<Cell[]> cells_;
+    // next position to write (shared by the producers)
+    std::atomic<std::size_t> enqueue_pos_{0};
+    // next position to read (background thread only)
+    std::size_t dequeue_pos_{0};
+    // number of messages passed to slot_
+    std::atomic<std::size_t> processed_{0};
+    std::atomic<std::uint64_t> dropped_{0};
+
+    // used to wake the background thread when it is idle
+    std::mutex wake_mutex_;
+    std::condition_variable wake_;
+    std::atomic<bool> idle_{false};
+    std::atomic<bool> stop_{false};
+
+    std::thread thread_;
+};
+} // namespace dccl
+
+#endif
@@ -0,0 +1,185 @@
+// Copyright 2026:
+//   GobySoft, LLC (2013-)
+//   Community contributors (see AUTHORS file)
+// File authors:
+//   Toby Schneider <toby@gobysoft.org>
+//
+//
+// This file is part of the Dynamic Compact Control Language Library
+// ("DCCL").
+//
+// DCCL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 2.1 of the License, or
+// (at your option) any later version.
+//
+// DCCL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DCCL.  If not, see <http://www.gnu.org/licenses/>.
+#ifndef DCCLBITREADER20261018H
+#define DCCLBITREADER20261018H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "bitset.h"
+#include "exception.h"
+
+namespace dccl
+{
+/// \brief Reads bits directly from an encoded message held in a byte buffer, without first converting it to a Bitset.
+///
+/// Bits are read in the same order that BitWriter writes them (and Bitset::from_byte_string() stores them), i.e. starting from the least significant bit of the first byte. The reader does not copy or own the buffer, which must remain valid for the lifetime of the reader.
+class BitReader
+{
+  public:
+    /// \brief Read from a buffer
+    ///
+    /// \param data Start of the buffer
+    /// \param len Length of data (bytes)
+    BitReader(const std::uint8_t* data, std::size_t len) : data_(data), len_(len), size_(len * 8)
+    {
+    }
+
+    /// \brief Read and consume the next num_bits
+    ///
+    /// \param num_bits Number of bits to read. If num_bits > 64, the bits beyond the first 64 are consumed but not returned.
+    /// \return The bits read (the first bit read is the least significant bit)
+    /// \throw Exception if fewer than num_bits remain
+    std::uint64_t read(std::size_t num_bits)
+    {
+        require(num_bits);
+
+        const std::size_t word_bits = 64;
+        std::uint64_t value = 0;
+        for (std::size_t shift = 0; shift < num_bits;)
+        {
+            std::size_t bit = pos_ % 8;
+            std::size_t n = std::min<std::size_t>(8 - bit, num_bits - shift);
+            if (shift < word_bits)
+                value |= static_cast<std::uint64_t>((data_[pos_ / 8] >> bit) & ((1u << n) - 1))
+                         << shift;
+            pos_ += n;
+            shift += n;
+        }
+        return value;
+    }
+
+    /// \brief Read and consume the next num_bits into a Bitset (for values wider than 64 bits)
+    Bitset read_bits(std::size_t num_bits)
+    {
+        require(num_bits);
+
+        Bitset bits;
+        const std::size_t word_bits = 64;
+        for (std::size_t i = 0; i < num_bits; i += word_bits)
+        {
+            std::size_t n = std::min(word_bits, num_bits - i);
+            bits.append(read(n), n);
+        }
+        return bits;
+    }
+
+    /// \brief Read and consume the next len bytes (each as 8 bits, lsb first) and append them to a string
+    ///
+    /// \param bytes String to append to
+    /// \param len Number of bytes to read
+    void read_bytes(std::string* bytes, std::size_t len)
+    {
+        require(len * 8);
+        if (pos_ % 8 == 0)
+        {
+            bytes->append(reinterpret_cast<const char*>(data_) + pos_ / 8, len);
+            pos_ += len * 8;
+        }
+        else
+        {
+            bytes->reserve(bytes->size() + len);
+            for (std::size_t i = 0; i < len; ++i) bytes->push_back(static_cast<char>(read(8)));
+        }
+    }
+
+    /// \brief Consume the next num_bits without reading them
+    void skip(std::size_t num_bits)
+    {
+        require(num_bits);
+        pos_ += num_bits;
+    }
+
+    /// \brief Return the last num_bits read (or skipped) to be read again, e.g. by a codec that reads ahead of the end of its field
+    ///
+    /// \throw Exception if fewer than num_bits have been read
+    void rewind(std::size_t num_bits)
+    {
+        if (num_bits > pos_)
+            throw(dccl::Exception("Cannot rewind " + std::to_string(num_bits) + " bits - only " +
+                                  std::to_string(pos_) + " bits have been read"));
+        pos_ -= num_bits;
+    }
+
+    /// \brief Provides the unread bits of a BitReader as a Bitset, for use as the parent of the Bitset passed to codecs that decode from a Bitset (and take further bits with Bitset::get_more_bits()). The bits taken from the Pool are consumed from the BitReader when the Pool is destroyed.
+    ///
+    /// The reader's buffer is converted to a Bitset the first time a Pool is created, and the Bitsets of all Pools share that storage.
+    class Pool
+    {
+      public:
+        explicit Pool(BitReader* reader) : reader_(reader)
+        {
+            if (reader_->frame_.size() != reader_->size_)
+                reader_->frame_.from_byte_stream(reader_->data_, reader_->data_ + reader_->len_);
+
+            bits_ = reader_->frame_;
+            bits_.pop_front(reader_->pos_);
+        }
+        ~Pool() { reader_->pos_ = reader_->size_ - bits_.size(); }
+
+        Pool(const Pool&) = delete;
+        Pool& operator=(const Pool&) = delete;
+
+        /// \brief The unread bits
+        Bitset* bits() { return &bits_; }
+
+      private:
+        BitReader* reader_;
+        Bitset bits_;
+    };
+
+    /// \brief Number of bits read (or skipped) so far
+    std::size_t position() const { return pos_; }
+
+    /// \brief Number of bytes (partially) read, i.e. ceil(position() / 8)
+    std::size_t byte_position() const { return (pos_ + 7) / 8; }
+
+    /// \brief Number of bits left to read
+    std::size_t remaining() const { return size_ - pos_; }
+
+  private:
+    void require(std::size_t num_bits) const
+    {
+        if (num_bits > size_ - pos_)
+            throw(dccl::Exception("Cannot read " + std::to_string(num_bits) +
+                                  " bits - only " + std::to_string(size_ - pos_) +
+                                  " bits left to read! Check that all field codecs are always "
+                                  "producing (encode) and consuming (decode) the exact same "
+                                  "number of bits."));
+    }
+
+  private:
+    const std::uint8_t* data_;
+    std::size_t len_;
+    // number of bits in data_
+    std::size_t size_;
+    // number of bits read
+    std::size_t pos_{0};
+    // data_ as a Bitset, created on demand by Pool
+    Bitset frame_;
+};
+} // namespace dccl
+
+#endif
@@ -0,0 +1,171 @@
+// Copyright 2026:
+//   GobySoft, LLC (2013-)
+//   Community contributors (see AUTHORS file)
+// File authors:
+//   Toby Schneider <toby@gobysoft.org>
+//
+//
+// This file is part of the Dynamic Compact Control Language Library
+// ("DCCL").
+//
+// DCCL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 2.1 of the License, or
+// (at your option) any later version.
+//
+// DCCL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DCCL.  If not, see <http://www.gnu.org/licenses/>.
+#ifndef DCCLBITWRITER20261018H
+#define DCCLBITWRITER20261018H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+#include "bitset.h"
+
+namespace dccl
+{
+/// \brief Appends encoded bits directly to their final destination: a caller supplied byte buffer, the end of a std::string, or a Bitset.
+///
+/// Bits are written in the same order as Bitset::append(), i.e. the first bit written is the least significant bit of the first byte, so the bytes produced are identical to those given by Bitset::to_byte_string() for the same sequence of appends. Writing into a byte buffer requires no heap allocation; each byte is zeroed as it is first written to, so the buffer need not be initialized by the caller.
+class BitWriter
+{
+  public:
+    /// \brief Write into a caller supplied buffer
+    ///
+    /// \param buf Buffer to write into, starting at buf[0]
+    /// \param max_len Length of buf (bytes)
+    BitWriter(char* buf, std::size_t max_len)
+        : buf_(reinterpret_cast<unsigned char*>(buf)), max_len_(max_len)
+    {
+    }
+
+    /// \brief Write onto the end of a string (which is grown as needed). Any existing contents of the string are left as they are.
+    explicit BitWriter(std::string* str) : str_(str), start_(str->size()) {}
+
+    /// \brief Append to the most significant end of a Bitset
+    explicit BitWriter(Bitset* bits) : bits_(bits) {}
+
+    /// \brief Append the lowest num_bits of value
+    ///
+    /// \param value Value to append. Bits above num_bits are ignored.
+    /// \param num_bits Number of bits to append. If num_bits > 64, zeros are written for the bits beyond the 64 bits of value.
+    /// \throw std::length_error if writing into a buffer that is too small
+    BitWriter& append(std::uint64_t value, std::size_t num_bits)
+    {
+        const std::size_t word_bits = 64;
+        if (bits_)
+        {
+            for (std::size_t i = 0; i < num_bits; i += word_bits, value = 0)
+                bits_->append(value, std::min(word_bits, num_bits - i));
+            size_ += num_bits;
+            return *this;
+        }
+
+        while (num_bits > 0)
+        {
+            std::size_t bit = size_ % 8;
+            if (bit == 0)
+                next_byte();
+            std::size_t n = std::min<std::size_t>(8 - bit, num_bits);
+            buf_[size_ / 8] |= static_cast<unsigned char>((value & ((1u << n) - 1)) << bit);
+            value = (n < word_bits) ? (value >> n) : 0;
+            size_ += n;
+            num_bits -= n;
+        }
+        return *this;
+    }
+
+    /// \brief Append all the bits of a Bitset (lsb first)
+    BitWriter& append(const Bitset& bits)
+    {
+        if (bits_)
+        {
+            bits_->append(bits);
+            size_ += bits.size();
+            return *this;
+        }
+
+        const std::size_t word_bits = 64;
+        for (std::size_t i = 0, n = bits.size(); i < n; i += word_bits)
+        {
+            std::size_t len = std::min(word_bits, n - i);
+            append(bits.read_word(i, len), len);
+        }
+        return *this;
+    }
+
+    /// \brief Append a run of bytes (each as 8 bits, lsb first)
+    ///
+    /// \param bytes Bytes to append
+    /// \param len Number of bytes to append
+    BitWriter& append_bytes(const char* bytes, std::size_t len)
+    {
+        for (std::size_t i = 0; i < len; ++i) append(static_cast<unsigned char>(bytes[i]), 8);
+        return *this;
+    }
+
+    /// \brief Pad with zeros to the next byte boundary
+    BitWriter& align()
+    {
+        if (size_ % 8)
+            append(0, 8 - size_ % 8);
+        return *this;
+    }
+
+    /// \brief Number of bits written
+    std::size_t size() const { return size_; }
+
+    /// \brief Number of bytes (partially) written, i.e. ceil(size() / 8)
+    std::size_t byte_size() const { return (size_ + 7) / 8; }
+
+    /// \brief Start of the bytes written (when writing into a buffer or string), or nullptr when writing into a Bitset
+    char* data()
+    {
+        if (str_)
+            return &(*str_)[0] + start_;
+        else
+            return reinterpret_cast<char*>(buf_);
+    }
+
+  private:
+    /// \brief Make the byte at size_ / 8 available (and zeroed) for writing
+    void next_byte()
+    {
+        std::size_t byte = size_ / 8;
+        if (str_)
+        {
+            str_->push_back(0);
+            buf_ = reinterpret_cast<unsigned char*>(&(*str_)[start_]);
+        }
+        else if (byte < max_len_)
+        {
+            buf_[byte] = 0;
+        }
+        else
+        {
+            throw std::length_error("BitWriter: buffer too small, max_len must be >= " +
+                                    std::to_string(byte + 1));
+        }
+    }
+
+  private:
+    unsigned char* buf_{nullptr};
+    std::size_t max_len_{0};
+    std::string* str_{nullptr};
+    std::string::size_type start_{0};
+    Bitset* bits_{nullptr};
+    // number of bits written
+    std::size_t size_{0};
+};
+} // namespace dccl
+
+#endif
@@ -26,6 +26,8 @@
 
 using namespace dccl::logger;
 
+const dccl::Bitset::size_type dccl::Bitset::WORD_BITS;
+
 dccl::Bitset dccl::Bitset::relinquish_bits(size_type num_bits, bool final_child)
 {
     if (final_child || this->size() < num_bits)
@@ -41,16 +43,17 @@ dccl::Bitset dccl::Bitset::relinquish_bits(size_type num_bits, bool final_child)
     Bitset out;
     if (!final_child)
     {
-        for (size_type i = 0; i < num_bits; ++i)
-        {
-            if (this->empty())
-                throw(dccl::Exception("Cannot relinquish_bits - no more bits to give up! Check "
-                                      "that all field codecs are always producing (encode) and "
-                                      "consuming (decode) the exact same number of bits."));
+        if (this->size() < num_bits)
+            throw(dccl::Exception("Cannot relinquish_bits - no more bits to give up! Check "
+                                  "that all field codecs are always producing (encode) and "
+                                  "consuming (decode) the exact same number of bits."));
 
-            out.push_back(this->front());
-            this->pop_front();
-        }
+        // the bits are shared with `out` (not copied)
+        out.words_ = words_;
+        out.offset_ = offset_;
+        out.size_ = num_bits;
+        offset_ += num_bits;
+        size_ -= num_bits;
     }
     return out;
 }
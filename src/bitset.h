@@ -26,21 +26,152 @@
 #define DCCLBITSET20120424H
 
 #include <algorithm>
+#include <cstddef>
+#include <cstdint>
 #include <cstring>
-#include <deque>
+#include <iterator>
 #include <limits>
+#include <memory>
+#include <ostream>
+#include <stdexcept>
 #include <string>
+#include <vector>
 
 #include "exception.h"
 
 namespace dccl
 {
-/// \brief A variable size container of bits (subclassed from std::deque<bool>) with an optional hierarchy. Similar to set::bitset but can be resized at runtime and has the ability to have parent Bitsets that can give bits to their children.
+/// \brief A variable size container of bits with an optional hierarchy. Similar to std::bitset but can be resized at runtime and has the ability to have parent Bitsets that can give bits to their children.
 ///
-/// This is the class used within DCCL hold the encoded message as it is created. The front() of the deque represents the least significant bit (lsb) and the back() is the most significant bit (msb). DCCL messages are encoded and decoded starting with the  lsb and ending at the msb. The hierarchy is used to represent parent bit pools from which the child can pull more bits from to decode. The top level Bitset represents the entire encoded message, whereas the children are the message fields.
-class Bitset : public std::deque<bool>
+/// This is the class used within DCCL hold the encoded message as it is created. The front() of the container represents the least significant bit (lsb) and the back() is the most significant bit (msb). DCCL messages are encoded and decoded starting with the  lsb and ending at the msb. The hierarchy is used to represent parent bit pools from which the child can pull more bits from to decode. The top level Bitset represents the entire encoded message, whereas the children are the message fields.
+///
+/// The bits are packed into 64-bit words (bit 0 of the first word in use is the lsb), so operations on whole integers, byte strings and other Bitsets proceed a word at a time rather than a bit at a time. Unused storage is kept ahead of the lsb so that push_front() and pop_front() are (amortized) constant time, as they were when this class was a std::deque<bool>.
+///
+/// The word storage is shared (copy-on-write) between copies of a Bitset: each Bitset is a read cursor (offset and length) into the storage, and the storage is only copied when a Bitset that shares it is modified. Thus a child taking bits from its parent with get_more_bits() simply moves the cursors of the child and parent rather than copying bits, so decoding a field costs the same regardless of how deeply it is nested.
+class Bitset
 {
   public:
+    using word_type = std::uint64_t;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using value_type = bool;
+    using const_reference = bool;
+    using storage_type = std::vector<word_type>;
+
+    /// \brief Number of bits in each storage word
+    static constexpr size_type WORD_BITS = std::numeric_limits<word_type>::digits;
+
+    /// \brief Proxy object that allows assignment to a single bit (e.g. <tt>bits[2] = true</tt>)
+    class reference
+    {
+      public:
+        reference(Bitset* bits, size_type n) : bits_(bits), n_(n) {}
+
+        reference& operator=(bool val)
+        {
+            bits_->set(n_, val);
+            return *this;
+        }
+        reference& operator=(const reference& rhs) { return *this = static_cast<bool>(rhs); }
+
+        reference& operator&=(bool val) { return *this = (static_cast<bool>(*this) && val); }
+        reference& operator|=(bool val) { return *this = (static_cast<bool>(*this) || val); }
+        reference& operator^=(bool val) { return *this = (static_cast<bool>(*this) != val); }
+
+        operator bool() const { return bits_->test(n_); }
+        bool operator~() const { return !static_cast<bool>(*this); }
+
+        reference& flip()
+        {
+            bits_->flip(n_);
+            return *this;
+        }
+
+      private:
+        Bitset* bits_;
+        size_type n_;
+    };
+
+    /// \brief Random access iterator over the bits, from lsb to msb
+    template <typename BitsetType, typename Reference> class basic_iterator
+    {
+      public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = bool;
+        using difference_type = Bitset::difference_type;
+        using pointer = void;
+        using reference = Reference;
+
+        basic_iterator() = default;
+        basic_iterator(BitsetType* bits, size_type n) : bits_(bits), n_(n) {}
+
+        // allow iterator -> const_iterator
+        template <typename OtherBitsetType, typename OtherReference>
+        basic_iterator(const basic_iterator<OtherBitsetType, OtherReference>& other)
+            : bits_(other.bits_), n_(other.n_)
+        {
+        }
+
+        Reference operator*() const { return (*bits_)[n_]; }
+        Reference operator[](difference_type i) const { return (*bits_)[n_ + i]; }
+
+        basic_iterator& operator++()
+        {
+            ++n_;
+            return *this;
+        }
+        basic_iterator operator++(int)
+        {
+            basic_iterator copy(*this);
+            ++n_;
+            return copy;
+        }
+        basic_iterator& operator--()
+        {
+            --n_;
+            return *this;
+        }
+        basic_iterator operator--(int)
+        {
+            basic_iterator copy(*this);
+            --n_;
+            return copy;
+        }
+        basic_iterator& operator+=(difference_type i)
+        {
+            n_ += i;
+            return *this;
+        }
+        basic_iterator& operator-=(difference_type i)
+        {
+            n_ -= i;
+            return *this;
+        }
+        basic_iterator operator+(difference_type i) const { return basic_iterator(bits_, n_ + i); }
+        basic_iterator operator-(difference_type i) const { return basic_iterator(bits_, n_ - i); }
+        difference_type operator-(const basic_iterator& rhs) const
+        {
+            return static_cast<difference_type>(n_) - static_cast<difference_type>(rhs.n_);
+        }
+
+        bool operator==(const basic_iterator& rhs) const { return n_ == rhs.n_; }
+        bool operator!=(const basic_iterator& rhs) const { return n_ != rhs.n_; }
+        bool operator<(const basic_iterator& rhs) const { return n_ < rhs.n_; }
+        bool operator>(const basic_iterator& rhs) const { return n_ > rhs.n_; }
+        bool operator<=(const basic_iterator& rhs) const { return n_ <= rhs.n_; }
+        bool operator>=(const basic_iterator& rhs) const { return n_ >= rhs.n_; }
+
+      private:
+        template <typename, typename> friend class basic_iterator;
+        BitsetType* bits_{nullptr};
+        size_type n_{0};
+    };
+
+    using iterator = basic_iterator<Bitset, reference>;
+    using const_iterator = basic_iterator<const Bitset, bool>;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
     /// \brief Construct an empty Bitset.
     ///
     /// \param parent Pointer to a bitset that should be consider this Bitset's parent for calls to get_more_bits()
@@ -52,7 +183,7 @@ class Bitset : public std::deque<bool>
     /// \param value Initial value of the bits in this Bitset
     /// \param parent Pointer to a bitset that should be consider this Bitset's parent for calls to get_more_bits()
     explicit Bitset(size_type num_bits, unsigned long value = 0, Bitset* parent = nullptr)
-        : std::deque<bool>(num_bits, false), parent_(parent)
+        : parent_(parent)
     {
         from(value, num_bits);
     }
@@ -67,6 +198,105 @@ class Bitset : public std::deque<bool>
     /// \throw Exception The parent (and up the hierarchy, if applicable) do not have num_bits to give up.
     void get_more_bits(size_type num_bits);
 
+    /// \brief Number of bits in this Bitset
+    size_type size() const { return size_; }
+
+    /// \brief Is this Bitset empty (size() == 0)?
+    bool empty() const { return size_ == 0; }
+
+    /// \brief Remove all the bits
+    void clear()
+    {
+        offset_ = 0;
+        size_ = 0;
+        words_.reset();
+    }
+
+    /// \brief Change the number of bits, adding or removing bits from the most significant end.
+    ///
+    /// \param num_bits New size of this Bitset
+    /// \param value Value to give any bits added to the Bitset
+    void resize(size_type num_bits, bool value = false)
+    {
+        if (num_bits > size_)
+        {
+            size_type old_size = size_;
+            reserve_back(num_bits - size_);
+            size_ = num_bits;
+            fill(old_size, num_bits - old_size, value);
+        }
+        else
+        {
+            size_ = num_bits;
+        }
+    }
+
+    /// \brief Access a bit (read-only)
+    bool operator[](size_type n) const
+    {
+        size_type i = offset_ + n;
+        return ((*words_)[i / WORD_BITS] >> (i % WORD_BITS)) & 1;
+    }
+    /// \brief Access a bit
+    reference operator[](size_type n) { return reference(this, n); }
+
+    /// \brief Least significant bit
+    bool front() const { return (*this)[0]; }
+    reference front() { return (*this)[0]; }
+
+    /// \brief Most significant bit
+    bool back() const { return (*this)[size_ - 1]; }
+    reference back() { return (*this)[size_ - 1]; }
+
+    iterator begin() { return iterator(this, 0); }
+    iterator end() { return iterator(this, size_); }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, size_); }
+    reverse_iterator rbegin() { return reverse_iterator(end()); }
+    reverse_iterator rend() { return reverse_iterator(begin()); }
+    const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+    const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+
+    /// \brief Add a bit to the big (most significant) end
+    void push_back(bool bit)
+    {
+        reserve_back(1);
+        ++size_;
+        set(size_ - 1, bit);
+    }
+
+    /// \brief Add a bit to the little (least significant) end
+    void push_front(bool bit)
+    {
+        reserve_front(1);
+        --offset_;
+        ++size_;
+        set(0, bit);
+    }
+
+    /// \brief Remove the most significant bit
+    void pop_back() { --size_; }
+
+    /// \brief Remove the least significant bit
+    void pop_front()
+    {
+        ++offset_;
+        --size_;
+    }
+
+    /// \brief Remove (drop) the num_bits least significant bits. Unlike operator>>=(), this reduces the size of the Bitset, and it takes constant time.
+    ///
+    /// \param num_bits Number of bits to remove
+    /// \throw Exception This Bitset has fewer than num_bits bits.
+    void pop_front(size_type num_bits)
+    {
+        if (num_bits > size_)
+            throw(dccl::Exception("Bitset pop_front(num_bits) requires num_bits <= this->size()"));
+
+        offset_ += num_bits;
+        size_ -= num_bits;
+    }
+
     /// \brief Logical AND in place
     ///
     /// Apply the result of a logical AND of this Bitset and another to this Bitset.
@@ -78,7 +308,12 @@ class Bitset : public std::deque<bool>
         if (rhs.size() != size())
             throw(dccl::Exception("Bitset operator&= requires this->size() == rhs.size()"));
 
-        for (size_type i = 0; i != this->size(); ++i) (*this)[i] &= rhs[i];
+        detach();
+        for (size_type i = 0; i < size_; i += WORD_BITS)
+        {
+            size_type n = std::min(WORD_BITS, size_ - i);
+            write_word(i, read_word(i, n) & rhs.read_word(i, n), n);
+        }
         return *this;
     }
 
@@ -93,7 +328,12 @@ class Bitset : public std::deque<bool>
         if (rhs.size() != size())
             throw(dccl::Exception("Bitset operator|= requires this->size() == rhs.size()"));
 
-        for (size_type i = 0; i != this->size(); ++i) (*this)[i] |= rhs[i];
+        detach();
+        for (size_type i = 0; i < size_; i += WORD_BITS)
+        {
+            size_type n = std::min(WORD_BITS, size_ - i);
+            write_word(i, read_word(i, n) | rhs.read_word(i, n), n);
+        }
         return *this;
     }
 
@@ -108,7 +348,12 @@ class Bitset : public std::deque<bool>
         if (rhs.size() != size())
             throw(dccl::Exception("Bitset operator^= requires this->size() == rhs.size()"));
 
-        for (size_type i = 0; i != this->size(); ++i) (*this)[i] ^= rhs[i];
+        detach();
+        for (size_type i = 0; i < size_; i += WORD_BITS)
+        {
+            size_type n = std::min(WORD_BITS, size_ - i);
+            write_word(i, read_word(i, n) ^ rhs.read_word(i, n), n);
+        }
         return *this;
     }
 
@@ -120,13 +365,16 @@ class Bitset : public std::deque<bool>
     /// that come off the most significant end. This operation does not change the size of the Bitset.
     /// \param n The number of bits to shift. This is equivalent to multiplying the Bitset by 2^n if the Bitset can hold the result
     /// \return  A reference to the resulting Bitset
+    ///
+    /// The bits are not moved; rather the start of this Bitset within its storage is moved n bits toward the lsb, so the cost depends only on n, not size().
     Bitset& operator<<=(size_type n)
     {
-        for (size_type i = 0; i < n; ++i)
-        {
-            push_front(false);
-            pop_back();
-        }
+        if (n >= size_)
+            return reset();
+
+        reserve_front(n);
+        offset_ -= n;
+        fill(0, n, false);
         return *this;
     }
 
@@ -136,13 +384,16 @@ class Bitset : public std::deque<bool>
     /// that come off the least significant end. This operation does not change the size of the Bitset.
     /// \param n The number of bits to shift. This is equivalent to dividing the Bitset by 2^n
     /// \return  A reference to the resulting Bitset
+    ///
+    /// As with operator<<=(), the bits are not moved, so the cost depends only on n, not size(). Use pop_front(n) if the zeros added to the most significant end are not needed.
     Bitset& operator>>=(size_type n)
     {
-        for (size_type i = 0; i < n; ++i)
-        {
-            push_back(false);
-            pop_front();
-        }
+        if (n >= size_)
+            return reset();
+
+        reserve_back(n);
+        offset_ += n;
+        fill(size_ - n, n, false);
         return *this;
     }
 
@@ -173,7 +424,13 @@ class Bitset : public std::deque<bool>
     /// \return A reference to the resulting Bitset
     Bitset& set(size_type n, bool val = true)
     {
-        (*this)[n] = val;
+        detach();
+        size_type i = offset_ + n;
+        word_type mask = static_cast<word_type>(1) << (i % WORD_BITS);
+        if (val)
+            (*words_)[i / WORD_BITS] |= mask;
+        else
+            (*words_)[i / WORD_BITS] &= ~mask;
         return *this;
     }
 
@@ -182,7 +439,8 @@ class Bitset : public std::deque<bool>
     /// \return A reference to the resulting Bitset
     Bitset& set()
     {
-        for (bool& it : *this) it = true;
+        detach();
+        fill(0, size_, true);
         return *this;
     }
 
@@ -197,7 +455,8 @@ class Bitset : public std::deque<bool>
     /// \return A reference to the resulting Bitset
     Bitset& reset()
     {
-        for (bool& it : *this) it = false;
+        detach();
+        fill(0, size_, false);
         return *this;
     }
 
@@ -212,7 +471,12 @@ class Bitset : public std::deque<bool>
     /// \return A reference to the resulting Bitset
     Bitset& flip()
     {
-        for (size_type i = 0, n = size(); i < n; ++i) flip(i);
+        detach();
+        for (size_type i = 0; i < size_; i += WORD_BITS)
+        {
+            size_type n = std::min(WORD_BITS, size_ - i);
+            write_word(i, ~read_word(i, n), n);
+        }
         return *this;
     }
 
@@ -234,13 +498,12 @@ class Bitset : public std::deque<bool>
     template <typename IntType>
     void from(IntType value, size_type num_bits = std::numeric_limits<IntType>::digits)
     {
-        this->resize(num_bits);
-        for (int i = 0, n = std::min<size_type>(std::numeric_limits<IntType>::digits, size());
-             i < n; ++i)
-        {
-            if (value & (static_cast<IntType>(1) << i))
-                (*this)[i] = true;
-        }
+        static_assert(std::numeric_limits<IntType>::digits <= static_cast<int>(WORD_BITS),
+                      "Bitset::from() supports integer types of at most 64 bits");
+        clear();
+        resize(num_bits);
+        size_type n = std::min<size_type>(std::numeric_limits<IntType>::digits, num_bits);
+        write_word(0, static_cast<word_type>(value), n);
     }
 
     /// \brief Sets value of the Bitset to the contents of an unsigned long integer. Equivalent to from<unsigned long>()
@@ -260,14 +523,7 @@ class Bitset : public std::deque<bool>
             throw(Exception("Type IntType cannot represent current bitset (this->size() > "
                             "std::numeric_limits<IntType>::digits)"));
 
-        IntType out = 0;
-        for (int i = 0, n = size(); i < n; ++i)
-        {
-            if ((*this)[i])
-                out |= (static_cast<IntType>(1) << i);
-        }
-
-        return out;
+        return static_cast<IntType>(read_word(0, size_));
     }
 
     /// \brief Returns the value of the Bitset as an unsigned long integer. Equivalent to to<unsigned long>().
@@ -293,14 +549,11 @@ class Bitset : public std::deque<bool>
     /// \brief Returns the value of the Bitset to a byte string, where each character represents 8 bits of the Bitset. The string is used as a byte container, and is not intended to be printed.
     ///
     /// \return A string containing the value of the Bitset, with the least signficant byte in string[0] and the most significant byte in string[size()-1]
-    std::string to_byte_string()
+    std::string to_byte_string() const
     {
         // number of bytes needed is ceil(size() / 8)
         std::string s(this->size() / 8 + (this->size() % 8 ? 1 : 0), 0);
-
-        for (size_type i = 0, n = this->size(); i < n; ++i)
-            s[i / 8] |= static_cast<char>((*this)[i] << (i % 8));
-
+        write_bytes(&s[0]);
         return s;
     }
 
@@ -309,7 +562,7 @@ class Bitset : public std::deque<bool>
     /// \param max_len Maximum length of buf
     /// \return number of bytes written to buf
     /// \throw std::length_error if max_len < encoded length.
-    size_t to_byte_string(char* buf, size_t max_len)
+    size_t to_byte_string(char* buf, size_t max_len) const
     {
         // number of bytes needed is ceil(size() / 8)
         size_t len = this->size() / 8 + (this->size() % 8 ? 1 : 0);
@@ -319,12 +572,7 @@ class Bitset : public std::deque<bool>
             throw std::length_error("max_len must be >= len");
         }
 
-        // initialize buffer to all zeroes
-        std::fill_n(buf, len, 0);
-
-        for (size_type i = 0, n = this->size(); i < n; ++i)
-            buf[i / 8] |= static_cast<char>((*this)[i] << (i % 8));
-
+        write_bytes(buf);
         return len;
     }
 
@@ -339,36 +587,207 @@ class Bitset : public std::deque<bool>
     /// \param end Iterator pointing to the end of the input bufer
     template <typename CharIterator> void from_byte_stream(CharIterator begin, CharIterator end)
     {
-        this->resize(std::distance(begin, end) * 8);
-        int i = 0;
-        for (CharIterator it = begin; it != end; ++it)
-        {
-            for (size_type j = 0; j < 8; ++j) (*this)[i * 8 + j] = (*it) & (1 << j);
-            ++i;
-        }
+        const size_type bytes_per_word = WORD_BITS / 8;
+        size_type num_bytes = std::distance(begin, end);
+
+        offset_ = 0;
+        size_ = num_bytes * 8;
+        words_ = std::make_shared<storage_type>((size_ + WORD_BITS - 1) / WORD_BITS, 0);
+
+        storage_type& words = *words_;
+        size_type i = 0;
+        for (CharIterator it = begin; it != end; ++it, ++i)
+            words[i / bytes_per_word] |= static_cast<word_type>(static_cast<unsigned char>(*it))
+                                          << (8 * (i % bytes_per_word));
     }
 
     /// \brief Adds the bitset to the little end
     Bitset& prepend(const Bitset& bits)
     {
-        for (auto it = bits.rbegin(), n = bits.rend(); it != n; ++it) push_front(*it);
+        if (&bits == this)
+            return prepend(Bitset(bits));
 
+        reserve_front(bits.size());
+        offset_ -= bits.size();
+        size_ += bits.size();
+        copy_from(bits, 0, 0, bits.size());
         return *this;
     }
 
     /// \brief Adds the bitset to the big end
+    ///
+    /// If this Bitset is empty, or the bits directly follow this Bitset's bits in shared storage (as they do when taken from a parent), no bits are copied.
     Bitset& append(const Bitset& bits)
     {
-        for (bool bit : bits) push_back(bit);
+        if (bits.empty())
+            return *this;
+
+        if (empty())
+        {
+            words_ = bits.words_;
+            offset_ = bits.offset_;
+            size_ = bits.size_;
+            return *this;
+        }
+
+        if (words_ == bits.words_ && offset_ + size_ == bits.offset_)
+        {
+            size_ += bits.size_;
+            return *this;
+        }
 
+        size_type old_size = size_;
+        reserve_back(bits.size());
+        size_ += bits.size();
+        copy_from(bits, 0, old_size, bits.size());
         return *this;
     }
 
+    /// \brief Adds the lowest num_bits of an integer to the big end (a word at a time, rather than a bit at a time).
+    ///
+    /// \param value Value to append. Bits above num_bits are ignored.
+    /// \param num_bits Number of bits of value to append (must be <= 64)
+    Bitset& append(word_type value, size_type num_bits)
+    {
+        size_type old_size = size_;
+        reserve_back(num_bits);
+        size_ += num_bits;
+        write_word(old_size, value, num_bits);
+        return *this;
+    }
+
+    /// \brief Read a run of up to 64 bits as an integer (a word at a time, rather than a bit at a time).
+    ///
+    /// \param pos Index of the first bit to read, which becomes bit 0 of the result.
+    /// \param n Number of bits to read (must be <= 64 and pos + n <= size())
+    word_type read_word(size_type pos, size_type n) const
+    {
+        if (n == 0)
+            return 0;
+        size_type i = offset_ + pos;
+        size_type w = i / WORD_BITS, b = i % WORD_BITS;
+        const storage_type& words = *words_;
+        word_type v = words[w] >> b;
+        if (b + n > WORD_BITS)
+            v |= words[w + 1] << (WORD_BITS - b);
+        return v & low_mask(n);
+    }
+
   private:
     Bitset relinquish_bits(size_type num_bits, bool final_child);
 
+    /// \brief Mask of the lowest n bits of a word (n <= 64)
+    static word_type low_mask(size_type n)
+    {
+        return (n >= WORD_BITS) ? ~static_cast<word_type>(0)
+                                : ((static_cast<word_type>(1) << n) - 1);
+    }
+
+    /// \brief Write the lowest n (<= 64) bits of value starting at logical bit pos. The storage must not be shared (see detach()).
+    void write_word(size_type pos, word_type value, size_type n)
+    {
+        if (n == 0)
+            return;
+        value &= low_mask(n);
+        size_type i = offset_ + pos;
+        size_type w = i / WORD_BITS, b = i % WORD_BITS;
+        storage_type& words = *words_;
+        word_type mask = low_mask(n) << b;
+        words[w] = (words[w] & ~mask) | (value << b);
+        if (b + n > WORD_BITS)
+        {
+            size_type spill = b + n - WORD_BITS;
+            word_type high_mask = low_mask(spill);
+            words[w + 1] = (words[w + 1] & ~high_mask) | (value >> (WORD_BITS - b));
+        }
+    }
+
+    /// \brief Set n bits starting at logical bit pos to value. The storage must not be shared (see detach()).
+    void fill(size_type pos, size_type n, bool value)
+    {
+        const word_type v = value ? ~static_cast<word_type>(0) : 0;
+        for (size_type i = 0; i < n; i += WORD_BITS)
+            write_word(pos + i, v, std::min(WORD_BITS, n - i));
+    }
+
+    /// \brief Copy n bits from bits (starting at src_pos) to this (starting at dest_pos). The storage must not be shared (see detach()).
+    void copy_from(const Bitset& bits, size_type src_pos, size_type dest_pos, size_type n)
+    {
+        for (size_type i = 0; i < n; i += WORD_BITS)
+        {
+            size_type len = std::min(WORD_BITS, n - i);
+            write_word(dest_pos + i, bits.read_word(src_pos + i, len), len);
+        }
+    }
+
+    /// \brief Write ceil(size()/8) bytes (lsb first) to buf
+    void write_bytes(char* buf) const
+    {
+        for (size_type i = 0; i < size_; i += 8)
+            buf[i / 8] = static_cast<char>(read_word(i, std::min<size_type>(8, size_ - i)));
+    }
+
+    /// \brief Give this Bitset its own copy of the storage (of just the words it uses) if it is shared with another Bitset, so that it can be modified.
+    void detach()
+    {
+        if (!words_)
+        {
+            words_ = std::make_shared<storage_type>();
+        }
+        else if (words_.use_count() > 1)
+        {
+            size_type first = offset_ / WORD_BITS;
+            size_type last = (offset_ + size_ + WORD_BITS - 1) / WORD_BITS;
+            words_ = std::make_shared<storage_type>(words_->begin() + first,
+                                                    words_->begin() + last);
+            offset_ -= first * WORD_BITS;
+        }
+    }
+
+    /// \brief Ensure there is (unshared) storage for num_bits more bits beyond the most significant end
+    void reserve_back(size_type num_bits)
+    {
+        detach();
+        storage_type& words = *words_;
+
+        size_type words_needed = (offset_ + size_ + num_bits + WORD_BITS - 1) / WORD_BITS;
+        if (words_needed <= words.size())
+            return;
+
+        // reclaim storage given up by pop_front() before growing
+        size_type dead_words = offset_ / WORD_BITS;
+        if (dead_words > 0 && dead_words >= words_needed - dead_words)
+        {
+            words.erase(words.begin(), words.begin() + dead_words);
+            offset_ -= dead_words * WORD_BITS;
+            words_needed -= dead_words;
+        }
+        if (words_needed > words.size())
+            words.resize(words_needed, 0);
+    }
+
+    /// \brief Ensure there is (unshared) storage for num_bits more bits beyond the least significant end
+    void reserve_front(size_type num_bits)
+    {
+        detach();
+        if (offset_ >= num_bits)
+            return;
+
+        // add at least as many words as currently in use so that repeated push_front() is amortized constant time
+        storage_type& words = *words_;
+        size_type new_words = (num_bits - offset_ + WORD_BITS - 1) / WORD_BITS;
+        new_words = std::max(new_words, words.size());
+        words.insert(words.begin(), new_words, 0);
+        offset_ += new_words * WORD_BITS;
+    }
+
   private:
     Bitset* parent_;
+    // shared (copy-on-write) between copies and between parents and children
+    std::shared_ptr<storage_type> words_;
+    // index into words_ (in bits) of the least significant bit
+    size_type offset_{0};
+    size_type size_{0};
 };
 
 inline bool operator==(const Bitset& a, const Bitset& b)
@@ -37,19 +37,16 @@
 #if DCCL_HAS_CRYPTOPP
 #if CRYPTOPP_PATH_USES_PLUS_SIGN
 #include <crypto++/aes.h>
-#include <crypto++/filters.h>
-#include <crypto++/modes.h>
 #include <crypto++/sha.h>
 #else
 #include <cryptopp/aes.h>
-#include <cryptopp/filters.h>
-#include <cryptopp/modes.h>
 #include <cryptopp/sha.h>
 #endif // CRYPTOPP_PATH_USES_PLUS_SIGN
 #endif // HAS_CRYPTOPP
 
 #include "codecs2/field_codec_default.h"
 #include "codecs3/field_codec_default.h"
+#include "codecs3/field_codec_delta.h"
 #include "codecs3/field_codec_presence.h"
 #include "codecs3/field_codec_var_bytes.h"
 #include "codecs4/field_codec_default.h"
@@ -67,6 +64,21 @@ using google::protobuf::Descriptor;
 using google::protobuf::FieldDescriptor;
 using google::protobuf::Reflection;
 
+// AES key schedules and authentication settings, prepared once in set_crypto_passphrase()
+struct dccl::Codec::CryptoKey
+{
+#if DCCL_HAS_CRYPTOPP
+    CryptoPP::AES::Encryption aes;
+
+    // AES-CMAC (RFC 4493) key schedule and subkeys
+    CryptoPP::AES::Encryption mac_aes;
+    std::uint8_t mac_k1[CryptoPP::AES::BLOCKSIZE];
+    std::uint8_t mac_k2[CryptoPP::AES::BLOCKSIZE];
+#endif
+    // length of the (truncated) CMAC appended to each encrypted message, 0 for no authentication
+    unsigned tag_bytes{0};
+};
+
 //
 // Codec
 //
@@ -159,6 +171,14 @@ void dccl::Codec::set_default_codecs()
     // alternative bytes codec that more efficiently encodes variable length bytes fields
     manager_.add<v3::VarBytesCodec, FieldDescriptor::TYPE_BYTES>("dccl.var_bytes");
 
+    // sends slowly varying repeated numeric fields as differences between successive values
+    manager_.add<v3::DeltaFieldCodec<double>>("dccl.delta");
+    manager_.add<v3::DeltaFieldCodec<float>>("dccl.delta");
+    manager_.add<v3::DeltaFieldCodec<int32>>("dccl.delta");
+    manager_.add<v3::DeltaFieldCodec<int64>>("dccl.delta");
+    manager_.add<v3::DeltaFieldCodec<uint32>>("dccl.delta");
+    manager_.add<v3::DeltaFieldCodec<uint64>>("dccl.delta");
+
     // for backwards compatibility
     manager_.add<v2::TimeCodec<uint64>>("_time");
     manager_.add<v2::TimeCodec<int64>>("_time");
@@ -173,18 +193,17 @@ void dccl::Codec::set_default_codecs()
     manager_.add<v2::StaticCodec<uint64>>("_static");
 }
 
-void dccl::Codec::encode_internal(const google::protobuf::Message& msg, bool header_only,
-                                  Bitset& head_bits, Bitset& body_bits, int user_id)
+size_t dccl::Codec::encode_internal(const google::protobuf::Message& msg, bool header_only,
+                                    BitWriter* writer, int user_id)
 {
     const Descriptor* desc = msg.GetDescriptor();
 
-    dlog.is(DEBUG1, ENCODE) && dlog << "Began encoding message of type: " << desc->full_name()
-                                    << std::endl;
+    DCCL_LOG_IS(DEBUG1, ENCODE) &&
+        dlog << "Began encoding message of type: " << desc->full_name() << std::endl;
 
     try
     {
         unsigned dccl_id = (user_id < 0) ? id(desc) : user_id;
-        size_t head_byte_size = 0;
 
         if (!msg.IsInitialized() && !header_only)
         {
@@ -207,27 +226,7 @@ void dccl::Codec::encode_internal(const google::protobuf::Message& msg, bool hea
 
         if (codec)
         {
-            //fixed header
-            id_codec()->field_encode(&head_bits, dccl_id, nullptr);
-
-            internal::MessageStack msg_stack(manager_.codec_data().root_message_,
-                                             manager_.codec_data().message_data_);
-            msg_stack.push(msg.GetDescriptor());
-            codec->base_encode(&head_bits, msg, HEAD, strict_);
-
-            // given header of not even byte size (e.g. 01011), make even byte size (e.g. 00001011)
-            head_byte_size = ceil_bits2bytes(head_bits.size());
-            head_bits.resize(head_byte_size * BITS_IN_BYTE);
-
-            if (header_only)
-            {
-                dlog.is(DEBUG2, ENCODE) &&
-                    dlog << "as requested, skipping encoding and encrypting body." << std::endl;
-            }
-            else
-            {
-                codec->base_encode(&body_bits, msg, BODY, strict_);
-            }
+            return encode_message(msg, dccl_id, codec.get(), header_only, writer);
         }
         else
         {
@@ -238,124 +237,177 @@ void dccl::Codec::encode_internal(const google::protobuf::Message& msg, bool hea
     }
     catch (dccl::OutOfRangeException& e)
     {
-        dlog.is(DEBUG1, ENCODE) &&
+        DCCL_LOG_IS(DEBUG1, ENCODE) &&
             dlog << "Message " << desc->full_name()
                  << " failed to encode because a field was out of bounds and strict == true: "
                  << e.what() << std::endl;
         throw;
     }
+    catch (std::length_error& e)
+    {
+        // output buffer too small
+        DCCL_LOG_IS(DEBUG1, ENCODE) && dlog << "Message " << desc->full_name()
+                                            << " failed to encode: " << e.what() << std::endl;
+        throw;
+    }
     catch (std::exception& e)
     {
         std::stringstream ss;
 
         ss << "Message " << desc->full_name() << " failed to encode. Reason: " << e.what();
 
-        dlog.is(DEBUG1, ENCODE) && dlog << ss.str() << std::endl;
+        DCCL_LOG_IS(DEBUG1, ENCODE) && dlog << ss.str() << std::endl;
         throw(Exception(ss.str(), desc));
     }
 }
 
-size_t dccl::Codec::encode(char* bytes, size_t max_len, const google::protobuf::Message& msg,
-                           bool header_only /* = false */, int user_id /* = -1 */)
+size_t dccl::Codec::encode_message(const google::protobuf::Message& msg, unsigned dccl_id,
+                                   FieldCodecBase* codec, bool header_only, BitWriter* writer)
 {
-    const Descriptor* desc = msg.GetDescriptor();
-    Bitset head_bits;
-    Bitset body_bits;
-    encode_internal(msg, header_only, head_bits, body_bits, user_id);
+    //fixed header
+    auto bits_it = id2bits_.find(dccl_id);
+    if (bits_it != id2bits_.end() && bits_it->second.revision == manager_.revision())
+        writer->append(bits_it->second.bits);
+    else
+        id_codec()->field_encode(writer, dccl_id, nullptr);
 
-    size_t head_byte_size = ceil_bits2bytes(head_bits.size());
-    if (max_len < head_byte_size)
+    internal::MessageStack msg_stack(manager_.codec_data().root_message_,
+                                     manager_.codec_data().message_data_);
+    msg_stack.push(msg.GetDescriptor());
+    codec->base_encode(writer, msg, HEAD, strict_);
+
+    // given header of not even byte size (e.g. 01011), make even byte size (e.g. 00001011)
+    writer->align();
+    size_t head_byte_size = writer->byte_size();
+    size_t body_byte_size = 0;
+
+    if (header_only)
+    {
+        DCCL_LOG_IS(DEBUG2, ENCODE) &&
+            dlog << "as requested, skipping encoding and encrypting body." << std::endl;
+    }
+    else
     {
-        throw std::length_error("max_len must be >= head_byte_size");
+        codec->base_encode(writer, msg, BODY, strict_);
+        body_byte_size = writer->byte_size() - head_byte_size;
     }
-    head_bits.to_byte_string(bytes, head_byte_size);
 
-    dlog.is(DEBUG2, ENCODE) && dlog << "Head bytes (bits): " << head_byte_size << "("
-                                    << head_bits.size() << ")" << std::endl;
-    dlog.is(DEBUG3, ENCODE) && dlog << "Unencrypted Head (bin): " << head_bits << std::endl;
-    dlog.is(DEBUG3, ENCODE) && dlog << "Unencrypted Head (hex): "
-                                    << hex_encode(bytes, bytes + head_byte_size) << std::endl;
+    char* bytes = writer->data();
+
+    DCCL_LOG_IS(DEBUG2, ENCODE) && dlog << "Head bytes (bits): " << head_byte_size << "("
+                                        << head_byte_size * BITS_IN_BYTE << ")" << std::endl;
+    DCCL_LOG_IS(DEBUG3, ENCODE) && dlog << "Unencrypted Head (hex): "
+                                        << hex_encode(bytes, bytes + head_byte_size) << std::endl;
 
-    size_t body_byte_size = 0;
     if (!header_only)
     {
-        body_byte_size = ceil_bits2bytes(body_bits.size());
-        if (max_len < (head_byte_size + body_byte_size))
-        {
-            throw std::length_error("max_len must be >= (head_byte_size + body_byte_size)");
-        }
-        body_bits.to_byte_string(bytes + head_byte_size, max_len - head_byte_size);
-
-        dlog.is(DEBUG3, ENCODE) && dlog << "Unencrypted Body (bin): " << body_bits << std::endl;
-        dlog.is(DEBUG3, ENCODE) &&
+        DCCL_LOG_IS(DEBUG3, ENCODE) &&
             dlog << "Unencrypted Body (hex): "
                  << hex_encode(bytes + head_byte_size, bytes + head_byte_size + body_byte_size)
                  << std::endl;
-        dlog.is(DEBUG2, ENCODE) && dlog << "Body bytes (bits): " << body_byte_size << "("
-                                        << body_bits.size() << ")" << std::endl;
+        DCCL_LOG_IS(DEBUG2, ENCODE) &&
+            dlog << "Body bytes (bits): " << body_byte_size << "("
+                 << writer->size() - head_byte_size * BITS_IN_BYTE << ")" << std::endl;
 
-        unsigned dccl_id = (user_id < 0) ? id(desc) : user_id;
-        if (!crypto_key_.empty() && !skip_crypto_ids_.count(dccl_id))
-        {
-            std::string head_bytes(bytes, bytes + head_byte_size);
-            std::string body_bytes(bytes + head_byte_size, bytes + head_byte_size + body_byte_size);
-            encrypt(&body_bytes, head_bytes);
-            std::memcpy(bytes + head_byte_size, body_bytes.data(), body_bytes.size());
-        }
+        if (crypto_key_ && !skip_crypto_ids_.count(dccl_id))
+            crypt(reinterpret_cast<std::uint8_t*>(bytes + head_byte_size), body_byte_size,
+                  reinterpret_cast<const std::uint8_t*>(bytes), head_byte_size);
 
-        dlog.is(logger::DEBUG3, logger::ENCODE) &&
+        DCCL_LOG_IS(DEBUG3, ENCODE) &&
             dlog << "Encrypted Body (hex): "
                  << hex_encode(bytes + head_byte_size, bytes + head_byte_size + body_byte_size)
                  << std::endl;
+
+        if (unsigned tag_bytes = auth_tag_bytes(dccl_id))
+        {
+            std::uint8_t tag[max_auth_tag_bytes];
+            authenticate(reinterpret_cast<const std::uint8_t*>(bytes),
+                         head_byte_size + body_byte_size, tag, tag_bytes);
+
+            writer->align();
+            for (unsigned i = 0; i < tag_bytes; ++i) writer->append(tag[i], BITS_IN_BYTE);
+            body_byte_size += tag_bytes;
+
+            DCCL_LOG_IS(DEBUG3, ENCODE) &&
+                dlog << "Authentication tag (hex): " << hex_encode(tag, tag + tag_bytes)
+                     << std::endl;
+        }
     }
 
-    dlog.is(DEBUG1, ENCODE) && dlog << "Successfully encoded message of type: " << desc->full_name()
-                                    << std::endl;
+    DCCL_LOG_IS(DEBUG1, ENCODE) && dlog << "Successfully encoded message of type: "
+                                        << msg.GetDescriptor()->full_name() << std::endl;
 
     return head_byte_size + body_byte_size;
 }
 
+size_t dccl::Codec::encode(char* bytes, size_t max_len, const google::protobuf::Message& msg,
+                           bool header_only /* = false */, int user_id /* = -1 */)
+{
+    // encode directly into the caller's buffer
+    BitWriter writer(bytes, max_len);
+    return encode_internal(msg, header_only, &writer, user_id);
+}
+
 void dccl::Codec::encode(std::string* bytes, const google::protobuf::Message& msg,
                          bool header_only /* = false */, int user_id /* = -1 */)
 {
-    const Descriptor* desc = msg.GetDescriptor();
-    Bitset head_bits;
-    Bitset body_bits;
-    encode_internal(msg, header_only, head_bits, body_bits, user_id);
+    std::string::size_type original_size = bytes->size();
+    BitWriter writer(bytes);
+    try
+    {
+        encode_internal(msg, header_only, &writer, user_id);
+    }
+    catch (...)
+    {
+        // leave bytes as they were on failure
+        bytes->resize(original_size);
+        throw;
+    }
+}
 
-    std::string head_bytes = head_bits.to_byte_string();
+unsigned dccl::Codec::id(const google::protobuf::Descriptor* desc) const
+{
+    auto it = desc2id_.find(desc);
+    if (it != desc2id_.end() && it->second.revision == manager_.revision())
+        return it->second.id;
+    else
+        return compute_id(desc);
+}
 
-    dlog.is(DEBUG2, ENCODE) && dlog << "Head bytes (bits): " << head_bytes.size() << "("
-                                    << head_bits.size() << ")" << std::endl;
-    dlog.is(DEBUG3, ENCODE) && dlog << "Unencrypted Head (bin): " << head_bits << std::endl;
-    dlog.is(DEBUG3, ENCODE) && dlog << "Unencrypted Head (hex): " << hex_encode(head_bytes)
-                                    << std::endl;
+unsigned dccl::Codec::compute_id(const google::protobuf::Descriptor* desc) const
+{
+    Bitset id_bits;
+    dccl::uint32 hardcoded_id = desc->options().GetExtension(dccl::msg).id();
+    // pass the hard coded id, that is, (dccl.msg).id,
+    // through encode/decode to allow a custom ID codec (if in use)
+    // to always take effect.
+    id_codec()->field_encode(&id_bits, hardcoded_id, nullptr);
+    std::string id_bytes(id_bits.to_byte_string());
+    return id(id_bytes);
+}
 
-    std::string body_bytes;
-    if (!header_only)
-    {
-        body_bytes = body_bits.to_byte_string();
+unsigned dccl::Codec::id(const std::string& bytes) const
+{
+    return id(reinterpret_cast<const std::uint8_t*>(bytes.data()), bytes.size());
+}
 
-        dlog.is(DEBUG3, ENCODE) && dlog << "Unencrypted Body (bin): " << body_bits << std::endl;
-        dlog.is(DEBUG3, ENCODE) && dlog << "Unencrypted Body (hex): " << hex_encode(body_bytes)
-                                        << std::endl;
-        dlog.is(DEBUG2, ENCODE) && dlog << "Body bytes (bits): " << body_bytes.size() << "("
-                                        << body_bits.size() << ")" << std::endl;
+unsigned dccl::Codec::id(const std::uint8_t* bytes, std::size_t len) const
+{
+    unsigned id_min_size = 0, id_max_size = 0;
+    id_codec()->field_min_size(&id_min_size, nullptr);
+    id_codec()->field_max_size(&id_max_size, nullptr);
 
-        unsigned dccl_id = (user_id < 0) ? id(desc) : user_id;
-        if (!crypto_key_.empty() && !skip_crypto_ids_.count(dccl_id))
-            encrypt(&body_bytes, head_bytes);
+    if (len < (id_min_size / BITS_IN_BYTE))
+        throw(Exception("Bytes passed (hex: " + hex_encode(bytes, bytes + len) +
+                        ") is too small to be a valid DCCL message"));
 
-        dlog.is(logger::DEBUG3, logger::ENCODE) &&
-            dlog << "Encrypted Body (hex): " << hex_encode(body_bytes) << std::endl;
-    }
+    BitReader reader(bytes, std::min<std::size_t>(len, ceil_bits2bytes(id_max_size)));
 
-    dlog.is(DEBUG1, ENCODE) && dlog << "Successfully encoded message of type: " << desc->full_name()
-                                    << std::endl;
-    *bytes += head_bytes + body_bytes;
-}
+    dccl::any return_value;
+    id_codec()->field_decode(&reader, &return_value, nullptr);
 
-unsigned dccl::Codec::id(const std::string& bytes) const { return id(bytes.begin(), bytes.end()); }
+    return dccl::any_cast<uint32>(return_value);
+}
 
 void dccl::Codec::decode(std::string* bytes, google::protobuf::Message* msg)
 {
@@ -367,7 +419,326 @@ void dccl::Codec::decode(std::string* bytes, google::protobuf::Message* msg)
 void dccl::Codec::decode(const std::string& bytes, google::protobuf::Message* msg,
                          bool header_only /* = false */)
 {
-    decode(bytes.begin(), bytes.end(), msg, header_only);
+    decode(reinterpret_cast<const std::uint8_t*>(bytes.data()), bytes.size(), msg, header_only);
+}
+
+std::size_t dccl::Codec::decode(const std::uint8_t* bytes, std::size_t len,
+                                google::protobuf::Message* msg, bool header_only /*= false*/)
+{
+    try
+    {
+        unsigned this_id = id(bytes, len);
+
+        DCCL_LOG_IS(DEBUG1, DECODE) &&
+            dlog << "Began decoding message of id: " << this_id << std::endl;
+
+        if (!id2desc_.count(this_id))
+            throw(Exception("Message id " + std::to_string(this_id) +
+                            " has not been loaded. Call load() before decoding this type."));
+
+        const google::protobuf::Descriptor* desc = msg->GetDescriptor();
+
+        DCCL_LOG_IS(DEBUG1, DECODE) && dlog << "Type name: " << desc->full_name() << std::endl;
+
+        std::shared_ptr<FieldCodecBase> codec = manager_.find(desc);
+
+        if (!codec)
+            throw(Exception("Failed to find (dccl.msg).codec `" +
+                            desc->options().GetExtension(dccl::msg).codec() + "`"),
+                  desc);
+
+        return decode_message(bytes, len, msg, header_only, this_id, codec.get());
+    }
+    catch (std::exception& e)
+    {
+        std::stringstream ss;
+
+        ss << "Message " << hex_encode(bytes, bytes + len)
+           << " failed to decode. Reason: " << e.what() << std::endl;
+
+        DCCL_LOG_IS(DEBUG1, DECODE) && dlog << ss.str() << std::endl;
+        throw(Exception(ss.str()));
+    }
+}
+
+std::size_t dccl::Codec::decode_message(const std::uint8_t* bytes, std::size_t len,
+                                        google::protobuf::Message* msg, bool header_only,
+                                        unsigned this_id, FieldCodecBase* codec)
+{
+    const google::protobuf::Descriptor* desc = msg->GetDescriptor();
+
+    // an authenticated message is the entire input, with the tag at the end: check it before
+    // decoding anything, so that corrupted or forged messages never reach the field codecs
+    const unsigned tag_bytes = header_only ? 0 : auth_tag_bytes(this_id);
+    if (tag_bytes)
+    {
+        if (len < tag_bytes || !check_auth_tag(bytes, len - tag_bytes, tag_bytes))
+            throw(Exception("Message failed authentication (incorrect tag)", desc));
+        len -= tag_bytes;
+    }
+
+    const MessageSizes sizes = message_sizes(desc);
+    unsigned head_size_bits = sizes.head_max_bits;
+    unsigned body_size_bits = sizes.body_max_bits;
+    unsigned id_size = 0;
+    id_codec()->field_size(&id_size, this_id, nullptr);
+    head_size_bits += id_size;
+
+    unsigned head_size_bytes = ceil_bits2bytes(head_size_bits);
+    unsigned body_size_bytes = ceil_bits2bytes(body_size_bits);
+
+    DCCL_LOG_IS(DEBUG2, DECODE) &&
+        dlog << "Head bytes (bits): " << head_size_bytes << "(" << head_size_bits
+             << "), max body bytes (bits): " << body_size_bytes << "(" << body_size_bits << ")"
+             << std::endl;
+
+    std::size_t head_len = std::min<std::size_t>(head_size_bytes, len);
+    DCCL_LOG_IS(DEBUG3, DECODE) &&
+        dlog << "Unencrypted Head (hex): " << hex_encode(bytes, bytes + head_len) << std::endl;
+
+    BitReader head_reader(bytes, head_len);
+
+    // skip ID bits
+    head_reader.skip(id_size);
+
+    internal::MessageStack msg_stack(manager_.codec_data().root_message_,
+                                     manager_.codec_data().message_data_);
+    msg_stack.push(msg->GetDescriptor());
+
+    codec->base_decode(&head_reader, msg, HEAD);
+    DCCL_LOG_IS(DEBUG2, DECODE) && dlog << "after header decode, message is: " << *msg << std::endl;
+
+    if (header_only)
+    {
+        DCCL_LOG_IS(DEBUG2, DECODE) &&
+            dlog << "as requested, skipping decrypting and decoding body." << std::endl;
+        return head_len;
+    }
+
+    const std::uint8_t* body = bytes + head_len;
+    std::size_t body_len = len - head_len;
+
+    DCCL_LOG_IS(DEBUG3, DECODE) &&
+        dlog << "Encrypted Body (hex): " << hex_encode(body, body + body_len) << std::endl;
+
+    if (crypto_key_ && !skip_crypto_ids_.count(this_id))
+    {
+        // the caller's bytes are const, so decrypt a copy (in a buffer reused for each message)
+        std::vector<std::uint8_t>& decrypted_body = manager_.codec_data().crypto_buffer_;
+        decrypted_body.assign(body, body + body_len);
+        crypt(decrypted_body.data(), body_len, bytes, head_len);
+        body = decrypted_body.data();
+    }
+
+    DCCL_LOG_IS(DEBUG3, DECODE) &&
+        dlog << "Unencrypted Body (hex): " << hex_encode(body, body + body_len) << std::endl;
+
+    BitReader body_reader(body, body_len);
+    codec->base_decode(&body_reader, msg, BODY);
+    DCCL_LOG_IS(DEBUG2, DECODE) &&
+        dlog << "after header & body decode, message is: " << *msg << std::endl;
+
+    DCCL_LOG_IS(DEBUG1, DECODE) &&
+        dlog << "Successfully decoded message of type: " << desc->full_name() << std::endl;
+
+    // the tag covers all of the input, so all of it is used
+    if (tag_bytes)
+        return len + tag_bytes;
+    else
+        return head_len + body_reader.byte_position();
+}
+
+std::size_t dccl::Codec::encode_batch(const google::protobuf::Message* const* msgs,
+                                      std::size_t count, std::string* bytes,
+                                      std::vector<BatchResult>* results)
+{
+    DCCL_LOG_IS(DEBUG1, ENCODE) &&
+        dlog << "Began encoding batch of " << count << " messages" << std::endl;
+
+    results->assign(count, BatchResult());
+
+    // lookups that only depend on the message type, done once per type
+    struct BatchType
+    {
+        unsigned dccl_id{0};
+        std::shared_ptr<FieldCodecBase> codec;
+        unsigned max_bytes{0};
+        std::string error;
+    };
+    std::map<const google::protobuf::Descriptor*, BatchType> types;
+    std::vector<const BatchType*> msg_types(count, nullptr);
+
+    std::size_t max_batch_bytes = 0;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        const google::protobuf::Descriptor* desc = msgs[i]->GetDescriptor();
+        auto it = types.find(desc);
+        if (it == types.end())
+        {
+            BatchType& type = types[desc];
+            try
+            {
+                type.dccl_id = id(desc);
+                if (!id2desc_.count(type.dccl_id))
+                    throw(Exception("Message id " + std::to_string(type.dccl_id) +
+                                        " has not been loaded. Call load() before encoding this "
+                                        "type.",
+                                    desc));
+
+                type.codec = manager_.find(desc);
+                if (!type.codec)
+                    throw(Exception("Failed to find (dccl.msg).codec `" +
+                                        desc->options().GetExtension(dccl::msg).codec() + "`",
+                                    desc));
+
+                type.max_bytes = max_size(desc);
+            }
+            catch (std::exception& e)
+            {
+                type.error = e.what();
+            }
+            it = types.find(desc);
+        }
+        msg_types[i] = &it->second;
+        max_batch_bytes += it->second.max_bytes;
+    }
+
+    // grow the output once for the whole batch
+    bytes->reserve(bytes->size() + max_batch_bytes);
+
+    std::size_t encoded = 0;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        BatchResult& result = (*results)[i];
+        const BatchType& type = *msg_types[i];
+        result.id = type.dccl_id;
+        result.offset = bytes->size();
+
+        if (!type.error.empty())
+        {
+            result.error = type.error;
+            continue;
+        }
+
+        try
+        {
+            if (!msgs[i]->IsInitialized())
+                throw(Exception("Message is not properly initialized. All `required` fields must "
+                                "be set. Fields with errors: \n" +
+                                    get_all_error_fields_in_message(*msgs[i]),
+                                msgs[i]->GetDescriptor()));
+
+            BitWriter writer(bytes);
+            result.size = encode_message(*msgs[i], type.dccl_id, type.codec.get(), false, &writer);
+            ++encoded;
+        }
+        catch (std::exception& e)
+        {
+            // remove any partially encoded message
+            bytes->resize(result.offset);
+            result.error = e.what();
+            DCCL_LOG_IS(DEBUG1, ENCODE) &&
+                dlog << "Message " << i << " of batch failed to encode: " << e.what() << std::endl;
+        }
+    }
+
+    DCCL_LOG_IS(DEBUG1, ENCODE) &&
+        dlog << "Encoded " << encoded << " of " << count << " messages in batch" << std::endl;
+
+    return encoded;
+}
+
+std::size_t dccl::Codec::decode_batch(const std::string* frames, std::size_t count,
+                                      std::vector<BatchResult>* results)
+{
+    DCCL_LOG_IS(DEBUG1, DECODE) &&
+        dlog << "Began decoding batch of " << count << " messages" << std::endl;
+
+    results->assign(count, BatchResult());
+
+    // group the frames by DCCL ID, keeping their order within each group
+    std::vector<std::size_t> order;
+    order.reserve(count);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        try
+        {
+            (*results)[i].id = id(frames[i]);
+            order.push_back(i);
+        }
+        catch (std::exception& e)
+        {
+            (*results)[i].error = e.what();
+        }
+    }
+    std::stable_sort(order.begin(), order.end(), [results](std::size_t a, std::size_t b)
+                     { return (*results)[a].id < (*results)[b].id; });
+
+    std::size_t decoded = 0;
+    for (auto group_begin = order.begin(); group_begin != order.end();)
+    {
+        const unsigned this_id = (*results)[*group_begin].id;
+        auto group_end = std::find_if(group_begin, order.end(), [results, this_id](std::size_t i)
+                                      { return (*results)[i].id != this_id; });
+
+        // lookups that only depend on the message type, done once per group
+        std::shared_ptr<google::protobuf::Message> prototype;
+        std::shared_ptr<FieldCodecBase> codec;
+        std::string error;
+        try
+        {
+            auto it = id2desc_.find(this_id);
+            if (it == id2desc_.end())
+                throw(Exception("Message id " + std::to_string(this_id) +
+                                " has not been loaded. Call load() before decoding this type."));
+
+            prototype = DynamicProtobufManager::new_protobuf_message<
+                std::shared_ptr<google::protobuf::Message>>(it->second);
+            codec = manager_.find(it->second);
+            if (!codec)
+                throw(Exception("Failed to find (dccl.msg).codec `" +
+                                    it->second->options().GetExtension(dccl::msg).codec() + "`",
+                                it->second));
+        }
+        catch (std::exception& e)
+        {
+            error = e.what();
+        }
+
+        for (auto it = group_begin; it != group_end; ++it)
+        {
+            BatchResult& result = (*results)[*it];
+            if (!error.empty())
+            {
+                result.error = error;
+                continue;
+            }
+
+            const std::string& frame = frames[*it];
+            try
+            {
+                std::shared_ptr<google::protobuf::Message> msg(prototype->New());
+                result.size =
+                    decode_message(reinterpret_cast<const std::uint8_t*>(frame.data()),
+                                   frame.size(), msg.get(), false, this_id, codec.get());
+                result.msg = msg;
+                ++decoded;
+            }
+            catch (std::exception& e)
+            {
+                result.error = e.what();
+                DCCL_LOG_IS(DEBUG1, DECODE) &&
+                    dlog << "Message " << *it << " of batch failed to decode: " << e.what()
+                         << std::endl;
+            }
+        }
+        group_begin = group_end;
+    }
+
+    DCCL_LOG_IS(DEBUG1, DECODE) &&
+        dlog << "Decoded " << decoded << " of " << count << " messages in batch" << std::endl;
+
+    return decoded;
 }
 
 // makes sure we can actual encode / decode a message of this descriptor given the loaded FieldCodecs
@@ -398,18 +769,8 @@ void dccl::Codec::load(const google::protobuf::Descriptor* desc, int user_id /*
         std::shared_ptr<FieldCodecBase> codec = manager_.find(desc);
 
         unsigned dccl_id = (user_id < 0) ? id(desc) : user_id;
-        unsigned head_size_bits, body_size_bits;
-        codec->base_max_size(&head_size_bits, desc, HEAD);
-        codec->base_max_size(&body_size_bits, desc, BODY);
-
-        unsigned id_bits = 0;
-        id_codec()->field_size(&id_bits, dccl_id, nullptr);
-        head_size_bits += id_bits;
-
-        const unsigned byte_size =
-            ceil_bits2bytes(head_size_bits) + ceil_bits2bytes(body_size_bits);
-
-        auto actual_max = byte_size;
+        const MessageSizes sizes = message_sizes(desc);
+        auto actual_max = max_encoded_bytes(sizes, dccl_id, auth_tag_bytes(dccl_id));
         auto allowed_max = desc->options().GetExtension(dccl::msg).max_bytes();
         if (actual_max > allowed_max)
             throw(Exception("Actual maximum size of message (" + std::to_string(actual_max) +
@@ -422,6 +783,8 @@ void dccl::Codec::load(const google::protobuf::Descriptor* desc, int user_id /*
         codec->base_validate(desc, HEAD);
         codec->base_validate(desc, BODY);
 
+        compile_dynamic_conditions(desc, desc);
+
         if (id2desc_.count(dccl_id) && desc != id2desc_.find(dccl_id)->second)
         {
             std::stringstream ss;
@@ -434,10 +797,24 @@ void dccl::Codec::load(const google::protobuf::Descriptor* desc, int user_id /*
         else
         {
             id2desc_.insert(std::make_pair(dccl_id, desc));
+            desc2sizes_[desc] = sizes;
+
+            // a custom id codec may depend on state outside of DCCL (e.g. the link in use),
+            // so only the ids given by the default id codec are cached
+            if (id_codec_ == default_id_codec_name())
+            {
+                if (desc->options().GetExtension(dccl::msg).has_id())
+                    desc2id_[desc] = {compute_id(desc), manager_.revision()};
+
+                EncodedId& encoded_id = id2bits_[dccl_id];
+                encoded_id.bits.clear();
+                id_codec()->field_encode(&encoded_id.bits, dccl_id, nullptr);
+                encoded_id.revision = manager_.revision();
+            }
         }
 
-        dlog.is(DEBUG1) && dlog << "Successfully validated message of type: " << desc->full_name()
-                                << std::endl;
+        DCCL_LOG_IS(DEBUG1, GENERAL) &&
+            dlog << "Successfully validated message of type: " << desc->full_name() << std::endl;
     }
     catch (Exception& e)
     {
@@ -449,10 +826,10 @@ void dccl::Codec::load(const google::protobuf::Descriptor* desc, int user_id /*
         {
         }
 
-        dlog.is(DEBUG1) && dlog << "Message " << desc->full_name() << ": " << desc
-                                << " failed validation. Reason: " << e.what() << "\n"
-                                << "If possible, information about the Message are printed above. "
-                                << std::endl;
+        DCCL_LOG_IS(DEBUG1, GENERAL) &&
+            dlog << "Message " << desc->full_name() << ": " << desc
+                 << " failed validation. Reason: " << e.what() << "\n"
+                 << "If possible, information about the Message are printed above. " << std::endl;
 
         throw;
     }
@@ -466,6 +843,7 @@ void dccl::Codec::unload(const google::protobuf::Descriptor* desc)
         if (it->second == desc)
         {
             erased++;
+            id2bits_.erase(it->first);
             id2desc_.erase(it++);
         }
         else
@@ -473,23 +851,43 @@ void dccl::Codec::unload(const google::protobuf::Descriptor* desc)
             it++;
         }
     }
+    desc2sizes_.erase(desc);
+    desc2id_.erase(desc);
     if (erased == 0)
     {
-        dlog.is(DEBUG1) && dlog << "Message " << desc->full_name()
-                                << ": is not loaded. Ignoring unload request." << std::endl;
+        DCCL_LOG_IS(DEBUG1, GENERAL) &&
+            dlog << "Message " << desc->full_name() << ": is not loaded. Ignoring unload request."
+                 << std::endl;
     }
 }
 
 void dccl::Codec::unload(size_t dccl_id)
 {
-    if (id2desc_.count(dccl_id))
+    auto it = id2desc_.find(dccl_id);
+    if (it != id2desc_.end())
     {
-        id2desc_.erase(dccl_id);
+        const google::protobuf::Descriptor* desc = it->second;
+        id2desc_.erase(it);
+        id2bits_.erase(dccl_id);
+
+        // keep the sizes if the message is still loaded under another id
+        bool still_loaded = false;
+        for (const auto& id_desc : id2desc_)
+        {
+            if (id_desc.second == desc)
+                still_loaded = true;
+        }
+        if (!still_loaded)
+        {
+            desc2sizes_.erase(desc);
+            desc2id_.erase(desc);
+        }
     }
     else
     {
-        dlog.is(DEBUG1) && dlog << "Message with id " << dccl_id
-                                << ": is not loaded. Ignoring unload request." << std::endl;
+        DCCL_LOG_IS(DEBUG1, GENERAL) &&
+            dlog << "Message with id " << dccl_id << ": is not loaded. Ignoring unload request."
+                 << std::endl;
         return;
     }
 }
@@ -513,45 +911,75 @@ unsigned dccl::Codec::size(const google::protobuf::Message& msg, int user_id /*
 
     const unsigned head_size_bytes = ceil_bits2bytes(head_size_bits);
     const unsigned body_size_bytes = ceil_bits2bytes(body_size_bits);
-    return head_size_bytes + body_size_bytes;
+    return head_size_bytes + body_size_bytes + auth_tag_bytes(dccl_id);
 }
 
 unsigned dccl::Codec::max_size(const google::protobuf::Descriptor* desc) const
 {
-    std::shared_ptr<FieldCodecBase> codec = manager_.find(desc);
+    const MessageSizes sizes = message_sizes(desc);
 
-    unsigned head_size_bits;
-    codec->base_max_size(&head_size_bits, desc, HEAD);
+    unsigned head_size_bits = sizes.head_max_bits;
 
     unsigned id_bits = 0;
     id_codec()->field_max_size(&id_bits, nullptr);
     head_size_bits += id_bits;
 
-    unsigned body_size_bits;
-    codec->base_max_size(&body_size_bits, desc, BODY);
+    unsigned body_size_bits = sizes.body_max_bits;
 
     const unsigned head_size_bytes = ceil_bits2bytes(head_size_bits);
     const unsigned body_size_bytes = ceil_bits2bytes(body_size_bits);
-    return head_size_bytes + body_size_bytes;
+    return head_size_bytes + body_size_bytes + auth_tag_bytes(id(desc));
 }
 
 unsigned dccl::Codec::min_size(const google::protobuf::Descriptor* desc) const
 {
-    std::shared_ptr<FieldCodecBase> codec = manager_.find(desc);
+    const MessageSizes sizes = message_sizes(desc);
 
-    unsigned head_size_bits;
-    codec->base_min_size(&head_size_bits, desc, HEAD);
+    unsigned head_size_bits = sizes.head_min_bits;
 
     unsigned id_bits = 0;
     id_codec()->field_min_size(&id_bits, nullptr);
     head_size_bits += id_bits;
 
-    unsigned body_size_bits;
-    codec->base_min_size(&body_size_bits, desc, BODY);
+    unsigned body_size_bits = sizes.body_min_bits;
 
     const unsigned head_size_bytes = ceil_bits2bytes(head_size_bits);
     const unsigned body_size_bytes = ceil_bits2bytes(body_size_bits);
-    return head_size_bytes + body_size_bytes;
+    return head_size_bytes + body_size_bytes + auth_tag_bytes(id(desc));
+}
+
+dccl::Codec::MessageSizes dccl::Codec::message_sizes(const google::protobuf::Descriptor* desc) const
+{
+    auto it = desc2sizes_.find(desc);
+    if (it != desc2sizes_.end() && it->second.revision == manager_.revision() &&
+        it->second.configuration_revision == manager_.configuration_revision() &&
+        !it->second.uses_state)
+        return it->second;
+
+    std::shared_ptr<FieldCodecBase> codec = manager_.find(desc);
+    if (!codec)
+        throw(Exception("Failed to find (dccl.msg).codec `" +
+                            desc->options().GetExtension(dccl::msg).codec() + "`",
+                        desc));
+
+    // the field codecs set this if any of the sizes depend on their state
+    internal::CodecData& codec_data = const_cast<FieldCodecManagerLocal&>(manager_).codec_data();
+    codec_data.size_uses_state_ = false;
+
+    MessageSizes sizes;
+    codec->base_max_size(&sizes.head_max_bits, desc, HEAD);
+    codec->base_max_size(&sizes.body_max_bits, desc, BODY);
+    codec->base_min_size(&sizes.head_min_bits, desc, HEAD);
+    codec->base_min_size(&sizes.body_min_bits, desc, BODY);
+    sizes.revision = manager_.revision();
+    sizes.configuration_revision = manager_.configuration_revision();
+    sizes.uses_state = codec_data.size_uses_state_;
+
+    // a codec was added or removed (or its configuration changed) since the message was loaded
+    if (it != desc2sizes_.end())
+        it->second = sizes;
+
+    return sizes;
 }
 
 void dccl::Codec::info(const google::protobuf::Descriptor* desc, std::ostream* param_os /*= 0 */,
@@ -563,15 +991,15 @@ void dccl::Codec::info(const google::protobuf::Descriptor* desc, std::ostream* p
     std::stringstream ss;
     std::ostream* os = (is_dlog) ? &ss : param_os;
 
-    if (!is_dlog || dlog.check(INFO))
+    if (!is_dlog || DCCL_LOG_CHECK(INFO))
     {
         try
         {
             std::shared_ptr<FieldCodecBase> codec = manager_.find(desc);
 
-            unsigned config_head_bit_size, body_bit_size;
-            codec->base_max_size(&config_head_bit_size, desc, HEAD);
-            codec->base_max_size(&body_bit_size, desc, BODY);
+            const MessageSizes sizes = message_sizes(desc);
+            unsigned config_head_bit_size = sizes.head_max_bits;
+            unsigned body_bit_size = sizes.body_max_bits;
 
             unsigned dccl_id = (user_id < 0) ? id(desc) : user_id;
             unsigned id_bit_size = 0;
@@ -632,11 +1060,11 @@ void dccl::Codec::info(const google::protobuf::Descriptor* desc, std::ostream* p
             os->flush();
 
             if (is_dlog)
-                dlog.is(INFO) && dlog << ss.str() << std::endl;
+                DCCL_LOG_IS(INFO, GENERAL) && dlog << ss.str() << std::endl;
         }
         catch (Exception& e)
         {
-            dlog.is(DEBUG1) &&
+            DCCL_LOG_IS(DEBUG1, GENERAL) &&
                 dlog << "Message " << desc->full_name()
                      << " cannot provide information due to invalid configuration. Reason: "
                      << e.what() << std::endl;
@@ -644,44 +1072,35 @@ void dccl::Codec::info(const google::protobuf::Descriptor* desc, std::ostream* p
     }
 }
 
-void dccl::Codec::encrypt(std::string* s, const std::string& nonce /* message head */)
+void dccl::Codec::crypt(std::uint8_t* body, std::size_t body_len,
+                        const std::uint8_t* nonce /* message head */, std::size_t nonce_len) const
 {
 #if DCCL_HAS_CRYPTOPP
     using namespace CryptoPP;
 
-    std::string iv;
-    SHA256 hash;
-    StringSource unused(nonce, true, new HashFilter(hash, new StringSink(iv)));
-
-    CTR_Mode<AES>::Encryption encryptor;
-    encryptor.SetKeyWithIV((byte*)crypto_key_.c_str(), crypto_key_.size(), (byte*)iv.c_str());
+    // AES in CTR mode (the same as CTR_Mode<AES>), using the start of the SHA256 hash of the
+    // nonce as the initial counter block
+    byte iv[SHA256::DIGESTSIZE];
+    SHA256().CalculateDigest(iv, nonce, nonce_len);
 
-    std::string cipher;
-    StreamTransformationFilter in(encryptor, new StringSink(cipher));
-    in.Put((byte*)s->c_str(), s->size());
-    in.MessageEnd();
-    *s = cipher;
-#endif
-}
+    byte counter[AES::BLOCKSIZE];
+    std::memcpy(counter, iv, AES::BLOCKSIZE);
 
-void dccl::Codec::decrypt(std::string* s, const std::string& nonce)
-{
-#if DCCL_HAS_CRYPTOPP
-    using namespace CryptoPP;
-
-    std::string iv;
-    SHA256 hash;
-    StringSource unused(nonce, true, new HashFilter(hash, new StringSink(iv)));
-
-    CTR_Mode<AES>::Decryption decryptor;
-    decryptor.SetKeyWithIV((byte*)crypto_key_.c_str(), crypto_key_.size(), (byte*)iv.c_str());
+    byte keystream[AES::BLOCKSIZE];
+    for (std::size_t pos = 0; pos < body_len; pos += AES::BLOCKSIZE)
+    {
+        crypto_key_->aes.ProcessBlock(counter, keystream);
 
-    std::string recovered;
+        std::size_t n = std::min<std::size_t>(AES::BLOCKSIZE, body_len - pos);
+        for (std::size_t i = 0; i < n; ++i) body[pos + i] ^= keystream[i];
 
-    StreamTransformationFilter out(decryptor, new StringSink(recovered));
-    out.Put((byte*)s->c_str(), s->size());
-    out.MessageEnd();
-    *s = recovered;
+        // increment the counter block as a big-endian integer
+        for (int i = AES::BLOCKSIZE - 1; i >= 0; --i)
+        {
+            if (++counter[i] != 0)
+                break;
+        }
+    }
 #endif
 }
 
@@ -717,25 +1136,174 @@ void dccl::Codec::unload_library(void* dl_handle)
         (*dccl_unload_ptr)(this);
 }
 
+void dccl::Codec::compile_dynamic_conditions(const google::protobuf::Descriptor* desc,
+                                             const google::protobuf::Descriptor* root_desc)
+{
+    DynamicConditions& dc = manager_.codec_data().dynamic_conditions_;
+    for (int i = 0, n = desc->field_count(); i < n; ++i)
+    {
+        const google::protobuf::FieldDescriptor* field_desc = desc->field(i);
+        const dccl::DCCLFieldOptions& field_options =
+            field_desc->options().GetExtension(dccl::field);
+        if (field_options.omit())
+            continue;
+
+        if (field_options.has_dynamic_conditions())
+        {
+            dc.set_field(field_desc);
+            dc.compile(root_desc);
+        }
+
+        // recursive messages are not supported by DCCL (and fail validation before this)
+        if (field_desc->cpp_type() == google::protobuf::FieldDescriptor::CPPTYPE_MESSAGE)
+            compile_dynamic_conditions(field_desc->message_type(), root_desc);
+    }
+}
+
+unsigned dccl::Codec::max_encoded_bytes(const MessageSizes& sizes, unsigned dccl_id,
+                                        unsigned tag_bytes) const
+{
+    unsigned id_bits = 0;
+    id_codec()->field_size(&id_bits, dccl_id, nullptr);
+
+    return ceil_bits2bytes(sizes.head_max_bits + id_bits) + ceil_bits2bytes(sizes.body_max_bits) +
+           tag_bytes;
+}
+
+unsigned dccl::Codec::auth_tag_bytes(unsigned dccl_id) const
+{
+    if (!crypto_key_ || skip_crypto_ids_.count(dccl_id))
+        return 0;
+    else
+        return crypto_key_->tag_bytes;
+}
+
+void dccl::Codec::authenticate(const std::uint8_t* bytes, std::size_t len, std::uint8_t* tag,
+                               unsigned tag_len) const
+{
+#if DCCL_HAS_CRYPTOPP
+    using namespace CryptoPP;
+
+    // AES-CMAC (RFC 4493) using the key schedule and subkeys prepared in
+    // set_crypto_passphrase(), with all per-message state on the stack so that const Codecs can
+    // authenticate concurrently
+    const CryptoKey& key = *crypto_key_;
+
+    // CBC-MAC of all but the last block
+    byte x[AES::BLOCKSIZE] = {0};
+    std::size_t pos = 0;
+    for (; len - pos > AES::BLOCKSIZE; pos += AES::BLOCKSIZE)
+    {
+        for (unsigned i = 0; i < AES::BLOCKSIZE; ++i) x[i] ^= bytes[pos + i];
+        key.mac_aes.ProcessBlock(x);
+    }
+
+    // the last block is masked with K1 if complete, otherwise padded and masked with K2
+    const std::size_t last_len = len - pos;
+    const byte* subkey = (last_len == AES::BLOCKSIZE) ? key.mac_k1 : key.mac_k2;
+    for (unsigned i = 0; i < AES::BLOCKSIZE; ++i)
+    {
+        byte m = (i < last_len) ? bytes[pos + i] : (i == last_len ? 0x80 : 0x00);
+        x[i] ^= m ^ subkey[i];
+    }
+    key.mac_aes.ProcessBlock(x);
+
+    std::memcpy(tag, x, tag_len);
+#endif
+}
+
+bool dccl::Codec::check_auth_tag(const std::uint8_t* bytes, std::size_t len,
+                                 unsigned tag_bytes) const
+{
+    std::uint8_t tag[max_auth_tag_bytes];
+    authenticate(bytes, len, tag, tag_bytes);
+
+    // compare all the bytes to avoid leaking the position of the first difference
+    std::uint8_t diff = 0;
+    for (unsigned i = 0; i < tag_bytes; ++i) diff |= tag[i] ^ bytes[len + i];
+    return diff == 0;
+}
+
 void dccl::Codec::set_crypto_passphrase(
     const std::string& passphrase,
-    const std::set<unsigned>& do_not_encrypt_ids_ /*= std::set<unsigned>()*/)
+    const std::set<unsigned>& do_not_encrypt_ids_ /*= std::set<unsigned>()*/,
+    unsigned authentication_tag_bits /*= 0*/)
 {
-    if (!crypto_key_.empty())
-        crypto_key_.clear();
+    if (authentication_tag_bits % BITS_IN_BYTE ||
+        authentication_tag_bits > max_auth_tag_bytes * BITS_IN_BYTE)
+        throw(Exception("Invalid authentication_tag_bits (" +
+                        std::to_string(authentication_tag_bits) +
+                        "): must be a multiple of 8 no larger than 128"));
+
+#if DCCL_HAS_CRYPTOPP
+    const unsigned tag_bytes = authentication_tag_bits / BITS_IN_BYTE;
+
+    // make sure the messages already loaded still fit with the tag added
+    if (tag_bytes)
+    {
+        for (const auto& id_desc_pair : id2desc_)
+        {
+            if (do_not_encrypt_ids_.count(id_desc_pair.first))
+                continue;
+
+            const google::protobuf::Descriptor* desc = id_desc_pair.second;
+            const unsigned actual_max =
+                max_encoded_bytes(message_sizes(desc), id_desc_pair.first, tag_bytes);
+            const unsigned allowed_max = desc->options().GetExtension(dccl::msg).max_bytes();
+            if (actual_max > allowed_max)
+                throw(Exception("Actual maximum size of message with authentication tag (" +
+                                    std::to_string(actual_max) +
+                                    "B) exceeds allowed maximum (" +
+                                    std::to_string(allowed_max) + "B)",
+                                desc));
+        }
+    }
+#endif
+
+    crypto_key_.reset();
     skip_crypto_ids_.clear();
 
 #if DCCL_HAS_CRYPTOPP
     using namespace CryptoPP;
 
-    SHA256 hash;
-    StringSource unused(passphrase, true, new HashFilter(hash, new StringSink(crypto_key_)));
-
-    dlog.is(DEBUG1) && dlog << "Cryptography enabled with given passphrase" << std::endl;
+    byte key[SHA256::DIGESTSIZE];
+    SHA256().CalculateDigest(key, reinterpret_cast<const byte*>(passphrase.data()),
+                             passphrase.size());
+    auto crypto_key = std::make_shared<CryptoKey>();
+    crypto_key->aes.SetKey(key, sizeof(key));
+
+    // separate key for authentication, derived from the encryption key
+    byte mac_key[SHA256::DIGESTSIZE];
+    SHA256().CalculateDigest(mac_key, key, sizeof(key));
+    crypto_key->mac_aes.SetKey(mac_key, sizeof(mac_key));
+
+    // CMAC subkeys (RFC 4493 section 2.3): K1 = L << 1 and K2 = K1 << 1 with L = AES(0), each
+    // reduced by 0x87 when a bit is shifted out
+    byte l[AES::BLOCKSIZE] = {0};
+    crypto_key->mac_aes.ProcessBlock(l);
+    auto double_block = [](const byte* in, byte* out) {
+        for (unsigned i = 0; i < AES::BLOCKSIZE; ++i)
+            out[i] = (in[i] << 1) | ((i + 1 < AES::BLOCKSIZE) ? (in[i + 1] >> 7) : 0);
+        if (in[0] & 0x80)
+            out[AES::BLOCKSIZE - 1] ^= 0x87;
+    };
+    double_block(l, crypto_key->mac_k1);
+    double_block(crypto_key->mac_k1, crypto_key->mac_k2);
+
+    crypto_key->tag_bytes = tag_bytes;
+    crypto_key_ = crypto_key;
+
+    DCCL_LOG_IS(DEBUG1, GENERAL) &&
+        dlog << "Cryptography enabled with given passphrase"
+             << (tag_bytes ? " and " + std::to_string(authentication_tag_bits) +
+                                 " bit authentication tag"
+                           : std::string())
+             << std::endl;
 #else
-    dlog.is(DEBUG1) && dlog << "Cryptography disabled because DCCL was compiled without support of "
-                               "Crypto++. Install Crypto++ and recompile to enable cryptography."
-                            << std::endl;
+    DCCL_LOG_IS(DEBUG1, GENERAL) &&
+        dlog << "Cryptography disabled because DCCL was compiled without support of Crypto++. "
+                "Install Crypto++ and recompile to enable cryptography."
+             << std::endl;
 #endif
 
     skip_crypto_ids_ = do_not_encrypt_ids_;
@@ -748,7 +1316,7 @@ void dccl::Codec::info_all(std::ostream* param_os /*= 0 */) const
         is_dlog = true;
     std::stringstream ss;
     std::ostream* os = (is_dlog) ? &ss : param_os;
-    if (!is_dlog || dlog.check(INFO))
+    if (!is_dlog || DCCL_LOG_CHECK(INFO))
     {
         std::string codec_str = "Dynamic Compact Control Language (DCCL) Codec";
         std::string codec_guard = build_guard_for_console_output(codec_str, '|');
@@ -762,7 +1330,7 @@ void dccl::Codec::info_all(std::ostream* param_os /*= 0 */) const
         os->flush();
 
         if (is_dlog)
-            dlog.is(INFO) && dlog << ss.str() << std::endl;
+            DCCL_LOG_IS(INFO, GENERAL) && dlog << ss.str() << std::endl;
     }
 }
 
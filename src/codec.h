@@ -33,6 +33,7 @@
 #include <stdexcept>
 #include <string>
 #include <type_traits>
+#include <unordered_map>
 #include <vector>
 
 #include <google/protobuf/descriptor.h>
@@ -123,7 +124,13 @@ class Codec
     /// \tparam ProtobufMessage Any Google Protobuf Message generated by protoc (i.e. subclass of google::protobuf::Message)
     template <typename ProtobufMessage> void unload() { unload(ProtobufMessage::descriptor()); }
 
-    void unload_all() { id2desc_.clear(); }
+    void unload_all()
+    {
+        id2desc_.clear();
+        desc2sizes_.clear();
+        desc2id_.clear();
+        id2bits_.clear();
+    }
 
     /// \brief An alterative form for loading and validating messages for message types <i>not</i> known at compile-time ("dynamic").
     ///
@@ -154,9 +161,11 @@ class Codec
     /// Encryption is performed using AES via the opertional Crypto++ library. If this library is not compiled in, no encryption will be performed.
     /// \param passphrase Plain-text passphrase
     /// \param do_not_encrypt_ids_ Optional set of DCCL ids for which to skip encrypting or decrypting
-    void
-    set_crypto_passphrase(const std::string& passphrase,
-                          const std::set<unsigned>& do_not_encrypt_ids_ = std::set<unsigned>());
+    /// \param authentication_tag_bits If non-zero, append an AES-CMAC of the encrypted message truncated to this many bits (a multiple of 8, up to 128) to each encrypted message. Decoding throws a dccl::Exception if the tag does not match, before any fields are decoded. The tag is included in size(), max_size(), min_size() and must fit within (dccl.msg).max_bytes. The tag is computed over the entire encoded message and checked at the end of the bytes given to decode(), so authenticated messages cannot be concatenated: decode each one separately.
+    /// \throw dccl::Exception if authentication_tag_bits is invalid or a loaded message would exceed its (dccl.msg).max_bytes with the tag added
+    void set_crypto_passphrase(const std::string& passphrase,
+                               const std::set<unsigned>& do_not_encrypt_ids_ = std::set<unsigned>(),
+                               unsigned authentication_tag_bits = 0);
 
     /// \brief Set "strict" mode where a dccl::OutOfRangeException will be thrown for encode if the value(s) provided are out of range
     ///
@@ -232,18 +241,17 @@ class Codec
     /// \brief Provides the DCCL ID given a DCCL type.
     template <typename CharIterator> unsigned id(CharIterator begin, CharIterator end) const;
 
+    /// \brief Get the DCCL ID of an unknown encoded DCCL message held in a byte buffer.
+    ///
+    /// \param bytes Start of the encoded message
+    /// \param len Length of the encoded message (bytes)
+    /// \return DCCL ID
+    unsigned id(const std::uint8_t* bytes, std::size_t len) const;
+
     /// \brief Provides the DCCL ID given a DCCL type.
-    unsigned id(const google::protobuf::Descriptor* desc) const
-    {
-        Bitset id_bits;
-        dccl::uint32 hardcoded_id = desc->options().GetExtension(dccl::msg).id();
-        // pass the hard coded id, that is, (dccl.msg).id,
-        // through encode/decode to allow a custom ID codec (if in use)
-        // to always take effect.
-        id_codec()->field_encode(&id_bits, hardcoded_id, nullptr);
-        std::string id_bytes(id_bits.to_byte_string());
-        return id(id_bytes);
-    }
+    ///
+    /// For loaded messages this is a lookup of the value computed by load().
+    unsigned id(const google::protobuf::Descriptor* desc) const;
 
     /// \brief Provides a map of all loaded DCCL IDs to the equivalent Protobuf descriptor
     const std::map<int32, const google::protobuf::Descriptor*>& loaded() const { return id2desc_; }
@@ -291,6 +299,17 @@ class Codec
     CharIterator decode(CharIterator begin, CharIterator end, google::protobuf::Message* msg,
                         bool header_only = false);
 
+    /// \brief Decode a DCCL message held in a byte buffer, reading the fields directly from the buffer (without copying it).
+    ///
+    /// \param bytes Start of the encoded message to decode (must already have been validated)
+    /// \param len Length of the buffer (bytes). This may be longer than the message.
+    /// \param msg Pointer to any Google Protobuf Message generated by protoc (i.e. subclass of google::protobuf::Message). The decoded message will be written here.
+    /// \param header_only If true, only decode the header (do not try to decrypt (if applicable) and decode the message body)
+    /// \throw Exception if message cannot be decoded.
+    /// \return Number of bytes used by the message, so the next message can be decoded starting at bytes + the returned value
+    std::size_t decode(const std::uint8_t* bytes, std::size_t len, google::protobuf::Message* msg,
+                       bool header_only = false);
+
     /// \brief Decode a DCCL message when the type is known at compile time.
     ///
     /// \param bytes encoded message to decode (must already have been validated)
@@ -325,6 +344,44 @@ class Codec
     template <typename GoogleProtobufMessagePointer>
     GoogleProtobufMessagePointer decode(std::string* bytes);
 
+    /// \brief Outcome of encoding or decoding one message of a batch
+    struct BatchResult
+    {
+        /// \brief DCCL ID of the message (0 if it could not be determined)
+        unsigned id{0};
+        /// \brief Start of the encoded message in the output (encode_batch() only)
+        std::size_t offset{0};
+        /// \brief Size of the encoded message (bytes)
+        std::size_t size{0};
+        /// \brief Decoded message (decode_batch() only)
+        std::shared_ptr<google::protobuf::Message> msg;
+        /// \brief Reason the message could not be encoded or decoded (empty on success)
+        std::string error;
+
+        bool ok() const { return error.empty(); }
+    };
+
+    /// \brief Encodes a batch of DCCL messages back to back.
+    ///
+    /// Gives the same bytes as calling encode() on each message in turn, but the lookups that depend only on the message type are done once per type for the whole batch. A message that cannot be encoded does not stop the rest of the batch: its reason is given in the corresponding BatchResult and nothing is written for it.
+    /// \param msgs Messages to encode (each must already have been loaded)
+    /// \param count Number of messages
+    /// \param bytes Encoded messages are appended to this string (which is grown once to fit the batch)
+    /// \param results Set to one result per message, in the same order as msgs
+    /// \return Number of messages successfully encoded
+    std::size_t encode_batch(const google::protobuf::Message* const* msgs, std::size_t count,
+                             std::string* bytes, std::vector<BatchResult>* results);
+
+    /// \brief Decodes a batch of DCCL messages of any loaded type.
+    ///
+    /// The frames are grouped by DCCL ID so that the lookups for each message type (and the creation of the message from its prototype) are done once per type. A frame that cannot be decoded does not stop the rest of the batch: its reason is given in the corresponding BatchResult.
+    /// \param frames Encoded messages, one per frame
+    /// \param count Number of frames
+    /// \param results Set to one result per frame, in the same order as frames
+    /// \return Number of messages successfully decoded
+    std::size_t decode_batch(const std::string* frames, std::size_t count,
+                             std::vector<BatchResult>* results);
+
     /// \brief Provides the encoded size (in bytes) of msg. This is useful if you need to know the size of a message before encoding it (encoding it is generally much more expensive than calling this method)
     ///
     /// \param msg Google Protobuf message with DCCL extensions for which the encoded size is requested
@@ -376,13 +433,37 @@ class Codec
     FieldCodecManagerLocal& manager() { return manager_; }
 
   private:
-    void encode_internal(const google::protobuf::Message& msg, bool header_only,
-                         Bitset& header_bits, Bitset& body_bits, int user_id);
+    size_t encode_internal(const google::protobuf::Message& msg, bool header_only,
+                           BitWriter* writer, int user_id);
+    // encodes a message whose id and codec have already been found
+    size_t encode_message(const google::protobuf::Message& msg, unsigned dccl_id,
+                          FieldCodecBase* codec, bool header_only, BitWriter* writer);
+    // decodes a message whose id and codec have already been found
+    std::size_t decode_message(const std::uint8_t* bytes, std::size_t len,
+                               google::protobuf::Message* msg, bool header_only, unsigned this_id,
+                               FieldCodecBase* codec);
     std::string get_all_error_fields_in_message(const google::protobuf::Message& msg,
                                                 uint8_t depth = 1);
 
-    void encrypt(std::string* s, const std::string& nonce);
-    void decrypt(std::string* s, const std::string& nonce);
+    // encrypts or decrypts (the same operation in CTR mode) the body in place
+    void crypt(std::uint8_t* body, std::size_t body_len, const std::uint8_t* nonce,
+               std::size_t nonce_len) const;
+
+    // compiles the dynamic conditions of all the fields of desc (and its embedded messages)
+    void compile_dynamic_conditions(const google::protobuf::Descriptor* desc,
+                                    const google::protobuf::Descriptor* root_desc);
+
+    // length of the authentication tag appended to messages with this id (0 if none)
+    unsigned auth_tag_bytes(unsigned dccl_id) const;
+    // writes the first tag_len bytes of the AES-CMAC of bytes to tag
+    void authenticate(const std::uint8_t* bytes, std::size_t len, std::uint8_t* tag,
+                      unsigned tag_len) const;
+    // true if the tag_bytes following the first len bytes are the authentication tag of those
+    bool check_auth_tag(const std::uint8_t* bytes, std::size_t len, unsigned tag_bytes) const;
+    enum
+    {
+        max_auth_tag_bytes = 16
+    };
 
     void set_default_codecs();
 
@@ -391,9 +472,47 @@ class Codec
         return manager_.find(google::protobuf::FieldDescriptor::TYPE_UINT32, id_codec_);
     }
 
+    // maximum and minimum sizes of the user head and body (not including the dccl id)
+    struct MessageSizes
+    {
+        unsigned head_max_bits{0};
+        unsigned body_max_bits{0};
+        unsigned head_min_bits{0};
+        unsigned body_min_bits{0};
+        // manager_.revision() and manager_.configuration_revision() when these were computed
+        unsigned revision{0};
+        unsigned configuration_revision{0};
+        // depend on codec specific state (see CodecData::size_uses_state_), so not cacheable
+        bool uses_state{false};
+    };
+
+    // cached sizes for loaded messages, computed from the field codecs otherwise
+    MessageSizes message_sizes(const google::protobuf::Descriptor* desc) const;
+    // maximum encoded size in bytes, including the dccl_id and an authentication tag of tag_bytes
+    unsigned max_encoded_bytes(const MessageSizes& sizes, unsigned dccl_id,
+                               unsigned tag_bytes) const;
+
+    struct MessageId
+    {
+        unsigned id{0};
+        // manager_.revision() when this was computed
+        unsigned revision{0};
+    };
+
+    struct EncodedId
+    {
+        Bitset bits;
+        // manager_.revision() when this was computed
+        unsigned revision{0};
+    };
+
+    // (dccl.msg).id passed through the id codec (and back)
+    unsigned compute_id(const google::protobuf::Descriptor* desc) const;
+
   private:
-    // SHA256 hash of the crypto passphrase
-    std::string crypto_key_;
+    // AES key from the SHA256 hash of the crypto passphrase (null if not encrypting)
+    struct CryptoKey;
+    std::shared_ptr<const CryptoKey> crypto_key_;
 
     // strict mode setting
     bool strict_{false};
@@ -406,6 +525,12 @@ class Codec
 
     // maps `dccl.id`s onto Message Descriptors
     std::map<int32, const google::protobuf::Descriptor*> id2desc_;
+    // sizes of the loaded messages, computed in load()
+    mutable std::map<const google::protobuf::Descriptor*, MessageSizes> desc2sizes_;
+    // ids of the loaded messages (from (dccl.msg).id), computed in load()
+    std::unordered_map<const google::protobuf::Descriptor*, MessageId> desc2id_;
+    // encoded identifier of each loaded `dccl.id`, computed in load()
+    std::unordered_map<int32, EncodedId> id2bits_;
     std::string id_codec_;
 
     std::vector<void*> dl_handles_;
@@ -415,6 +540,34 @@ class Codec
     FieldCodecManagerLocal manager_;
 };
 
+/// \brief Per-thread state for using one Codec from more than one thread at once.
+///
+/// Once its messages are loaded, a Codec is a compiled schema (the loaded messages, their resolved field codecs and sizes) that is only read when encoding and decoding. The state that the field codecs need while encoding or decoding a message is kept separately: in the Codec itself, or, while a CodecSession for the Codec exists on the calling thread, in that session. To share one Codec between threads without locking, load the messages (and add any codecs or arithmetic models) first, then give each thread its own CodecSession:
+/// \code
+/// dccl::Codec codec;
+/// codec.load<MyMessage>();
+/// // on each thread
+/// dccl::CodecSession session(codec);
+/// codec.encode(&bytes, msg);
+/// \endcode
+/// The Codec must not be modified (load(), unload(), set_id_codec(), set_crypto_passphrase(), adding or removing codecs, ...) while it is shared, and a CodecSession must be destroyed on the thread that created it.
+class CodecSession
+{
+  public:
+    explicit CodecSession(Codec& codec) : manager_(codec.manager())
+    {
+        manager_.begin_session(&data_);
+    }
+    ~CodecSession() { manager_.end_session(&data_); }
+
+    CodecSession(const CodecSession&) = delete;
+    CodecSession& operator=(const CodecSession&) = delete;
+
+  private:
+    FieldCodecManagerLocal& manager_;
+    internal::CodecData data_;
+};
+
 inline std::ostream& operator<<(std::ostream& os, const Codec& codec)
 {
     codec.info_all(&os);
@@ -451,162 +604,31 @@ GoogleProtobufMessagePointer dccl::Codec::decode(std::string* bytes)
     GoogleProtobufMessagePointer msg =
         dccl::DynamicProtobufManager::new_protobuf_message<GoogleProtobufMessagePointer>(
             id2desc_.find(this_id)->second);
-    std::string::iterator new_begin = decode(bytes->begin(), bytes->end(), &(*msg));
-    bytes->erase(bytes->begin(), new_begin);
+    bytes->erase(0, decode(reinterpret_cast<const std::uint8_t*>(bytes->data()), bytes->size(),
+                           &(*msg)));
     return msg;
 }
 
 template <typename CharIterator>
 unsigned dccl::Codec::id(CharIterator begin, CharIterator end) const
 {
-    unsigned id_min_size = 0, id_max_size = 0;
-    id_codec()->field_min_size(&id_min_size, nullptr);
+    unsigned id_max_size = 0;
     id_codec()->field_max_size(&id_max_size, nullptr);
 
-    if (std::distance(begin, end) < (id_min_size / BITS_IN_BYTE))
-        throw(Exception("Bytes passed (hex: " + hex_encode(begin, end) +
-                        ") is too small to be a valid DCCL message"));
-
-    Bitset fixed_header_bits;
-    fixed_header_bits.from_byte_stream(
-        begin, begin + (size_t)std::ceil(double(id_max_size) / BITS_IN_BYTE));
-
-    Bitset these_bits(&fixed_header_bits);
-    these_bits.get_more_bits(id_min_size);
-
-    dccl::any return_value;
-    id_codec()->field_decode(&these_bits, &return_value, nullptr);
-
-    return dccl::any_cast<uint32>(return_value);
+    // only the bytes that may hold the ID are needed
+    std::ptrdiff_t id_max_bytes = ceil_bits2bytes(id_max_size);
+    std::string id_bytes(begin, begin + std::min(std::distance(begin, end), id_max_bytes));
+    return id(reinterpret_cast<const std::uint8_t*>(id_bytes.data()), id_bytes.size());
 }
 
 template <typename CharIterator>
 CharIterator dccl::Codec::decode(CharIterator begin, CharIterator end,
                                  google::protobuf::Message* msg, bool header_only /*= false*/)
 {
-    try
-    {
-        unsigned this_id = id(begin, end);
-
-        dlog.is(logger::DEBUG1, logger::DECODE) &&
-            dlog << "Began decoding message of id: " << this_id << std::endl;
-
-        if (!id2desc_.count(this_id))
-            throw(Exception("Message id " + std::to_string(this_id) +
-                            " has not been loaded. Call load() before decoding this type."));
-
-        const google::protobuf::Descriptor* desc = msg->GetDescriptor();
-
-        dlog.is(logger::DEBUG1, logger::DECODE) && dlog << "Type name: " << desc->full_name()
-                                                        << std::endl;
-
-        std::shared_ptr<FieldCodecBase> codec = manager_.find(desc);
-        std::shared_ptr<internal::FromProtoCppTypeBase> helper = manager_.type_helper().find(desc);
-
-        CharIterator actual_end = end;
-        if (codec)
-        {
-            unsigned head_size_bits;
-            unsigned body_size_bits;
-            codec->base_max_size(&head_size_bits, desc, HEAD);
-            codec->base_max_size(&body_size_bits, desc, BODY);
-            unsigned id_size = 0;
-            id_codec()->field_size(&id_size, this_id, nullptr);
-            head_size_bits += id_size;
-
-            unsigned head_size_bytes = ceil_bits2bytes(head_size_bits);
-            unsigned body_size_bytes = ceil_bits2bytes(body_size_bits);
-
-            dlog.is(logger::DEBUG2, logger::DECODE) &&
-                dlog << "Head bytes (bits): " << head_size_bytes << "(" << head_size_bits
-                     << "), max body bytes (bits): " << body_size_bytes << "(" << body_size_bits
-                     << ")" << std::endl;
-
-            CharIterator head_bytes_end = begin + head_size_bytes;
-            dlog.is(logger::DEBUG3, logger::DECODE) &&
-                dlog << "Unencrypted Head (hex): " << hex_encode(begin, head_bytes_end)
-                     << std::endl;
-
-            Bitset head_bits;
-            head_bits.from_byte_stream(begin, head_bytes_end);
-            dlog.is(logger::DEBUG3, logger::DECODE) &&
-                dlog << "Unencrypted Head (bin): " << head_bits << std::endl;
-
-            // shift off ID bits
-            head_bits >>= id_size;
-
-            dlog.is(logger::DEBUG3, logger::DECODE) &&
-                dlog << "Unencrypted Head after ID bits removal (bin): " << head_bits << std::endl;
-
-            internal::MessageStack msg_stack(manager_.codec_data().root_message_,
-                                             manager_.codec_data().message_data_);
-            msg_stack.push(msg->GetDescriptor());
-
-            codec->base_decode(&head_bits, msg, HEAD);
-            dlog.is(logger::DEBUG2, logger::DECODE) &&
-                dlog << "after header decode, message is: " << *msg << std::endl;
-
-            if (header_only)
-            {
-                dlog.is(logger::DEBUG2, logger::DECODE) &&
-                    dlog << "as requested, skipping decrypting and decoding body." << std::endl;
-                actual_end = head_bytes_end;
-            }
-            else
-            {
-                dlog.is(logger::DEBUG3, logger::DECODE) &&
-                    dlog << "Encrypted Body (hex): " << hex_encode(head_bytes_end, end)
-                         << std::endl;
-
-                Bitset body_bits;
-                if (!crypto_key_.empty() && !skip_crypto_ids_.count(this_id))
-                {
-                    std::string head_bytes(begin, head_bytes_end);
-                    std::string body_bytes(head_bytes_end, end);
-                    decrypt(&body_bytes, head_bytes);
-                    dlog.is(logger::DEBUG3, logger::DECODE) &&
-                        dlog << "Unencrypted Body (hex): " << hex_encode(body_bytes) << std::endl;
-                    body_bits.from_byte_stream(body_bytes.begin(), body_bytes.end());
-                }
-                else
-                {
-                    dlog.is(logger::DEBUG3, logger::DECODE) &&
-                        dlog << "Unencrypted Body (hex): " << hex_encode(head_bytes_end, end)
-                             << std::endl;
-                    body_bits.from_byte_stream(head_bytes_end, end);
-                }
-
-                dlog.is(logger::DEBUG3, logger::DECODE) &&
-                    dlog << "Unencrypted Body (bin): " << body_bits << std::endl;
-
-                codec->base_decode(&body_bits, msg, BODY);
-                dlog.is(logger::DEBUG2, logger::DECODE) &&
-                    dlog << "after header & body decode, message is: " << *msg << std::endl;
-
-                actual_end = end - body_bits.size() / BITS_IN_BYTE;
-            }
-        }
-        else
-        {
-            throw(Exception("Failed to find (dccl.msg).codec `" +
-                            desc->options().GetExtension(dccl::msg).codec() + "`"),
-                  desc);
-        }
-
-        dlog.is(logger::DEBUG1, logger::DECODE) &&
-            dlog << "Successfully decoded message of type: " << desc->full_name() << std::endl;
-        return actual_end;
-    }
-    catch (std::exception& e)
-    {
-        std::stringstream ss;
-
-        ss << "Message " << hex_encode(begin, end) << " failed to decode. Reason: " << e.what()
-           << std::endl;
-
-        dlog.is(logger::DEBUG1, logger::DECODE) && dlog << ss.str() << std::endl;
-        throw(Exception(ss.str()));
-    }
+    // BitReader requires contiguous bytes
+    std::string bytes(begin, end);
+    return begin + decode(reinterpret_cast<const std::uint8_t*>(bytes.data()), bytes.size(), msg,
+                          header_only);
 }
 
 #endif
@@ -41,9 +41,22 @@ dccl::Bitset dccl::v2::DefaultBoolCodec::encode(const bool& wire_value)
     return Bitset(size(), use_required() ? wire_value : wire_value + 1);
 }
 
-bool dccl::v2::DefaultBoolCodec::decode(Bitset* bits)
+void dccl::v2::DefaultBoolCodec::encode(BitWriter* writer) { writer->append(0, size()); }
+
+void dccl::v2::DefaultBoolCodec::encode(BitWriter* writer, const bool& wire_value)
+{
+    writer->append(use_required() ? wire_value : wire_value + 1, size());
+}
+
+bool dccl::v2::DefaultBoolCodec::decode(Bitset* bits) { return decode_value(bits->to_ulong()); }
+
+bool dccl::v2::DefaultBoolCodec::decode(BitReader* reader)
+{
+    return decode_value(reader->read(size()));
+}
+
+bool dccl::v2::DefaultBoolCodec::decode_value(unsigned long t)
 {
-    unsigned long t = bits->to_ulong();
     if (use_required())
     {
         return t;
@@ -79,37 +92,40 @@ dccl::Bitset dccl::v2::DefaultStringCodec::encode() { return Bitset(min_size());
 
 dccl::Bitset dccl::v2::DefaultStringCodec::encode(const std::string& wire_value)
 {
-    std::string s = wire_value;
-    if (s.size() > dccl_field_options().max_length())
+    Bitset bits;
+    BitWriter writer(&bits);
+    encode(&writer, wire_value);
+
+    DCCL_LOG_IS(DEBUG2, GENERAL) &&
+        dccl::dlog << "DefaultStringCodec created: " << bits << std::endl;
+
+    return bits;
+}
+
+void dccl::v2::DefaultStringCodec::encode(BitWriter* writer) { writer->append(0, min_size()); }
+
+void dccl::v2::DefaultStringCodec::encode(BitWriter* writer, const std::string& wire_value)
+{
+    std::string::size_type length = wire_value.size();
+    if (length > dccl_field_options().max_length())
     {
         if (this->strict())
             throw(dccl::OutOfRangeException(std::string("String too long for field: ") +
                                                 FieldCodecBase::this_field()->DebugString(),
                                             this->this_field(), this->this_descriptor()));
 
-        dccl::dlog.is(DEBUG2) &&
-            dccl::dlog << "String " << s << " exceeds `dccl.max_length`, truncating" << std::endl;
-        s.resize(dccl_field_options().max_length());
+        DCCL_LOG_IS(DEBUG2, GENERAL) &&
+            dccl::dlog << "String " << wire_value << " exceeds `dccl.max_length`, truncating"
+                       << std::endl;
+        length = dccl_field_options().max_length();
     }
 
-    Bitset value_bits;
-    value_bits.from_byte_string(s);
-
-    Bitset length_bits(min_size(), s.length());
-
-    dccl::dlog.is(DEBUG2) && dccl::dlog << "DefaultStringCodec value_bits: " << value_bits
-                                        << std::endl;
+    DCCL_LOG_IS(DEBUG2, GENERAL) &&
+        dccl::dlog << "DefaultStringCodec length: " << length << std::endl;
 
-    dccl::dlog.is(DEBUG2) && dccl::dlog << "DefaultStringCodec length_bits: " << length_bits
-                                        << std::endl;
-
-    // adds to MSBs
-    for (int i = 0, n = value_bits.size(); i < n; ++i) length_bits.push_back(value_bits[i]);
-
-    dccl::dlog.is(DEBUG2) && dccl::dlog << "DefaultStringCodec created: " << length_bits
-                                        << std::endl;
-
-    return length_bits;
+    // length, then the string itself in the MSBs
+    writer->append(length, min_size());
+    writer->append_bytes(wire_value.data(), length);
 }
 
 std::string dccl::v2::DefaultStringCodec::decode(Bitset* bits)
@@ -120,15 +136,17 @@ std::string dccl::v2::DefaultStringCodec::decode(Bitset* bits)
     {
         unsigned header_length = min_size();
 
-        dccl::dlog.is(DEBUG2) && dccl::dlog << "Length of string is = " << value_length
-                                            << std::endl;
+        DCCL_LOG_IS(DEBUG2, GENERAL) &&
+            dccl::dlog << "Length of string is = " << value_length << std::endl;
 
-        dccl::dlog.is(DEBUG2) && dccl::dlog << "bits before get_more_bits " << *bits << std::endl;
+        DCCL_LOG_IS(DEBUG2, GENERAL) &&
+            dccl::dlog << "bits before get_more_bits " << *bits << std::endl;
 
         // grabs more bits to add to the MSBs of `bits`
         bits->get_more_bits(value_length * BITS_IN_BYTE);
 
-        dccl::dlog.is(DEBUG2) && dccl::dlog << "bits after get_more_bits " << *bits << std::endl;
+        DCCL_LOG_IS(DEBUG2, GENERAL) &&
+            dccl::dlog << "bits after get_more_bits " << *bits << std::endl;
         Bitset string_body_bits = *bits;
         string_body_bits >>= header_length;
         string_body_bits.resize(bits->size() - header_length);
@@ -141,6 +159,25 @@ std::string dccl::v2::DefaultStringCodec::decode(Bitset* bits)
     }
 }
 
+std::string dccl::v2::DefaultStringCodec::decode(BitReader* reader)
+{
+    unsigned value_length = reader->read(min_size());
+
+    if (value_length)
+    {
+        DCCL_LOG_IS(DEBUG2, GENERAL) &&
+            dccl::dlog << "Length of string is = " << value_length << std::endl;
+
+        std::string value;
+        reader->read_bytes(&value, value_length);
+        return value;
+    }
+    else
+    {
+        throw NullValueException();
+    }
+}
+
 unsigned dccl::v2::DefaultStringCodec::size() { return min_size(); }
 
 unsigned dccl::v2::DefaultStringCodec::size(const std::string& wire_value)
@@ -173,22 +210,28 @@ dccl::Bitset dccl::v2::DefaultBytesCodec::encode() { return Bitset(min_size(), 0
 dccl::Bitset dccl::v2::DefaultBytesCodec::encode(const std::string& wire_value)
 {
     Bitset bits;
-    bits.from_byte_string(wire_value);
+    BitWriter writer(&bits);
+    encode(&writer, wire_value);
+    return bits;
+}
 
-    if (bits.size() > max_size() && this->strict())
+void dccl::v2::DefaultBytesCodec::encode(BitWriter* writer) { writer->append(0, min_size()); }
+
+void dccl::v2::DefaultBytesCodec::encode(BitWriter* writer, const std::string& wire_value)
+{
+    if (wire_value.size() * BITS_IN_BYTE > max_size() && this->strict())
         throw(dccl::OutOfRangeException(std::string("Bytes too long for field: ") +
                                             FieldCodecBase::this_field()->DebugString(),
                                         this->this_field(), this->this_descriptor()));
 
-    bits.resize(max_size());
-
     if (!use_required())
-    {
-        bits <<= 1;
-        bits.set(0, true); // presence bit
-    }
+        writer->append(1, 1); // presence bit
 
-    return bits;
+    // truncate or zero pad to max_length
+    std::string::size_type max_length = dccl_field_options().max_length();
+    std::string::size_type length = std::min(wire_value.size(), max_length);
+    writer->append_bytes(wire_value.data(), length);
+    writer->append(0, (max_length - length) * BITS_IN_BYTE);
 }
 
 unsigned dccl::v2::DefaultBytesCodec::size() { return min_size(); }
@@ -221,6 +264,16 @@ std::string dccl::v2::DefaultBytesCodec::decode(Bitset* bits)
     }
 }
 
+std::string dccl::v2::DefaultBytesCodec::decode(BitReader* reader)
+{
+    if (!use_required() && !reader->read(1)) // presence bit
+        throw NullValueException();
+
+    std::string value;
+    reader->read_bytes(&value, dccl_field_options().max_length());
+    return value;
+}
+
 unsigned dccl::v2::DefaultBytesCodec::max_size()
 {
     return dccl_field_options().max_length() * BITS_IN_BYTE +
@@ -39,6 +39,7 @@
 #include "../binary.h"
 #include "../field_codec.h"
 #include "../field_codec_fixed.h"
+#include "../static_codec.h"
 #include "field_codec_default_message.h"
 
 namespace dccl
@@ -53,6 +54,8 @@ template <typename WireType, typename FieldType = WireType>
 class DefaultNumericFieldCodec : public TypedFixedFieldCodec<WireType, FieldType>
 {
   public:
+    using default_repeated = std::true_type;
+
     virtual double max()
     {
         DynamicConditions& dc = this->dynamic_conditions(this->this_field());
@@ -143,12 +146,12 @@ class DefaultNumericFieldCodec : public TypedFixedFieldCodec<WireType, FieldType
             auto res = resolution();
             // this was previously allowed so we will only give a warning not throw an exception
             if (!min_multiple_of_res)
-                dccl::dlog.is(dccl::logger::WARN, dccl::logger::GENERAL) &&
+                DCCL_LOG_IS(WARN, GENERAL) &&
                     dccl::dlog << "Warning: (dccl.field).min should be an exact multiple of "
                                   "10^(-(dccl.field).precision), i.e. "
                                << res << ": " << this->this_field()->DebugString() << std::endl;
             if (!max_multiple_of_res)
-                dccl::dlog.is(dccl::logger::WARN, dccl::logger::GENERAL) &&
+                DCCL_LOG_IS(WARN, GENERAL) &&
                     dccl::dlog << "Warning: (dccl.field).max should be an exact multiple of "
                                   "10^(-(dccl.field).precision), i.e. "
                                << res << ": " << this->this_field()->DebugString() << std::endl;
@@ -164,18 +167,25 @@ class DefaultNumericFieldCodec : public TypedFixedFieldCodec<WireType, FieldType
 
     Bitset encode() override { return Bitset(size()); }
 
+    void encode(BitWriter* writer) override { writer->append(0, size()); }
+
     Bitset encode(const WireType& value) override
     {
-        dccl::dlog.is(dccl::logger::DEBUG2, dccl::logger::ENCODE) &&
+        Bitset encoded;
+        BitWriter writer(&encoded);
+        encode(&writer, value);
+        return encoded;
+    }
+
+    void encode(BitWriter* writer, const WireType& value) override
+    {
+        DCCL_LOG_IS(DEBUG2, ENCODE) &&
             dlog << "Encode " << value << " with bounds: [" << min() << "," << max() << "]"
                  << std::endl;
 
-        // round first, before checking bounds
-        double res = resolution();
-        WireType wire_value = dccl::quantize(value, res);
-
-        // check bounds
-        if (wire_value < min() || wire_value > max())
+        dccl::uint64 uint_value = 0;
+        if (!static_codec::encode_numeric(value, min(), max(), resolution(),
+                                          FieldCodecBase::use_required(), &uint_value))
         {
             // strict mode
             if (this->strict())
@@ -185,56 +195,33 @@ class DefaultNumericFieldCodec : public TypedFixedFieldCodec<WireType, FieldType
                     this->this_field(), this->this_descriptor()));
             // non-strict (default): if out-of-bounds, send as zeros
             else
-                return Bitset(size());
+            {
+                writer->append(0, size());
+                return;
+            }
         }
 
-        // calculate the encoded value: remove the minimum, scale for the resolution, cast to int.
-        wire_value -= dccl::quantize(static_cast<WireType>(min()), res);
-        if (res >= 1)
-            wire_value /= res;
-        else
-            wire_value *= (1.0 / res);
-        auto uint_value = static_cast<dccl::uint64>(dccl::round(wire_value, 0));
-
-        // "presence" value (0)
-        if (!FieldCodecBase::use_required())
-            uint_value += 1;
-
-        Bitset encoded;
-        encoded.from(uint_value, size());
-        return encoded;
+        writer->append(uint_value, size());
     }
 
     WireType decode(Bitset* bits) override
     {
-        dccl::dlog.is(dccl::logger::DEBUG2, dccl::logger::DECODE) &&
+        DCCL_LOG_IS(DEBUG2, DECODE) &&
             dlog << "Decode with bounds: [" << min() << "," << max() << "]" << std::endl;
 
         // The line below SHOULD BE:
         // dccl::uint64 t = bits->to<dccl::uint64>();
         // But GCC3.3 requires an explicit template modifier on the method.
         // See, e.g., http://gcc.gnu.org/bugzilla/show_bug.cgi?id=10959
-        dccl::uint64 uint_value = (bits->template to<dccl::uint64>)();
-
-        if (!FieldCodecBase::use_required())
-        {
-            if (!uint_value)
-                throw NullValueException();
-            --uint_value;
-        }
+        return decode_value((bits->template to<dccl::uint64>)());
+    }
 
-        auto wire_value = (WireType)uint_value;
-        double res = resolution();
-        if (res >= 1)
-            wire_value *= res;
-        else
-            wire_value /= (1.0 / res);
+    WireType decode(BitReader* reader) override
+    {
+        DCCL_LOG_IS(DEBUG2, DECODE) &&
+            dlog << "Decode with bounds: [" << min() << "," << max() << "]" << std::endl;
 
-        // round values again to properly handle cases where double precision
-        // leads to slightly off values (e.g. 2.099999999 instead of 2.1)
-        wire_value =
-            dccl::quantize(wire_value + dccl::quantize(static_cast<WireType>(min()), res), res);
-        return wire_value;
+        return decode_value(reader->read(size()));
     }
 
     // bring size(const WireType&) into scope so callers can access it
@@ -242,10 +229,22 @@ class DefaultNumericFieldCodec : public TypedFixedFieldCodec<WireType, FieldType
 
     unsigned size() override
     {
-        // if not required field, leave one value for unspecified (always encoded as 0)
-        unsigned NULL_VALUE = FieldCodecBase::use_required() ? 0 : 1;
+        return static_codec::numeric_size(min(), max(), resolution(),
+                                          FieldCodecBase::use_required());
+    }
 
-        return dccl::ceil_log2((max() - min()) / resolution() + 1 + NULL_VALUE);
+  private:
+    // convert the encoded unsigned integer (the field's size() bits) back to the value
+    WireType decode_value(dccl::uint64 uint_value)
+    {
+        if (!FieldCodecBase::use_required())
+        {
+            if (!uint_value)
+                throw NullValueException();
+            --uint_value;
+        }
+
+        return static_codec::decode_numeric<WireType>(uint_value, min(), resolution());
     }
 };
 
@@ -254,10 +253,18 @@ class DefaultNumericFieldCodec : public TypedFixedFieldCodec<WireType, FieldType
 /// [presence bit (0 bits if required, 1 bit if optional)][value (1 bit)]
 class DefaultBoolCodec : public TypedFixedFieldCodec<bool>
 {
+  public:
+    using default_repeated = std::true_type;
+
+    void encode(BitWriter* writer, const bool& wire_value) override;
+    void encode(BitWriter* writer) override;
+    bool decode(BitReader* reader) override;
+
   private:
     Bitset encode(const bool& wire_value) override;
     Bitset encode() override;
     bool decode(Bitset* bits) override;
+    bool decode_value(unsigned long t);
     unsigned size() override;
     void validate() override;
 };
@@ -267,6 +274,13 @@ class DefaultBoolCodec : public TypedFixedFieldCodec<bool>
 /// [length of following string (1 byte)][string (0-255 bytes)]
 class DefaultStringCodec : public TypedFieldCodec<std::string>
 {
+  public:
+    using default_repeated = std::true_type;
+
+    void encode(BitWriter* writer) override;
+    void encode(BitWriter* writer, const std::string& wire_value) override;
+    std::string decode(BitReader* reader) override;
+
   private:
     Bitset encode() override;
     Bitset encode(const std::string& wire_value) override;
@@ -287,6 +301,13 @@ class DefaultStringCodec : public TypedFieldCodec<std::string>
 /// \brief Provides an fixed length byte string encoder.
 class DefaultBytesCodec : public TypedFieldCodec<std::string>
 {
+  public:
+    using default_repeated = std::true_type;
+
+    void encode(BitWriter* writer) override;
+    void encode(BitWriter* writer, const std::string& wire_value) override;
+    std::string decode(BitReader* reader) override;
+
   private:
     Bitset encode() override;
     Bitset encode(const std::string& wire_value) override;
@@ -402,11 +423,23 @@ template <> class TimeCodec<double> : public TimeCodecBase<double, 1>
 /// \brief Placeholder codec that takes no space on the wire (0 bits).
 template <typename T> class StaticCodec : public TypedFixedFieldCodec<T>
 {
+  public:
+    using default_repeated = std::true_type;
+
+    void encode(BitWriter* writer, const T&) override { writer->append(0, size()); }
+
+    void encode(BitWriter* writer) override { writer->append(0, size()); }
+
+    T decode(BitReader* /*reader*/) override { return static_value(); }
+
+  private:
     Bitset encode(const T&) override { return Bitset(size()); }
 
     Bitset encode() override { return Bitset(size()); }
 
-    T decode(Bitset* /*bits*/) override
+    T decode(Bitset* /*bits*/) override { return static_value(); }
+
+    T static_value()
     {
         std::istringstream iss(FieldCodecBase::dccl_field_options().static_value());
         T value;
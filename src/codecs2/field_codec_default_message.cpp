@@ -30,22 +30,46 @@
 //
 
 void dccl::v2::DefaultMessageCodec::any_encode(Bitset* bits, const dccl::any& wire_value)
+{
+    bits->clear();
+    BitWriter writer(bits);
+    any_encode(&writer, wire_value);
+}
+
+void dccl::v2::DefaultMessageCodec::any_encode(BitWriter* writer, const dccl::any& wire_value)
 {
     if (is_empty(wire_value))
-        *bits = Bitset(min_size());
+        writer->append(0, min_size());
     else
-        *bits = traverse_const_message<Encoder, Bitset>(wire_value);
+        traverse_const_message<Encoder>(wire_value, writer);
 }
 
 unsigned dccl::v2::DefaultMessageCodec::any_size(const dccl::any& wire_value)
 {
     if (is_empty(wire_value))
+    {
         return min_size();
+    }
     else
-        return traverse_const_message<Size, unsigned>(wire_value);
+    {
+        unsigned size = 0;
+        traverse_const_message<Size>(wire_value, &size);
+        return size;
+    }
 }
 
 void dccl::v2::DefaultMessageCodec::any_decode(Bitset* bits, dccl::any* wire_value)
+{
+    decode_message(bits, wire_value);
+}
+
+void dccl::v2::DefaultMessageCodec::any_decode(BitReader* reader, dccl::any* wire_value)
+{
+    decode_message(reader, wire_value);
+}
+
+template <typename Bits>
+void dccl::v2::DefaultMessageCodec::decode_message(Bits* bits, dccl::any* wire_value)
 {
     try
     {
@@ -54,25 +78,20 @@ void dccl::v2::DefaultMessageCodec::any_decode(Bitset* bits, dccl::any* wire_val
         const google::protobuf::Descriptor* desc = msg->GetDescriptor();
         const google::protobuf::Reflection* refl = msg->GetReflection();
 
-        for (int i = 0, n = desc->field_count(); i < n; ++i)
+        for (const internal::FieldPlan& field : plan(desc).fields)
         {
-            const google::protobuf::FieldDescriptor* field_desc = desc->field(i);
-
-            if (!check_field(field_desc))
+            if (!check_field(field))
                 continue;
 
-            std::shared_ptr<FieldCodecBase> codec = find(field_desc);
-            std::shared_ptr<internal::FromProtoCppTypeBase> helper =
-                manager().type_helper().find(field_desc);
+            const google::protobuf::FieldDescriptor* field_desc = field.field_desc;
+            FieldCodecBase* codec = field.codec;
 
-            if (field_desc->is_repeated())
+            if (field.is_repeated)
             {
                 std::vector<dccl::any> wire_values;
-                if (field_desc->cpp_type() == google::protobuf::FieldDescriptor::CPPTYPE_MESSAGE)
+                if (field.is_message)
                 {
-                    for (unsigned j = 0,
-                                  m = field_desc->options().GetExtension(dccl::field).max_repeat();
-                         j < m; ++j)
+                    for (unsigned j = 0, m = field.max_repeat; j < m; ++j)
                         wire_values.emplace_back(refl->AddMessage(msg, field_desc));
 
                     codec->field_decode_repeated(bits, &wire_values, field_desc);
@@ -88,13 +107,13 @@ void dccl::v2::DefaultMessageCodec::any_decode(Bitset* bits, dccl::any* wire_val
                     // for primitive types
                     codec->field_decode_repeated(bits, &wire_values, field_desc);
                     for (auto& wire_value : wire_values)
-                        helper->add_value(field_desc, msg, wire_value);
+                        field.helper->add_value(field_desc, msg, wire_value);
                 }
             }
             else
             {
                 dccl::any wire_value;
-                if (field_desc->cpp_type() == google::protobuf::FieldDescriptor::CPPTYPE_MESSAGE)
+                if (field.is_message)
                 {
                     // allows us to propagate pointers instead of making many copies of entire messages
                     wire_value = refl->MutableMessage(msg, field_desc);
@@ -106,9 +125,12 @@ void dccl::v2::DefaultMessageCodec::any_decode(Bitset* bits, dccl::any* wire_val
                 {
                     // for primitive types
                     codec->field_decode(bits, &wire_value, field_desc);
-                    helper->set_value(field_desc, msg, wire_value);
+                    field.helper->set_value(field_desc, msg, wire_value);
                 }
             }
+
+            // conditions that read this field must be evaluated again
+            manager().codec_data().dynamic_conditions_.field_changed(field_desc);
         }
 
         std::vector<const google::protobuf::FieldDescriptor*> set_fields;
@@ -159,34 +181,21 @@ std::string dccl::v2::DefaultMessageCodec::info()
     return ss.str();
 }
 
-bool dccl::v2::DefaultMessageCodec::check_field(const google::protobuf::FieldDescriptor* field)
+bool dccl::v2::DefaultMessageCodec::check_field(const internal::FieldPlan& field)
 {
-    if (!field)
+    // fields with (dccl.field).omit = true are not included in the plan
+    if (message_data().current_part() == UNKNOWN) // part not yet explicitly specified
     {
-        return true;
-    }
-    else
-    {
-        dccl::DCCLFieldOptions dccl_field_options = field->options().GetExtension(dccl::field);
-        if (dccl_field_options.omit()) // omit
-        {
-            return false;
-        }
-        else if (message_data().current_part() == UNKNOWN) // part not yet explicitly specified
-        {
-            if (field->cpp_type() == google::protobuf::FieldDescriptor::CPPTYPE_MESSAGE &&
-                find(field)->name() ==
-                    Codec::default_codec_name()) // default message codec will expand
-                return true;
-            else if ((part() == HEAD && !dccl_field_options.in_head()) ||
-                     (part() == BODY && dccl_field_options.in_head()))
-                return false;
-            else
-                return true;
-        }
-        else if (message_data().current_part() != part()) // part specified and doesn't match
+        if (field.is_message &&
+            field.codec->name() == Codec::default_codec_name()) // default message codec will expand
+            return true;
+        else if ((part() == HEAD && !field.in_head) || (part() == BODY && field.in_head))
             return false;
         else
             return true;
     }
+    else if (message_data().current_part() != part()) // part specified and doesn't match
+        return false;
+    else
+        return true;
 }
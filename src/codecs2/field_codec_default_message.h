@@ -37,32 +37,40 @@ namespace v2
 /// \brief Provides the default codec for encoding a base Google Protobuf message or an embedded message by calling the appropriate field codecs for every field.
 class DefaultMessageCodec : public FieldCodecBase
 {
+  public:
+    using default_repeated = std::true_type;
+
   private:
     void any_encode(Bitset* bits, const dccl::any& wire_value) override;
+    void any_encode(BitWriter* writer, const dccl::any& wire_value) override;
     void any_decode(Bitset* bits, dccl::any* wire_value) override;
+    void any_decode(BitReader* reader, dccl::any* wire_value) override;
+    // decodes from either a Bitset (holding min_size() bits) or a BitReader
+    template <typename Bits> void decode_message(Bits* bits, dccl::any* wire_value);
+
     unsigned max_size() override;
     unsigned min_size() override;
     unsigned any_size(const dccl::any& wire_value) override;
 
-    std::shared_ptr<FieldCodecBase> find(const google::protobuf::FieldDescriptor* field_desc)
+    const internal::MessagePlan& plan(const google::protobuf::Descriptor* desc)
     {
-        return manager().find(field_desc, has_codec_group(), codec_group());
+        return manager().plan(desc, root_descriptor());
     }
 
     void validate() override;
     std::string info() override;
-    bool check_field(const google::protobuf::FieldDescriptor* field);
+    bool check_field(const internal::FieldPlan& field);
 
     struct Size
     {
-        static void repeated(std::shared_ptr<FieldCodecBase> codec, unsigned* return_value,
+        static void repeated(FieldCodecBase* codec, unsigned* return_value,
                              const std::vector<dccl::any>& field_values,
                              const google::protobuf::FieldDescriptor* field_desc)
         {
             codec->field_size_repeated(return_value, field_values, field_desc);
         }
 
-        static void single(std::shared_ptr<FieldCodecBase> codec, unsigned* return_value,
+        static void single(FieldCodecBase* codec, unsigned* return_value,
                            const dccl::any& field_value,
                            const google::protobuf::FieldDescriptor* field_desc)
         {
@@ -72,14 +80,14 @@ class DefaultMessageCodec : public FieldCodecBase
 
     struct Encoder
     {
-        static void repeated(std::shared_ptr<FieldCodecBase> codec, Bitset* return_value,
+        static void repeated(FieldCodecBase* codec, BitWriter* return_value,
                              const std::vector<dccl::any>& field_values,
                              const google::protobuf::FieldDescriptor* field_desc)
         {
             codec->field_encode_repeated(return_value, field_values, field_desc);
         }
 
-        static void single(std::shared_ptr<FieldCodecBase> codec, Bitset* return_value,
+        static void single(FieldCodecBase* codec, BitWriter* return_value,
                            const dccl::any& field_value,
                            const google::protobuf::FieldDescriptor* field_desc)
         {
@@ -89,7 +97,7 @@ class DefaultMessageCodec : public FieldCodecBase
 
     struct MaxSize
     {
-        static void field(std::shared_ptr<FieldCodecBase> codec, unsigned* return_value,
+        static void field(FieldCodecBase* codec, unsigned* return_value,
                           const google::protobuf::FieldDescriptor* field_desc)
         {
             codec->field_max_size(return_value, field_desc);
@@ -98,7 +106,7 @@ class DefaultMessageCodec : public FieldCodecBase
 
     struct MinSize
     {
-        static void field(std::shared_ptr<FieldCodecBase> codec, unsigned* return_value,
+        static void field(FieldCodecBase* codec, unsigned* return_value,
                           const google::protobuf::FieldDescriptor* field_desc)
         {
             codec->field_min_size(return_value, field_desc);
@@ -107,7 +115,7 @@ class DefaultMessageCodec : public FieldCodecBase
 
     struct Validate
     {
-        static void field(std::shared_ptr<FieldCodecBase> codec, bool* return_value,
+        static void field(FieldCodecBase* codec, bool* return_value,
                           const google::protobuf::FieldDescriptor* field_desc)
         {
             codec->field_validate(return_value, field_desc);
@@ -116,7 +124,7 @@ class DefaultMessageCodec : public FieldCodecBase
 
     struct Info
     {
-        static void field(std::shared_ptr<FieldCodecBase> codec, std::stringstream* return_value,
+        static void field(FieldCodecBase* codec, std::stringstream* return_value,
                           const google::protobuf::FieldDescriptor* field_desc)
         {
             codec->field_info(return_value, field_desc);
@@ -127,53 +135,45 @@ class DefaultMessageCodec : public FieldCodecBase
     void traverse_descriptor(ReturnType* return_value)
     {
         const google::protobuf::Descriptor* desc = FieldCodecBase::this_descriptor();
-        for (int i = 0, n = desc->field_count(); i < n; ++i)
+        for (const internal::FieldPlan& field : plan(desc).fields)
         {
-            const google::protobuf::FieldDescriptor* field_desc = desc->field(i);
-
-            if (!check_field(field_desc))
+            if (!check_field(field))
                 continue;
 
-            Action::field(find(field_desc), return_value, field_desc);
+            Action::field(field.codec, return_value, field.field_desc);
         }
     }
 
     template <typename Action, typename ReturnType>
-    ReturnType traverse_const_message(const dccl::any& wire_value)
+    void traverse_const_message(const dccl::any& wire_value, ReturnType* return_value)
     {
         try
         {
-            ReturnType return_value = ReturnType();
-
             const auto* msg = dccl::any_cast<const google::protobuf::Message*>(wire_value);
             const google::protobuf::Descriptor* desc = msg->GetDescriptor();
             const google::protobuf::Reflection* refl = msg->GetReflection();
-            for (int i = 0, n = desc->field_count(); i < n; ++i)
+            for (const internal::FieldPlan& field : plan(desc).fields)
             {
-                const google::protobuf::FieldDescriptor* field_desc = desc->field(i);
-
-                if (!check_field(field_desc))
+                if (!check_field(field))
                     continue;
 
-                std::shared_ptr<FieldCodecBase> codec = find(field_desc);
-                std::shared_ptr<internal::FromProtoCppTypeBase> helper =
-                    manager().type_helper().find(field_desc);
+                const google::protobuf::FieldDescriptor* field_desc = field.field_desc;
 
-                if (field_desc->is_repeated())
+                if (field.is_repeated)
                 {
                     std::vector<dccl::any> field_values;
                     for (int j = 0, m = refl->FieldSize(*msg, field_desc); j < m; ++j)
-                        field_values.push_back(helper->get_repeated_value(field_desc, *msg, j));
+                        field_values.push_back(
+                            field.helper->get_repeated_value(field_desc, *msg, j));
 
-                    Action::repeated(codec, &return_value, field_values, field_desc);
+                    Action::repeated(field.codec, return_value, field_values, field_desc);
                 }
                 else
                 {
-                    Action::single(codec, &return_value, helper->get_value(field_desc, *msg),
-                                   field_desc);
+                    Action::single(field.codec, return_value,
+                                   field.helper->get_value(field_desc, *msg), field_desc);
                 }
             }
-            return return_value;
         }
         catch (dccl::bad_any_cast& e)
         {
@@ -34,37 +34,40 @@ dccl::Bitset dccl::v3::DefaultStringCodec::encode() { return Bitset(min_size());
 
 dccl::Bitset dccl::v3::DefaultStringCodec::encode(const std::string& wire_value)
 {
-    std::string s = wire_value;
-    if (s.size() > dccl_field_options().max_length())
+    Bitset bits;
+    BitWriter writer(&bits);
+    encode(&writer, wire_value);
+
+    DCCL_LOG_IS(DEBUG2, GENERAL) &&
+        dccl::dlog << "DefaultStringCodec created: " << bits << std::endl;
+
+    return bits;
+}
+
+void dccl::v3::DefaultStringCodec::encode(BitWriter* writer) { writer->append(0, min_size()); }
+
+void dccl::v3::DefaultStringCodec::encode(BitWriter* writer, const std::string& wire_value)
+{
+    std::string::size_type length = wire_value.size();
+    if (length > dccl_field_options().max_length())
     {
         if (this->strict())
             throw(dccl::OutOfRangeException(std::string("String too long for field: ") +
                                                 FieldCodecBase::this_field()->DebugString(),
                                             this->this_field(), this->this_descriptor()));
 
-        dccl::dlog.is(DEBUG2) &&
-            dccl::dlog << "String " << s << " exceeds `dccl.max_length`, truncating" << std::endl;
-        s.resize(dccl_field_options().max_length());
+        DCCL_LOG_IS(DEBUG2, GENERAL) &&
+            dccl::dlog << "String " << wire_value << " exceeds `dccl.max_length`, truncating"
+                       << std::endl;
+        length = dccl_field_options().max_length();
     }
 
-    Bitset value_bits;
-    value_bits.from_byte_string(s);
+    DCCL_LOG_IS(DEBUG2, GENERAL) &&
+        dccl::dlog << "DefaultStringCodec length: " << length << std::endl;
 
-    Bitset length_bits(min_size(), s.length());
-
-    dccl::dlog.is(DEBUG2) && dccl::dlog << "DefaultStringCodec value_bits: " << value_bits
-                                        << std::endl;
-
-    dccl::dlog.is(DEBUG2) && dccl::dlog << "DefaultStringCodec length_bits: " << length_bits
-                                        << std::endl;
-
-    // adds to MSBs
-    for (int i = 0, n = value_bits.size(); i < n; ++i) length_bits.push_back(value_bits[i]);
-
-    dccl::dlog.is(DEBUG2) && dccl::dlog << "DefaultStringCodec created: " << length_bits
-                                        << std::endl;
-
-    return length_bits;
+    // length, then the string itself in the MSBs
+    writer->append(length, min_size());
+    writer->append_bytes(wire_value.data(), length);
 }
 
 std::string dccl::v3::DefaultStringCodec::decode(Bitset* bits)
@@ -75,15 +78,17 @@ std::string dccl::v3::DefaultStringCodec::decode(Bitset* bits)
     {
         unsigned header_length = min_size();
 
-        dccl::dlog.is(DEBUG2) && dccl::dlog << "Length of string is = " << value_length
-                                            << std::endl;
+        DCCL_LOG_IS(DEBUG2, GENERAL) &&
+            dccl::dlog << "Length of string is = " << value_length << std::endl;
 
-        dccl::dlog.is(DEBUG2) && dccl::dlog << "bits before get_more_bits " << *bits << std::endl;
+        DCCL_LOG_IS(DEBUG2, GENERAL) &&
+            dccl::dlog << "bits before get_more_bits " << *bits << std::endl;
 
         // grabs more bits to add to the MSBs of `bits`
         bits->get_more_bits(value_length * BITS_IN_BYTE);
 
-        dccl::dlog.is(DEBUG2) && dccl::dlog << "bits after get_more_bits " << *bits << std::endl;
+        DCCL_LOG_IS(DEBUG2, GENERAL) &&
+            dccl::dlog << "bits after get_more_bits " << *bits << std::endl;
         Bitset string_body_bits = *bits;
         string_body_bits >>= header_length;
         string_body_bits.resize(bits->size() - header_length);
@@ -96,6 +101,25 @@ std::string dccl::v3::DefaultStringCodec::decode(Bitset* bits)
     }
 }
 
+std::string dccl::v3::DefaultStringCodec::decode(BitReader* reader)
+{
+    unsigned value_length = reader->read(min_size());
+
+    if (value_length)
+    {
+        DCCL_LOG_IS(DEBUG2, GENERAL) &&
+            dccl::dlog << "Length of string is = " << value_length << std::endl;
+
+        std::string value;
+        reader->read_bytes(&value, value_length);
+        return value;
+    }
+    else
+    {
+        throw NullValueException();
+    }
+}
+
 unsigned dccl::v3::DefaultStringCodec::size() { return min_size(); }
 
 unsigned dccl::v3::DefaultStringCodec::size(const std::string& wire_value)
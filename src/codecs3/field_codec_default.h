@@ -88,6 +88,13 @@ template <typename T> class StaticCodec : public v2::StaticCodec<T>
 /// [length of following string size: ceil(log2(max_length))][string]
 class DefaultStringCodec : public TypedFieldCodec<std::string>
 {
+  public:
+    using default_repeated = std::true_type;
+
+    void encode(BitWriter* writer) override;
+    void encode(BitWriter* writer, const std::string& wire_value) override;
+    std::string decode(BitReader* reader) override;
+
   private:
     Bitset encode() override;
     Bitset encode(const std::string& wire_value) override;
@@ -30,17 +30,24 @@
 //
 
 void dccl::v3::DefaultMessageCodec::any_encode(Bitset* bits, const dccl::any& wire_value)
+{
+    bits->clear();
+    BitWriter writer(bits);
+    any_encode(&writer, wire_value);
+}
+
+void dccl::v3::DefaultMessageCodec::any_encode(BitWriter* writer, const dccl::any& wire_value)
 {
     if (is_empty(wire_value))
     {
-        *bits = Bitset(min_size());
+        writer->append(0, min_size());
     }
     else
     {
-        *bits = traverse_const_message<Encoder, Bitset>(wire_value);
-
         if (is_optional())
-            bits->push_front(true); // presence bit
+            writer->append(1, 1); // presence bit
+
+        traverse_const_message<Encoder>(wire_value, writer);
     }
 }
 
@@ -52,7 +59,8 @@ unsigned dccl::v3::DefaultMessageCodec::any_size(const dccl::any& wire_value)
     }
     else
     {
-        unsigned size = traverse_const_message<Size, unsigned>(wire_value);
+        unsigned size = 0;
+        traverse_const_message<Size>(wire_value, &size);
         if (is_optional())
         {
             const unsigned presence_bit = 1;
@@ -64,75 +72,74 @@ unsigned dccl::v3::DefaultMessageCodec::any_size(const dccl::any& wire_value)
 }
 
 void dccl::v3::DefaultMessageCodec::any_decode(Bitset* bits, dccl::any* wire_value)
+{
+    decode_message(bits, wire_value);
+}
+
+void dccl::v3::DefaultMessageCodec::any_decode(BitReader* reader, dccl::any* wire_value)
+{
+    decode_message(reader, wire_value);
+}
+
+template <typename Bits>
+void dccl::v3::DefaultMessageCodec::decode_message(Bits* bits, dccl::any* wire_value)
 {
     try
     {
         auto* msg = dccl::any_cast<google::protobuf::Message*>(*wire_value);
 
-        if (is_optional())
+        if (is_optional() && !read_presence_bit(bits))
         {
-            if (!bits->to_ulong())
-            {
-                *wire_value = dccl::any();
-                return;
-            }
-            else
-            {
-                bits->pop_front(); // presence bit
-            }
+            *wire_value = dccl::any();
+            return;
         }
 
         const google::protobuf::Descriptor* desc = msg->GetDescriptor();
         const google::protobuf::Reflection* refl = msg->GetReflection();
 
-        for (int i = 0, n = desc->field_count(); i < n; ++i)
+        for (const internal::FieldPlan& field : plan(desc).fields)
         {
-            const google::protobuf::FieldDescriptor* field_desc = desc->field(i);
-
-            if (!check_field(field_desc))
+            if (!check_field(field))
                 continue;
 
-            std::shared_ptr<FieldCodecBase> codec = find(field_desc);
-            std::shared_ptr<internal::FromProtoCppTypeBase> helper =
-                manager().type_helper().find(field_desc);
+            const google::protobuf::FieldDescriptor* field_desc = field.field_desc;
+            FieldCodecBase* codec = field.codec;
 
-            if (field_desc->is_repeated())
+            if (field.is_repeated)
             {
                 std::vector<dccl::any> field_values;
-                if (field_desc->cpp_type() == google::protobuf::FieldDescriptor::CPPTYPE_MESSAGE)
+                if (field.is_message)
                 {
-                    unsigned max_repeat =
-                        field_desc->options().GetExtension(dccl::field).max_repeat();
-                    for (unsigned j = 0, m = max_repeat; j < m; ++j)
+                    for (unsigned j = 0, m = field.max_repeat; j < m; ++j)
                         field_values.emplace_back(refl->AddMessage(msg, field_desc));
 
                     codec->field_decode_repeated(bits, &field_values, field_desc);
 
                     // remove the unused messages
-                    for (int j = field_values.size(), m = max_repeat; j < m; ++j)
+                    for (int j = field_values.size(), m = field.max_repeat; j < m; ++j)
                     { refl->RemoveLast(msg, field_desc); } }
                 else
                 {
                     // for primitive types
                     codec->field_decode_repeated(bits, &field_values, field_desc);
                     for (auto& field_value : field_values)
-                        helper->add_value(field_desc, msg, field_value);
+                        field.helper->add_value(field_desc, msg, field_value);
                 }
             }
             else
             {
                 // singular field dynamic conditions - repeated fields handled in any_decode_repeated
-                DynamicConditions& dc = dynamic_conditions(field_desc);
-                if (dc.has_omit_if())
+                if (field.has_omit_if)
                 {
                     // expensive, so don't do this unless we're going to use it
+                    DynamicConditions& dc = dynamic_conditions(field_desc);
                     dc.regenerate(this_message(), root_message());
                     if (dc.omit())
                         continue;
                 }
 
                 dccl::any field_value;
-                if (field_desc->cpp_type() == google::protobuf::FieldDescriptor::CPPTYPE_MESSAGE)
+                if (field.is_message)
                 {
                     // allows us to propagate pointers instead of making many copies of entire messages
                     field_value = refl->MutableMessage(msg, field_desc);
@@ -144,9 +151,12 @@ void dccl::v3::DefaultMessageCodec::any_decode(Bitset* bits, dccl::any* wire_val
                 {
                     // for primitive types
                     codec->field_decode(bits, &field_value, field_desc);
-                    helper->set_value(field_desc, msg, field_value);
+                    field.helper->set_value(field_desc, msg, field_value);
                 }
             }
+
+            // conditions that read this field must be evaluated again
+            manager().codec_data().dynamic_conditions_.field_changed(field_desc);
         }
 
         std::vector<const google::protobuf::FieldDescriptor*> set_fields;
@@ -209,30 +219,18 @@ std::string dccl::v3::DefaultMessageCodec::info()
     return ss.str();
 }
 
-bool dccl::v3::DefaultMessageCodec::check_field(const google::protobuf::FieldDescriptor* field)
+bool dccl::v3::DefaultMessageCodec::check_field(const internal::FieldPlan& field)
 {
-    if (!field)
-    {
-        return true;
-    }
-    else
+    // fields with (dccl.field).omit = true are not included in the plan
+    if (message_data().current_part() == UNKNOWN) // part not yet explicitly specified
     {
-        dccl::DCCLFieldOptions dccl_field_options = field->options().GetExtension(dccl::field);
-        if (dccl_field_options.omit()) // omit
-        {
-            return false;
-        }
-        else if (message_data().current_part() == UNKNOWN) // part not yet explicitly specified
-        {
-            if ((part() == HEAD && !dccl_field_options.in_head()) ||
-                (part() == BODY && dccl_field_options.in_head()))
-                return false;
-            else
-                return true;
-        }
-        else if (message_data().current_part() != part()) // part specified and doesn't match
+        if ((part() == HEAD && !field.in_head) || (part() == BODY && field.in_head))
             return false;
         else
             return true;
     }
+    else if (message_data().current_part() != part()) // part specified and doesn't match
+        return false;
+    else
+        return true;
 }
@@ -0,0 +1,299 @@
+// Copyright 2026:
+//   GobySoft, LLC (2013-)
+//   Community contributors (see AUTHORS file)
+// File authors:
+//   Toby Schneider <toby@gobysoft.org>
+//
+//
+// This file is part of the Dynamic Compact Control Language Library
+// ("DCCL").
+//
+// DCCL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 2.1 of the License, or
+// (at your option) any later version.
+//
+// DCCL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DCCL.  If not, see <http://www.gnu.org/licenses/>.
+#ifndef DCCLFIELDCODECDELTA20261018H
+#define DCCLFIELDCODECDELTA20261018H
+
+#include <cmath>
+
+#include "../field_codec_typed.h"
+#include "../static_codec.h"
+
+namespace dccl
+{
+namespace v3
+{
+/// \brief Encodes slowly varying repeated numeric fields (e.g. profiles or time series) as the first value followed by the differences between successive values.
+///
+/// Values are quantized exactly as by the default numeric codec ((dccl.field).min, max and resolution). Differences are bounded by (dccl.field).delta_min and delta_max; a difference outside these bounds "escapes" and the value is sent at full width instead. The field size is as follows:
+/// - [size prefix, as for the default repeated field (ceil(log2(max_repeat - min_repeat + 1)) bits)]
+/// - [first value (full width)]
+/// - If there is more than one value: [1 bit: 0 = remaining values at full width, 1 = as differences] followed by the remaining values. Each difference is ceil(log2((delta_max - delta_min) / resolution + 2)) bits, with zero reserved for an escape, which is followed by the value at full width.
+///
+/// The encoder chooses whichever of the two forms is smaller, so the (exact) max_size() is one bit more than the default codec's.
+template <typename WireType, typename FieldType = WireType>
+class DeltaFieldCodec : public RepeatedTypedFieldCodec<WireType, FieldType>
+{
+  public:
+    Bitset encode_repeated(const std::vector<WireType>& wire_values) override
+    {
+        Bitset bits;
+        BitWriter writer(&bits);
+
+        std::vector<dccl::uint64> encoded = encode_values(wire_values);
+        writer.append(encoded.size() - min_repeat(), prefix_size());
+
+        if (encoded.empty())
+            return bits;
+
+        writer.append(encoded[0], full_size());
+        if (encoded.size() == 1)
+            return bits;
+
+        bool use_deltas = deltas_size(encoded) < (encoded.size() - 1) * full_size();
+        writer.append(use_deltas, 1);
+
+        for (std::size_t i = 1, n = encoded.size(); i < n; ++i)
+        {
+            if (!use_deltas)
+            {
+                writer.append(encoded[i], full_size());
+                continue;
+            }
+
+            dccl::int64 delta =
+                static_cast<dccl::int64>(encoded[i]) - static_cast<dccl::int64>(encoded[i - 1]);
+            if (delta >= delta_min() && delta <= delta_max())
+            {
+                writer.append(delta - delta_min() + 1, delta_size());
+            }
+            else
+            {
+                // escape
+                writer.append(0, delta_size());
+                writer.append(encoded[i], full_size());
+            }
+        }
+        return bits;
+    }
+
+    std::vector<WireType> decode_repeated(Bitset* bits) override
+    {
+        Bitset::size_type bits_read = 0;
+        return decode_values(
+            [&](unsigned num_bits)
+            {
+                if (bits_read + num_bits > bits->size())
+                    bits->get_more_bits(bits_read + num_bits - bits->size());
+
+                dccl::uint64 value = 0;
+                for (unsigned i = 0; i < num_bits; ++i)
+                    value |= static_cast<dccl::uint64>((*bits)[bits_read++]) << i;
+                return value;
+            });
+    }
+
+    /// \brief Decode a repeated field directly from the encoded bytes
+    std::vector<WireType> decode_repeated(BitReader* reader)
+    {
+        return decode_values([&](unsigned num_bits) { return reader->read(num_bits); });
+    }
+
+    unsigned size_repeated(const std::vector<WireType>& wire_values) override
+    {
+        std::vector<dccl::uint64> encoded = encode_values(wire_values);
+        return size(encoded.size(), encoded.size() < 2 ? 0 : deltas_size(encoded));
+    }
+
+    unsigned max_size_repeated() override
+    {
+        // all differences escaped, so the remaining values are sent at full width
+        return size(max_repeat(),
+                    max_repeat() > 1 ? (max_repeat() - 1) * (delta_size() + full_size()) : 0);
+    }
+
+    unsigned min_size_repeated() override
+    {
+        // all differences within bounds
+        return size(min_repeat(), min_repeat() > 1 ? (min_repeat() - 1) * delta_size() : 0);
+    }
+
+    void validate() override
+    {
+        FieldCodecBase::require(FieldCodecBase::this_field()->is_repeated(),
+                                "dccl.delta can only be used for repeated fields");
+        FieldCodecBase::require(FieldCodecBase::dccl_field_options().has_min(),
+                                "missing (dccl.field).min");
+        FieldCodecBase::require(FieldCodecBase::dccl_field_options().has_max(),
+                                "missing (dccl.field).max");
+        FieldCodecBase::require(FieldCodecBase::dccl_field_options().resolution() > 0,
+                                "(dccl.field).resolution must be greater than 0");
+        FieldCodecBase::require(
+            !(FieldCodecBase::dccl_field_options().has_precision() &&
+              FieldCodecBase::dccl_field_options().has_resolution()),
+            "at most one of either (dccl.field).precision or (dccl.field).resolution can be set");
+        FieldCodecBase::require(FieldCodecBase::dccl_field_options().has_delta_min(),
+                                "missing (dccl.field).delta_min");
+        FieldCodecBase::require(FieldCodecBase::dccl_field_options().has_delta_max(),
+                                "missing (dccl.field).delta_max");
+        FieldCodecBase::require(FieldCodecBase::dccl_field_options().delta_min() <=
+                                    FieldCodecBase::dccl_field_options().delta_max(),
+                                "(dccl.field).delta_min must be <= (dccl.field).delta_max");
+
+        // allowable epsilon for the delta bounds to diverge from nearest quantile
+        const double eps = 1e-10;
+        for (double bound : {FieldCodecBase::dccl_field_options().delta_min(),
+                             FieldCodecBase::dccl_field_options().delta_max()})
+            FieldCodecBase::require(
+                std::abs(quantize(bound, resolution()) - bound) < eps,
+                "(dccl.field).delta_min and delta_max must be exact multiples of the resolution");
+
+        // ensure value fits into double
+        FieldCodecBase::require(std::log2(max() - min()) - std::log2(resolution()) <=
+                                    std::numeric_limits<double>::digits,
+                                "[(dccl.field).max-(dccl.field).min]/(dccl.field).resolution must "
+                                "fit in a double-precision floating point value. Please increase "
+                                "min, decrease max, or decrease precision.");
+    }
+
+  private:
+    void any_decode_repeated(BitReader* reader, std::vector<dccl::any>* wire_values) override
+    {
+        std::vector<WireType> values = decode_repeated(reader);
+        wire_values->assign(values.begin(), values.end());
+    }
+
+    // read_bits(n) returns the next n bits of the encoded field
+    template <typename ReadBits> std::vector<WireType> decode_values(ReadBits read_bits)
+    {
+        std::vector<WireType> values;
+
+        unsigned num_values = read_bits(prefix_size()) + min_repeat();
+        if (num_values == 0)
+            return values;
+
+        dccl::uint64 encoded = read_bits(full_size());
+        values.push_back(decode_value(encoded));
+
+        bool use_deltas = num_values > 1 && read_bits(1);
+        for (unsigned i = 1; i < num_values; ++i)
+        {
+            dccl::uint64 delta_value = use_deltas ? read_bits(delta_size()) : 0;
+            if (delta_value == 0) // full width (or escape)
+                encoded = read_bits(full_size());
+            else
+                encoded += static_cast<dccl::int64>(delta_value) - 1 + delta_min();
+            values.push_back(decode_value(encoded));
+        }
+        return values;
+    }
+
+    // quantized values (as for the default numeric codec), truncated / padded to the repeat bounds
+    std::vector<dccl::uint64> encode_values(const std::vector<WireType>& wire_values)
+    {
+        if (wire_values.size() > max_repeat() && this->strict())
+            throw(dccl::OutOfRangeException(
+                std::string("Repeated size exceeds max_repeat for field: ") +
+                    FieldCodecBase::this_field()->DebugString(),
+                this->this_field(), this->this_descriptor()));
+
+        if (wire_values.size() < min_repeat() && this->strict())
+            throw(dccl::OutOfRangeException(
+                std::string("Repeated size is less than min_repeat for field: ") +
+                    FieldCodecBase::this_field()->DebugString(),
+                this->this_field(), this->this_descriptor()));
+
+        std::vector<dccl::uint64> encoded(
+            std::max<std::size_t>(std::min<std::size_t>(wire_values.size(), max_repeat()),
+                                  min_repeat()),
+            0);
+
+        for (std::size_t i = 0, n = std::min(encoded.size(), wire_values.size()); i < n; ++i)
+        {
+            if (!static_codec::encode_numeric(wire_values[i], min(), max(), resolution(), true,
+                                              &encoded[i]) &&
+                this->strict())
+            {
+                throw(dccl::OutOfRangeException(
+                    std::string("Value exceeds min/max bounds for field: ") +
+                        FieldCodecBase::this_field()->DebugString(),
+                    this->this_field(), this->this_descriptor()));
+            }
+            // non-strict (default): if out-of-bounds, send as zeros (min), as for the default
+            // codec's repeated values
+        }
+        return encoded;
+    }
+
+    WireType decode_value(dccl::uint64 encoded)
+    {
+        return static_codec::decode_numeric<WireType>(encoded, min(), resolution());
+    }
+
+    // size of the values after the first, sent as differences
+    unsigned deltas_size(const std::vector<dccl::uint64>& encoded)
+    {
+        unsigned size = 0;
+        for (std::size_t i = 1, n = encoded.size(); i < n; ++i)
+        {
+            dccl::int64 delta =
+                static_cast<dccl::int64>(encoded[i]) - static_cast<dccl::int64>(encoded[i - 1]);
+            size += delta_size();
+            if (delta < delta_min() || delta > delta_max())
+                size += full_size();
+        }
+        return size;
+    }
+
+    // size of num_values values, given the size of the values after the first when sent as
+    // differences
+    unsigned size(unsigned num_values, unsigned deltas_size)
+    {
+        unsigned size = prefix_size();
+        if (num_values > 0)
+            size += full_size();
+        if (num_values > 1)
+            size += 1 + std::min(deltas_size, (num_values - 1) * full_size());
+        return size;
+    }
+
+    unsigned max_repeat() { return FieldCodecBase::dccl_field_options().max_repeat(); }
+    unsigned min_repeat() { return FieldCodecBase::dccl_field_options().min_repeat(); }
+
+    double min() { return FieldCodecBase::dccl_field_options().min(); }
+    double max() { return FieldCodecBase::dccl_field_options().max(); }
+    double resolution()
+    {
+        if (FieldCodecBase::dccl_field_options().has_precision())
+            return std::pow(10.0, -FieldCodecBase::dccl_field_options().precision());
+        return FieldCodecBase::dccl_field_options().resolution();
+    }
+
+    // bounds of the difference between successive quantized values
+    dccl::int64 delta_min()
+    {
+        return std::llround(FieldCodecBase::dccl_field_options().delta_min() / resolution());
+    }
+    dccl::int64 delta_max()
+    {
+        return std::llround(FieldCodecBase::dccl_field_options().delta_max() / resolution());
+    }
+
+    unsigned prefix_size() { return dccl::ceil_log2(max_repeat() - min_repeat() + 1); }
+    unsigned full_size() { return static_codec::numeric_size(min(), max(), resolution(), true); }
+    // zero is reserved for an escape
+    unsigned delta_size() { return dccl::ceil_log2(delta_max() - delta_min() + 2); }
+};
+} // namespace v3
+} // namespace dccl
+
+#endif
@@ -55,12 +55,19 @@ class PresenceBitCodec
     /// The field_type of the "wrapped" codec
     using field_type = typename Base::field_type;
 
+    using default_repeated = std::true_type;
+
   private:
     /// Instance of the "wrapped" codec
     WrappedType _inner_codec;
 
   public:
-    PresenceBitCodec() { _inner_codec.set_force_use_required(true); }
+    PresenceBitCodec()
+    {
+        _inner_codec.set_force_use_required(true);
+        _inner_codec.set_bit_writer_encode(internal::HasBitWriterEncode<WrappedType>::value);
+        _inner_codec.set_bit_reader_decode(internal::HasBitReaderDecode<WrappedType>::value);
+    }
 
     // required when wire_type != field_type
     wire_type pre_encode(const field_type& field_value) override
@@ -95,6 +102,21 @@ class PresenceBitCodec
         return encoded;
     }
 
+    /// Encodes an empty field as a single 0 bit
+    void encode(BitWriter* writer) override
+    {
+        writer->append(0, 1); // presence bit == false
+    }
+
+    /// Encodes a non-empty field, writing a 1 bit first for optional fields
+    void encode(BitWriter* writer, const wire_type& value) override
+    {
+        if (!this->use_required())
+            writer->append(1, 1);
+
+        _inner_codec.write(writer, value);
+    }
+
     /// Decodes a field, first evaluating the presence bit if necessary
     wire_type decode(Bitset* bits) override
     {
@@ -114,6 +136,15 @@ class PresenceBitCodec
         return _inner_codec.decode(bits);
     }
 
+    /// Decodes a field directly from the encoded bytes, first evaluating the presence bit if necessary
+    wire_type decode(BitReader* reader) override
+    {
+        if (!this->use_required() && !reader->read(1))
+            throw NullValueException();
+
+        return _inner_codec.read(reader);
+    }
+
     /// Size of an empty field (1 bit)
     unsigned size() override
     {
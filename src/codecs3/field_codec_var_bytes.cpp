@@ -31,43 +31,43 @@ dccl::Bitset dccl::v3::VarBytesCodec::encode() { return dccl::Bitset(min_size())
 
 dccl::Bitset dccl::v3::VarBytesCodec::encode(const std::string& wire_value)
 {
-    std::string s = wire_value;
-    if (s.size() > dccl_field_options().max_length())
+    dccl::Bitset bits;
+    dccl::BitWriter writer(&bits);
+    encode(&writer, wire_value);
+
+    DCCL_LOG_IS(DEBUG2, GENERAL) &&
+        dccl::dlog << "dccl::v3::VarBytesCodec created: " << bits << std::endl;
+
+    return bits;
+}
+
+void dccl::v3::VarBytesCodec::encode(dccl::BitWriter* writer) { writer->append(0, min_size()); }
+
+void dccl::v3::VarBytesCodec::encode(dccl::BitWriter* writer, const std::string& wire_value)
+{
+    std::string::size_type length = wire_value.size();
+    if (length > dccl_field_options().max_length())
     {
         if (this->strict())
             throw(dccl::OutOfRangeException(std::string("Bytes too long for field: ") +
                                                 FieldCodecBase::this_field()->DebugString(),
                                             this->this_field(), this->this_descriptor()));
 
-        dccl::dlog.is(DEBUG2) &&
-            dccl::dlog << "Bytes " << s << " exceeds `dccl.max_length`, truncating" << std::endl;
-        s.resize(dccl_field_options().max_length());
+        DCCL_LOG_IS(DEBUG2, GENERAL) &&
+            dccl::dlog << "Bytes " << wire_value << " exceeds `dccl.max_length`, truncating"
+                       << std::endl;
+        length = dccl_field_options().max_length();
     }
 
-    dccl::Bitset value_bits;
-    value_bits.from_byte_string(s);
-
-    dccl::Bitset length_bits(presence_size() + prefix_size(), s.length());
+    DCCL_LOG_IS(DEBUG2, GENERAL) &&
+        dccl::dlog << "dccl::v3::VarBytesCodec length: " << length << std::endl;
 
     if (!use_required()) // set the presence bit
-    {
-        length_bits <<= 1;
-        length_bits.set(0);
-    }
-
-    dccl::dlog.is(DEBUG2) && dccl::dlog << "dccl::v3::VarBytesCodec value_bits: " << value_bits
-                                        << std::endl;
+        writer->append(1, 1);
 
-    dccl::dlog.is(DEBUG2) && dccl::dlog << "dccl::v3::VarBytesCodec length_bits: " << length_bits
-                                        << std::endl;
-
-    // adds to MSBs
-    for (int i = 0, n = value_bits.size(); i < n; ++i) length_bits.push_back(value_bits[i]);
-
-    dccl::dlog.is(DEBUG2) && dccl::dlog << "dccl::v3::VarBytesCodec created: " << length_bits
-                                        << std::endl;
-
-    return length_bits;
+    // length prefix, then the bytes themselves in the MSBs
+    writer->append(length, prefix_size());
+    writer->append_bytes(wire_value.data(), length);
 }
 
 std::string dccl::v3::VarBytesCodec::decode(dccl::Bitset* bits)
@@ -88,23 +88,41 @@ std::string dccl::v3::VarBytesCodec::decode(dccl::Bitset* bits)
     unsigned value_length = bits->to_ulong();
     unsigned header_length = presence_size() + prefix_size();
 
-    dccl::dlog.is(DEBUG2) && dccl::dlog << "Length of string is = " << value_length << std::endl;
+    DCCL_LOG_IS(DEBUG2, GENERAL) &&
+        dccl::dlog << "Length of string is = " << value_length << std::endl;
 
-    dccl::dlog.is(DEBUG2) && dccl::dlog << "bits before get_more_bits " << *bits << std::endl;
+    DCCL_LOG_IS(DEBUG2, GENERAL) &&
+        dccl::dlog << "bits before get_more_bits " << *bits << std::endl;
 
     // grabs more bits to add to the MSBs of `bits`
     bits->get_more_bits(value_length * dccl::BITS_IN_BYTE);
 
-    dccl::dlog.is(DEBUG2) && dccl::dlog << "bits after get_more_bits " << *bits << std::endl;
+    DCCL_LOG_IS(DEBUG2, GENERAL) && dccl::dlog << "bits after get_more_bits " << *bits << std::endl;
     dccl::Bitset string_body_bits = *bits;
     string_body_bits >>= header_length;
     string_body_bits.resize(bits->size() - header_length);
 
-    dccl::dlog.is(DEBUG2) && dccl::dlog << "string_body_bits " << string_body_bits << std::endl;
+    DCCL_LOG_IS(DEBUG2, GENERAL) &&
+        dccl::dlog << "string_body_bits " << string_body_bits << std::endl;
 
     return string_body_bits.to_byte_string();
 }
 
+std::string dccl::v3::VarBytesCodec::decode(dccl::BitReader* reader)
+{
+    if (!use_required() && !reader->read(presence_size()))
+        throw dccl::NullValueException();
+
+    unsigned value_length = reader->read(prefix_size());
+
+    DCCL_LOG_IS(DEBUG2, GENERAL) &&
+        dccl::dlog << "Length of string is = " << value_length << std::endl;
+
+    std::string value;
+    reader->read_bytes(&value, value_length);
+    return value;
+}
+
 unsigned dccl::v3::VarBytesCodec::size() { return min_size(); }
 
 unsigned dccl::v3::VarBytesCodec::size(const std::string& wire_value)
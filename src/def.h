@@ -32,6 +32,7 @@
 #define DCCL_HAS_B64 @DCCL_HAS_B64@
 #define DCCL_HAS_LUA @DCCL_HAS_LUA@
 #define DCCL_THREAD_SUPPORT @DCCL_HAS_THREAD_SUPPORT@
+#define DCCL_MIN_LOG_LEVEL @DCCL_MIN_LOG_LEVEL_VALUE@
 #define DCCL_COMPILED_CXX_STANDARD @CMAKE_CXX_STANDARD@
 
 #if DCCL_COMPILED_CXX_STANDARD >= 17
@@ -20,8 +20,12 @@
 //
 // You should have received a copy of the GNU Lesser General Public License
 // along with DCCL.  If not, see <http://www.gnu.org/licenses/>.
+#include <algorithm>
+
 #include "dynamic_conditions.h"
 #include "exception.h"
+#include "internal/condition_expression.h"
+#include "logger.h"
 
 #if DCCL_HAS_LUA
 #include "thirdparty/sol/sol.hpp"
@@ -29,8 +33,43 @@
 LUALIB_API int luaopen_pb(lua_State* L);
 #define SOL_ALL_SAFETIES_ON 1
 #define SOL_PRINT_ERRORS 1
+
+#include <set>
+#include <unordered_map>
+
+struct dccl::DynamicConditions::LuaState
+{
+    // declared first so it is destroyed after the functions that reference it
+    sol::state lua;
+
+    // compiled once when the state is created
+    sol::protected_function load_desc;
+    sol::protected_function decode_message;
+
+    // compiled condition scripts, keyed by the script text
+    std::unordered_map<std::string, sol::protected_function> conditions;
+
+    // files already loaded with pb.load()
+    std::set<const google::protobuf::FileDescriptor*> loaded_files;
+
+    // the messages and index used to build the current "this", "root" and "this_index"
+    const google::protobuf::Message* this_msg{nullptr};
+    const google::protobuf::Message* root_msg{nullptr};
+    int index{-1};
+};
+
 #endif
 
+struct dccl::DynamicConditions::CompiledField
+{
+    // built-in expression for each Condition (null if not set, or if it requires Lua)
+    std::shared_ptr<const internal::ConditionExpression> expressions[5];
+    // fields read by the built-in expressions (sorted)
+    std::vector<const google::protobuf::FieldDescriptor*> dependencies;
+    // true if any built-in expression reads "this_index"
+    bool uses_index{false};
+};
+
 void build_file_desc_set(const google::protobuf::FileDescriptor* file_desc,
                          google::protobuf::FileDescriptorSet& file_desc_set)
 {
@@ -41,7 +80,10 @@ void build_file_desc_set(const google::protobuf::FileDescriptor* file_desc,
     file_desc->CopyTo(file_desc_proto);
 }
 
-dccl::DynamicConditions::DynamicConditions() = default;
+dccl::DynamicConditions::DynamicConditions()
+    : shared_compiled_(std::make_shared<CompiledMap>()), local_compiled_(new CompiledMap)
+{
+}
 
 dccl::DynamicConditions::~DynamicConditions()
 {
@@ -49,7 +91,7 @@ dccl::DynamicConditions::~DynamicConditions()
     if (lua_)
     {
         // without this, we get a segfault in Ubuntu jammy
-        lua_->script("pb.clear()");
+        lua_->lua.script("pb.clear()");
         delete lua_;
     }
 #endif
@@ -65,47 +107,294 @@ void dccl::DynamicConditions::regenerate(const google::protobuf::Message* this_m
     root_msg_ = root_msg;
     if (!this_msg_)
         this_msg_ = root_msg_;
+}
 
+void dccl::DynamicConditions::clear_results()
+{
+    results_.clear();
 #if DCCL_HAS_LUA
+    lua_stale_ = true;
+#endif
+}
+
+#if DCCL_HAS_LUA
+void dccl::DynamicConditions::update_lua()
+{
     if (this_msg_ && root_msg_)
     {
         if (!lua_)
         {
-            lua_ = new sol::state;
-            lua_->open_libraries();
-            lua_->require("pb", luaopen_pb);
+            lua_ = new LuaState;
+            lua_->lua.open_libraries();
+            lua_->lua.require("pb", luaopen_pb);
+
+            lua_->load_desc = lua_->lua.load(R"(local desc = ...; return pb.load(desc) )")
+                                  .get<sol::protected_function>();
+
+            const auto& decode_script = R"(
+             local this_encoded_msg, this_type, root_encoded_msg, root_type, cpp_index = ...;
+             pb.option('use_default_metatable');
+             root = pb.decode(root_type, root_encoded_msg);
+             this = pb.decode(this_type, this_encoded_msg); this_index = cpp_index+1;
+             return this;
+            )";
+
+            sol::load_result decode_message = lua_->lua.load(decode_script);
+            if (!decode_message.valid())
+            {
+                sol::error err = decode_message;
+                throw(Exception(
+                    std::string("Failed to load condition script into the Lua program: ") +
+                        err.what(),
+                    this_msg_->GetDescriptor()));
+            }
+            lua_->decode_message = decode_message.get<sol::protected_function>();
         }
 
-        sol::load_result desc_load = lua_->load(R"(local desc = ...; return pb.load(desc) )");
+        // only load the descriptors the first time this message's file is seen
+        const google::protobuf::FileDescriptor* root_file = root_msg_->GetDescriptor()->file();
+        if (!lua_->loaded_files.count(root_file))
+        {
+            google::protobuf::FileDescriptorSet file_desc_set;
+            build_file_desc_set(root_file, file_desc_set);
 
-        google::protobuf::FileDescriptorSet file_desc_set;
-        build_file_desc_set(root_msg_->GetDescriptor()->file(), file_desc_set);
+            std::tuple<bool, int> desc_load_result =
+                lua_->load_desc(file_desc_set.SerializeAsString());
+            assert(std::get<0>(desc_load_result));
+            lua_->loaded_files.insert(root_file);
+        }
 
-        std::tuple<bool, int> desc_load_result = desc_load(file_desc_set.SerializeAsString());
-        assert(std::get<0>(desc_load_result));
-        const auto& decode_script = R"(
-         local this_encoded_msg, this_type, root_encoded_msg, root_type, cpp_index = ...;
-         pb.option('use_default_metatable');
-         root = pb.decode(root_type, root_encoded_msg);
-         this = pb.decode(this_type, this_encoded_msg); this_index = cpp_index+1;
-         return this;
-        )";
+        // only rebuild the "this" and "root" tables if the messages have changed (or are
+        // different messages), otherwise at most the index needs updating
+        if (lua_stale_ || this_msg_ != lua_->this_msg || root_msg_ != lua_->root_msg)
+        {
+            sol::protected_function_result decoded_message = lua_->decode_message(
+                this_msg_->SerializePartialAsString(), this_msg_->GetDescriptor()->full_name(),
+                root_msg_->SerializePartialAsString(), root_msg_->GetDescriptor()->full_name(),
+                index_);
+            if (!decoded_message.valid())
+            {
+                sol::error err = decoded_message;
+                throw(Exception(std::string("Failed to decode message into the Lua program: ") +
+                                    err.what(),
+                                this_msg_->GetDescriptor()));
+            }
 
-        sol::load_result decode_message = lua_->load(decode_script);
-        if (!decode_message.valid())
+            lua_->this_msg = this_msg_;
+            lua_->root_msg = root_msg_;
+            lua_->index = index_;
+            lua_stale_ = false;
+        }
+        else if (index_ != lua_->index)
         {
-            sol::error err = decode_message;
+            lua_->lua["this_index"] = index_ + 1;
+            lua_->index = index_;
+        }
+    }
+}
+
+template <typename T> T dccl::DynamicConditions::evaluate_lua(const std::string& script)
+{
+    update_lua();
+
+    const google::protobuf::Descriptor* desc = field_desc_->containing_type();
+
+    auto it = lua_->conditions.find(script);
+    if (it == lua_->conditions.end())
+    {
+        sol::load_result condition = lua_->lua.load(script);
+        if (!condition.valid())
+        {
+            sol::error err = condition;
             throw(Exception(std::string("Failed to load condition script into the Lua program: ") +
                                 err.what(),
-                            this_msg_->GetDescriptor()));
+                            desc));
+        }
+        it = lua_->conditions
+                 .insert(std::make_pair(script, condition.get<sol::protected_function>()))
+                 .first;
+    }
+
+    sol::protected_function_result result = it->second();
+    if (!result.valid())
+    {
+        sol::error err = result;
+        throw(Exception("Failed to run condition script \"" + script + "\": " + err.what(), desc));
+    }
+    return result.get<T>();
+}
+#endif
+
+namespace
+{
+template <typename T> struct ExpressionResult;
+
+template <> struct ExpressionResult<bool>
+{
+    static bool evaluate(const dccl::internal::ConditionExpression& expression,
+                         const dccl::internal::ConditionExpression::Context& context)
+    {
+        return expression.evaluate_bool(context);
+    }
+};
+
+template <> struct ExpressionResult<double>
+{
+    static double evaluate(const dccl::internal::ConditionExpression& expression,
+                           const dccl::internal::ConditionExpression::Context& context)
+    {
+        return expression.evaluate_number(context);
+    }
+};
+} // namespace
+
+dccl::DynamicConditions::CompiledField
+dccl::DynamicConditions::compile_field(const google::protobuf::Descriptor* root_desc)
+{
+    CompiledField compiled;
+
+    auto compile_condition = [&](Condition condition, bool has_script, const std::string& script)
+    {
+        if (!has_script)
+            return;
+
+        std::shared_ptr<const internal::ConditionExpression> expression;
+        try
+        {
+            expression = std::make_shared<const internal::ConditionExpression>(
+                return_prefix(script));
+        }
+        catch (Exception& e)
+        {
+#if DCCL_HAS_LUA
+            // not in the subset the built-in evaluator supports
+            DCCL_LOG_IS(DEBUG2, GENERAL) &&
+                dlog << "Using Lua for dynamic condition. " << e.what() << std::endl;
+            return;
+#else
+            throw(Exception(std::string(e.what()) +
+                                ". This condition requires Lua, but DCCL was built without "
+                                "Lua support",
+                            field_desc_->containing_type()));
+#endif
         }
 
-        auto index = index_;
+        if (expression->uses_this_index())
+            compiled.uses_index = true;
+
+        // every field along each path is a dependency, e.g. "root.child[1].i" reads child and i
+        for (const internal::ConditionExpression::Reference& reference : expression->references())
+        {
+            const google::protobuf::Descriptor* desc =
+                reference.from_root ? root_desc : field_desc_->containing_type();
+            for (const std::string& name : reference.fields)
+            {
+                const google::protobuf::FieldDescriptor* field =
+                    desc ? desc->FindFieldByName(name) : nullptr;
+                if (!field)
+                    break;
+                compiled.dependencies.push_back(field);
+                desc = field->message_type();
+            }
+        }
+
+        compiled.expressions[static_cast<int>(condition)] = expression;
+    };
+
+    const dccl::DCCLFieldOptions::Conditions& c = conditions();
+    compile_condition(Condition::REQUIRED_IF, c.has_required_if(), c.required_if());
+    compile_condition(Condition::OMIT_IF, c.has_omit_if(), c.omit_if());
+    compile_condition(Condition::ONLY_IF, c.has_only_if(), c.only_if());
+    compile_condition(Condition::MIN, c.has_min(), c.min());
+    compile_condition(Condition::MAX, c.has_max(), c.max());
+
+    std::sort(compiled.dependencies.begin(), compiled.dependencies.end());
+    compiled.dependencies.erase(
+        std::unique(compiled.dependencies.begin(), compiled.dependencies.end()),
+        compiled.dependencies.end());
+
+    return compiled;
+}
 
-        sol::table decoded_message = decode_message(
-            this_msg_->SerializePartialAsString(), this_msg_->GetDescriptor()->full_name(),
-            root_msg_->SerializePartialAsString(), root_msg_->GetDescriptor()->full_name(), index);
+void dccl::DynamicConditions::compile(const google::protobuf::Descriptor* root_desc)
+{
+    (*shared_compiled_)[CompiledKey(field_desc_, root_desc)] = compile_field(root_desc);
+}
+
+const dccl::DynamicConditions::CompiledField& dccl::DynamicConditions::compiled()
+{
+    CompiledKey key(field_desc_, root_msg_->GetDescriptor());
+
+    auto it = shared_compiled_->find(key);
+    if (it != shared_compiled_->end())
+        return it->second;
+
+    // not loaded with Codec::load(), so compile it now, for this instance only
+    auto local_it = local_compiled_->find(key);
+    if (local_it == local_compiled_->end())
+        local_it = local_compiled_->insert(std::make_pair(key, compile_field(key.second))).first;
+    return local_it->second;
+}
+
+void dccl::DynamicConditions::field_changed(const google::protobuf::FieldDescriptor* field)
+{
+    for (auto it = results_.begin(); it != results_.end();)
+    {
+        const std::vector<const google::protobuf::FieldDescriptor*>* dependencies =
+            it->second.dependencies;
+        if (!dependencies ||
+            std::binary_search(dependencies->begin(), dependencies->end(), field))
+            it = results_.erase(it);
+        else
+            ++it;
     }
+
+#if DCCL_HAS_LUA
+    lua_stale_ = true;
+#endif
+}
+
+template <typename T>
+T dccl::DynamicConditions::evaluate(Condition condition, const std::string& script)
+{
+    const CompiledField& compiled = this->compiled();
+    const auto& expression = compiled.expressions[static_cast<int>(condition)];
+
+    // Lua scripts may read this_index, and any field
+    ResultKey key(field_desc_, condition, this_msg_,
+                  (!expression || compiled.uses_index) ? index_ : -1);
+    auto it = results_.find(key);
+    if (it != results_.end())
+        return static_cast<T>(it->second.value);
+
+    if (expression)
+    {
+        internal::ConditionExpression::Context context;
+        context.this_msg = this_msg_;
+        context.root_msg = root_msg_;
+        context.this_index = index_ + 1;
+
+        double value;
+        try
+        {
+            value = ExpressionResult<T>::evaluate(*expression, context);
+        }
+        catch (Exception& e)
+        {
+            throw(Exception(e.what(), field_desc_->containing_type()));
+        }
+        results_.insert(std::make_pair(key, Result{value, &compiled.dependencies}));
+        return static_cast<T>(value);
+    }
+
+#if DCCL_HAS_LUA
+    T value = evaluate_lua<T>(return_prefix(script));
+    results_.insert(std::make_pair(key, Result{static_cast<double>(value), nullptr}));
+    return value;
+#else
+    // compile_field() throws for conditions that aren't supported without Lua
+    throw(Exception("Dynamic condition \"" + script + "\" requires Lua",
+                    field_desc_->containing_type()));
 #endif
 }
 
@@ -119,20 +408,15 @@ const dccl::DCCLFieldOptions::Conditions& dccl::DynamicConditions::conditions()
 
 bool dccl::DynamicConditions::required()
 {
-#if DCCL_HAS_LUA
     if (is_initialized())
     {
         if (conditions().has_required_if())
         {
-            auto condition_script = return_prefix(conditions().required_if());
-            bool required = lua_->script(condition_script);
-            return required;
+            return evaluate<bool>(Condition::REQUIRED_IF, conditions().required_if());
         }
         else if (conditions().has_only_if())
         {
-            auto condition_script = return_prefix(conditions().only_if());
-            bool only = lua_->script(condition_script);
-            return only;
+            return evaluate<bool>(Condition::ONLY_IF, conditions().only_if());
         }
         else
         {
@@ -143,28 +427,19 @@ bool dccl::DynamicConditions::required()
     {
         return false;
     }
-
-#else
-    throw(Exception("DCCL built without Lua support: cannot use dynamic_conditions"));
-#endif
 }
 
 bool dccl::DynamicConditions::omit()
 {
-#if DCCL_HAS_LUA
     if (is_initialized())
     {
         if (conditions().has_omit_if())
         {
-            auto condition_script = return_prefix(conditions().omit_if());
-            bool omit = lua_->script(condition_script);
-            return omit;
+            return evaluate<bool>(Condition::OMIT_IF, conditions().omit_if());
         }
         else if (conditions().has_only_if())
         {
-            auto condition_script = return_prefix(conditions().only_if());
-            bool only = lua_->script(condition_script);
-            return !only;
+            return !evaluate<bool>(Condition::ONLY_IF, conditions().only_if());
         }
         else
         {
@@ -175,43 +450,28 @@ bool dccl::DynamicConditions::omit()
     {
         return false;
     }
-#else
-    throw(Exception("DCCL built without Lua support: cannot use dynamic_conditions"));
-#endif
 }
 
 double dccl::DynamicConditions::min()
 {
-#if DCCL_HAS_LUA
     if (is_initialized())
     {
-        auto condition_script = return_prefix(conditions().min());
-        double v = lua_->script(condition_script);
-        return v;
+        return evaluate<double>(Condition::MIN, conditions().min());
     }
     else
     {
         return -std::numeric_limits<double>::infinity();
     }
-#else
-    throw(Exception("DCCL built without Lua support: cannot use dynamic_conditions"));
-#endif
 }
 
 double dccl::DynamicConditions::max()
 {
-#if DCCL_HAS_LUA
     if (is_initialized())
     {
-        auto condition_script = return_prefix(conditions().max());
-        double v = lua_->script(condition_script);
-        return v;
+        return evaluate<double>(Condition::MAX, conditions().max());
     }
     else
     {
         return std::numeric_limits<double>::infinity();
     }
-#else
-    throw(Exception("DCCL built without Lua support: cannot use dynamic_conditions"));
-#endif
 }
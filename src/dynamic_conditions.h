@@ -23,19 +23,26 @@
 #ifndef DCCLDYNAMICCONDITIONALS20220214H
 #define DCCLDYNAMICCONDITIONALS20220214H
 
+#include <map>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+
 #include <google/protobuf/descriptor.h>
 #include <google/protobuf/message.h>
 
 #include "dccl/def.h"
 #include "option_extensions.pb.h"
 
-namespace sol
+namespace dccl
+{
+namespace internal
 {
-class state;
+class ConditionExpression;
 }
 
-namespace dccl
-{
+/// \brief Evaluates the (dccl.field).dynamic_conditions scripts, using the built-in expression evaluator (internal::ConditionExpression) where possible, and Lua (if compiled in) for all other scripts.
 class DynamicConditions
 {
   public:
@@ -68,6 +75,21 @@ class DynamicConditions
     double min();
     double max();
 
+    /// \brief Compile the conditions of the current field (set_field()) and find the fields they read, so this is done when the message is loaded rather than on first use. The result is shared with the DynamicConditions of each CodecSession (see share_compiled()).
+    ///
+    /// \param root_desc Descriptor of the base message ("root")
+    /// \throw Exception if a condition is not supported by the built-in evaluator and DCCL was built without Lua
+    void compile(const google::protobuf::Descriptor* root_desc);
+
+    /// \brief Use (read-only) the conditions compiled by compile() on another instance
+    void share_compiled(const DynamicConditions& other) { shared_compiled_ = other.shared_compiled_; }
+
+    /// \brief Discard all cached condition results (called at the start of each encode, decode or size)
+    void clear_results();
+
+    /// \brief Discard the cached results of the conditions that read this field (called when the field is set while decoding)
+    void field_changed(const google::protobuf::FieldDescriptor* field);
+
   private:
     std::string return_prefix(const std::string& script)
     {
@@ -83,8 +105,59 @@ class DynamicConditions
     const google::protobuf::Message* root_msg_{nullptr};
     int index_{0};
 
+    enum class Condition
+    {
+        REQUIRED_IF,
+        OMIT_IF,
+        ONLY_IF,
+        MIN,
+        MAX
+    };
+
+    // the compiled conditions of one field (within one root message)
+    struct CompiledField;
+    using CompiledKey =
+        std::pair<const google::protobuf::FieldDescriptor*, const google::protobuf::Descriptor*>;
+    using CompiledMap = std::map<CompiledKey, CompiledField>;
+
+    const CompiledField& compiled();
+    CompiledField compile_field(const google::protobuf::Descriptor* root_desc);
+
+    // runs the condition with the built-in evaluator if possible, otherwise with Lua, caching
+    // the result until clear_results() or field_changed() on a field it reads (on any field,
+    // for Lua)
+    template <typename T> T evaluate(Condition condition, const std::string& script);
+
+    // compiled by compile() when messages are loaded, shared with each CodecSession
+    std::shared_ptr<CompiledMap> shared_compiled_;
+    // compiled on first use (not shared)
+    std::unique_ptr<CompiledMap> local_compiled_;
+
+    // field, condition, this message, repeated index (-1 if not used)
+    using ResultKey = std::tuple<const google::protobuf::FieldDescriptor*, Condition,
+                                 const google::protobuf::Message*, int>;
+    struct Result
+    {
+        double value;
+        // fields read by the condition (sorted), owned by the CompiledField, or null if unknown
+        // (Lua), in which case the result is discarded when any field changes
+        const std::vector<const google::protobuf::FieldDescriptor*>* dependencies;
+    };
+    std::map<ResultKey, Result> results_;
+
 #if DCCL_HAS_LUA
-    sol::state* lua_{nullptr};
+    // Lua state with the compiled condition scripts and the last message tables loaded into it
+    struct LuaState;
+    LuaState* lua_{nullptr};
+    // true if the contents of the messages may have changed since the Lua tables were built
+    // (set by clear_results() and field_changed())
+    bool lua_stale_{true};
+
+    // loads this_msg_, root_msg_ and index_ into the Lua state (if changed)
+    void update_lua();
+
+    // runs the (cached) compiled script with Lua, returning its result
+    template <typename T> T evaluate_lua(const std::string& script);
 #endif
 };
 
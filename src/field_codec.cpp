@@ -52,20 +52,20 @@ void dccl::FieldCodecBase::field_encode(Bitset* bits, const dccl::any& field_val
     internal::MessageStack msg_handler(root_message(), message_data(), field);
 
     if (field)
-        dlog.is(DEBUG2, ENCODE) && dlog << "Starting encode for field: " << field->DebugString()
-                                        << std::flush;
+        DCCL_LOG_IS(DEBUG2, ENCODE) &&
+            dlog << "Starting encode for field: " << field->DebugString() << std::flush;
 
     dccl::any wire_value;
     field_pre_encode(&wire_value, field_value);
 
     Bitset new_bits;
     any_encode(&new_bits, wire_value);
-    disp_size(field, new_bits, msg_handler.field_size());
+    disp_size(field, new_bits.size(), msg_handler.field_size());
     bits->append(new_bits);
 
     if (field)
-        dlog.is(DEBUG2, ENCODE) && dlog << "... produced these " << new_bits.size()
-                                        << " bits: " << new_bits << std::endl;
+        DCCL_LOG_IS(DEBUG2, ENCODE) &&
+            dlog << "... produced these " << new_bits.size() << " bits: " << new_bits << std::endl;
 }
 
 void dccl::FieldCodecBase::field_encode_repeated(Bitset* bits,
@@ -79,10 +79,56 @@ void dccl::FieldCodecBase::field_encode_repeated(Bitset* bits,
 
     Bitset new_bits;
     any_encode_repeated(&new_bits, wire_values);
-    disp_size(field, new_bits, msg_handler.field_size(), wire_values.size());
+    disp_size(field, new_bits.size(), msg_handler.field_size(), wire_values.size());
     bits->append(new_bits);
 }
 
+void dccl::FieldCodecBase::base_encode(BitWriter* writer,
+                                       const google::protobuf::Message& field_value,
+                                       MessagePart part, bool strict)
+{
+    BaseRAII scoped_globals(this, part, &field_value, strict);
+
+    field_encode(writer,
+                 manager().type_helper().find(field_value.GetDescriptor())->get_value(field_value),
+                 nullptr);
+}
+
+void dccl::FieldCodecBase::field_encode(BitWriter* writer, const dccl::any& field_value,
+                                        const google::protobuf::FieldDescriptor* field)
+{
+    internal::MessageStack msg_handler(root_message(), message_data(), field);
+
+    if (field)
+        DCCL_LOG_IS(DEBUG2, ENCODE) &&
+            dlog << "Starting encode for field: " << field->DebugString() << std::flush;
+
+    dccl::any wire_value;
+    field_pre_encode(&wire_value, field_value);
+
+    std::size_t start = writer->size();
+    any_encode(writer, wire_value);
+    disp_size(field, writer->size() - start, msg_handler.field_size());
+
+    if (field)
+        DCCL_LOG_IS(DEBUG2, ENCODE) &&
+            dlog << "... produced " << writer->size() - start << " bits" << std::endl;
+}
+
+void dccl::FieldCodecBase::field_encode_repeated(BitWriter* writer,
+                                                 const std::vector<dccl::any>& field_values,
+                                                 const google::protobuf::FieldDescriptor* field)
+{
+    internal::MessageStack msg_handler(root_message(), message_data(), field);
+
+    std::vector<dccl::any> wire_values;
+    field_pre_encode_repeated(&wire_values, field_values);
+
+    std::size_t start = writer->size();
+    any_encode_repeated(writer, wire_values);
+    disp_size(field, writer->size() - start, msg_handler.field_size(), wire_values.size());
+}
+
 void dccl::FieldCodecBase::base_size(unsigned* bit_size, const google::protobuf::Message& msg,
                                      MessagePart part)
 {
@@ -124,6 +170,14 @@ void dccl::FieldCodecBase::base_decode(Bitset* bits, google::protobuf::Message*
     field_decode(bits, &value, nullptr);
 }
 
+void dccl::FieldCodecBase::base_decode(BitReader* reader, google::protobuf::Message* field_value,
+                                       MessagePart part)
+{
+    BaseRAII scoped_globals(this, part, field_value);
+    dccl::any value(field_value);
+    field_decode(reader, &value, nullptr);
+}
+
 void dccl::FieldCodecBase::field_decode(Bitset* bits, dccl::any* field_value,
                                         const google::protobuf::FieldDescriptor* field)
 {
@@ -135,12 +189,12 @@ void dccl::FieldCodecBase::field_decode(Bitset* bits, dccl::any* field_value,
         throw(Exception("Decode called with NULL Bitset"));
 
     if (field)
-        dlog.is(DEBUG2, DECODE) && dlog << "Starting decode for field: " << field->DebugString()
-                                        << std::flush;
+        DCCL_LOG_IS(DEBUG2, DECODE) &&
+            dlog << "Starting decode for field: " << field->DebugString() << std::flush;
 
     if (root_message())
-        dlog.is(DEBUG3, DECODE) && dlog << "Message thus far is: " << root_message()->DebugString()
-                                        << std::flush;
+        DCCL_LOG_IS(DEBUG3, DECODE) &&
+            dlog << "Message thus far is: " << root_message()->DebugString() << std::flush;
 
     Bitset these_bits(bits);
 
@@ -149,7 +203,7 @@ void dccl::FieldCodecBase::field_decode(Bitset* bits, dccl::any* field_value,
     these_bits.get_more_bits(bits_to_transfer);
 
     if (field)
-        dlog.is(DEBUG2, DECODE) && dlog << "... using these bits: " << these_bits << std::endl;
+        DCCL_LOG_IS(DEBUG2, DECODE) && dlog << "... using these bits: " << these_bits << std::endl;
 
     dccl::any wire_value = *field_value;
 
@@ -169,7 +223,7 @@ void dccl::FieldCodecBase::field_decode_repeated(Bitset* bits, std::vector<dccl:
         throw(Exception("Decode called with NULL Bitset"));
 
     if (field)
-        dlog.is(DEBUG2, DECODE) &&
+        DCCL_LOG_IS(DEBUG2, DECODE) &&
             dlog << "Starting repeated decode for field: " << field->DebugString() << std::endl;
 
     Bitset these_bits(bits);
@@ -178,8 +232,8 @@ void dccl::FieldCodecBase::field_decode_repeated(Bitset* bits, std::vector<dccl:
     field_min_size(&bits_to_transfer, field);
     these_bits.get_more_bits(bits_to_transfer);
 
-    dlog.is(DEBUG2, DECODE) && dlog << "using these " << these_bits.size()
-                                    << " bits: " << these_bits << std::endl;
+    DCCL_LOG_IS(DEBUG2, DECODE) &&
+        dlog << "using these " << these_bits.size() << " bits: " << these_bits << std::endl;
 
     std::vector<dccl::any> wire_values = *field_values;
     any_decode_repeated(&these_bits, &wire_values);
@@ -188,6 +242,63 @@ void dccl::FieldCodecBase::field_decode_repeated(Bitset* bits, std::vector<dccl:
     field_post_decode_repeated(wire_values, field_values);
 }
 
+void dccl::FieldCodecBase::field_decode(BitReader* reader, dccl::any* field_value,
+                                        const google::protobuf::FieldDescriptor* field)
+{
+    internal::MessageStack msg_handler(root_message(), message_data(), field);
+
+    if (!field_value)
+        throw(Exception("Decode called with NULL dccl::any"));
+    else if (!reader)
+        throw(Exception("Decode called with NULL BitReader"));
+
+    if (field)
+        DCCL_LOG_IS(DEBUG2, DECODE) &&
+            dlog << "Starting decode for field: " << field->DebugString() << std::flush;
+
+    if (root_message())
+        DCCL_LOG_IS(DEBUG3, DECODE) &&
+            dlog << "Message thus far is: " << root_message()->DebugString() << std::flush;
+
+    dccl::any wire_value = *field_value;
+
+    std::size_t start = reader->position();
+    any_decode(reader, &wire_value);
+
+    if (field)
+        DCCL_LOG_IS(DEBUG2, DECODE) &&
+            dlog << "... consumed " << reader->position() - start << " bits" << std::endl;
+
+    field_post_decode(wire_value, field_value);
+}
+
+void dccl::FieldCodecBase::field_decode_repeated(BitReader* reader,
+                                                 std::vector<dccl::any>* field_values,
+                                                 const google::protobuf::FieldDescriptor* field)
+{
+    internal::MessageStack msg_handler(root_message(), message_data(), field);
+
+    if (!field_values)
+        throw(Exception("Decode called with NULL field_values"));
+    else if (!reader)
+        throw(Exception("Decode called with NULL BitReader"));
+
+    if (field)
+        DCCL_LOG_IS(DEBUG2, DECODE) &&
+            dlog << "Starting repeated decode for field: " << field->DebugString() << std::endl;
+
+    std::vector<dccl::any> wire_values = *field_values;
+
+    std::size_t start = reader->position();
+    any_decode_repeated(reader, &wire_values);
+
+    DCCL_LOG_IS(DEBUG2, DECODE) &&
+        dlog << "... consumed " << reader->position() - start << " bits" << std::endl;
+
+    field_values->clear();
+    field_post_decode_repeated(wire_values, field_values);
+}
+
 void dccl::FieldCodecBase::base_max_size(unsigned* bit_size,
                                          const google::protobuf::Descriptor* desc, MessagePart part)
 {
@@ -364,8 +475,37 @@ std::string dccl::FieldCodecBase::codec_group(const google::protobuf::Descriptor
 
 std::string dccl::FieldCodecBase::info() { return std::string(); }
 
+void dccl::FieldCodecBase::any_encode(BitWriter* writer, const dccl::any& wire_value)
+{
+    Bitset bits;
+    any_encode(&bits, wire_value);
+    writer->append(bits);
+}
+
 void dccl::FieldCodecBase::any_encode_repeated(dccl::Bitset* bits,
                                                const std::vector<dccl::any>& wire_values)
+{
+    BitWriter writer(bits);
+    default_any_encode_repeated(&writer, wire_values);
+}
+
+void dccl::FieldCodecBase::any_encode_repeated(BitWriter* writer,
+                                               const std::vector<dccl::any>& wire_values)
+{
+    if (default_repeated_)
+    {
+        default_any_encode_repeated(writer, wire_values);
+    }
+    else
+    {
+        Bitset bits;
+        any_encode_repeated(&bits, wire_values);
+        writer->append(bits);
+    }
+}
+
+void dccl::FieldCodecBase::default_any_encode_repeated(BitWriter* writer,
+                                                       const std::vector<dccl::any>& wire_values)
 {
     // out_bits = [field_values[2]][field_values[1]][field_values[0]]
 
@@ -392,13 +532,14 @@ void dccl::FieldCodecBase::any_encode_repeated(dccl::Bitset* bits,
         wire_vector_size = std::max(static_cast<int>(dccl_field_options().min_repeat()),
                                     static_cast<int>(wire_vector_size));
 
-        Bitset size_bits(repeated_vector_field_size(dccl_field_options().min_repeat(),
-                                                    dccl_field_options().max_repeat()),
-                         wire_vector_size - dccl_field_options().min_repeat());
-        bits->append(size_bits);
+        unsigned size_bits_size = repeated_vector_field_size(dccl_field_options().min_repeat(),
+                                                             dccl_field_options().max_repeat());
+        unsigned size_value = wire_vector_size - dccl_field_options().min_repeat();
+        writer->append(size_value, size_bits_size);
 
-        dlog.is(DEBUG2, ENCODE) && dlog << "repeated size field ... produced these "
-                                        << size_bits.size() << " bits: " << size_bits << std::endl;
+        DCCL_LOG_IS(DEBUG2, ENCODE) &&
+            dlog << "repeated size field ... produced these " << size_bits_size << " bits: "
+                 << Bitset(size_bits_size, size_value) << std::endl;
     }
 
     internal::MessageStack msg_handler(root_message(), message_data(), this->this_field());
@@ -415,12 +556,10 @@ void dccl::FieldCodecBase::any_encode_repeated(dccl::Bitset* bits,
                 continue;
         }
 
-        Bitset new_bits;
         if (i < wire_values.size())
-            any_encode(&new_bits, wire_values[i]);
+            any_encode(writer, wire_values[i]);
         else
-            any_encode(&new_bits, dccl::any());
-        bits->append(new_bits);
+            any_encode(writer, dccl::any());
     }
 }
 
@@ -459,6 +598,61 @@ void dccl::FieldCodecBase::any_decode_repeated(Bitset* repeated_bits,
     }
 }
 
+void dccl::FieldCodecBase::any_decode(BitReader* reader, dccl::any* wire_value)
+{
+    BitReader::Pool pool(reader);
+    Bitset these_bits(pool.bits());
+    these_bits.get_more_bits(min_size());
+    any_decode(&these_bits, wire_value);
+}
+
+void dccl::FieldCodecBase::any_decode_repeated(BitReader* reader,
+                                               std::vector<dccl::any>* wire_values)
+{
+    if (default_repeated_)
+    {
+        default_any_decode_repeated(reader, wire_values);
+    }
+    else
+    {
+        BitReader::Pool pool(reader);
+        Bitset these_bits(pool.bits());
+        these_bits.get_more_bits(min_size_repeated());
+        any_decode_repeated(&these_bits, wire_values);
+    }
+}
+
+void dccl::FieldCodecBase::default_any_decode_repeated(BitReader* reader,
+                                                       std::vector<dccl::any>* wire_values)
+{
+    unsigned wire_vector_size = dccl_field_options().max_repeat();
+    if (codec_version() > 2)
+    {
+        wire_vector_size = reader->read(repeated_vector_field_size(
+                               dccl_field_options().min_repeat(), dccl_field_options().max_repeat())) +
+                           dccl_field_options().min_repeat();
+    }
+
+    wire_values->resize(wire_vector_size);
+
+    internal::MessageStack msg_handler(root_message(), message_data(), this->this_field());
+    for (unsigned i = 0, n = wire_vector_size; i < n; ++i)
+    {
+        msg_handler.update_index(root_message(), this->this_field(), i);
+
+        DynamicConditions& dc = this->dynamic_conditions(this->this_field());
+        dc.set_repeated_index(i);
+        if (dc.has_omit_if())
+        {
+            dc.regenerate(this_message(), root_message(), i);
+            if (dc.omit())
+                continue;
+        }
+
+        any_decode(reader, &(*wire_values)[i]);
+    }
+}
+
 unsigned dccl::FieldCodecBase::any_size_repeated(const std::vector<dccl::any>& wire_values)
 {
     unsigned out = 0;
@@ -560,23 +754,24 @@ void dccl::FieldCodecBase::any_post_decode_repeated(const std::vector<dccl::any>
 //
 
 void dccl::FieldCodecBase::disp_size(const google::protobuf::FieldDescriptor* field,
-                                     const Bitset& new_bits, int depth, int vector_size /* = -1 */)
+                                     unsigned new_bits_size, int depth,
+                                     int vector_size /* = -1 */)
 {
     if (!root_descriptor())
         return;
 
-    if (dlog.check(DEBUG2))
+    if (DCCL_LOG_CHECK(DEBUG2))
     {
         std::string name = ((field) ? field->name() : root_descriptor()->full_name());
         if (vector_size >= 0)
             name += "[" + std::to_string(vector_size) + "]";
 
-        dlog.is(DEBUG2, SIZE) && dlog << std::string(depth, '|') << name << std::setfill('.')
-                                      << std::setw(40 - name.size() - depth) << new_bits.size()
-                                      << std::endl;
+        DCCL_LOG_IS(DEBUG2, SIZE) &&
+            dlog << std::string(depth, '|') << name << std::setfill('.')
+                 << std::setw(40 - name.size() - depth) << new_bits_size << std::endl;
 
         if (!field)
-            dlog.is(DEBUG2, SIZE) && dlog << std::endl;
+            DCCL_LOG_IS(DEBUG2, SIZE) && dlog << std::endl;
     }
 }
 
@@ -628,6 +823,11 @@ const dccl::internal::MessageStackData& dccl::FieldCodecBase::message_data() con
 {
     return manager().codec_data().message_data_;
 }
+
+void dccl::FieldCodecBase::set_size_uses_state()
+{
+    manager().codec_data().size_uses_state_ = true;
+}
 bool dccl::FieldCodecBase::has_codec_group()
 {
     const google::protobuf::Descriptor* root_desc = root_descriptor();
@@ -677,6 +877,8 @@ dccl::FieldCodecBase::BaseRAII::BaseRAII(FieldCodecBase* field_codec, MessagePar
     field_codec_->manager().codec_data().part_ = part;
     field_codec_->manager().codec_data().strict_ = strict;
     field_codec_->manager().codec_data().root_message_ = root_message;
+    // the message may have changed since the conditions were last evaluated
+    field_codec_->manager().codec_data().dynamic_conditions_.clear_results();
     field_codec_->manager().codec_data().root_descriptor_ = root_message->GetDescriptor();
 }
 dccl::FieldCodecBase::BaseRAII::~BaseRAII()
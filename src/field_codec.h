@@ -27,6 +27,8 @@
 
 #include <map>
 #include <string>
+#include <type_traits>
+#include <utility>
 
 #include <google/protobuf/descriptor.h>
 #include <google/protobuf/descriptor.pb.h>
@@ -34,6 +36,8 @@
 
 #include "any.h"
 #include "binary.h"
+#include "bit_reader.h"
+#include "bit_writer.h"
 #include "common.h"
 #include "dynamic_conditions.h"
 #include "exception.h"
@@ -48,7 +52,43 @@ class Codec;
 namespace internal
 {
 class MessageStack;
-}
+
+/// \brief True if the encode(BitWriter*, const wire_type&) overload is visible in Codec, that is, Codec either declares it or inherits it without hiding it by redeclaring only the Bitset returning encode().
+template <typename Codec, typename Enable = void> struct HasBitWriterEncode : std::false_type
+{
+};
+
+template <typename Codec>
+struct HasBitWriterEncode<
+    Codec, decltype(std::declval<Codec&>().encode(
+                        std::declval<BitWriter*>(), std::declval<const typename Codec::wire_type&>()),
+                    void())> : std::true_type
+{
+};
+
+/// \brief True if the decode(BitReader*) overload is visible in Codec, that is, Codec either declares it or inherits it without hiding it by redeclaring only decode(Bitset*).
+template <typename Codec, typename Enable = void> struct HasBitReaderDecode : std::false_type
+{
+};
+
+template <typename Codec>
+struct HasBitReaderDecode<
+    Codec, decltype(std::declval<Codec&>().decode(std::declval<BitReader*>()), void())>
+    : std::true_type
+{
+};
+
+/// \brief True if Codec declares (or inherits) `using default_repeated = std::true_type;`, marking that it uses the default encoding of repeated fields (it doesn't override the Bitset any_encode_repeated() or any_decode_repeated()), so repeated fields can be encoded and decoded directly with default_any_encode_repeated() and default_any_decode_repeated().
+template <typename Codec, typename Enable = void> struct HasDefaultRepeated : std::false_type
+{
+};
+
+template <typename Codec>
+struct HasDefaultRepeated<Codec, std::enable_if_t<Codec::default_repeated::value>>
+    : std::true_type
+{
+};
+} // namespace internal
 
 /// \brief Provides a base class for defining DCCL field encoders / decoders. Most users who wish to define custom encoders/decoders will use the RepeatedTypedFieldCodec, TypedFieldCodec or its children (e.g. TypedFixedFieldCodec) instead of directly inheriting from this class.
 class FieldCodecBase
@@ -117,11 +157,23 @@ class FieldCodecBase
     /// \brief the part of the message currently being encoded (head or body)
     MessagePart part();
 
+    /// \brief Call from the max_size() or min_size() methods when the size depends on state that changes as messages are encoded or decoded (e.g. adaptive models), so that Codec recomputes the message sizes instead of caching them
+    void set_size_uses_state();
+
     bool strict();
 
     /// \brief Force the codec to always use the "required" field encoding, regardless of the FieldDescriptor setting. Useful when wrapping this codec in another that handles optional and repeated fields
     void set_force_use_required(bool force_required = true) { force_required_ = force_required; }
 
+    /// \brief Allow the codec to encode directly into a BitWriter (using encode(BitWriter*, ...)) rather than returning a Bitset. This is set by FieldCodecManagerLocal::add() from internal::HasBitWriterEncode so that codecs derived from the default codecs which only override the Bitset returning encode() keep working.
+    void set_bit_writer_encode(bool enable = true) { bit_writer_encode_ = enable; }
+
+    /// \brief Allow the codec to decode directly from a BitReader (using decode(BitReader*)) rather than from a Bitset. This is set by FieldCodecManagerLocal::add() from internal::HasBitReaderDecode so that codecs derived from the default codecs which only override decode(Bitset*) keep working.
+    void set_bit_reader_decode(bool enable = true) { bit_reader_decode_ = enable; }
+
+    /// \brief Encode and decode repeated fields directly with default_any_encode_repeated() and default_any_decode_repeated() rather than through the Bitset any_encode_repeated() and any_decode_repeated(). This is set by FieldCodecManagerLocal::add() from internal::HasDefaultRepeated. A codec derived from a default codec that overrides the Bitset methods should declare `using default_repeated = std::false_type;`.
+    void set_default_repeated(bool enable = true) { default_repeated_ = enable; }
+
     //@}
 
     /// \name Base message functions
@@ -144,6 +196,14 @@ class FieldCodecBase
     void base_encode(Bitset* bits, const google::protobuf::Message& msg, MessagePart part,
                      bool strict);
 
+    /// \brief Encode this part (body or head) of the base message directly into its destination
+    ///
+    /// \param writer BitWriter where all bits will be appended.
+    /// \param msg DCCL Message to encode
+    /// \param part Part of the message to encode
+    void base_encode(BitWriter* writer, const google::protobuf::Message& msg, MessagePart part,
+                     bool strict);
+
     /// \brief Calculate the size (in bits) of a part of the base message when it is encoded
     ///
     /// \param bit_size Pointer to unsigned integer to store the result.
@@ -158,6 +218,13 @@ class FieldCodecBase
     /// \param part part of the Message to decode
     void base_decode(Bitset* bits, google::protobuf::Message* msg, MessagePart part);
 
+    /// \brief Decode part of a message directly from the encoded bytes
+    ///
+    /// \param reader BitReader positioned at the start of this part. The bits used are consumed from the reader.
+    /// \param msg DCCL Message to <i>merge</i> the decoded result into.
+    /// \param part part of the Message to decode
+    void base_decode(BitReader* reader, google::protobuf::Message* msg, MessagePart part);
+
     /// \brief Calculate the maximum size of a message given its Descriptor alone (no data)
     ///
     /// \param bit_size Pointer to unsigned integer to store calculated maximum size in bits.
@@ -237,6 +304,22 @@ class FieldCodecBase
     void field_encode_repeated(Bitset* bits, const std::vector<dccl::any>& field_values,
                                const google::protobuf::FieldDescriptor* field);
 
+    /// \brief Encode a non-repeated field directly into its destination.
+    ///
+    /// \param writer BitWriter to append the encoded bits to
+    /// \param field_value Value to encode (FieldType)
+    /// \param field Protobuf descriptor to the field to encode. Set to 0 for base message.
+    void field_encode(BitWriter* writer, const dccl::any& field_value,
+                      const google::protobuf::FieldDescriptor* field);
+
+    /// \brief Encode a repeated field directly into its destination.
+    ///
+    /// \param writer BitWriter to append the encoded bits to
+    /// \param field_values Values to encode (FieldType)
+    /// \param field Protobuf descriptor to the field. Set to 0 for base message.
+    void field_encode_repeated(BitWriter* writer, const std::vector<dccl::any>& field_values,
+                               const google::protobuf::FieldDescriptor* field);
+
     /// \brief Calculate the size of a field
     ///
     /// \param bit_size Location to <i>add</i> calculated bit size to. Be sure to zero `bit_size` if you want only the size of this field.
@@ -270,6 +353,22 @@ class FieldCodecBase
     void field_decode_repeated(Bitset* bits, std::vector<dccl::any>* field_values,
                                const google::protobuf::FieldDescriptor* field);
 
+    /// \brief Decode a non-repeated field directly from the encoded bytes
+    ///
+    /// \param reader Bits to decode. Used bits are consumed from the reader
+    /// \param field_value Location to store decoded value (FieldType)
+    /// \param field Protobuf descriptor to the field. Set to 0 for base message.
+    void field_decode(BitReader* reader, dccl::any* field_value,
+                      const google::protobuf::FieldDescriptor* field);
+
+    /// \brief Decode a repeated field directly from the encoded bytes
+    ///
+    /// \param reader Bits to decode. Used bits are consumed from the reader
+    /// \param field_values Location to store decoded values (FieldType)
+    /// \param field Protobuf descriptor to the field. Set to 0 for base message.
+    void field_decode_repeated(BitReader* reader, std::vector<dccl::any>* field_values,
+                               const google::protobuf::FieldDescriptor* field);
+
     /// \brief Post-decodes a non-repeated (i.e. optional or required) field by converting the WireType (the type used in the encoded DCCL message) representation into the FieldType representation (the Google Protobuf representation). This allows for type-converting codecs.
     ///
     /// \param wire_value Should be set to the desired value to translate
@@ -369,6 +468,12 @@ class FieldCodecBase
     virtual void set_manager(FieldCodecManagerLocal* manager) { manager_ = manager; }
 
   protected:
+    /// \brief Whether encode(BitWriter*, ...) can be used in place of the Bitset returning encode() (see set_bit_writer_encode())
+    bool bit_writer_encode() const { return bit_writer_encode_; }
+
+    /// \brief Whether decode(BitReader*) can be used in place of decode(Bitset*) (see set_bit_reader_decode())
+    bool bit_reader_decode() const { return bit_reader_decode_; }
+
     /// \brief Whether to use the required or optional encoding
     bool use_required()
     {
@@ -404,12 +509,26 @@ class FieldCodecBase
     /// \param wire_value Value to encode (WireType)
     virtual void any_encode(Bitset* bits, const dccl::any& wire_value) = 0;
 
+    /// \brief Virtual method used to encode directly into the destination (e.g. the caller's buffer passed to Codec::encode()).
+    ///
+    /// The default implementation encodes into a temporary Bitset with any_encode(Bitset*, const dccl::any&) and appends the result, so existing codecs work unchanged. Override this to avoid the temporary Bitset.
+    /// \param writer BitWriter to append the encoded bits to
+    /// \param wire_value Value to encode (WireType)
+    virtual void any_encode(BitWriter* writer, const dccl::any& wire_value);
+
     /// \brief Virtual method used to decode
     ///
     /// \param bits Bitset containing bits to decode. This will initially contain min_size() bits. If you need more bits, call get_more_bits() with the number of bits required. This bits will be consumed from the bit pool and placed in `bits`.
     /// \param wire_value Place to store decoded value (as FieldType)
     virtual void any_decode(Bitset* bits, dccl::any* wire_value) = 0;
 
+    /// \brief Virtual method used to decode directly from the encoded bytes (e.g. those passed to Codec::decode()).
+    ///
+    /// The default implementation passes min_size() bits to any_decode(Bitset*, dccl::any*) in a Bitset whose parent holds the rest of the unread bits (see BitReader::Pool), so existing codecs work unchanged. Override this to read the bits directly.
+    /// \param reader BitReader to consume the bits from
+    /// \param wire_value Place to store decoded value (as FieldType)
+    virtual void any_decode(BitReader* reader, dccl::any* wire_value);
+
     /// \brief Virtual method used to pre-encode (convert from FieldType to WireType). The default implementation of this method is for when WireType == FieldType and simply copies the field_value to the wire_value.
     ///
     /// \param wire_value Converted value (WireType)
@@ -454,7 +573,11 @@ class FieldCodecBase
     virtual unsigned min_size() = 0;
 
     virtual void any_encode_repeated(Bitset* bits, const std::vector<dccl::any>& wire_values);
+    /// \brief Encode a repeated field directly into the destination. The default implementation calls default_any_encode_repeated() for codecs that use the default repeated encoding (see set_default_repeated()), and otherwise calls any_encode_repeated(Bitset*, const std::vector<dccl::any>&) and appends the result, so codecs that override that method work unchanged.
+    virtual void any_encode_repeated(BitWriter* writer, const std::vector<dccl::any>& wire_values);
     virtual void any_decode_repeated(Bitset* repeated_bits, std::vector<dccl::any>* field_values);
+    /// \brief Decode a repeated field directly from the encoded bytes. The default implementation calls default_any_decode_repeated() for codecs that use the default repeated encoding (see set_default_repeated()), and otherwise calls any_decode_repeated(Bitset*, std::vector<dccl::any>*) (as for any_decode(BitReader*, dccl::any*)), so codecs that override that method work unchanged.
+    virtual void any_decode_repeated(BitReader* reader, std::vector<dccl::any>* field_values);
 
     virtual void any_pre_encode_repeated(std::vector<dccl::any>* wire_values,
                                          const std::vector<dccl::any>& field_values);
@@ -467,6 +590,12 @@ class FieldCodecBase
     virtual unsigned min_size_repeated();
     void check_repeat_settings() const;
 
+    /// \brief The default encoding of a repeated field (a size prefix for DCCL3 and beyond, followed by each value encoded with any_encode(BitWriter*, const dccl::any&))
+    void default_any_encode_repeated(BitWriter* writer, const std::vector<dccl::any>& wire_values);
+
+    /// \brief The default decoding of a repeated field (the inverse of default_any_encode_repeated(), with each value decoded by any_decode(BitReader*, dccl::any*))
+    void default_any_decode_repeated(BitReader* reader, std::vector<dccl::any>* wire_values);
+
     friend class FieldCodecManagerLocal;
 
   private:
@@ -488,7 +617,7 @@ class FieldCodecBase
         return dccl::ceil_log2(max_repeat - min_repeat + 1);
     }
 
-    void disp_size(const google::protobuf::FieldDescriptor* field, const Bitset& new_bits,
+    void disp_size(const google::protobuf::FieldDescriptor* field, unsigned new_bits_size,
                    int depth, int vector_size = -1);
 
   private:
@@ -513,6 +642,9 @@ class FieldCodecBase
     google::protobuf::FieldDescriptor::CppType wire_type_;
 
     bool force_required_{false};
+    bool bit_writer_encode_{false};
+    bool bit_reader_decode_{false};
+    bool default_repeated_{false};
 
     FieldCodecManagerLocal* manager_{nullptr};
 };
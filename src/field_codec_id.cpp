@@ -27,7 +27,7 @@
 // DefaultIdentifierCodec
 //
 
-dccl::Bitset dccl::DefaultIdentifierCodec::encode() { return encode(0); }
+dccl::Bitset dccl::DefaultIdentifierCodec::encode() { return encode(uint32(0)); }
 
 dccl::Bitset dccl::DefaultIdentifierCodec::encode(const uint32& id)
 {
@@ -46,6 +46,15 @@ dccl::Bitset dccl::DefaultIdentifierCodec::encode(const uint32& id)
     }
 }
 
+void dccl::DefaultIdentifierCodec::encode(BitWriter* writer) { encode(writer, uint32(0)); }
+
+void dccl::DefaultIdentifierCodec::encode(BitWriter* writer, const uint32& id)
+{
+    // LSB indicates short (0) or long (1) header form
+    writer->append(id <= ONE_BYTE_MAX_ID ? 0 : 1, 1);
+    writer->append(id, this_size(id) - 1);
+}
+
 dccl::uint32 dccl::DefaultIdentifierCodec::decode(Bitset* bits)
 {
     if (bits->test(0))
@@ -65,6 +74,15 @@ dccl::uint32 dccl::DefaultIdentifierCodec::decode(Bitset* bits)
     }
 }
 
+dccl::uint32 dccl::DefaultIdentifierCodec::decode(BitReader* reader)
+{
+    // LSB indicates short (0) or long (1) header form
+    if (reader->read(1))
+        return reader->read(LONG_FORM_ID_BYTES * BITS_IN_BYTE - 1);
+    else
+        return reader->read(SHORT_FORM_ID_BYTES * BITS_IN_BYTE - 1);
+}
+
 unsigned dccl::DefaultIdentifierCodec::size() { return this_size(0); }
 
 unsigned dccl::DefaultIdentifierCodec::size(const uint32& id) { return this_size(id); }
@@ -28,6 +28,11 @@ namespace dccl
 /// \brief Provides the default 1 byte or 2 byte DCCL ID codec
 class DefaultIdentifierCodec : public TypedFieldCodec<uint32>
 {
+  public:
+    void encode(BitWriter* writer) override;
+    void encode(BitWriter* writer, const uint32& wire_value) override;
+    uint32 decode(BitReader* reader) override;
+
   protected:
     Bitset encode() override;
     Bitset encode(const uint32& wire_value) override;
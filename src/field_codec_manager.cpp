@@ -22,11 +22,54 @@
 // You should have received a copy of the GNU Lesser General Public License
 // along with DCCL.  If not, see <http://www.gnu.org/licenses/>.
 #include "field_codec_manager.h"
+#include "oneof.h"
 
 dccl::FieldCodecManagerLocal::FieldCodecManagerLocal() = default;
 
 dccl::FieldCodecManagerLocal::~FieldCodecManagerLocal() = default;
 
+namespace
+{
+struct ActiveSession
+{
+    const dccl::FieldCodecManagerLocal* manager;
+    dccl::internal::CodecData* data;
+};
+// sessions created on this thread, most recent last
+thread_local std::vector<ActiveSession> active_sessions;
+} // namespace
+
+void dccl::FieldCodecManagerLocal::begin_session(internal::CodecData* data)
+{
+    data->share_codec_specific_data(codec_data_);
+    data->dynamic_conditions_.share_compiled(codec_data_.dynamic_conditions_);
+    active_sessions.push_back({this, data});
+    ++sessions_;
+}
+
+void dccl::FieldCodecManagerLocal::end_session(internal::CodecData* data)
+{
+    for (auto it = active_sessions.rbegin(), end = active_sessions.rend(); it != end; ++it)
+    {
+        if (it->data == data)
+        {
+            active_sessions.erase(std::next(it).base());
+            --sessions_;
+            return;
+        }
+    }
+}
+
+dccl::internal::CodecData& dccl::FieldCodecManagerLocal::session_codec_data()
+{
+    for (auto it = active_sessions.rbegin(), end = active_sessions.rend(); it != end; ++it)
+    {
+        if (it->manager == this)
+            return *it->data;
+    }
+    return codec_data_;
+}
+
 std::shared_ptr<dccl::FieldCodecBase>
 dccl::FieldCodecManagerLocal::__find(google::protobuf::FieldDescriptor::Type type,
                                      const std::string& codec_name,
@@ -50,3 +93,83 @@ dccl::FieldCodecManagerLocal::__find(google::protobuf::FieldDescriptor::Type typ
     throw(Exception("No codec by the name `" + codec_name +
                     "` found for type: " + type_helper().find(type)->as_str()));
 }
+
+const dccl::internal::MessagePlan&
+dccl::FieldCodecManagerLocal::plan(const google::protobuf::Descriptor* desc,
+                                   const google::protobuf::Descriptor* root_desc) const
+{
+    PlanKey key(desc, root_desc);
+    auto it = plans_.find(key);
+    if (it != plans_.end())
+        return it->second;
+
+    // sessions only read the plans, so that they can share them without locking
+    if (sessions_.load(std::memory_order_acquire) != 0)
+        throw(Exception("No plan for message " + desc->full_name() +
+                        ": load() it before using the Codec from a CodecSession"));
+
+    return plans_.insert(std::make_pair(key, make_plan(desc, root_desc))).first->second;
+}
+
+dccl::internal::MessagePlan
+dccl::FieldCodecManagerLocal::make_plan(const google::protobuf::Descriptor* desc,
+                                        const google::protobuf::Descriptor* root_desc) const
+{
+    // same codec group rules as FieldCodecBase::has_codec_group() and codec_group()
+    bool has_codec_group = false;
+    std::string codec_group;
+    if (root_desc)
+    {
+        const dccl::DCCLMessageOptions& msg_options = root_desc->options().GetExtension(dccl::msg);
+        has_codec_group = msg_options.has_codec_group() || msg_options.has_codec_version();
+        codec_group = FieldCodecBase::codec_group(root_desc);
+    }
+
+    internal::MessagePlan new_plan;
+    for (int i = 0, n = desc->oneof_decl_count(); i < n; ++i)
+        new_plan.oneof_sizes.push_back(oneof_size(desc->oneof_decl(i)));
+
+    for (int i = 0, n = desc->field_count(); i < n; ++i)
+    {
+        const google::protobuf::FieldDescriptor* field_desc = desc->field(i);
+        const dccl::DCCLFieldOptions& field_options = field_desc->options().GetExtension(dccl::field);
+        if (field_options.omit())
+            continue;
+
+        internal::FieldPlan field;
+        field.field_desc = field_desc;
+        field.codec = find(field_desc, has_codec_group, codec_group).get();
+        field.helper = type_helper_.find(field_desc).get();
+        field.in_head = field_options.in_head();
+        field.is_repeated = field_desc->is_repeated();
+        field.is_message =
+            field_desc->cpp_type() == google::protobuf::FieldDescriptor::CPPTYPE_MESSAGE;
+        field.max_repeat = field_options.max_repeat();
+
+        const dccl::DCCLFieldOptions::Conditions& conditions = field_options.dynamic_conditions();
+        field.has_omit_if = conditions.has_omit_if() || conditions.has_only_if();
+        field.has_required_if = conditions.has_required_if() || conditions.has_only_if();
+        field.oneof_index = containing_oneof_index(field_desc);
+
+        new_plan.fields.push_back(field);
+    }
+
+    return new_plan;
+}
+
+void dccl::FieldCodecManagerLocal::rebuild_plans()
+{
+    for (auto it = plans_.begin(); it != plans_.end();)
+    {
+        try
+        {
+            it->second = make_plan(it->first.first, it->first.second);
+            ++it;
+        }
+        catch (Exception&)
+        {
+            // a codec the message uses was removed: built again on use, if it is added back
+            it = plans_.erase(it);
+        }
+    }
+}
@@ -24,10 +24,12 @@
 #ifndef FieldCodecManager20110405H
 #define FieldCodecManager20110405H
 
+#include <atomic>
 #include <type_traits>
 
 #include "field_codec.h"
 #include "internal/field_codec_data.h"
+#include "internal/message_plan.h"
 #include "internal/type_helper.h"
 #include "logger.h"
 #include "thread_safety.h"
@@ -148,19 +150,61 @@ class FieldCodecManagerLocal
         return __find(type, name);
     }
 
+    /// \brief Find the resolved codec, type helper and options for each field of a message. The plans for a message and its embedded messages are built when it is loaded (Codec::load()), and rebuilt when a codec is added or removed, so that plan() only reads them while the codec is shared between threads.
+    ///
+    /// Without any CodecSession, a missing plan (e.g. for the size of a message that is not loaded) is built on first use.
+    /// \throw Exception if the plan is missing while a CodecSession exists
+    ///
+    /// \param desc Message descriptor (base or embedded message)
+    /// \param root_desc Descriptor of the base message, which sets the codec group used for the fields
+    const internal::MessagePlan& plan(const google::protobuf::Descriptor* desc,
+                                      const google::protobuf::Descriptor* root_desc) const;
+
+    /// \brief Incremented every time a codec is added or removed, so that values derived from the codecs (such as the message sizes cached by Codec) can tell when they are out of date
+    unsigned revision() const { return revision_; }
+
+    /// \brief Incremented by configuration_changed(), so that values derived from the codec specific configuration (such as the message sizes cached by Codec) can tell when they are out of date
+    unsigned configuration_revision() const { return configuration_revision_; }
+
+    /// \brief Call after changing codec specific configuration that the sizes of the field codecs depend on (such as an arithmetic model)
+    void configuration_changed() { ++configuration_revision_; }
+
     void clear()
     {
         type_helper_.reset();
         codecs_.clear();
+        plans_.clear();
+        ++revision_;
     }
 
     internal::TypeHelper& type_helper() { return type_helper_; }
     const internal::TypeHelper& type_helper() const { return type_helper_; }
 
-    internal::CodecData& codec_data() { return codec_data_; }
-    const internal::CodecData& codec_data() const { return codec_data_; }
+    /// \brief State used by the field codecs while encoding or decoding a message. If a CodecSession for this manager is active on the calling thread, this is the session's state, otherwise it is the manager's own.
+    internal::CodecData& codec_data()
+    {
+        if (sessions_.load(std::memory_order_acquire) == 0)
+            return codec_data_;
+        else
+            return session_codec_data();
+    }
+    const internal::CodecData& codec_data() const
+    {
+        return const_cast<FieldCodecManagerLocal*>(this)->codec_data();
+    }
 
   private:
+    friend class CodecSession;
+    internal::MessagePlan make_plan(const google::protobuf::Descriptor* desc,
+                                    const google::protobuf::Descriptor* root_desc) const;
+    // rebuild the existing plans with the current codecs (dropping those that no longer resolve)
+    void rebuild_plans();
+
+    // use data for codec_data() on the calling thread, until end_session(data) is called
+    void begin_session(internal::CodecData* data);
+    void end_session(internal::CodecData* data);
+    internal::CodecData& session_codec_data();
+
     std::shared_ptr<FieldCodecBase> __find(google::protobuf::FieldDescriptor::Type type,
                                            const std::string& codec_name,
                                            const std::string& type_name = "") const;
@@ -214,8 +258,17 @@ class FieldCodecManagerLocal
     using InsideMap = std::map<std::string, std::shared_ptr<FieldCodecBase>>;
     std::map<google::protobuf::FieldDescriptor::Type, InsideMap> codecs_;
 
+    // keyed on (message descriptor, root message descriptor)
+    using PlanKey =
+        std::pair<const google::protobuf::Descriptor*, const google::protobuf::Descriptor*>;
+    mutable std::map<PlanKey, internal::MessagePlan> plans_;
+    unsigned revision_{0};
+    unsigned configuration_revision_{0};
+
     internal::TypeHelper type_helper_;
     internal::CodecData codec_data_;
+    // number of CodecSessions (on any thread) using this manager
+    std::atomic<int> sessions_{0};
 };
 
 class FieldCodecManager
@@ -346,16 +399,21 @@ void dccl::FieldCodecManagerLocal::add_single_type(
     new_field_codec->set_field_type(field_type);
     new_field_codec->set_wire_type(wire_type);
     new_field_codec->set_manager(this);
+    new_field_codec->set_bit_writer_encode(internal::HasBitWriterEncode<Codec>::value);
+    new_field_codec->set_bit_reader_decode(internal::HasBitReaderDecode<Codec>::value);
+    new_field_codec->set_default_repeated(internal::HasDefaultRepeated<Codec>::value);
     using google::protobuf::FieldDescriptor;
     if (!codecs_[field_type].count(name))
     {
         codecs_[field_type][name] = new_field_codec;
-        dccl::dlog.is(dccl::logger::DEBUG1) && dccl::dlog << "Adding codec " << *new_field_codec
-                                                          << std::endl;
+        rebuild_plans();
+        ++revision_;
+        DCCL_LOG_IS(DEBUG1, GENERAL) &&
+            dccl::dlog << "Adding codec " << *new_field_codec << std::endl;
     }
     else
     {
-        dccl::dlog.is(dccl::logger::DEBUG1) &&
+        DCCL_LOG_IS(DEBUG1, GENERAL) &&
             dccl::dlog << "Trying to add: " << *new_field_codec
                        << ", but already have duplicate codec (For `name`/`field type` pair) "
                        << *(codecs_[field_type].find(name)->second) << std::endl;
@@ -416,9 +474,11 @@ void dccl::FieldCodecManagerLocal::remove_single_type(
     using google::protobuf::FieldDescriptor;
     if (codecs_[field_type].count(name))
     {
-        dccl::dlog.is(dccl::logger::DEBUG1) &&
+        DCCL_LOG_IS(DEBUG1, GENERAL) &&
             dccl::dlog << "Removing codec " << *codecs_[field_type][name] << std::endl;
         codecs_[field_type].erase(name);
+        rebuild_plans();
+        ++revision_;
     }
     else
     {
@@ -428,9 +488,9 @@ void dccl::FieldCodecManagerLocal::remove_single_type(
         new_field_codec->set_wire_type(wire_type);
         new_field_codec->set_manager(this);
 
-        dccl::dlog.is(dccl::logger::DEBUG1) && dccl::dlog
-                                                   << "Trying to remove: " << *new_field_codec
-                                                   << ", but no such codec exists" << std::endl;
+        DCCL_LOG_IS(DEBUG1, GENERAL) &&
+            dccl::dlog << "Trying to remove: " << *new_field_codec << ", but no such codec exists"
+                       << std::endl;
     }
 }
 
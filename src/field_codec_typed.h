@@ -88,12 +88,65 @@ class TypedFieldCodec : public FieldCodecSelector<WireType, FieldType>
     /// \return Bits represented the encoded field.
     virtual Bitset encode(const WireType& wire_value) = 0;
 
+    /// \brief Encode an empty field directly into its destination. The default implementation appends the result of encode(); override this (and encode(BitWriter*, const WireType&)) to avoid creating a Bitset for each field.
+    ///
+    /// \param writer BitWriter to append the encoded bits to.
+    virtual void encode(BitWriter* writer) { writer->append(encode()); }
+
+    /// \brief Encode a non-empty field directly into its destination. The default implementation appends the result of encode(const WireType&).
+    ///
+    /// \param writer BitWriter to append the encoded bits to.
+    /// \param wire_value Value to encode.
+    virtual void encode(BitWriter* writer, const WireType& wire_value)
+    {
+        writer->append(encode(wire_value));
+    }
+
+    /// \brief Encode an empty field into writer, using encode(BitWriter*) if enabled (see FieldCodecBase::set_bit_writer_encode()), or otherwise appending the result of encode()
+    void write(BitWriter* writer)
+    {
+        if (this->bit_writer_encode())
+            encode(writer);
+        else
+            writer->append(encode());
+    }
+
+    /// \brief Encode a non-empty field into writer, using encode(BitWriter*, const WireType&) if enabled (see FieldCodecBase::set_bit_writer_encode()), or otherwise appending the result of encode(const WireType&)
+    void write(BitWriter* writer, const WireType& wire_value)
+    {
+        if (this->bit_writer_encode())
+            encode(writer, wire_value);
+        else
+            writer->append(encode(wire_value));
+    }
+
     /// \brief Decode a field. If the field is empty (i.e. was encoded using the zero-argument encode()), throw NullValueException to indicate this.
     ///
     /// \param bits Bits to use for decoding.
     /// \return the decoded value.
     virtual WireType decode(Bitset* bits) = 0;
 
+    /// \brief Decode a field directly from the encoded bytes. If the field is empty, throw NullValueException. The default implementation calls decode(Bitset*) with min_size() bits whose parent holds the rest of the unread bits (see BitReader::Pool); override this to read the bits directly.
+    ///
+    /// \param reader BitReader to consume the bits from.
+    /// \return the decoded value.
+    virtual WireType decode(BitReader* reader)
+    {
+        BitReader::Pool pool(reader);
+        Bitset bits(pool.bits());
+        bits.get_more_bits(this->min_size());
+        return decode(&bits);
+    }
+
+    /// \brief Decode a field from reader, using decode(BitReader*) if enabled (see FieldCodecBase::set_bit_reader_decode()), or otherwise decode(Bitset*)
+    WireType read(BitReader* reader)
+    {
+        if (this->bit_reader_decode())
+            return decode(reader);
+        else
+            return TypedFieldCodec::decode(reader);
+    }
+
     /// \brief Calculate the size (in bits) of an empty field.
     ///
     /// \return the size (in bits) of the empty field.
@@ -130,11 +183,33 @@ class TypedFieldCodec : public FieldCodecSelector<WireType, FieldType>
         }
     }
 
+    void any_encode(BitWriter* writer, const dccl::any& wire_value) override
+    {
+        try
+        {
+            if (is_empty(wire_value))
+                write(writer);
+            else
+                write(writer, dccl::any_cast<WireType>(wire_value));
+        }
+        catch (dccl::bad_any_cast&)
+        {
+            throw(type_error("encode", typeid(WireType), wire_value.type()));
+        }
+    }
+
     void any_decode(Bitset* bits, dccl::any* wire_value) override
     {
         any_decode_specific<WireType>(bits, wire_value);
     }
 
+    void any_decode(BitReader* reader, dccl::any* wire_value) override
+    {
+        any_decode_specific<WireType>(reader, wire_value);
+    }
+
+    WireType read(Bitset* bits) { return decode(bits); }
+
     void any_pre_encode(dccl::any* wire_value, const dccl::any& field_value) override
     {
         try
@@ -184,14 +259,14 @@ class TypedFieldCodec : public FieldCodecSelector<WireType, FieldType>
         }
     }
 
-    template <typename T>
+    template <typename T, typename Bits>
     typename std::enable_if_t<std::is_base_of<google::protobuf::Message, T>::value, void>
-    any_decode_specific(Bitset* bits, dccl::any* wire_value)
+    any_decode_specific(Bits* bits, dccl::any* wire_value)
     {
         try
         {
             auto* msg = dccl::any_cast<google::protobuf::Message*>(*wire_value);
-            msg->CopyFrom(decode(bits));
+            msg->CopyFrom(read(bits));
         }
         catch (NullValueException&)
         {
@@ -200,13 +275,13 @@ class TypedFieldCodec : public FieldCodecSelector<WireType, FieldType>
         }
     }
 
-    template <typename T>
+    template <typename T, typename Bits>
     typename std::enable_if_t<!std::is_base_of<google::protobuf::Message, T>::value, void>
-    any_decode_specific(Bitset* bits, dccl::any* wire_value)
+    any_decode_specific(Bits* bits, dccl::any* wire_value)
     {
         try
         {
-            *wire_value = decode(bits);
+            *wire_value = read(bits);
         }
         catch (NullValueException&)
         {
@@ -264,7 +339,7 @@ class RepeatedTypedFieldCodec : public TypedFieldCodec<WireType, FieldType>
     WireType decode(dccl::Bitset* bits) override
     {
         std::vector<WireType> return_vec = decode_repeated(bits);
-        if (is_empty(return_vec))
+        if (return_vec.empty())
             throw dccl::NullValueException();
         else
             return return_vec.at(0);
@@ -303,11 +378,23 @@ class RepeatedTypedFieldCodec : public TypedFieldCodec<WireType, FieldType>
         }
     }
 
+    void any_encode_repeated(BitWriter* writer, const std::vector<dccl::any>& wire_values) override
+    {
+        Bitset bits;
+        any_encode_repeated(&bits, wire_values);
+        writer->append(bits);
+    }
+
     void any_decode_repeated(Bitset* repeated_bits, std::vector<dccl::any>* field_values) override
     {
         any_decode_repeated_specific<WireType>(repeated_bits, field_values);
     }
 
+    void any_decode_repeated(BitReader* reader, std::vector<dccl::any>* field_values) override
+    {
+        FieldCodecBase::any_decode_repeated(reader, field_values);
+    }
+
     template <typename T>
     typename std::enable_if_t<std::is_base_of<google::protobuf::Message, T>::value, void>
     any_decode_repeated_specific(Bitset* repeated_bits, std::vector<dccl::any>* wire_values)
@@ -0,0 +1,727 @@
+// Copyright 2026:
+//   GobySoft, LLC (2013-)
+//   Community contributors (see AUTHORS file)
+// File authors:
+//   Toby Schneider <toby@gobysoft.org>
+//
+//
+// This file is part of the Dynamic Compact Control Language Library
+// ("DCCL").
+//
+// DCCL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 2.1 of the License, or
+// (at your option) any later version.
+//
+// DCCL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DCCL.  If not, see <http://www.gnu.org/licenses/>.
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+#include "../exception.h"
+#include "condition_expression.h"
+
+using dccl::Exception;
+using dccl::internal::ConditionExpression;
+using Value = ConditionExpression::Value;
+using Context = ConditionExpression::Context;
+
+struct ConditionExpression::Node
+{
+    virtual ~Node() = default;
+    virtual Value evaluate(const Context& context) const = 0;
+};
+
+namespace
+{
+using Node = ConditionExpression::Node;
+using NodePtr = std::unique_ptr<Node>;
+
+const char* type_name(Value::Type type)
+{
+    switch (type)
+    {
+        case Value::Type::NIL: return "nil";
+        case Value::Type::BOOLEAN: return "boolean";
+        case Value::Type::NUMBER: return "number";
+        case Value::Type::STRING: return "string";
+        case Value::Type::MESSAGE:
+        case Value::Type::REPEATED: return "table";
+    }
+    return "unknown";
+}
+
+Value make_boolean(bool b)
+{
+    Value v;
+    v.type = Value::Type::BOOLEAN;
+    v.boolean = b;
+    return v;
+}
+
+Value make_number(double d)
+{
+    Value v;
+    v.type = Value::Type::NUMBER;
+    v.number = d;
+    return v;
+}
+
+Value make_string(std::string s)
+{
+    Value v;
+    v.type = Value::Type::STRING;
+    v.string = std::move(s);
+    return v;
+}
+
+Value make_message(const google::protobuf::Message* msg)
+{
+    Value v;
+    v.type = Value::Type::MESSAGE;
+    v.msg = msg;
+    return v;
+}
+
+// value of a singular field (index < 0) or one element of a repeated field
+Value field_value(const google::protobuf::Message& msg,
+                  const google::protobuf::FieldDescriptor* field, int index)
+{
+    using google::protobuf::FieldDescriptor;
+    const google::protobuf::Reflection* refl = msg.GetReflection();
+    const bool repeated = index >= 0;
+
+    switch (field->cpp_type())
+    {
+        case FieldDescriptor::CPPTYPE_INT32:
+            return make_number(repeated ? refl->GetRepeatedInt32(msg, field, index)
+                                        : refl->GetInt32(msg, field));
+        case FieldDescriptor::CPPTYPE_INT64:
+            return make_number(repeated ? refl->GetRepeatedInt64(msg, field, index)
+                                        : refl->GetInt64(msg, field));
+        case FieldDescriptor::CPPTYPE_UINT32:
+            return make_number(repeated ? refl->GetRepeatedUInt32(msg, field, index)
+                                        : refl->GetUInt32(msg, field));
+        case FieldDescriptor::CPPTYPE_UINT64:
+            return make_number(repeated ? refl->GetRepeatedUInt64(msg, field, index)
+                                        : refl->GetUInt64(msg, field));
+        case FieldDescriptor::CPPTYPE_DOUBLE:
+            return make_number(repeated ? refl->GetRepeatedDouble(msg, field, index)
+                                        : refl->GetDouble(msg, field));
+        case FieldDescriptor::CPPTYPE_FLOAT:
+            return make_number(repeated ? refl->GetRepeatedFloat(msg, field, index)
+                                        : refl->GetFloat(msg, field));
+        case FieldDescriptor::CPPTYPE_BOOL:
+            return make_boolean(repeated ? refl->GetRepeatedBool(msg, field, index)
+                                         : refl->GetBool(msg, field));
+        case FieldDescriptor::CPPTYPE_STRING:
+            return make_string(repeated ? refl->GetRepeatedString(msg, field, index)
+                                        : refl->GetString(msg, field));
+        case FieldDescriptor::CPPTYPE_ENUM:
+            // lua-protobuf decodes enumerations to the name of the value
+            return make_string(repeated ? refl->GetRepeatedEnum(msg, field, index)->name()
+                                        : refl->GetEnum(msg, field)->name());
+        case FieldDescriptor::CPPTYPE_MESSAGE:
+            return make_message(repeated ? &refl->GetRepeatedMessage(msg, field, index)
+                                         : &refl->GetMessage(msg, field));
+    }
+    return Value();
+}
+
+class ConstantNode : public Node
+{
+  public:
+    explicit ConstantNode(Value value) : value_(std::move(value)) {}
+    Value evaluate(const Context& /*context*/) const override { return value_; }
+
+  private:
+    Value value_;
+};
+
+class ThisIndexNode : public Node
+{
+  public:
+    Value evaluate(const Context& context) const override
+    {
+        return make_number(context.this_index);
+    }
+};
+
+// "this" or "root" followed by any number of ".name" or "[index]"
+class PathNode : public Node
+{
+  public:
+    struct Segment
+    {
+        std::string name;
+        NodePtr index; // used instead of name if set
+    };
+
+    PathNode(bool from_root, std::vector<Segment> segments)
+        : from_root_(from_root), segments_(std::move(segments))
+    {
+    }
+
+    Value evaluate(const Context& context) const override
+    {
+        const google::protobuf::Message* start = from_root_ ? context.root_msg : context.this_msg;
+        if (!start)
+            return Value();
+
+        Value current = make_message(start);
+        for (std::size_t i = 0, n = segments_.size(); i < n; ++i)
+        {
+            const Segment& segment = segments_[i];
+            const bool last = (i + 1 == n);
+            if (segment.index)
+            {
+                if (current.type != Value::Type::REPEATED)
+                    throw(Exception(std::string("attempt to index a ") + type_name(current.type) +
+                                    " value"));
+
+                Value index = segment.index->evaluate(context);
+                if (index.type != Value::Type::NUMBER)
+                    return Value();
+
+                const int size = current.msg->GetReflection()->FieldSize(*current.msg,
+                                                                         current.field);
+                // Lua tables are indexed from 1; missing entries are nil
+                const double cpp_index = index.number - 1;
+                if (cpp_index < 0 || cpp_index >= size || cpp_index != std::floor(cpp_index))
+                    current = Value();
+                else
+                    current = field_value(*current.msg, current.field, static_cast<int>(cpp_index));
+            }
+            else
+            {
+                if (current.type != Value::Type::MESSAGE)
+                    throw(Exception(std::string("attempt to index a ") + type_name(current.type) +
+                                    " value (field '" + segment.name + "')"));
+
+                const google::protobuf::FieldDescriptor* field =
+                    current.msg->GetDescriptor()->FindFieldByName(segment.name);
+                if (!field)
+                {
+                    current = Value();
+                }
+                else if (field->is_repeated())
+                {
+                    current.type = Value::Type::REPEATED;
+                    current.field = field;
+                }
+                else if (last &&
+                         field->cpp_type() == google::protobuf::FieldDescriptor::CPPTYPE_MESSAGE &&
+                         !current.msg->GetReflection()->HasField(*current.msg, field))
+                {
+                    // unset embedded messages are nil, but their (default) fields can be read
+                    current = Value();
+                }
+                else
+                {
+                    current = field_value(*current.msg, field, -1);
+                }
+            }
+        }
+        return current;
+    }
+
+  private:
+    bool from_root_;
+    std::vector<Segment> segments_;
+};
+
+enum class Op
+{
+    AND,
+    OR,
+    NOT,
+    EQ,
+    NE,
+    LT,
+    LE,
+    GT,
+    GE,
+    ADD,
+    SUB,
+    MUL,
+    DIV,
+    IDIV,
+    MOD,
+    POW,
+    NEG,
+    LEN
+};
+
+double number_operand(const Value& v, const char* operation)
+{
+    if (v.type != Value::Type::NUMBER)
+        throw(Exception(std::string("attempt to perform ") + operation + " on a " +
+                        type_name(v.type) + " value"));
+    return v.number;
+}
+
+class UnaryNode : public Node
+{
+  public:
+    UnaryNode(Op op, NodePtr operand) : op_(op), operand_(std::move(operand)) {}
+
+    Value evaluate(const Context& context) const override
+    {
+        Value v = operand_->evaluate(context);
+        switch (op_)
+        {
+            case Op::NOT: return make_boolean(!v.truthy());
+            case Op::NEG: return make_number(-number_operand(v, "arithmetic"));
+            case Op::LEN:
+                if (v.type == Value::Type::STRING)
+                    return make_number(v.string.size());
+                else if (v.type == Value::Type::REPEATED)
+                    return make_number(v.msg->GetReflection()->FieldSize(*v.msg, v.field));
+                else
+                    throw(Exception(std::string("attempt to get length of a ") +
+                                    type_name(v.type) + " value"));
+            default: break;
+        }
+        throw(Exception("Invalid unary operator"));
+    }
+
+  private:
+    Op op_;
+    NodePtr operand_;
+};
+
+class BinaryNode : public Node
+{
+  public:
+    BinaryNode(Op op, NodePtr lhs, NodePtr rhs)
+        : op_(op), lhs_(std::move(lhs)), rhs_(std::move(rhs))
+    {
+    }
+
+    Value evaluate(const Context& context) const override
+    {
+        Value a = lhs_->evaluate(context);
+
+        // short circuit, returning the deciding operand as Lua does
+        if (op_ == Op::AND)
+            return a.truthy() ? rhs_->evaluate(context) : a;
+        if (op_ == Op::OR)
+            return a.truthy() ? a : rhs_->evaluate(context);
+
+        Value b = rhs_->evaluate(context);
+        switch (op_)
+        {
+            case Op::EQ: return make_boolean(equal(a, b));
+            case Op::NE: return make_boolean(!equal(a, b));
+            case Op::LT: return make_boolean(less(a, b));
+            case Op::LE: return make_boolean(!less(b, a));
+            case Op::GT: return make_boolean(less(b, a));
+            case Op::GE: return make_boolean(!less(a, b));
+            default: break;
+        }
+
+        double x = number_operand(a, "arithmetic"), y = number_operand(b, "arithmetic");
+        switch (op_)
+        {
+            case Op::ADD: return make_number(x + y);
+            case Op::SUB: return make_number(x - y);
+            case Op::MUL: return make_number(x * y);
+            case Op::DIV: return make_number(x / y);
+            case Op::IDIV: return make_number(std::floor(x / y));
+            case Op::MOD: return make_number(x - std::floor(x / y) * y);
+            case Op::POW: return make_number(std::pow(x, y));
+            default: break;
+        }
+        throw(Exception("Invalid binary operator"));
+    }
+
+  private:
+    static bool equal(const Value& a, const Value& b)
+    {
+        if (a.type != b.type)
+            return false;
+        switch (a.type)
+        {
+            case Value::Type::NIL: return true;
+            case Value::Type::BOOLEAN: return a.boolean == b.boolean;
+            case Value::Type::NUMBER: return a.number == b.number;
+            case Value::Type::STRING: return a.string == b.string;
+            case Value::Type::MESSAGE: return a.msg == b.msg;
+            case Value::Type::REPEATED: return a.msg == b.msg && a.field == b.field;
+        }
+        return false;
+    }
+
+    static bool less(const Value& a, const Value& b)
+    {
+        if (a.type == Value::Type::NUMBER && b.type == Value::Type::NUMBER)
+            return a.number < b.number;
+        else if (a.type == Value::Type::STRING && b.type == Value::Type::STRING)
+            return a.string < b.string;
+        else
+            throw(Exception(std::string("attempt to compare ") + type_name(a.type) + " with " +
+                            type_name(b.type)));
+    }
+
+    Op op_;
+    NodePtr lhs_;
+    NodePtr rhs_;
+};
+
+// recursive descent parser using Lua's operator precedence
+class Parser
+{
+  public:
+    Parser(const std::string& script, std::vector<ConditionExpression::Reference>* references,
+           bool* uses_this_index)
+        : s_(script), references_(references), uses_this_index_(uses_this_index)
+    {
+    }
+
+    NodePtr parse()
+    {
+        next();
+        if (is_name("return"))
+            next();
+        NodePtr expr = parse_or();
+        if (is_op(";"))
+            next();
+        if (token_ != Token::END)
+            error("unexpected '" + text_ + "'");
+        return expr;
+    }
+
+  private:
+    enum class Token
+    {
+        END,
+        NAME,
+        NUMBER,
+        STRING,
+        OP
+    };
+
+    void error(const std::string& what)
+    {
+        throw(Exception("Cannot parse condition \"" + s_ + "\": " + what));
+    }
+
+    bool is_op(const char* op) const { return token_ == Token::OP && text_ == op; }
+    bool is_name(const char* name) const { return token_ == Token::NAME && text_ == name; }
+
+    void expect_op(const char* op)
+    {
+        if (!is_op(op))
+            error(std::string("expected '") + op + "'");
+        next();
+    }
+
+    // reads the next token into token_ and text_ (and number_ for numbers)
+    void next()
+    {
+        while (pos_ < s_.size() && std::isspace(static_cast<unsigned char>(s_[pos_]))) ++pos_;
+
+        text_.clear();
+        if (pos_ >= s_.size())
+        {
+            token_ = Token::END;
+            return;
+        }
+
+        char c = s_[pos_];
+        if (std::isalpha(static_cast<unsigned char>(c)) || c == '_')
+        {
+            token_ = Token::NAME;
+            while (pos_ < s_.size() &&
+                   (std::isalnum(static_cast<unsigned char>(s_[pos_])) || s_[pos_] == '_'))
+                text_ += s_[pos_++];
+        }
+        else if (std::isdigit(static_cast<unsigned char>(c)) ||
+                 (c == '.' && pos_ + 1 < s_.size() &&
+                  std::isdigit(static_cast<unsigned char>(s_[pos_ + 1]))))
+        {
+            token_ = Token::NUMBER;
+            const char* begin = s_.c_str() + pos_;
+            char* end = nullptr;
+            number_ = std::strtod(begin, &end);
+            pos_ += end - begin;
+            text_.assign(begin, end - begin);
+        }
+        else if (c == '\'' || c == '"')
+        {
+            token_ = Token::STRING;
+            ++pos_;
+            while (pos_ < s_.size() && s_[pos_] != c)
+            {
+                if (s_[pos_] == '\\')
+                    error("escape sequences in strings are not supported");
+                text_ += s_[pos_++];
+            }
+            if (pos_ >= s_.size())
+                error("unfinished string");
+            ++pos_;
+        }
+        else
+        {
+            token_ = Token::OP;
+            static const char* two_char_ops[] = {"==", "~=", "<=", ">=", "//"};
+            for (const char* op : two_char_ops)
+            {
+                if (s_.compare(pos_, 2, op) == 0)
+                {
+                    text_ = op;
+                    pos_ += 2;
+                    return;
+                }
+            }
+
+            // ".." (concatenation), "--" (comments), etc. are not supported
+            if (s_.compare(pos_, 2, "..") == 0 || s_.compare(pos_, 2, "--") == 0)
+                error("'" + s_.substr(pos_, 2) + "' is not supported");
+
+            static const std::string one_char_ops = "<>+-*/%^#()[].;";
+            if (one_char_ops.find(c) == std::string::npos)
+                error(std::string("unexpected '") + c + "'");
+            text_ = c;
+            ++pos_;
+        }
+    }
+
+    NodePtr parse_or()
+    {
+        NodePtr lhs = parse_and();
+        while (is_name("or"))
+        {
+            next();
+            lhs.reset(new BinaryNode(Op::OR, std::move(lhs), parse_and()));
+        }
+        return lhs;
+    }
+
+    NodePtr parse_and()
+    {
+        NodePtr lhs = parse_comparison();
+        while (is_name("and"))
+        {
+            next();
+            lhs.reset(new BinaryNode(Op::AND, std::move(lhs), parse_comparison()));
+        }
+        return lhs;
+    }
+
+    NodePtr parse_comparison()
+    {
+        NodePtr lhs = parse_additive();
+        for (;;)
+        {
+            Op op;
+            if (is_op("=="))
+                op = Op::EQ;
+            else if (is_op("~="))
+                op = Op::NE;
+            else if (is_op("<"))
+                op = Op::LT;
+            else if (is_op("<="))
+                op = Op::LE;
+            else if (is_op(">"))
+                op = Op::GT;
+            else if (is_op(">="))
+                op = Op::GE;
+            else
+                return lhs;
+            next();
+            lhs.reset(new BinaryNode(op, std::move(lhs), parse_additive()));
+        }
+    }
+
+    NodePtr parse_additive()
+    {
+        NodePtr lhs = parse_multiplicative();
+        while (is_op("+") || is_op("-"))
+        {
+            Op op = is_op("+") ? Op::ADD : Op::SUB;
+            next();
+            lhs.reset(new BinaryNode(op, std::move(lhs), parse_multiplicative()));
+        }
+        return lhs;
+    }
+
+    NodePtr parse_multiplicative()
+    {
+        NodePtr lhs = parse_unary();
+        for (;;)
+        {
+            Op op;
+            if (is_op("*"))
+                op = Op::MUL;
+            else if (is_op("/"))
+                op = Op::DIV;
+            else if (is_op("//"))
+                op = Op::IDIV;
+            else if (is_op("%"))
+                op = Op::MOD;
+            else
+                return lhs;
+            next();
+            lhs.reset(new BinaryNode(op, std::move(lhs), parse_unary()));
+        }
+    }
+
+    NodePtr parse_unary()
+    {
+        Op op;
+        if (is_name("not"))
+            op = Op::NOT;
+        else if (is_op("-"))
+            op = Op::NEG;
+        else if (is_op("#"))
+            op = Op::LEN;
+        else
+            return parse_power();
+
+        next();
+        return NodePtr(new UnaryNode(op, parse_unary()));
+    }
+
+    NodePtr parse_power()
+    {
+        NodePtr base = parse_primary();
+        if (is_op("^"))
+        {
+            next();
+            // right associative, and binds tighter than a unary operator on its left
+            return NodePtr(new BinaryNode(Op::POW, std::move(base), parse_unary()));
+        }
+        return base;
+    }
+
+    NodePtr parse_primary()
+    {
+        NodePtr node;
+        if (token_ == Token::NUMBER)
+        {
+            node.reset(new ConstantNode(make_number(number_)));
+        }
+        else if (token_ == Token::STRING)
+        {
+            node.reset(new ConstantNode(make_string(text_)));
+        }
+        else if (is_name("true") || is_name("false"))
+        {
+            node.reset(new ConstantNode(make_boolean(text_ == "true")));
+        }
+        else if (is_name("nil"))
+        {
+            node.reset(new ConstantNode(Value()));
+        }
+        else if (is_name("this_index"))
+        {
+            *uses_this_index_ = true;
+            node.reset(new ThisIndexNode);
+        }
+        else if (is_name("this") || is_name("root"))
+        {
+            return parse_path();
+        }
+        else if (is_op("("))
+        {
+            next();
+            node = parse_or();
+            expect_op(")");
+            return node;
+        }
+        else if (token_ == Token::END)
+        {
+            error("unexpected end of script");
+        }
+        else
+        {
+            // function calls, other global variables, keywords, etc.
+            error("'" + text_ + "' is not supported");
+        }
+        next();
+        return node;
+    }
+
+    NodePtr parse_path()
+    {
+        const bool from_root = is_name("root");
+        next();
+
+        ConditionExpression::Reference reference;
+        reference.from_root = from_root;
+
+        std::vector<PathNode::Segment> segments;
+        for (;;)
+        {
+            PathNode::Segment segment;
+            if (is_op("."))
+            {
+                next();
+                if (token_ != Token::NAME)
+                    error("expected field name after '.'");
+                segment.name = text_;
+                reference.fields.push_back(text_);
+                next();
+            }
+            else if (is_op("["))
+            {
+                next();
+                segment.index = parse_or();
+                expect_op("]");
+            }
+            else
+            {
+                break;
+            }
+            segments.push_back(std::move(segment));
+        }
+        references_->push_back(std::move(reference));
+        return NodePtr(new PathNode(from_root, std::move(segments)));
+    }
+
+    const std::string& s_;
+    std::vector<ConditionExpression::Reference>* references_;
+    bool* uses_this_index_;
+    std::size_t pos_{0};
+    Token token_{Token::END};
+    std::string text_;
+    double number_{0};
+};
+
+} // namespace
+
+ConditionExpression::ConditionExpression(const std::string& script)
+    : script_(script), root_(Parser(script, &references_, &uses_this_index_).parse())
+{
+}
+
+ConditionExpression::~ConditionExpression() = default;
+
+Value ConditionExpression::evaluate(const Context& context) const
+{
+    try
+    {
+        return root_->evaluate(context);
+    }
+    catch (Exception& e)
+    {
+        throw(Exception("Failed to evaluate condition \"" + script_ + "\": " + e.what()));
+    }
+}
+
+double ConditionExpression::evaluate_number(const Context& context) const
+{
+    Value v = evaluate(context);
+    if (v.type != Value::Type::NUMBER)
+        throw(Exception("Condition \"" + script_ + "\" returned a " + type_name(v.type) +
+                        " value, expected a number"));
+    return v.number;
+}
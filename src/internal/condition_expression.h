@@ -0,0 +1,122 @@
+// Copyright 2026:
+//   GobySoft, LLC (2013-)
+//   Community contributors (see AUTHORS file)
+// File authors:
+//   Toby Schneider <toby@gobysoft.org>
+//
+//
+// This file is part of the Dynamic Compact Control Language Library
+// ("DCCL").
+//
+// DCCL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 2.1 of the License, or
+// (at your option) any later version.
+//
+// DCCL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DCCL.  If not, see <http://www.gnu.org/licenses/>.
+#ifndef DCCLCONDITIONEXPRESSION20261018H
+#define DCCLCONDITIONEXPRESSION20261018H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <google/protobuf/message.h>
+
+namespace dccl
+{
+namespace internal
+{
+/// \brief Built-in evaluator for the common subset of the Lua scripts used in (dccl.field).dynamic_conditions, reading the field values directly from the messages with Protobuf reflection.
+///
+/// Supports an optional leading "return", field references starting from "this" or "root" (e.g. "root.child[this_index].i"), "this_index", number, string, boolean and nil literals, the comparison ("==", "~=", "<", "<=", ">", ">="), logical ("and", "or", "not"), arithmetic ("+", "-", "*", "/", "//", "%", "^") and length ("#") operators, and parentheses, all with the same semantics as Lua. As with lua-protobuf, enumerations evaluate to the name of the value, repeated fields are indexed from 1, and unset fields evaluate to their default value (or nil for unset embedded messages).
+class ConditionExpression
+{
+  public:
+    /// \brief Compile the given script
+    ///
+    /// \throw Exception if the script is not within the subset supported
+    explicit ConditionExpression(const std::string& script);
+    ~ConditionExpression();
+
+    ConditionExpression(const ConditionExpression&) = delete;
+    ConditionExpression& operator=(const ConditionExpression&) = delete;
+
+    /// \brief The result of evaluating an expression (or part of it)
+    struct Value
+    {
+        enum class Type
+        {
+            NIL,
+            BOOLEAN,
+            NUMBER,
+            STRING,
+            MESSAGE,
+            REPEATED
+        };
+
+        Type type{Type::NIL};
+        bool boolean{false};
+        double number{0};
+        std::string string;
+        // for MESSAGE, the message, for REPEATED, the message containing field
+        const google::protobuf::Message* msg{nullptr};
+        const google::protobuf::FieldDescriptor* field{nullptr};
+
+        /// \brief Lua truth value: everything except nil and false is true
+        bool truthy() const { return !(type == Type::NIL || (type == Type::BOOLEAN && !boolean)); }
+    };
+
+    /// \brief The messages (and repeated index) the expression is evaluated against
+    struct Context
+    {
+        const google::protobuf::Message* this_msg{nullptr};
+        const google::protobuf::Message* root_msg{nullptr};
+        // value of "this_index" (indexed from 1, as in Lua)
+        int this_index{1};
+    };
+
+    /// \brief Evaluate the expression
+    ///
+    /// \throw Exception on a runtime error (e.g. comparing a number with a string)
+    Value evaluate(const Context& context) const;
+
+    /// \brief Evaluate the expression, converting the result to a boolean as Lua would
+    bool evaluate_bool(const Context& context) const { return evaluate(context).truthy(); }
+
+    /// \brief Evaluate the expression, which must result in a number
+    ///
+    /// \throw Exception if the result is not a number
+    double evaluate_number(const Context& context) const;
+
+    /// \brief A field path read by the expression, e.g. "root.child[this_index].i" is {true, {"child", "i"}}
+    struct Reference
+    {
+        bool from_root{false};
+        std::vector<std::string> fields;
+    };
+
+    /// \brief All the field paths read by the expression
+    const std::vector<Reference>& references() const { return references_; }
+
+    /// \brief Whether the expression reads "this_index"
+    bool uses_this_index() const { return uses_this_index_; }
+
+    struct Node;
+
+  private:
+    std::string script_;
+    std::vector<Reference> references_;
+    bool uses_this_index_{false};
+    std::unique_ptr<Node> root_;
+};
+} // namespace internal
+} // namespace dccl
+
+#endif
@@ -6,6 +6,7 @@
 #include "field_codec_message_stack.h"
 
 #include <typeindex>
+#include <vector>
 
 namespace google
 {
@@ -29,25 +30,47 @@ struct CodecData
     const google::protobuf::Descriptor* root_descriptor_{nullptr};
     MessageStackData message_data_;
     DynamicConditions dynamic_conditions_;
+    // reused for decrypting message bodies
+    std::vector<std::uint8_t> crypto_buffer_;
+    // set by field codecs whose max or min size depends on codec specific state (e.g. adaptive
+    // arithmetic models), so that the message sizes computed with them are not cached
+    // (FieldCodecBase::set_size_uses_state())
+    bool size_uses_state_{false};
 
     template <typename FieldCodecType>
     void set_codec_specific_data(std::shared_ptr<dccl::any> data)
     {
-        codec_specific_[std::type_index(typeid(FieldCodecType))] = data;
+        (*codec_specific_)[std::type_index(typeid(FieldCodecType))] = data;
     }
 
     template <typename FieldCodecType> std::shared_ptr<dccl::any> codec_specific_data()
     {
-        return codec_specific_.at(std::type_index(typeid(FieldCodecType)));
+        return codec_specific_->at(std::type_index(typeid(FieldCodecType)));
     }
 
     template <typename FieldCodecType> bool has_codec_specific_data()
     {
-        return codec_specific_.count(std::type_index(typeid(FieldCodecType)));
+        return codec_specific_->count(std::type_index(typeid(FieldCodecType)));
+    }
+
+    // codec specific data is configuration (e.g. arithmetic models), not per call state,
+    // so it is shared with the CodecData of each CodecSession
+    void share_codec_specific_data(const CodecData& other)
+    {
+        codec_specific_ = other.codec_specific_;
+    }
+
+    // codec specific state changes as messages are encoded and decoded (e.g. adaptive
+    // arithmetic models), so each CodecSession has its own (initially empty)
+    template <typename FieldCodecType> std::shared_ptr<dccl::any>& codec_specific_state()
+    {
+        return codec_specific_state_[std::type_index(typeid(FieldCodecType))];
     }
 
   private:
-    std::map<std::type_index, std::shared_ptr<dccl::any>> codec_specific_;
+    std::shared_ptr<std::map<std::type_index, std::shared_ptr<dccl::any>>> codec_specific_{
+        std::make_shared<std::map<std::type_index, std::shared_ptr<dccl::any>>>()};
+    std::map<std::type_index, std::shared_ptr<dccl::any>> codec_specific_state_;
 };
 } // namespace internal
 } // namespace dccl
@@ -0,0 +1,75 @@
+// Copyright 2026:
+//   GobySoft, LLC (2013-)
+//   Community contributors (see AUTHORS file)
+// File authors:
+//   Toby Schneider <toby@gobysoft.org>
+//
+//
+// This file is part of the Dynamic Compact Control Language Library
+// ("DCCL").
+//
+// DCCL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 2.1 of the License, or
+// (at your option) any later version.
+//
+// DCCL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DCCL.  If not, see <http://www.gnu.org/licenses/>.
+#ifndef DCCLMESSAGEPLAN20261018H
+#define DCCLMESSAGEPLAN20261018H
+
+#include <vector>
+
+namespace google
+{
+namespace protobuf
+{
+class FieldDescriptor;
+} // namespace protobuf
+} // namespace google
+
+namespace dccl
+{
+class FieldCodecBase;
+
+namespace internal
+{
+class FromProtoCppTypeBase;
+
+/// \brief Everything needed to encode or decode one field of a message, resolved once (when the message is loaded) rather than on every encode/decode.
+struct FieldPlan
+{
+    const google::protobuf::FieldDescriptor* field_desc{nullptr};
+    /// codec for this field (owned by the FieldCodecManagerLocal)
+    FieldCodecBase* codec{nullptr};
+    /// type helper for this field (owned by the TypeHelper)
+    FromProtoCppTypeBase* helper{nullptr};
+    bool in_head{false};
+    bool is_repeated{false};
+    bool is_message{false};
+    unsigned max_repeat{0};
+    /// (dccl.field).dynamic_conditions has omit_if or only_if
+    bool has_omit_if{false};
+    /// (dccl.field).dynamic_conditions has required_if or only_if
+    bool has_required_if{false};
+    /// index of the containing oneof, or -1 if not part of a oneof
+    int oneof_index{-1};
+};
+
+/// \brief The fields of a message (excluding those with (dccl.field).omit = true) in the order they are encoded.
+struct MessagePlan
+{
+    std::vector<FieldPlan> fields;
+    /// number of bits used to encode the case of each oneof, indexed by oneof index
+    std::vector<unsigned> oneof_sizes;
+};
+
+} // namespace internal
+} // namespace dccl
+
+#endif
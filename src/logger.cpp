@@ -28,25 +28,52 @@
 
 dccl::Logger dccl::dlog;
 
-int dccl::internal::LogBuffer::sync()
+namespace
+{
+// log message formatting for each thread
+struct ThreadLog
+{
+    explicit ThreadLog(dccl::Logger& logger) : buf(logger), os(&buf) {}
+    dccl::internal::LogBuffer buf;
+    std::ostream os;
+};
+
+// a pointer rather than a thread local ThreadLog, as static objects (e.g. a global dccl::Codec)
+// may still log from the main thread after the thread local objects are destroyed (in which case
+// a new ThreadLog is created, and never deleted)
+thread_local ThreadLog* thread_log_ptr = nullptr;
+
+struct ThreadLogCleanup
 {
-#if DCCL_THREAD_SUPPORT
-    if (verbosity() == logger::UNKNOWN)
+    ~ThreadLogCleanup()
     {
-        std::cerr
-            << "Must use 'dlog.is(...) && dlog << ... << std::endl;' expression when running in "
-               "thread safe mode to allow the dlog mutex to be correctly locked and unlocked. "
-               "Offending line: "
-            << buffer_.front() << std::endl;
-        exit(EXIT_FAILURE);
+        delete thread_log_ptr;
+        thread_log_ptr = nullptr;
     }
+};
+
+ThreadLog& thread_log(dccl::Logger& logger)
+{
+    if (!thread_log_ptr)
+    {
+        // there is only one Logger (dlog)
+        thread_log_ptr = new ThreadLog(logger);
+        thread_local ThreadLogCleanup cleanup;
+    }
+    return *thread_log_ptr;
+}
+} // namespace
 
-#endif
+dccl::internal::LogBuffer& dccl::Logger::thread_buffer() { return thread_log(*this).buf; }
 
+std::ostream& dccl::Logger::thread_stream() { return thread_log(*this).os; }
+
+int dccl::internal::LogBuffer::sync()
+{
     // all but last one
     while (buffer_.size() > 1)
     {
-        display(buffer_.front());
+        logger_.display(buffer_.front(), verbosity(), group());
         buffer_.pop_front();
     }
 
@@ -55,9 +82,6 @@ int dccl::internal::LogBuffer::sync()
     if (!group_.empty())
         group_.pop();
 
-#if DCCL_THREAD_SUPPORT
-    g_dlog_mutex.unlock();
-#endif
     return 0;
 }
 
@@ -78,6 +102,16 @@ int dccl::internal::LogBuffer::overflow(int c)
     return c;
 }
 
+int dccl::internal::ThreadLogBuffer::sync() { return logger_.thread_buffer().pubsync(); }
+
+int dccl::internal::ThreadLogBuffer::overflow(int c)
+{
+    if (c == EOF)
+        return c;
+    else
+        return logger_.thread_buffer().sputc(c);
+}
+
 void dccl::to_ostream(const std::string& msg, dccl::logger::Verbosity /*vrb*/,
                       dccl::logger::Group grp, std::ostream* os, bool add_timestamp)
 {
@@ -25,6 +25,7 @@
 #ifndef DCCLLOGGER20121009H
 #define DCCLLOGGER20121009H
 
+#include <atomic>
 #include <cstdio>
 #include <deque>
 #include <functional>
@@ -34,6 +35,7 @@
 #include <string>
 #include <vector>
 
+#include "dccl/def.h"
 #include "thread_safety.h"
 
 namespace dccl
@@ -73,16 +75,61 @@ class Logger;
 
 namespace internal
 {
+/// \brief Formats the log messages of one thread, and passes each complete line to the Logger on std::flush or std::endl
 class LogBuffer : public std::streambuf
 {
   public:
-    LogBuffer() : buffer_(1) {}
+    explicit LogBuffer(Logger& logger) : logger_(logger), buffer_(1) {}
     ~LogBuffer() override = default;
 
+    /// sets the verbosity level until the next sync()
+    void set_verbosity(logger::Verbosity verbosity) { verbosity_.push(verbosity); }
+
+    void set_group(logger::Group group) { group_.push(group); }
+
+  private:
+    /// virtual inherited from std::streambuf.
+    /// Called when std::endl or std::flush is inserted into the stream
+    int sync() override;
+
+    /// virtual inherited from std::streambuf. Called when something is inserted into the stream
+    /// Called when std::endl or std::flush is inserted into the stream
+    int overflow(int c = EOF) override;
+
+    logger::Verbosity verbosity()
+    {
+        return verbosity_.empty() ? logger::UNKNOWN : verbosity_.top();
+    }
+    logger::Group group() { return group_.empty() ? logger::GENERAL : group_.top(); }
+
+  private:
+    Logger& logger_;
+    std::stack<logger::Verbosity> verbosity_;
+    std::stack<logger::Group> group_;
+    std::deque<std::string> buffer_;
+};
+
+/// \brief Passes anything written directly to the Logger's std::ostream base to the calling thread's LogBuffer
+class ThreadLogBuffer : public std::streambuf
+{
+  public:
+    explicit ThreadLogBuffer(Logger& logger) : logger_(logger) {}
+
+  private:
+    int sync() override;
+    int overflow(int c = EOF) override;
+
+  private:
+    Logger& logger_;
+};
+
+/// \brief The slots connected to the Logger for each verbosity
+class LogSlots
+{
+  public:
     /// connect a signal to a slot (function pointer or similar)
     template <typename Slot> void connect(int verbosity_mask, Slot slot)
     {
-        enabled_verbosities_ |= verbosity_mask;
         if (verbosity_mask & logger::WARN)
             warn_signal.emplace_back(slot);
         if (verbosity_mask & logger::INFO)
@@ -97,7 +144,6 @@ class LogBuffer : public std::streambuf
 
     void disconnect(int verbosity_mask)
     {
-        enabled_verbosities_ &= ~verbosity_mask;
         if (verbosity_mask & logger::WARN)
             warn_signal.clear();
         if (verbosity_mask & logger::INFO)
@@ -110,58 +156,31 @@ class LogBuffer : public std::streambuf
             debug3_signal.clear();
     }
 
-    /// sets the verbosity level until the next sync()
-    void set_verbosity(logger::Verbosity verbosity) { verbosity_.push(verbosity); }
-
-    void set_group(logger::Group group) { group_.push(group); }
-
-    bool contains(logger::Verbosity verbosity) const { return verbosity & enabled_verbosities_; }
-
-  private:
-    /// virtual inherited from std::streambuf.
-    /// Called when std::endl or std::flush is inserted into the stream
-    int sync() override;
-
-    /// virtual inherited from std::streambuf. Called when something is inserted into the stream
-    /// Called when std::endl or std::flush is inserted into the stream
-    int overflow(int c = EOF) override;
-
-    void display(const std::string& s)
+    void display(const std::string& s, logger::Verbosity verbosity, logger::Group group)
     {
-        if (verbosity() & logger::WARN)
+        if (verbosity & logger::WARN)
         {
-            for (auto& slot : warn_signal) slot(s, logger::WARN, group());
+            for (auto& slot : warn_signal) slot(s, logger::WARN, group);
         }
-        if (verbosity() & logger::INFO)
+        if (verbosity & logger::INFO)
         {
-            for (auto& slot : info_signal) slot(s, logger::INFO, group());
+            for (auto& slot : info_signal) slot(s, logger::INFO, group);
         }
-        if (verbosity() & logger::DEBUG1)
+        if (verbosity & logger::DEBUG1)
         {
-            for (auto& slot : debug1_signal) slot(s, logger::DEBUG1, group());
+            for (auto& slot : debug1_signal) slot(s, logger::DEBUG1, group);
         }
-        if (verbosity() & logger::DEBUG2)
+        if (verbosity & logger::DEBUG2)
         {
-            for (auto& slot : debug2_signal) slot(s, logger::DEBUG2, group());
+            for (auto& slot : debug2_signal) slot(s, logger::DEBUG2, group);
         }
-        if (verbosity() & logger::DEBUG3)
+        if (verbosity & logger::DEBUG3)
         {
-            for (auto& slot : debug3_signal) slot(s, logger::DEBUG3, group());
+            for (auto& slot : debug3_signal) slot(s, logger::DEBUG3, group);
         }
     }
 
-    logger::Verbosity verbosity()
-    {
-        return verbosity_.empty() ? logger::UNKNOWN : verbosity_.top();
-    }
-    logger::Group group() { return group_.empty() ? logger::GENERAL : group_.top(); }
-
   private:
-    std::stack<logger::Verbosity> verbosity_;
-    std::stack<logger::Group> group_;
-    std::deque<std::string> buffer_;
-    int enabled_verbosities_; // mask of verbosity settings enabled
-
     using LogSignal = std::vector<
         std::function<void(const std::string& msg, logger::Verbosity vrb, logger::Group grp)>>;
 
@@ -170,16 +189,21 @@ class LogBuffer : public std::streambuf
 } // namespace internal
 
 /// The DCCL Logger class. Do not instantiate this class directly. Rather, use the dccl::dlog object.
+///
+/// Each thread formats its messages in its own (thread local) buffer, so logging from several threads does not require any locking until a complete message is passed to the connected slots (which is done with the dlog mutex locked when running with DCCL_THREAD_SUPPORT).
 class Logger : public std::ostream
 {
   public:
-    Logger() : std::ostream(&buf_) {}
+    Logger() : std::ostream(&buf_), buf_(*this) {}
     ~Logger() override = default;
 
-    /// \brief Same as is() but doesn't set the verbosity or lock the mutex.
-    bool check(logger::Verbosity verbosity) { return buf_.contains(verbosity); }
+    /// \brief Same as is() but doesn't set the verbosity.
+    bool check(logger::Verbosity verbosity) const
+    {
+        return verbosity & enabled_verbosities_.load(std::memory_order_relaxed);
+    }
 
-    /// \brief Indicates the verbosity of the Logger until the next std::flush or std::endl. The boolean return is used to take advantage of short-circuit evaluation of && to avoid spending CPU time generating log files that if they are not used. This locks the dlog mutex when running with DCCL_THREAD_SUPPORT
+    /// \brief Indicates the verbosity of the Logger until the next std::flush or std::endl. The boolean return is used to take advantage of short-circuit evaluation of && to avoid spending CPU time generating log files that if they are not used. This is a lock-free check of the verbosities enabled by connect().
     ///
     /// The typical usage is
     /// \code
@@ -190,21 +214,30 @@ class Logger : public std::ostream
     /// \param group The group that this message belongs to.
     bool is(logger::Verbosity verbosity, logger::Group group = logger::GENERAL)
     {
-        if (!buf_.contains(verbosity))
+        if (!check(verbosity))
         {
             return false;
         }
         else
         {
-#if DCCL_THREAD_SUPPORT
-            g_dlog_mutex.lock();
-#endif
-            buf_.set_verbosity(verbosity);
-            buf_.set_group(group);
+            internal::LogBuffer& buf = thread_buffer();
+            buf.set_verbosity(verbosity);
+            buf.set_group(group);
             return true;
         }
     }
 
+    /// \brief Write to this thread's log message
+    template <typename T> std::ostream& operator<<(const T& t) { return thread_stream() << t; }
+    std::ostream& operator<<(std::ostream& (*manip)(std::ostream&))
+    {
+        return thread_stream() << manip;
+    }
+    std::ostream& operator<<(std::ios_base& (*manip)(std::ios_base&))
+    {
+        return thread_stream() << manip;
+    }
+
     /// \brief Connect the output of one or more given verbosities to a slot (function pointer or similar)
     ///
     /// \param verbosity_mask A bitmask representing the verbosity or verbosities to send to this slot. For example, you can use connect(WARN | INFO, slot) to send both WARN and INFO messages to slot.
@@ -213,7 +246,8 @@ class Logger : public std::ostream
     template <typename Slot> void connect(int verbosity_mask, Slot slot)
     {
         DCCL_LOCK_DLOG_MUTEX
-        buf_.connect(verbosity_mask, slot);
+        slots_.connect(verbosity_mask, slot);
+        enabled_verbosities_.fetch_or(verbosity_mask);
     }
 
     /// \brief Connect the output of one or more given verbosities to a member function
@@ -227,7 +261,6 @@ class Logger : public std::ostream
                  void (Obj::*mem_func)(const std::string& msg, logger::Verbosity vrb,
                                        logger::Group grp))
     {
-        DCCL_LOCK_DLOG_MUTEX
         connect(verbosity_mask, std::bind(mem_func, obj, std::placeholders::_1,
                                           std::placeholders::_2, std::placeholders::_3));
     }
@@ -239,24 +272,55 @@ class Logger : public std::ostream
     /// \param add_timestamp If true, prepend the current timestamp of the message to each log message.
     void connect(int verbosity_mask, std::ostream* os, bool add_timestamp = true)
     {
-        DCCL_LOCK_DLOG_MUTEX
-        buf_.connect(verbosity_mask,
-                     std::bind(to_ostream, std::placeholders::_1, std::placeholders::_2,
-                               std::placeholders::_3, os, add_timestamp));
+        connect(verbosity_mask, std::bind(to_ostream, std::placeholders::_1, std::placeholders::_2,
+                                          std::placeholders::_3, os, add_timestamp));
     }
 
     /// \brief Disconnect all slots for one or more given verbosities
     void disconnect(int verbosity_mask)
     {
         DCCL_LOCK_DLOG_MUTEX
-        buf_.disconnect(verbosity_mask);
+        enabled_verbosities_.fetch_and(~verbosity_mask);
+        slots_.disconnect(verbosity_mask);
+    }
+
+  private:
+    friend class internal::LogBuffer;
+    friend class internal::ThreadLogBuffer;
+
+    /// the calling thread's buffer and stream used to format log messages
+    internal::LogBuffer& thread_buffer();
+    std::ostream& thread_stream();
+
+    /// pass a complete log message to the connected slots
+    void display(const std::string& s, logger::Verbosity verbosity, logger::Group group)
+    {
+        DCCL_LOCK_DLOG_MUTEX
+        slots_.display(s, verbosity, group);
     }
 
   private:
-    internal::LogBuffer buf_;
+    internal::ThreadLogBuffer buf_;
+    internal::LogSlots slots_;
+    // mask of verbosity settings enabled
+    std::atomic<int> enabled_verbosities_{0};
 };
 
 extern Logger dlog;
 } // namespace dccl
 
+/// \brief Same as dccl::dlog.is(verbosity, group), but always false (at compile time) for verbosities more verbose than the DCCL_MIN_LOG_LEVEL CMake option, so that the log statement is removed entirely.
+///
+/// The verbosity and group must be given without the namespace, e.g.
+/// \code
+/// DCCL_LOG_IS(DEBUG2, ENCODE) && dlog << "Something of interest while encoding." << std::endl;
+/// \endcode
+#define DCCL_LOG_IS(verbosity, group)                 \
+    (dccl::logger::verbosity <= DCCL_MIN_LOG_LEVEL && \
+     dccl::dlog.is(dccl::logger::verbosity, dccl::logger::group))
+
+/// \brief Same as dccl::dlog.check(verbosity), but always false (at compile time) for verbosities more verbose than the DCCL_MIN_LOG_LEVEL CMake option
+#define DCCL_LOG_CHECK(verbosity) \
+    (dccl::logger::verbosity <= DCCL_MIN_LOG_LEVEL && dccl::dlog.check(dccl::logger::verbosity))
+
 #endif // DCCLLOGGER20121009H
@@ -299,6 +299,9 @@ template <typename WireType, google::protobuf::FieldDescriptor::Type DeclaredTyp
           typename FieldType = WireType>
 class PrimitiveTypeFieldCodec : public TypedFieldCodec<WireType, FieldType>
 {
+  public:
+    using default_repeated = std::true_type;
+
   private:
     unsigned presence_bit_size() { return this->use_required() ? 0 : 1; }
 
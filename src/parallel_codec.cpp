@@ -0,0 +1,221 @@
+// Copyright 2026:
+//   GobySoft, LLC (2013-)
+//   Community contributors (see AUTHORS file)
+// File authors:
+//   Toby Schneider <toby@gobysoft.org>
+//
+//
+// This file is part of the Dynamic Compact Control Language Library
+// ("DCCL").
+//
+// DCCL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 2.1 of the License, or
+// (at your option) any later version.
+//
+// DCCL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DCCL.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <algorithm>
+
+#include "parallel_codec.h"
+
+dccl::ParallelCodec::ParallelCodec(Codec& codec, unsigned num_threads /* = 0 */,
+                                   std::size_t chunk_size /* = 64 */)
+    : codec_(codec), chunk_size_(std::max<std::size_t>(chunk_size, 1))
+{
+    if (num_threads == 0)
+        num_threads = std::max(std::thread::hardware_concurrency(), 1u);
+
+    for (unsigned i = 0; i < num_threads; ++i)
+        workers_.emplace_back(new Worker);
+
+    // all the workers exist before any of them can try to steal from the others
+    for (unsigned i = 0; i < num_threads; ++i)
+        workers_[i]->thread = std::thread([this, i]() { worker_main(i); });
+}
+
+dccl::ParallelCodec::~ParallelCodec()
+{
+    {
+        std::lock_guard<std::mutex> lock(job_mutex_);
+        stop_ = true;
+    }
+    job_start_.notify_all();
+    for (auto& worker : workers_) worker->thread.join();
+}
+
+std::size_t dccl::ParallelCodec::encode_batch(const google::protobuf::Message* const* msgs,
+                                              std::size_t count, std::string* bytes,
+                                              std::vector<Codec::BatchResult>* results)
+{
+    const std::size_t num_chunks = (count + chunk_size_ - 1) / chunk_size_;
+    std::vector<std::string> chunk_bytes(num_chunks);
+    std::vector<std::vector<Codec::BatchResult>> chunk_results(num_chunks);
+
+    run(num_chunks,
+        [&](std::size_t chunk)
+        {
+            std::size_t begin = chunk * chunk_size_;
+            codec_.encode_batch(msgs + begin, std::min(chunk_size_, count - begin),
+                                &chunk_bytes[chunk], &chunk_results[chunk]);
+        });
+
+    // join the chunks in order
+    std::size_t total_bytes = 0;
+    for (const auto& chunk : chunk_bytes) total_bytes += chunk.size();
+    bytes->reserve(bytes->size() + total_bytes);
+
+    results->clear();
+    results->reserve(count);
+    std::size_t encoded = 0;
+    for (std::size_t chunk = 0; chunk < num_chunks; ++chunk)
+    {
+        std::size_t offset = bytes->size();
+        bytes->append(chunk_bytes[chunk]);
+        for (Codec::BatchResult& result : chunk_results[chunk])
+        {
+            result.offset += offset;
+            if (result.ok())
+                ++encoded;
+            results->push_back(std::move(result));
+        }
+    }
+    return encoded;
+}
+
+std::size_t dccl::ParallelCodec::decode_batch(const std::string* frames, std::size_t count,
+                                              std::vector<Codec::BatchResult>* results)
+{
+    const std::size_t num_chunks = (count + chunk_size_ - 1) / chunk_size_;
+    std::vector<std::vector<Codec::BatchResult>> chunk_results(num_chunks);
+
+    run(num_chunks,
+        [&](std::size_t chunk)
+        {
+            std::size_t begin = chunk * chunk_size_;
+            codec_.decode_batch(frames + begin, std::min(chunk_size_, count - begin),
+                                &chunk_results[chunk]);
+        });
+
+    results->clear();
+    results->reserve(count);
+    std::size_t decoded = 0;
+    for (auto& chunk : chunk_results)
+    {
+        for (Codec::BatchResult& result : chunk)
+        {
+            if (result.ok())
+                ++decoded;
+            results->push_back(std::move(result));
+        }
+    }
+    return decoded;
+}
+
+void dccl::ParallelCodec::run(std::size_t num_chunks,
+                              const std::function<void(std::size_t)>& work)
+{
+    if (num_chunks == 0)
+        return;
+
+    std::unique_lock<std::mutex> lock(job_mutex_);
+
+    // give each worker a contiguous range of chunks
+    const std::size_t num_workers = workers_.size();
+    for (std::size_t i = 0; i < num_workers; ++i)
+    {
+        std::lock_guard<std::mutex> worker_lock(workers_[i]->mutex);
+        for (std::size_t chunk = i * num_chunks / num_workers,
+                         end = (i + 1) * num_chunks / num_workers;
+             chunk < end; ++chunk)
+            workers_[i]->chunks.push_back(chunk);
+    }
+
+    work_ = &work;
+    error_ = nullptr;
+    idle_workers_ = 0;
+    ++job_;
+    job_start_.notify_all();
+
+    job_done_.wait(lock, [this]() { return idle_workers_ == workers_.size(); });
+    work_ = nullptr;
+
+    if (error_)
+        std::rethrow_exception(error_);
+}
+
+void dccl::ParallelCodec::worker_main(unsigned index)
+{
+    // per-thread state for using the shared Codec
+    CodecSession session(codec_);
+
+    unsigned last_job = 0;
+    for (;;)
+    {
+        const std::function<void(std::size_t)>* work = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(job_mutex_);
+            job_start_.wait(lock, [&]() { return stop_ || job_ != last_job; });
+            if (stop_)
+                return;
+            last_job = job_;
+            work = work_;
+        }
+
+        std::size_t chunk;
+        while (next_chunk(index, &chunk))
+        {
+            try
+            {
+                (*work)(chunk);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(job_mutex_);
+                if (!error_)
+                    error_ = std::current_exception();
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(job_mutex_);
+            ++idle_workers_;
+        }
+        job_done_.notify_one();
+    }
+}
+
+bool dccl::ParallelCodec::next_chunk(unsigned index, std::size_t* chunk)
+{
+    // own chunks first, in order
+    {
+        Worker& worker = *workers_[index];
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        if (!worker.chunks.empty())
+        {
+            *chunk = worker.chunks.front();
+            worker.chunks.pop_front();
+            return true;
+        }
+    }
+
+    // then steal from the back of the other workers' chunks
+    for (std::size_t i = 1, n = workers_.size(); i < n; ++i)
+    {
+        Worker& victim = *workers_[(index + i) % n];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.chunks.empty())
+        {
+            *chunk = victim.chunks.back();
+            victim.chunks.pop_back();
+            return true;
+        }
+    }
+    return false;
+}
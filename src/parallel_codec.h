@@ -0,0 +1,103 @@
+// Copyright 2026:
+//   GobySoft, LLC (2013-)
+//   Community contributors (see AUTHORS file)
+// File authors:
+//   Toby Schneider <toby@gobysoft.org>
+//
+//
+// This file is part of the Dynamic Compact Control Language Library
+// ("DCCL").
+//
+// DCCL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 2.1 of the License, or
+// (at your option) any later version.
+//
+// DCCL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DCCL.  If not, see <http://www.gnu.org/licenses/>.
+#ifndef DCCLPARALLELCODEC20261018H
+#define DCCLPARALLELCODEC20261018H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "codec.h"
+
+namespace dccl
+{
+/// \brief Encodes and decodes large batches of messages on a pool of worker threads that share one loaded Codec.
+///
+/// Each batch is split into chunks of messages which are divided between the workers. A worker that runs out of chunks takes the remaining ones from the other workers (work stealing), so that messages that are slow to encode or decode do not leave the other threads idle. Each worker uses its own CodecSession, and the results are identical to (and in the same order as) those of Codec::encode_batch() and Codec::decode_batch().
+///
+/// All messages must be loaded into the Codec before the ParallelCodec is created, and the Codec must not be modified while the ParallelCodec exists (see CodecSession).
+class ParallelCodec
+{
+  public:
+    /// \brief Start the worker threads
+    ///
+    /// \param codec Codec (with all messages loaded) to share between the workers
+    /// \param num_threads Number of worker threads, or 0 to use one per hardware thread
+    /// \param chunk_size Number of messages in each chunk of work
+    explicit ParallelCodec(Codec& codec, unsigned num_threads = 0, std::size_t chunk_size = 64);
+    ~ParallelCodec();
+
+    ParallelCodec(const ParallelCodec&) = delete;
+    ParallelCodec& operator=(const ParallelCodec&) = delete;
+
+    /// \brief Encodes a batch of messages in parallel (see Codec::encode_batch())
+    std::size_t encode_batch(const google::protobuf::Message* const* msgs, std::size_t count,
+                             std::string* bytes, std::vector<Codec::BatchResult>* results);
+
+    /// \brief Decodes a batch of messages in parallel (see Codec::decode_batch())
+    std::size_t decode_batch(const std::string* frames, std::size_t count,
+                             std::vector<Codec::BatchResult>* results);
+
+    /// \brief Number of worker threads
+    unsigned num_threads() const { return workers_.size(); }
+
+  private:
+    struct Worker
+    {
+        std::thread thread;
+        std::mutex mutex;
+        // chunks not yet started, taken from the front by this worker and from the back by others
+        std::deque<std::size_t> chunks;
+    };
+
+    // calls work(i) for i in [0, num_chunks) on the workers and waits for them to finish
+    void run(std::size_t num_chunks, const std::function<void(std::size_t)>& work);
+    void worker_main(unsigned index);
+    bool next_chunk(unsigned index, std::size_t* chunk);
+
+  private:
+    Codec& codec_;
+    std::size_t chunk_size_;
+    std::vector<std::unique_ptr<Worker>> workers_;
+
+    std::mutex job_mutex_;
+    std::condition_variable job_start_;
+    std::condition_variable job_done_;
+    const std::function<void(std::size_t)>* work_{nullptr};
+    std::exception_ptr error_;
+    // incremented for each job
+    unsigned job_{0};
+    // workers that have finished the current job
+    unsigned idle_workers_{0};
+    bool stop_{false};
+};
+} // namespace dccl
+
+#endif
@@ -0,0 +1,278 @@
+// Copyright 2026:
+//   GobySoft, LLC (2013-)
+//   Community contributors (see AUTHORS file)
+// File authors:
+//   Toby Schneider <toby@gobysoft.org>
+//
+//
+// This file is part of the Dynamic Compact Control Language Library
+// ("DCCL").
+//
+// DCCL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 2.1 of the License, or
+// (at your option) any later version.
+//
+// DCCL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DCCL.  If not, see <http://www.gnu.org/licenses/>.
+#ifndef DCCLSTATICCODEC20261018H
+#define DCCLSTATICCODEC20261018H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "binary.h"
+#include "bit_reader.h"
+#include "bit_writer.h"
+#include "common.h"
+#include "exception.h"
+
+namespace dccl
+{
+/// \brief Building blocks shared by the default field codecs and the reflection-free encoders / decoders generated by protoc-gen-dccl (with the "static_codec" parameter), so that both produce identical encoded bytes.
+namespace static_codec
+{
+/// \brief Counts the bits that would be written by a BitWriter, used to compute the encoded size without encoding
+class BitCounter
+{
+  public:
+    BitCounter& append(std::uint64_t /*value*/, std::size_t num_bits)
+    {
+        size_ += num_bits;
+        return *this;
+    }
+
+    BitCounter& append_bytes(const char* /*bytes*/, std::size_t len)
+    {
+        size_ += len * 8;
+        return *this;
+    }
+
+    BitCounter& align()
+    {
+        if (size_ % 8)
+            size_ += 8 - size_ % 8;
+        return *this;
+    }
+
+    std::size_t size() const { return size_; }
+    std::size_t byte_size() const { return (size_ + 7) / 8; }
+
+  private:
+    std::size_t size_{0};
+};
+
+/// \brief Number of bits used by a bounded numeric value
+///
+/// \param min (dccl.field).min
+/// \param max (dccl.field).max
+/// \param resolution (dccl.field).resolution (or 10^-(dccl.field).precision)
+/// \param use_required If false, the value zero is reserved to indicate the field is not set
+inline unsigned numeric_size(double min, double max, double resolution, bool use_required)
+{
+    // if not required field, leave one value for unspecified (always encoded as 0)
+    unsigned null_value = use_required ? 0 : 1;
+    return dccl::ceil_log2((max - min) / resolution + 1 + null_value);
+}
+
+/// \brief Convert a bounded numeric value to the unsigned integer that is encoded
+///
+/// \return false if the value (after rounding to the resolution) is outside [min, max], in which case nothing is written to encoded
+template <typename WireType>
+bool encode_numeric(WireType value, double min, double max, double resolution, bool use_required,
+                    dccl::uint64* encoded)
+{
+    // round first, before checking bounds
+    WireType wire_value = dccl::quantize(value, resolution);
+
+    if (wire_value < min || wire_value > max)
+        return false;
+
+    // calculate the encoded value: remove the minimum, scale for the resolution, cast to int.
+    wire_value -= dccl::quantize(static_cast<WireType>(min), resolution);
+    if (resolution >= 1)
+        wire_value /= resolution;
+    else
+        wire_value *= (1.0 / resolution);
+    auto uint_value = static_cast<dccl::uint64>(dccl::round(wire_value, 0));
+
+    // "presence" value (0)
+    if (!use_required)
+        uint_value += 1;
+
+    *encoded = uint_value;
+    return true;
+}
+
+/// \brief Convert an encoded unsigned integer back to the numeric value
+///
+/// \param encoded The encoded value, with the "not set" value (if any) already removed
+template <typename WireType>
+WireType decode_numeric(dccl::uint64 encoded, double min, double resolution)
+{
+    auto wire_value = (WireType)encoded;
+    if (resolution >= 1)
+        wire_value *= resolution;
+    else
+        wire_value /= (1.0 / resolution);
+
+    // round values again to properly handle cases where double precision
+    // leads to slightly off values (e.g. 2.099999999 instead of 2.1)
+    return dccl::quantize(wire_value + dccl::quantize(static_cast<WireType>(min), resolution),
+                          resolution);
+}
+
+/// \brief Write a bounded numeric value (zeros if it is out of bounds)
+template <typename WireType, typename Writer>
+void write_numeric(Writer* writer, WireType value, double min, double max, double resolution,
+                   bool use_required, unsigned size)
+{
+    dccl::uint64 encoded = 0;
+    if (encode_numeric(value, min, max, resolution, use_required, &encoded))
+        writer->append(encoded, size);
+    else
+        writer->append(0, size);
+}
+
+/// \brief Read a bounded numeric value
+///
+/// \return false if the field was not set
+template <typename WireType>
+bool read_numeric(BitReader* reader, double min, double resolution, bool use_required,
+                  unsigned size, WireType* value)
+{
+    dccl::uint64 encoded = reader->read(size);
+    if (!use_required)
+    {
+        if (!encoded)
+            return false;
+        --encoded;
+    }
+    *value = decode_numeric<WireType>(encoded, min, resolution);
+    return true;
+}
+
+/// \brief Write a bool
+template <typename Writer>
+void write_bool(Writer* writer, bool value, bool use_required, unsigned size)
+{
+    writer->append(use_required ? value : value + 1, size);
+}
+
+/// \brief Read a bool
+///
+/// \return false if the field was not set
+inline bool read_bool(BitReader* reader, bool use_required, unsigned size, bool* value)
+{
+    dccl::uint64 encoded = reader->read(size);
+    if (!use_required)
+    {
+        if (!encoded)
+            return false;
+        --encoded;
+    }
+    *value = encoded;
+    return true;
+}
+
+/// \brief Write a length-prefixed string or bytes value (v2 / v3 DefaultStringCodec, v3::VarBytesCodec), truncated to max_length
+///
+/// \param prefix_size Number of bits in the length prefix
+/// \param presence If true, a presence bit (1) is written first
+template <typename Writer>
+void write_var_bytes(Writer* writer, const std::string& value, std::size_t max_length,
+                     unsigned prefix_size, bool presence)
+{
+    if (presence)
+        writer->append(1, 1);
+    std::size_t length = std::min(value.size(), max_length);
+    writer->append(length, prefix_size);
+    writer->append_bytes(value.data(), length);
+}
+
+/// \brief Read a length-prefixed string or bytes value
+///
+/// \param presence If true, a presence bit is read first (zero if the field is not set)
+/// \param empty_is_null If true, a zero length indicates the field is not set (DefaultStringCodec)
+/// \return false if the field was not set
+inline bool read_var_bytes(BitReader* reader, unsigned prefix_size, bool presence,
+                           bool empty_is_null, std::string* value)
+{
+    if (presence && !reader->read(1))
+        return false;
+    std::size_t length = reader->read(prefix_size);
+    if (empty_is_null && !length)
+        return false;
+    value->clear();
+    reader->read_bytes(value, length);
+    return true;
+}
+
+/// \brief Write a fixed length bytes value (v2 / v3 DefaultBytesCodec), truncated or zero padded to max_length
+template <typename Writer>
+void write_fixed_bytes(Writer* writer, const std::string& value, std::size_t max_length,
+                       bool presence)
+{
+    if (presence)
+        writer->append(1, 1);
+    std::size_t length = std::min(value.size(), max_length);
+    writer->append_bytes(value.data(), length);
+    writer->append(0, (max_length - length) * 8);
+}
+
+/// \brief Read a fixed length bytes value
+///
+/// \return false if the field was not set
+inline bool read_fixed_bytes(BitReader* reader, std::size_t max_length, bool presence,
+                             std::string* value)
+{
+    if (presence && !reader->read(1))
+        return false;
+    value->clear();
+    reader->read_bytes(value, max_length);
+    return true;
+}
+
+/// \brief Index of an enumeration value (as in google::protobuf::EnumValueDescriptor::index()), given the numbers of all the values in declaration order
+inline int enum_index(int number, const int* numbers, int count)
+{
+    for (int i = 0; i < count; ++i)
+        if (numbers[i] == number)
+            return i;
+    return -1;
+}
+
+/// \brief Write the default DCCL identifier (DefaultIdentifierCodec)
+template <typename Writer> void write_id(Writer* writer, unsigned id)
+{
+    const unsigned one_byte_max_id = (1 << 7) - 1;
+    // LSB indicates short (0) or long (1) header form
+    if (id <= one_byte_max_id)
+        writer->append(0, 1).append(id, 7);
+    else
+        writer->append(1, 1).append(id, 15);
+}
+
+/// \brief Read the default DCCL identifier and check that it matches the expected id
+///
+/// \throw Exception if the identifier does not match
+inline void read_id(BitReader* reader, unsigned id)
+{
+    // LSB indicates short (0) or long (1) header form
+    unsigned this_id = reader->read(1) ? reader->read(15) : reader->read(7);
+    if (this_id != id)
+        throw(Exception("Message id " + std::to_string(this_id) +
+                        " does not match the expected id " + std::to_string(id)));
+}
+
+} // namespace static_codec
+} // namespace dccl
+
+#endif
@@ -158,6 +158,139 @@ int main()
         assert(grandparent.to_ulong() == 0xD);
     }
 
+    // operations spanning the 64-bit storage word boundaries
+    {
+        dccl::uint64 big = 0xF0E1D2C3B4A59687ull;
+        Bitset bits(64, 0);
+        bits.from(big);
+        assert(bits.size() == 64);
+        assert(bits.to<dccl::uint64>() == big);
+
+        // misalign by pushing to the little end, then append across two words
+        bits.push_front(true);
+        bits.append(big, 64);
+        bits.push_back(true);
+        assert(bits.size() == 130);
+        assert(bits.front() && bits.back());
+
+        Bitset middle(bits);
+        middle >>= 1;
+        middle.resize(64);
+        assert(middle.to<dccl::uint64>() == big);
+
+        Bitset upper(bits);
+        upper >>= 65;
+        upper.resize(64);
+        assert(upper.to<dccl::uint64>() == big);
+
+        Bitset source(bits);
+
+        // pop_front / push_front realign
+        for (int i = 0; i < 65; ++i) bits.pop_front();
+        bits.pop_back();
+        assert(bits.to<dccl::uint64>() == big);
+
+        // byte string round trip of a non byte aligned view
+        Bitset odd(&source);
+        odd.get_more_bits(67);
+        assert(odd.size() == 67 && source.size() == 63);
+        assert(odd.front() && odd.test(65) == (big & 1) && odd.test(66) == ((big >> 1) & 1));
+        std::string bytes = odd.to_byte_string();
+        assert(bytes.size() == 9);
+        Bitset odd_copy;
+        odd_copy.from_byte_string(bytes);
+        odd_copy.resize(67);
+        assert(odd_copy == odd);
+
+        // shifts across word boundary
+        Bitset shifted(100, 1);
+        shifted <<= 70;
+        assert(shifted.test(70));
+        for (int i = 0; i < 100; ++i) assert(shifted.test(i) == (i == 70));
+        shifted >>= 69;
+        shifted.resize(8);
+        assert(shifted.to_ulong() == 2);
+
+        // logic across word boundary
+        Bitset a(70), b(70);
+        a.set();
+        b.set(65);
+        a ^= b;
+        assert(!a.test(65) && a.test(64) && a.test(69));
+        a.flip();
+        assert(a == b);
+    }
+
+    // shifts and pop_front(n) on a long Bitset
+    {
+        Bitset header(1000, 0);
+        header.set(0);
+        header.set(999);
+
+        Bitset left(header);
+        left <<= 10;
+        assert(left.size() == 1000 && left.test(10) && !left.test(0) && !left.test(999));
+        for (int i = 0; i < 1000; ++i) assert(left.test(i) == (i == 10));
+
+        Bitset right(header);
+        right >>= 990;
+        assert(right.size() == 1000 && right.test(9));
+        for (int i = 0; i < 1000; ++i) assert(right.test(i) == (i == 9));
+
+        // repeated small shifts
+        Bitset walk(header);
+        for (int i = 0; i < 999; ++i) walk >>= 1;
+        assert(walk.size() == 1000 && walk.to_string() == std::string(999, '0') + "1");
+
+        header.pop_front(999);
+        assert(header.size() == 1 && header.test(0));
+        header.pop_front(1);
+        assert(header.empty());
+
+        bool caught = false;
+        try
+        {
+            header.pop_front(1);
+        }
+        catch (dccl::Exception&)
+        {
+            caught = true;
+        }
+        assert(caught);
+    }
+
+    // shared storage: copies and children are views that are only copied when modified
+    {
+        Bitset original(200, 0);
+        original.set(3);
+        original.set(150);
+
+        Bitset copy(original);
+        copy.set(3, false);
+        copy.push_back(true);
+        assert(original.test(3) && original.size() == 200);
+        assert(!copy.test(3) && copy.size() == 201);
+
+        // deep hierarchy pulling through several empty parents
+        Bitset level1(&original);
+        Bitset level2(&level1);
+        Bitset level3(&level2);
+        level3.get_more_bits(4);
+        assert(level3.size() == 4 && level3.to_ulong() == 0x8);
+        level3.get_more_bits(150);
+        assert(level3.size() == 154 && level3.test(150) && !level3.test(4));
+        assert(original.size() == 46);
+
+        // modifying the child does not change what the parent has left
+        level3.flip();
+        level3.push_front(true);
+        level3 >>= 1;
+        assert(!level3.test(150) && level3.test(0));
+        Bitset rest(&original);
+        rest.get_more_bits(46);
+        assert(rest == Bitset(46, 0));
+    }
+
     std::cout << "all tests passed" << std::endl;
 
     return 0;
@@ -0,0 +1,80 @@
+// Copyright 2026:
+//   GobySoft, LLC (2013-)
+//   Community contributors (see AUTHORS file)
+// File authors:
+//   Toby Schneider <toby@gobysoft.org>
+//
+//
+// This file is part of the Dynamic Compact Control Language Library
+// ("DCCL").
+//
+// DCCL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 2.1 of the License, or
+// (at your option) any later version.
+//
+// DCCL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DCCL.  If not, see <http://www.gnu.org/licenses/>.
+// tests the cumulative frequency tables used by the arithmetic encoder
+
+#include <cassert>
+#include <iostream>
+
+#include "../../arithmetic/field_codec_arithmetic.h"
+
+using dccl::arith::CumulativeFrequencyTable;
+
+// compare against the cumulative frequencies computed the slow way
+void check_table(const CumulativeFrequencyTable& table, const std::vector<dccl::uint32>& freqs)
+{
+    assert(table.size() == static_cast<int>(freqs.size()));
+
+    dccl::uint32 c_freq = 0;
+    for (int i = 0, n = freqs.size(); i < n; ++i)
+    {
+        assert(table.range(i) == std::make_pair(c_freq, c_freq + freqs[i]));
+        c_freq += freqs[i];
+    }
+    assert(table.total() == c_freq);
+
+    // the symbol found for each cumulative frequency is the first one whose range ends above it
+    for (dccl::uint32 search = 0; search < table.total(); ++search)
+    {
+        int expected = 0;
+        while (table.range(expected).second <= search) ++expected;
+        assert(table.find(search) == expected);
+    }
+}
+
+int main(int /*argc*/, char* /*argv*/[])
+{
+    // includes zero frequencies (as EOF and out-of-range may have)
+    const std::vector<std::vector<dccl::uint32>> all_freqs = {
+        {1}, {0, 5}, {0, 0, 3, 1}, {2, 0, 7, 1, 1, 4, 9}, {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11}};
+
+    for (const auto& initial_freqs : all_freqs)
+    {
+        for (bool adaptive : {false, true})
+        {
+            std::vector<dccl::uint32> freqs = initial_freqs;
+            CumulativeFrequencyTable table;
+            table.assign(freqs, adaptive);
+            check_table(table, freqs);
+
+            for (int k = 0; k < 20; ++k)
+            {
+                int index = (k * 7 + 3) % freqs.size();
+                table.increment(index);
+                ++freqs[index];
+                check_table(table, freqs);
+            }
+        }
+    }
+
+    std::cout << "all tests passed" << std::endl;
+}
@@ -0,0 +1,178 @@
+// Copyright 2026:
+//   GobySoft, LLC (2013-)
+//   Community contributors (see AUTHORS file)
+// File authors:
+//   Toby Schneider <toby@gobysoft.org>
+//
+//
+// This file is part of the Dynamic Compact Control Language Library
+// ("DCCL").
+//
+// DCCL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 2.1 of the License, or
+// (at your option) any later version.
+//
+// DCCL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DCCL.  If not, see <http://www.gnu.org/licenses/>.
+// tests that adaptive arithmetic models are kept per Codec / CodecSession, and snapshot / restore
+
+#include <dlfcn.h>
+
+#include <cassert>
+#include <iostream>
+#include <thread>
+
+#include "../../arithmetic/field_codec_arithmetic.h"
+#include "../../codec.h"
+#include "test.pb.h"
+
+using namespace dccl::test::range;
+
+void load(dccl::Codec& codec)
+{
+    void* dl_handle = dlopen(DCCL_ARITHMETIC_NAME, RTLD_LAZY);
+    if (!dl_handle)
+    {
+        std::cerr << "Failed to open " << DCCL_ARITHMETIC_NAME << std::endl;
+        exit(1);
+    }
+    codec.load_library(dl_handle);
+
+    dccl::arith::protobuf::ArithmeticModel model;
+    model.set_name("model");
+    model.set_is_adaptive(true);
+    for (int i = 0; i < 8; ++i)
+    {
+        model.add_value_bound(i);
+        model.add_frequency(1);
+    }
+    model.add_value_bound(8);
+    dccl::arith::ModelManager::set_model(codec, model);
+
+    dccl::arith::protobuf::ArithmeticModel enum_model;
+    enum_model.set_name("enum_model");
+    enum_model.set_is_adaptive(true);
+    for (int i = 1; i <= 3; ++i)
+    {
+        enum_model.add_value_bound(i);
+        enum_model.add_frequency(1);
+    }
+    enum_model.add_value_bound(4);
+    dccl::arith::ModelManager::set_model(codec, enum_model);
+
+    codec.load<RangeTestMsg>();
+    codec.load<ArithmeticTestMsg>();
+}
+
+template <typename Msg> Msg make_msg(int i)
+{
+    Msg msg;
+    // mostly 3s, so the adaptive models shorten the messages over time
+    for (int j = 0; j < 20; ++j) msg.add_value((i + j) % 5 ? 3 : j % 8);
+    msg.set_e(static_cast<Enum1>(1 + i % 3));
+    msg.set_after(i);
+    return msg;
+}
+
+const int num_messages = 30;
+
+// encodes (and decodes) a sequence of messages, returning the encoded bytes
+template <typename Msg> std::vector<std::string> run_sequence(dccl::Codec& codec)
+{
+    std::vector<std::string> encoded;
+    for (int i = 0; i < num_messages; ++i)
+    {
+        Msg msg_in = make_msg<Msg>(i);
+        std::string bytes;
+        codec.encode(&bytes, msg_in);
+
+        Msg msg_out;
+        codec.decode(bytes, &msg_out);
+        assert(msg_out.SerializeAsString() == msg_in.SerializeAsString());
+        encoded.push_back(bytes);
+    }
+    return encoded;
+}
+
+template <typename Msg> void test_snapshot()
+{
+    dccl::Codec codec;
+    load(codec);
+
+    std::vector<std::string> expected = run_sequence<Msg>(codec);
+    // the models adapted
+    assert(expected.front().size() > expected.back().size());
+
+    // start again
+    dccl::arith::ModelManager::reset(codec);
+    assert(run_sequence<Msg>(codec) == expected);
+
+    // encoding the same message again after restoring the state gives the same bytes
+    dccl::arith::ModelManager::reset(codec);
+    Msg msg = make_msg<Msg>(0);
+    dccl::arith::ModelState state = dccl::arith::ModelManager::snapshot(codec);
+    std::string bytes1, bytes2, bytes3;
+    codec.encode(&bytes1, msg);
+    assert(bytes1 == expected.front());
+    codec.encode(&bytes2, msg);
+    assert(bytes2 != bytes1);
+    dccl::arith::ModelManager::restore(codec, state);
+    codec.encode(&bytes3, msg);
+    assert(bytes3 == bytes1);
+}
+
+template <typename Msg> void test_sessions()
+{
+    dccl::Codec codec;
+    load(codec);
+
+    std::vector<std::string> expected;
+    {
+        dccl::Codec fresh_codec;
+        load(fresh_codec);
+        expected = run_sequence<Msg>(fresh_codec);
+    }
+
+    // adapt the Codec's own models, which must not affect the sessions
+    run_sequence<Msg>(codec);
+
+    // each session adapts its own models, starting from those given to set_model()
+    const int num_threads = 4;
+    std::vector<std::thread> threads;
+    std::vector<std::vector<std::string>> results(num_threads);
+    for (int t = 0; t < num_threads; ++t)
+    {
+        threads.emplace_back(
+            [&codec, &results, t]()
+            {
+                dccl::CodecSession session(codec);
+                for (int k = 0; k < 5; ++k)
+                {
+                    results[t] = run_sequence<Msg>(codec);
+                    dccl::arith::ModelManager::reset(codec);
+                }
+            });
+    }
+    for (auto& thread : threads) thread.join();
+
+    for (const auto& result : results) assert(result == expected);
+
+    // and the Codec's own state carried on from where it was
+    assert(run_sequence<Msg>(codec) != expected);
+}
+
+int main(int /*argc*/, char* /*argv*/[])
+{
+    test_snapshot<ArithmeticTestMsg>();
+    test_snapshot<RangeTestMsg>();
+    test_sessions<ArithmeticTestMsg>();
+    test_sessions<RangeTestMsg>();
+
+    std::cout << "all tests passed" << std::endl;
+}
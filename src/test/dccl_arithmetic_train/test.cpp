@@ -0,0 +1,272 @@
+// Copyright 2026:
+//   GobySoft, LLC (2013-)
+//   Community contributors (see AUTHORS file)
+// File authors:
+//   Toby Schneider <toby@gobysoft.org>
+//
+//
+// This file is part of the Dynamic Compact Control Language Library
+// ("DCCL").
+//
+// DCCL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 2.1 of the License, or
+// (at your option) any later version.
+//
+// DCCL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DCCL.  If not, see <http://www.gnu.org/licenses/>.
+// tests training arithmetic model frequencies from a corpus of messages
+
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+#include <numeric>
+
+#include "../../arithmetic/model_trainer.h"
+#include "../../codec.h"
+#include "test.pb.h"
+
+using namespace dccl::test::arith_train;
+using dccl::arith::protobuf::ArithmeticModel;
+
+ArithmeticModel uniform_model(const std::string& name, int num_symbols, bool adaptive)
+{
+    ArithmeticModel model;
+    model.set_name(name);
+    model.set_is_adaptive(adaptive);
+    for (int i = 0; i < num_symbols; ++i)
+    {
+        model.add_value_bound(i);
+        model.add_frequency(10);
+    }
+    model.add_value_bound(num_symbols);
+    model.set_eof_frequency(10);
+    return model;
+}
+
+std::vector<Profile> make_corpus()
+{
+    std::vector<Profile> corpus;
+    for (int i = 0; i < 200; ++i)
+    {
+        Profile profile;
+        // mostly around 5, never 15
+        for (int j = 0, n = 10 + i % 10; j < n; ++j)
+            profile.add_temperature((i * j) % 7 ? 5 + (j % 3) - 1 : (i + j) % 15);
+        profile.add_sample()->set_depth(i % 4);
+        if (i % 2)
+            profile.add_sample()->set_depth(1);
+        profile.set_id(i);
+        corpus.push_back(profile);
+    }
+    return corpus;
+}
+
+dccl::uint64 total_frequency(const ArithmeticModel& model)
+{
+    return std::accumulate(model.frequency().begin(), model.frequency().end(),
+                           static_cast<dccl::uint64>(0)) +
+           model.eof_frequency() + model.out_of_range_frequency();
+}
+
+std::size_t encoded_size(dccl::Codec& codec, const std::vector<Profile>& corpus)
+{
+    dccl::arith::ModelManager::reset(codec);
+    std::size_t size = 0;
+    for (const Profile& profile : corpus)
+    {
+        std::string bytes;
+        codec.encode(&bytes, profile);
+        size += bytes.size();
+    }
+
+    // and check the round trip
+    dccl::arith::ModelManager::reset(codec);
+    for (const Profile& profile : corpus)
+    {
+        std::string bytes;
+        codec.encode(&bytes, profile);
+        Profile decoded;
+        codec.decode(bytes, &decoded);
+        assert(decoded.SerializeAsString() == profile.SerializeAsString());
+    }
+    return size;
+}
+
+void test_train(bool adaptive)
+{
+    dccl::Codec codec;
+    dccl_arithmetic_load(&codec);
+    dccl::arith::ModelManager::set_model(codec, uniform_model("temperature_model", 16, adaptive));
+    dccl::arith::ModelManager::set_model(codec, uniform_model("depth_model", 4, adaptive));
+    codec.load<Profile>();
+    const unsigned max_size_before = codec.max_size<Profile>();
+
+    std::vector<Profile> corpus = make_corpus();
+
+    dccl::arith::ModelTrainer trainer(codec);
+    for (const Profile& profile : corpus) trainer.add(profile);
+    assert(trainer.message_count() == static_cast<int>(corpus.size()));
+    assert(trainer.model_names() ==
+           std::vector<std::string>({"depth_model", "temperature_model"}));
+
+    std::size_t size_before = encoded_size(codec, corpus);
+
+    std::vector<ArithmeticModel> trained_models;
+    for (const std::string& name : trainer.model_names())
+    {
+        const ArithmeticModel& current = trainer.current_model(name);
+        ArithmeticModel trained = trainer.train(name);
+
+        assert(trained.value_bound_size() == current.value_bound_size());
+        assert(trained.frequency_size() == current.frequency_size());
+        assert(trained.is_adaptive() == adaptive);
+
+        double bits_before = trainer.bits(name, current);
+        double bits_after = trainer.bits(name, trained);
+        std::cout << name << (adaptive ? " (adaptive)" : "") << ": "
+                  << bits_before / trainer.message_count() << " bits/message before, "
+                  << bits_after / trainer.message_count() << " after" << std::endl;
+        assert(bits_after < bits_before);
+
+        // never observed, but still encodable
+        assert(trained.out_of_range_frequency() == 0);
+        if (name == "temperature_model")
+        {
+            assert(trained.frequency(15) == 1);
+            assert(trained.frequency(5) > trained.frequency(0));
+            // one EOF per message, as no profile is max_repeat long
+            assert(trained.eof_frequency() == corpus.size());
+        }
+        else
+        {
+            // singular fields that are set have no EOF
+            assert(trained.eof_frequency() == 1);
+            assert(trained.frequency(1) == 50 + 100);
+        }
+
+        // bounded by the total frequency
+        ArithmeticModel small = trainer.train(name, 100);
+        assert(total_frequency(small) <= 100);
+        for (auto freq : small.frequency()) assert(freq >= 1);
+        assert(small.eof_frequency() >= 1);
+
+        bool threw = false;
+        try
+        {
+            trainer.train(name, 2);
+        }
+        catch (dccl::Exception&)
+        {
+            threw = true;
+        }
+        assert(threw);
+
+        trained_models.push_back(trained);
+    }
+
+    // the trained models must still fit the message within max_bytes, which is checked when the
+    // message is loaded
+    dccl::Codec trained_codec;
+    dccl_arithmetic_load(&trained_codec);
+    for (const ArithmeticModel& trained : trained_models)
+        dccl::arith::ModelManager::set_model(trained_codec, trained);
+    trained_codec.load<Profile>();
+
+    const unsigned max_bytes = Profile::descriptor()->options().GetExtension(dccl::msg).max_bytes();
+    std::cout << "max size: " << max_size_before << " bytes before, "
+              << trained_codec.max_size<Profile>() << " after (max_bytes: " << max_bytes << ")"
+              << std::endl;
+    assert(trained_codec.max_size<Profile>() <= max_bytes);
+
+    std::size_t size_after = encoded_size(trained_codec, corpus);
+    std::cout << "encoded: " << size_before << " bytes before, " << size_after << " after"
+              << std::endl;
+    assert(size_after < size_before);
+}
+
+// the symbol counts used for training match what dccl.range actually encodes, which the
+// codec's adaptive models count as they are updated
+void test_range_counts()
+{
+    dccl::Codec codec;
+    dccl_arithmetic_load(&codec);
+
+    ArithmeticModel reading_model = uniform_model("reading_model", 8, true);
+    for (auto& freq : *reading_model.mutable_frequency()) freq = 1;
+    reading_model.set_eof_frequency(1);
+    reading_model.set_out_of_range_frequency(0);
+    dccl::arith::ModelManager::set_model(codec, reading_model);
+
+    ArithmeticModel level_model = uniform_model("level_model", 4, true);
+    for (auto& freq : *level_model.mutable_frequency()) freq = 1;
+    level_model.set_eof_frequency(0);
+    dccl::arith::ModelManager::set_model(codec, level_model);
+
+    codec.load<RangeProfile>();
+
+    dccl::arith::ModelTrainer trainer(codec);
+    for (int i = 0; i < 100; ++i)
+    {
+        RangeProfile profile;
+        for (int j = 0, n = i % 8; j < n; ++j)
+        {
+            // an out-of-range value part way through (the following values aren't encoded)
+            profile.add_reading(i % 3 == 0 && j == 2 ? 20 : (i + j) % 8);
+        }
+        for (int j = 0, n = i % 6; j < n; ++j) profile.add_level(1 + (i + j) % 3);
+
+        std::string bytes;
+        codec.encode(&bytes, profile);
+        trainer.add(profile);
+    }
+
+    for (const ArithmeticModel& current : {reading_model, level_model})
+    {
+        ArithmeticModel trained = trainer.train(current.name());
+        dccl::arith::Model& encoded =
+            dccl::arith::model_state(codec.manager())
+                .model(dccl::arith::model_manager(codec.manager()), current.name());
+
+        for (dccl::arith::Model::symbol_type symbol = dccl::arith::Model::MIN_SYMBOL;
+             symbol <= encoded.max_symbol(); ++symbol)
+        {
+            auto c_freq_range =
+                encoded.symbol_to_cumulative_freq(symbol, dccl::arith::Model::ENCODER);
+            dccl::uint64 initial_freq = symbol == dccl::arith::Model::EOF_SYMBOL
+                                            ? current.eof_frequency()
+                                            : symbol == dccl::arith::Model::OUT_OF_RANGE_SYMBOL
+                                                  ? current.out_of_range_frequency()
+                                                  : current.frequency(symbol);
+            dccl::uint64 count = c_freq_range.second - c_freq_range.first - initial_freq;
+
+            dccl::uint64 trained_freq = symbol == dccl::arith::Model::EOF_SYMBOL
+                                            ? trained.eof_frequency()
+                                            : symbol == dccl::arith::Model::OUT_OF_RANGE_SYMBOL
+                                                  ? trained.out_of_range_frequency()
+                                                  : trained.frequency(symbol);
+
+            std::cout << current.name() << " symbol " << symbol << ": encoded " << count
+                      << " times, trained frequency " << trained_freq << std::endl;
+            // symbols without a frequency are never encoded and stay disabled, others that
+            // were never encoded get a frequency of one
+            if (initial_freq == 0)
+                assert(count == 0 && trained_freq == 0);
+            else
+                assert(trained_freq == std::max<dccl::uint64>(count, 1));
+        }
+    }
+}
+
+int main(int /*argc*/, char* /*argv*/[])
+{
+    test_train(false);
+    test_train(true);
+    test_range_counts();
+    std::cout << "all tests passed" << std::endl;
+}
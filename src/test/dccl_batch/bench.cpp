@@ -0,0 +1,98 @@
+// Copyright 2026:
+//   GobySoft, LLC (2013-)
+//   Community contributors (see AUTHORS file)
+// File authors:
+//   Toby Schneider <toby@gobysoft.org>
+//
+//
+// This file is part of the Dynamic Compact Control Language Library
+// ("DCCL").
+//
+// DCCL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 2.1 of the License, or
+// (at your option) any later version.
+//
+// DCCL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DCCL.  If not, see <http://www.gnu.org/licenses/>.
+// compares encode_batch() / decode_batch() with calling encode() / decode() for each message
+
+#include <chrono>
+
+#include "../../codec.h"
+
+#include "test.pb.h"
+using namespace dccl::test;
+
+template <typename Function> double time_ms(Function f)
+{
+    auto start = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+        .count();
+}
+
+int main(int argc, char* argv[])
+{
+    const int count = (argc > 1) ? std::stoi(argv[1]) : 100000;
+
+    dccl::Codec codec;
+    codec.load<Status>();
+    codec.load<Command>();
+
+    std::vector<std::shared_ptr<google::protobuf::Message>> msgs;
+    std::vector<const google::protobuf::Message*> msg_ptrs;
+    for (int i = 0; i < count; ++i)
+    {
+        if (i % 4)
+        {
+            auto status = std::make_shared<Status>();
+            status->set_seq(i % 65536);
+            status->set_depth((i % 6000) + 0.5);
+            status->set_heading(i % 360);
+            for (int j = 0; j < i % 8; ++j) status->add_sensor(j);
+            msgs.push_back(status);
+        }
+        else
+        {
+            auto command = std::make_shared<Command>();
+            command->set_seq(i % 65536);
+            command->set_text("go");
+            msgs.push_back(command);
+        }
+        msg_ptrs.push_back(msgs.back().get());
+    }
+
+    std::vector<std::string> frames(count);
+    double encode_ms = time_ms(
+        [&]()
+        {
+            for (int i = 0; i < count; ++i) codec.encode(&frames[i], *msgs[i]);
+        });
+
+    std::string batch_bytes;
+    std::vector<dccl::Codec::BatchResult> results;
+    double encode_batch_ms =
+        time_ms([&]() { codec.encode_batch(msg_ptrs.data(), count, &batch_bytes, &results); });
+
+    double decode_ms = time_ms(
+        [&]()
+        {
+            for (int i = 0; i < count; ++i)
+                codec.decode<std::shared_ptr<google::protobuf::Message>>(frames[i]);
+        });
+
+    double decode_batch_ms =
+        time_ms([&]() { codec.decode_batch(frames.data(), count, &results); });
+
+    std::cout << count << " messages" << std::endl;
+    std::cout << "encode():       " << encode_ms << " ms" << std::endl;
+    std::cout << "encode_batch(): " << encode_batch_ms << " ms" << std::endl;
+    std::cout << "decode():       " << decode_ms << " ms" << std::endl;
+    std::cout << "decode_batch(): " << decode_batch_ms << " ms" << std::endl;
+}
@@ -0,0 +1,143 @@
+// Copyright 2026:
+//   GobySoft, LLC (2013-)
+//   Community contributors (see AUTHORS file)
+// File authors:
+//   Toby Schneider <toby@gobysoft.org>
+//
+//
+// This file is part of the Dynamic Compact Control Language Library
+// ("DCCL").
+//
+// DCCL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 2.1 of the License, or
+// (at your option) any later version.
+//
+// DCCL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DCCL.  If not, see <http://www.gnu.org/licenses/>.
+// tests encoding and decoding batches of messages
+
+#include "../../codec.h"
+
+#include "test.pb.h"
+using namespace dccl::test;
+
+int main(int /*argc*/, char* /*argv*/ [])
+{
+    dccl::dlog.connect(dccl::logger::ALL, &std::cerr);
+
+    dccl::Codec codec;
+    codec.load<Status>();
+    codec.load<Command>();
+
+    std::vector<std::shared_ptr<google::protobuf::Message>> msgs;
+    for (int i = 0; i < 100; ++i)
+    {
+        if (i % 3)
+        {
+            auto status = std::make_shared<Status>();
+            status->set_seq(i);
+            status->set_depth(i * 10.5);
+            if (i % 2)
+                status->set_heading(i);
+            for (int j = 0; j < i % 8; ++j) status->add_sensor(j * 10 - 40);
+            msgs.push_back(status);
+        }
+        else
+        {
+            auto command = std::make_shared<Command>();
+            command->set_seq(i);
+            command->set_text("go to " + std::to_string(i));
+            msgs.push_back(command);
+        }
+    }
+
+    // messages that cannot be encoded
+    const std::size_t not_initialized = 10, not_loaded = 50;
+    msgs[not_initialized] = std::make_shared<Status>();
+    auto unloaded = std::make_shared<NotLoaded>();
+    unloaded->set_a(1);
+    msgs[not_loaded] = unloaded;
+
+    std::vector<const google::protobuf::Message*> msg_ptrs;
+    for (const auto& msg : msgs) msg_ptrs.push_back(msg.get());
+
+    // existing contents of the output are kept
+    const std::string prefix = "prefix";
+    std::string batch_bytes = prefix;
+    std::vector<dccl::Codec::BatchResult> encode_results;
+    std::size_t encoded =
+        codec.encode_batch(msg_ptrs.data(), msg_ptrs.size(), &batch_bytes, &encode_results);
+    assert(encoded == msgs.size() - 2);
+    assert(encode_results.size() == msgs.size());
+    assert(batch_bytes.substr(0, prefix.size()) == prefix);
+
+    // same bytes as encode() for each message
+    std::vector<std::string> frames;
+    std::size_t offset = prefix.size();
+    for (std::size_t i = 0, n = msgs.size(); i < n; ++i)
+    {
+        const dccl::Codec::BatchResult& result = encode_results[i];
+        if (i == not_initialized || i == not_loaded)
+        {
+            std::cout << i << ": " << result.error << std::endl;
+            assert(!result.ok());
+            assert(result.size == 0);
+            assert(result.offset == offset);
+            frames.push_back(std::string());
+            continue;
+        }
+
+        assert(result.ok());
+        assert(result.id == codec.id(msgs[i]->GetDescriptor()));
+        assert(result.offset == offset);
+
+        std::string encoded;
+        codec.encode(&encoded, *msgs[i]);
+        assert(batch_bytes.substr(result.offset, result.size) == encoded);
+        offset += result.size;
+        frames.push_back(encoded);
+    }
+    assert(offset == batch_bytes.size());
+
+    // a frame with an unknown id, and one that is too short
+    frames[not_loaded] = dccl::Bitset(8, 3 << 1).to_byte_string() + std::string(4, '\0');
+    frames[not_initialized] = std::string(1, '\x02');
+
+    std::vector<dccl::Codec::BatchResult> decode_results;
+    std::size_t decoded = codec.decode_batch(frames.data(), frames.size(), &decode_results);
+    assert(decoded == msgs.size() - 2);
+    assert(decode_results.size() == msgs.size());
+
+    for (std::size_t i = 0, n = msgs.size(); i < n; ++i)
+    {
+        const dccl::Codec::BatchResult& result = decode_results[i];
+        if (i == not_initialized || i == not_loaded)
+        {
+            std::cout << i << ": " << result.error << std::endl;
+            assert(!result.ok());
+            assert(!result.msg);
+            continue;
+        }
+
+        assert(result.ok());
+        assert(result.id == codec.id(msgs[i]->GetDescriptor()));
+        assert(result.size == frames[i].size());
+        assert(result.msg->GetDescriptor() == msgs[i]->GetDescriptor());
+        assert(result.msg->SerializeAsString() == msgs[i]->SerializeAsString());
+    }
+
+    // empty batch
+    std::string empty_bytes;
+    assert(codec.encode_batch(nullptr, 0, &empty_bytes, &encode_results) == 0);
+    assert(empty_bytes.empty() && encode_results.empty());
+    assert(codec.decode_batch(nullptr, 0, &decode_results) == 0);
+    assert(decode_results.empty());
+
+    std::cout << "all tests passed" << std::endl;
+}
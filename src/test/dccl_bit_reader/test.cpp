@@ -0,0 +1,242 @@
+// Copyright 2026:
+//   GobySoft, LLC (2013-)
+//   Community contributors (see AUTHORS file)
+// File authors:
+//   Toby Schneider <toby@gobysoft.org>
+//
+//
+// This file is part of the Dynamic Compact Control Language Library
+// ("DCCL").
+//
+// DCCL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 2.1 of the License, or
+// (at your option) any later version.
+//
+// DCCL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DCCL.  If not, see <http://www.gnu.org/licenses/>.
+// tests decoding directly from a byte buffer with dccl::BitReader
+
+#include <cstring>
+
+#include "../../bit_reader.h"
+#include "../../bit_writer.h"
+#include "../../codec.h"
+#include "../../codecs3/field_codec_default.h"
+
+#include "test.pb.h"
+using namespace dccl::test;
+
+namespace dccl
+{
+namespace test
+{
+// codec that only overrides decode(Bitset*), as written before BitReader was introduced
+class LegacyCodec : public dccl::v3::DefaultNumericFieldCodec<dccl::int32>
+{
+  public:
+    static int decodes;
+
+  private:
+    dccl::int32 decode(dccl::Bitset* bits) override
+    {
+        ++decodes;
+        return dccl::v3::DefaultNumericFieldCodec<dccl::int32>::decode(bits);
+    }
+};
+int LegacyCodec::decodes = 0;
+} // namespace test
+} // namespace dccl
+
+void check_reader();
+void check_message(dccl::Codec& codec, const ReaderMsg& msg_in);
+
+int main(int /*argc*/, char* /*argv*/ [])
+{
+    dccl::dlog.connect(dccl::logger::ALL, &std::cerr);
+
+    check_reader();
+
+    dccl::Codec codec;
+    codec.manager().add<dccl::test::LegacyCodec>("test.legacy");
+    codec.load<ReaderMsg>();
+    codec.load<SmallMsg>();
+    codec.info<ReaderMsg>(&dccl::dlog);
+
+    ReaderMsg msg_in;
+    msg_in.mutable_header()->set_seq(12);
+    msg_in.set_d(-123.456);
+    check_message(codec, msg_in);
+
+    msg_in.mutable_header()->set_flag(true);
+    msg_in.set_i(4999999);
+    msg_in.set_b(false);
+    msg_in.set_e(ENUM_B);
+    msg_in.set_s("zero copy");
+    msg_in.set_fixed(dccl::hex_decode("a1b2c3"));
+    msg_in.set_var(dccl::hex_decode("0102030405"));
+    msg_in.set_pres(17);
+    msg_in.add_rep(1);
+    msg_in.add_rep(100);
+    msg_in.mutable_msg()->set_val(-99);
+    msg_in.mutable_msg()->add_flags(true);
+    msg_in.add_rep_msg()->set_val(7);
+    msg_in.add_rep_msg()->add_flags(false);
+    msg_in.set_legacy(5);
+    msg_in.add_legacy_rep(200);
+    msg_in.add_legacy_rep(0);
+    msg_in.set_choice_s("abc");
+    int legacy_decodes = dccl::test::LegacyCodec::decodes;
+    check_message(codec, msg_in);
+    assert(dccl::test::LegacyCodec::decodes > legacy_decodes);
+
+    msg_in.set_choice_i(9);
+    check_message(codec, msg_in);
+
+    // several messages back to back in one buffer
+    SmallMsg small_in;
+    small_in.set_u(5);
+    std::string stream;
+    codec.encode(&stream, msg_in);
+    std::size_t first_size = stream.size();
+    codec.encode(&stream, small_in);
+    codec.encode(&stream, msg_in);
+
+    const auto* data = reinterpret_cast<const std::uint8_t*>(stream.data());
+    std::size_t len = stream.size();
+    assert(codec.id(data, len) == 2001);
+
+    ReaderMsg msg_out1, msg_out2;
+    SmallMsg small_out;
+    std::size_t used = codec.decode(data, len, &msg_out1);
+    assert(used == first_size);
+    assert(codec.id(data + used, len - used) == 3);
+    used += codec.decode(data + used, len - used, &small_out);
+    used += codec.decode(data + used, len - used, &msg_out2);
+    assert(used == len);
+    assert(msg_out1.SerializeAsString() == msg_in.SerializeAsString());
+    assert(msg_out2.SerializeAsString() == msg_in.SerializeAsString());
+    assert(small_out.SerializeAsString() == small_in.SerializeAsString());
+
+    // header only
+    ReaderMsg head_out;
+    std::size_t head_size = codec.decode(data, len, &head_out, true);
+    assert(head_size < first_size);
+    assert(head_out.header().SerializeAsString() == msg_in.header().SerializeAsString());
+    assert(!head_out.has_d());
+
+    // truncated message
+    bool caught = false;
+    try
+    {
+        ReaderMsg msg_out;
+        codec.decode(data, first_size / 2, &msg_out);
+    }
+    catch (dccl::Exception& e)
+    {
+        caught = true;
+    }
+    assert(caught);
+
+    std::cout << "all tests passed" << std::endl;
+}
+
+void check_reader()
+{
+    std::string bytes;
+    dccl::BitWriter writer(&bytes);
+    writer.append(0x5, 3).append(0xF0E1D2C3B4A59687ull, 64).append(0x1abc, 13);
+    writer.append_bytes("AB", 2).align().append_bytes("CD", 2);
+
+    dccl::BitReader reader(reinterpret_cast<const std::uint8_t*>(bytes.data()), bytes.size());
+    assert(reader.remaining() == bytes.size() * 8);
+    assert(reader.read(3) == 0x5);
+    assert(reader.read(64) == 0xF0E1D2C3B4A59687ull);
+    assert(reader.read(13) == 0x1abc);
+    std::string ab, cd;
+    reader.read_bytes(&ab, 2); // not byte aligned
+    assert(ab == "AB");
+    reader.skip(reader.position() % 8 ? 8 - reader.position() % 8 : 0);
+    reader.read_bytes(&cd, 2); // byte aligned
+    assert(cd == "CD");
+    assert(reader.remaining() == 0);
+    assert(reader.byte_position() == bytes.size());
+
+    bool caught = false;
+    try
+    {
+        reader.read(1);
+    }
+    catch (dccl::Exception& e)
+    {
+        caught = true;
+    }
+    assert(caught);
+
+    // reading ahead, then returning the bits not used
+    reader.rewind(reader.position() - 3);
+    assert(reader.position() == 3);
+    assert(reader.read(64) == 0xF0E1D2C3B4A59687ull);
+    caught = false;
+    try
+    {
+        reader.rewind(68);
+    }
+    catch (dccl::Exception& e)
+    {
+        caught = true;
+    }
+    assert(caught);
+
+    // Bitset view of the unread bits: only the bits taken by children are consumed
+    dccl::BitReader pool_reader(reinterpret_cast<const std::uint8_t*>(bytes.data()),
+                                bytes.size());
+    pool_reader.skip(3);
+    {
+        dccl::BitReader::Pool pool(&pool_reader);
+        dccl::Bitset child(pool.bits());
+        child.get_more_bits(10);
+        child.get_more_bits(54);
+        assert(child.to<dccl::uint64>() == 0xF0E1D2C3B4A59687ull);
+    }
+    assert(pool_reader.position() == 67);
+    {
+        dccl::BitReader::Pool pool(&pool_reader);
+        dccl::Bitset child(pool.bits());
+        child.get_more_bits(13);
+        assert(child.to_ulong() == 0x1abc);
+    }
+    assert(pool_reader.read(16) == 0x4241);
+}
+
+void check_message(dccl::Codec& codec, const ReaderMsg& msg_in)
+{
+    std::string encoded;
+    codec.encode(&encoded, msg_in);
+
+    // trailing bytes are left unread
+    std::string buffer = encoded + "trailing";
+    const auto* data = reinterpret_cast<const std::uint8_t*>(buffer.data());
+
+    ReaderMsg msg_out;
+    std::size_t used = codec.decode(data, buffer.size(), &msg_out);
+    std::cout << msg_out.ShortDebugString() << std::endl;
+    assert(used == encoded.size());
+    assert(msg_in.SerializeAsString() == msg_out.SerializeAsString());
+
+    // other overloads give the same result
+    ReaderMsg msg_out_str;
+    codec.decode(encoded, &msg_out_str);
+    assert(msg_in.SerializeAsString() == msg_out_str.SerializeAsString());
+
+    ReaderMsg msg_out_it;
+    std::string::const_iterator end =
+        codec.decode(buffer.cbegin(), buffer.cend(), &msg_out_it);
+    assert(end == buffer.cbegin() + encoded.size());
+    assert(msg_in.SerializeAsString() == msg_out_it.SerializeAsString());
+}
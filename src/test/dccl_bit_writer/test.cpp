@@ -0,0 +1,210 @@
+// Copyright 2026:
+//   GobySoft, LLC (2013-)
+//   Community contributors (see AUTHORS file)
+// File authors:
+//   Toby Schneider <toby@gobysoft.org>
+//
+//
+// This file is part of the Dynamic Compact Control Language Library
+// ("DCCL").
+//
+// DCCL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 2.1 of the License, or
+// (at your option) any later version.
+//
+// DCCL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DCCL.  If not, see <http://www.gnu.org/licenses/>.
+// tests that encoding directly into a caller buffer or string with dccl::BitWriter gives the same bytes as the Bitset based encoding
+
+#include <cstring>
+
+#include "../../bit_writer.h"
+#include "../../codec.h"
+#include "../../codecs3/field_codec_default.h"
+
+#include "test.pb.h"
+using namespace dccl::test;
+
+namespace dccl
+{
+namespace test
+{
+// codec that only overrides the Bitset encode/decode methods, as written before BitWriter was introduced
+class LegacyCodec : public dccl::v3::DefaultNumericFieldCodec<dccl::int32>
+{
+    dccl::Bitset encode() override
+    {
+        dccl::Bitset bits = dccl::v3::DefaultNumericFieldCodec<dccl::int32>::encode();
+        bits.flip();
+        return bits;
+    }
+
+    dccl::Bitset encode(const dccl::int32& wire_value) override
+    {
+        dccl::Bitset bits = dccl::v3::DefaultNumericFieldCodec<dccl::int32>::encode(wire_value);
+        bits.flip();
+        return bits;
+    }
+
+    dccl::int32 decode(dccl::Bitset* bits) override
+    {
+        bits->flip();
+        return dccl::v3::DefaultNumericFieldCodec<dccl::int32>::decode(bits);
+    }
+};
+} // namespace test
+} // namespace dccl
+
+void check_writer();
+void check_message(dccl::Codec& codec, const StreamMsg& msg_in);
+
+int main(int /*argc*/, char* /*argv*/ [])
+{
+    dccl::dlog.connect(dccl::logger::ALL, &std::cerr);
+
+    check_writer();
+
+    dccl::Codec codec;
+    codec.manager().add<dccl::test::LegacyCodec>("test.legacy");
+    codec.load<StreamMsg>();
+    codec.info<StreamMsg>(&dccl::dlog);
+
+    StreamMsg msg_in;
+    msg_in.set_d(-123.456);
+    check_message(codec, msg_in);
+
+    msg_in.set_i(4999999);
+    msg_in.set_b(true);
+    msg_in.set_e(ENUM_C);
+    msg_in.set_s("streaming");
+    msg_in.set_fixed(dccl::hex_decode("a1b2c3"));
+    msg_in.set_var(dccl::hex_decode("0102030405"));
+    msg_in.set_pres(999);
+    msg_in.add_rep(1);
+    msg_in.add_rep(100);
+    msg_in.add_rep(42);
+    msg_in.mutable_msg()->set_val(-99);
+    msg_in.mutable_msg()->add_flags(true);
+    msg_in.mutable_msg()->add_flags(false);
+    msg_in.add_rep_msg()->set_val(7);
+    msg_in.add_rep_msg()->add_flags(true);
+    msg_in.set_legacy(5);
+    check_message(codec, msg_in);
+
+    std::cout << "all tests passed" << std::endl;
+}
+
+void check_writer()
+{
+    // each mode gives identical results to Bitset::to_byte_string()
+    dccl::Bitset expected;
+    expected.append(dccl::Bitset(3, 0x5));
+    expected.append(dccl::Bitset(64, 0xF0E1D2C3B4A59687ull));
+    expected.append(dccl::Bitset(13, 0x1abc));
+    expected.append(dccl::Bitset(16, 0x4142));
+
+    auto write = [](dccl::BitWriter& writer) {
+        writer.append(0x5, 3).append(0xF0E1D2C3B4A59687ull, 64).append(0xfabc, 13);
+        writer.append_bytes("BA", 2);
+    };
+
+    dccl::Bitset bits;
+    dccl::BitWriter bits_writer(&bits);
+    write(bits_writer);
+    assert(bits == expected);
+    assert(bits_writer.size() == expected.size());
+    assert(bits_writer.data() == nullptr);
+
+    std::string str = "prefix";
+    dccl::BitWriter str_writer(&str);
+    write(str_writer);
+    str_writer.align();
+    assert(str == "prefix" + expected.to_byte_string());
+    assert(str_writer.byte_size() == expected.to_byte_string().size());
+
+    // buffer contents are overwritten, not OR'd
+    char buf[16];
+    std::memset(buf, 0xff, sizeof(buf));
+    dccl::BitWriter buf_writer(buf, sizeof(buf));
+    write(buf_writer);
+    buf_writer.align();
+    assert(std::string(buf, buf_writer.byte_size()) == expected.to_byte_string());
+
+    // writing the Bitset itself, at an offset
+    dccl::BitWriter offset_writer(buf, sizeof(buf));
+    offset_writer.append(1, 1).append(expected);
+    dccl::Bitset offset_expected(expected);
+    offset_expected.push_front(true);
+    assert(std::string(buf, offset_writer.byte_size()) == offset_expected.to_byte_string());
+
+    // overflow
+    bool caught = false;
+    try
+    {
+        dccl::BitWriter small_writer(buf, 2);
+        small_writer.append(0, 17);
+    }
+    catch (std::length_error& e)
+    {
+        caught = true;
+    }
+    assert(caught);
+}
+
+void check_message(dccl::Codec& codec, const StreamMsg& msg_in)
+{
+    std::string encoded;
+    codec.encode(&encoded, msg_in);
+    assert(encoded.size() == codec.size(msg_in));
+
+    // appending to a string leaves the existing contents
+    std::string appended = "abc";
+    codec.encode(&appended, msg_in);
+    assert(appended == "abc" + encoded);
+
+    char buf[128];
+    std::memset(buf, 0xff, sizeof(buf));
+    std::size_t buf_size = codec.encode(buf, sizeof(buf), msg_in);
+    assert(std::string(buf, buf_size) == encoded);
+
+    // buffer too small
+    bool caught = false;
+    try
+    {
+        codec.encode(buf, encoded.size() - 1, msg_in);
+    }
+    catch (std::length_error& e)
+    {
+        caught = true;
+    }
+    assert(caught);
+
+    // a failed encode leaves the string as it was
+    StreamMsg bad_msg(msg_in);
+    bad_msg.set_d(5000);
+    std::string unchanged = "abc";
+    caught = false;
+    codec.set_strict(true);
+    try
+    {
+        codec.encode(&unchanged, bad_msg);
+    }
+    catch (dccl::OutOfRangeException& e)
+    {
+        caught = true;
+    }
+    codec.set_strict(false);
+    assert(caught);
+    assert(unchanged == "abc");
+
+    StreamMsg msg_out;
+    codec.decode(encoded, &msg_out);
+    std::cout << msg_out.ShortDebugString() << std::endl;
+    assert(msg_in.SerializeAsString() == msg_out.SerializeAsString());
+}
@@ -0,0 +1,202 @@
+// Copyright 2026:
+//   GobySoft, LLC (2013-)
+//   Community contributors (see AUTHORS file)
+// File authors:
+//   Toby Schneider <toby@gobysoft.org>
+//
+//
+// This file is part of the Dynamic Compact Control Language Library
+// ("DCCL").
+//
+// DCCL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 2.1 of the License, or
+// (at your option) any later version.
+//
+// DCCL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// tests authenticated encryption (truncated authentication tag)
+
+#include "../../codec.h"
+#include "dccl/def.h"
+#include "test.pb.h"
+
+using namespace dccl::test;
+
+// counts the values it decodes, to check which messages reach the field codecs
+class CountingCodec : public dccl::TypedFixedFieldCodec<dccl::int32>
+{
+  public:
+    static int decode_count;
+
+  private:
+    dccl::Bitset encode(const dccl::int32& wire_value) override
+    {
+        return dccl::Bitset(size(), wire_value);
+    }
+
+    dccl::Bitset encode() override { return dccl::Bitset(size()); }
+
+    dccl::int32 decode(dccl::Bitset* bits) override
+    {
+        ++decode_count;
+        return bits->to_ulong();
+    }
+
+    unsigned size() override { return 16; }
+
+    void validate() override {}
+};
+
+int CountingCodec::decode_count = 0;
+
+template <typename Exception, typename F> bool throws(F f)
+{
+    try
+    {
+        f();
+    }
+    catch (Exception& e)
+    {
+        std::cout << "Caught (expected): " << e.what() << std::endl;
+        return true;
+    }
+    return false;
+}
+
+int main(int /*argc*/, char* /*argv*/ [])
+{
+    dccl::dlog.connect(dccl::logger::ALL, &std::cerr);
+
+    dccl::Codec codec;
+
+    // only multiples of 8 bits up to 128 are allowed
+    assert(throws<dccl::Exception>([&]() { codec.set_crypto_passphrase("secret", {}, 12); }));
+    assert(throws<dccl::Exception>([&]() { codec.set_crypto_passphrase("secret", {}, 136); }));
+
+    codec.load<AuthMsg>();
+    const unsigned plain_max_size = codec.max_size<AuthMsg>();
+
+    AuthMsg msg;
+    msg.set_a(42);
+    msg.set_b(-12.34);
+    msg.set_c("hello");
+    const unsigned plain_size = codec.size(msg);
+
+#if DCCL_HAS_CRYPTOPP
+    const unsigned tag_bits = 64, tag_bytes = tag_bits / 8;
+    codec.set_crypto_passphrase("secret", {}, tag_bits);
+
+    assert(codec.max_size<AuthMsg>() == plain_max_size + tag_bytes);
+    assert(codec.size(msg) == plain_size + tag_bytes);
+
+    std::string encoded;
+    codec.encode(&encoded, msg);
+    std::cout << "Encoded: " << dccl::hex_encode(encoded) << std::endl;
+    assert(encoded.size() == plain_size + tag_bytes);
+
+    AuthMsg decoded;
+    codec.decode(encoded, &decoded);
+    assert(decoded.SerializeAsString() == msg.SerializeAsString());
+
+    // header only decoding doesn't need (or check) the tag
+    AuthMsg header_only;
+    codec.decode(encoded, &header_only, true);
+
+    // any changed bit in the message (head, body or tag) is detected
+    for (std::size_t i = 0; i < encoded.size(); ++i)
+    {
+        std::string corrupt = encoded;
+        corrupt[i] ^= 0x10;
+        // changing the id byte may also be detected as an unknown id
+        if (i == 0)
+            continue;
+        assert(throws<dccl::Exception>([&]() { codec.decode(corrupt, &decoded); }));
+    }
+
+    // a message with an incorrect tag is rejected before any field is decoded
+    {
+        codec.manager().add<CountingCodec>("counting_codec");
+        codec.load<CountedMsg>();
+
+        CountedMsg counted;
+        counted.set_a(1234);
+        std::string counted_encoded;
+        codec.encode(&counted_encoded, counted);
+
+        CountedMsg counted_decoded;
+        codec.decode(counted_encoded, &counted_decoded);
+        assert(counted_decoded.a() == 1234);
+        assert(CountingCodec::decode_count == 1);
+
+        for (std::size_t i = 1; i < counted_encoded.size(); ++i)
+        {
+            std::string corrupt = counted_encoded;
+            corrupt[i] ^= 0x01;
+            assert(throws<dccl::Exception>([&]() { codec.decode(corrupt, &counted_decoded); }));
+        }
+        assert(CountingCodec::decode_count == 1);
+    }
+
+    // truncated message
+    assert(throws<dccl::Exception>(
+        [&]() { codec.decode(encoded.substr(0, encoded.size() - 1), &decoded); }));
+
+    // a different passphrase (or no tag) fails authentication
+    {
+        dccl::Codec other;
+        other.load<AuthMsg>();
+        other.set_crypto_passphrase("not the secret", {}, tag_bits);
+        assert(throws<dccl::Exception>([&]() { other.decode(encoded, &decoded); }));
+    }
+
+    // decode(std::string*) consumes the entire message including the tag
+    std::string encoded_copy = encoded;
+    codec.decode(&encoded_copy, &decoded);
+    assert(encoded_copy.empty());
+
+    // the tag covers the entire input, so concatenated authenticated messages are rejected
+    // rather than decoded
+    {
+        AuthMsg msg2;
+        msg2.set_a(7);
+        std::string concatenated = encoded;
+        codec.encode(&concatenated, msg2);
+        assert(throws<dccl::Exception>([&]() { codec.decode(&concatenated, &decoded); }));
+    }
+
+    // ids that are not encrypted are not authenticated either
+    codec.set_crypto_passphrase("secret", {codec.id<AuthMsg>()}, tag_bits);
+    assert(codec.max_size<AuthMsg>() == plain_max_size);
+
+    // too big for max_bytes with the tag added
+    codec.set_crypto_passphrase("secret", {}, tag_bits);
+    assert(throws<dccl::Exception>([&]() { codec.load<TightMsg>(); }));
+
+    codec.set_crypto_passphrase("secret");
+    codec.load<TightMsg>();
+    assert(throws<dccl::Exception>([&]() { codec.set_crypto_passphrase("secret", {}, 32); }));
+    // the failed call leaves the previous settings in place
+    assert(codec.max_size<TightMsg>() <= 4);
+    codec.set_crypto_passphrase("secret", {codec.id<TightMsg>()}, 32);
+
+    // exactly at the limit: 1 byte id + 2 byte body + 1 byte tag fits in 4 bytes, 2 byte tag doesn't
+    codec.set_crypto_passphrase("secret", {}, 8);
+    TightMsg tight;
+    tight.set_a(1000);
+    assert(codec.size(tight) == 4);
+    assert(throws<dccl::Exception>([&]() { codec.set_crypto_passphrase("secret", {}, 16); }));
+#else
+    // without Crypto++ there is no encryption, so no authentication tag
+    codec.set_crypto_passphrase("secret", {}, 64);
+    assert(codec.max_size<AuthMsg>() == plain_max_size);
+    assert(codec.size(msg) == plain_size);
+    std::cout << "Compiled without Crypto++, authentication not tested" << std::endl;
+#endif
+
+    std::cout << "all tests passed" << std::endl;
+}
@@ -183,6 +183,58 @@ class Int32RepeatedCodec : public dccl::RepeatedTypedFieldCodec<dccl::int32>
     }
 };
 
+// only customizes the Bitset repeated methods: always max_repeat slots of (value - min + 1),
+// with 0 for an unused slot, and no size prefix
+class Int32SlotsCodec : public dccl::TypedFixedFieldCodec<dccl::int32>
+{
+  private:
+    dccl::int32 min() { return FieldCodecBase::dccl_field_options().min(); }
+    dccl::int32 max() { return FieldCodecBase::dccl_field_options().max(); }
+    unsigned max_repeat() { return FieldCodecBase::dccl_field_options().max_repeat(); }
+
+    Bitset encode(const dccl::int32& wire_value) override
+    {
+        return Bitset(size(), wire_value - min() + 1);
+    }
+
+    Bitset encode() override { return Bitset(size()); }
+
+    dccl::int32 decode(Bitset* bits) override
+    {
+        unsigned long value = bits->to_ulong();
+        if (!value)
+            throw(dccl::NullValueException());
+        return value - 1 + min();
+    }
+
+    unsigned size() override { return dccl::ceil_log2((max() - min()) + 2); }
+
+    void any_encode_repeated(Bitset* bits, const std::vector<dccl::any>& wire_values) override
+    {
+        for (unsigned i = 0; i < max_repeat(); ++i)
+            bits->append(i < wire_values.size()
+                             ? encode(dccl::any_cast<dccl::int32>(wire_values[i]))
+                             : encode());
+    }
+
+    void any_decode_repeated(Bitset* bits, std::vector<dccl::any>* wire_values) override
+    {
+        for (unsigned i = 0; i < max_repeat(); ++i)
+        {
+            Bitset slot(size(), (*bits >> (i * size())).to_ulong() & ((1ul << size()) - 1));
+            if (slot.to_ulong())
+                wire_values->push_back(decode(&slot));
+        }
+    }
+
+    unsigned any_size_repeated(const std::vector<dccl::any>& /*wire_values*/) override
+    {
+        return max_size_repeated();
+    }
+    unsigned max_size_repeated() override { return max_repeat() * size(); }
+    unsigned min_size_repeated() override { return max_size_repeated(); }
+};
+
 } // namespace test
 } // namespace dccl
 
@@ -193,6 +245,7 @@ int main(int /*argc*/, char* /*argv*/ [])
     dccl::Codec codec;
     codec.manager().add<dccl::test::CustomCodec>("custom_codec");
     codec.manager().add<dccl::test::Int32RepeatedCodec>("int32_test_codec");
+    codec.manager().add<dccl::test::Int32SlotsCodec>("int32_slots_codec");
 
     codec.set_crypto_passphrase("my_passphrase!");
 
@@ -232,5 +285,19 @@ int main(int /*argc*/, char* /*argv*/ [])
     std::cout << "... got Message out:\n" << msg_out2.DebugString() << std::endl;
     assert(msg_in2.SerializeAsString() == msg_out2.SerializeAsString());
 
+    // a codec overriding only the Bitset repeated methods keeps its own wire format
+    CustomMsg3 msg_in3, msg_out3;
+    msg_in3.add_d(0);
+    msg_in3.add_d(100);
+    codec.load(msg_in3.GetDescriptor());
+    std::string bytes3;
+    codec.encode(&bytes3, msg_in3);
+    std::cout << "... got bytes (hex): " << dccl::hex_encode(bytes3) << std::endl;
+    // 1 byte id + 3 slots of 7 bits
+    assert(bytes3.size() == 1 + 3);
+    assert(bytes3.size() == codec.size(msg_in3));
+    codec.decode(bytes3, &msg_out3);
+    assert(msg_in3.SerializeAsString() == msg_out3.SerializeAsString());
+
     std::cout << "all tests passed" << std::endl;
 }
@@ -104,5 +104,43 @@ int main(int /*argc*/, char* /*argv*/ [])
         codec.decode(encoded, &short_id_msg_with_data);
     }
 
+    {
+        // the id and encoded id of a loaded message are computed once by load()
+        dccl::Codec codec;
+        assert(codec.id<LongIDMsg>() == 10000);
+        codec.load<LongIDMsg>();
+        assert(codec.id<LongIDMsg>() == 10000);
+
+        LongIDMsg long_id_msg;
+        std::string encoded;
+        codec.encode(&encoded, long_id_msg);
+        assert(encoded == dccl::Bitset(16, (10000 << 1) | 1).to_byte_string());
+
+        // the encoded id is cached for user specified ids as well
+        codec.load(LongIDMsg::descriptor(), 5);
+        std::string encoded_user_id;
+        codec.encode(&encoded_user_id, long_id_msg, false, 5);
+        assert(codec.id(encoded_user_id) == 5);
+        assert(encoded_user_id.size() == 1);
+
+        // unloading one id keeps the other
+        codec.unload(5);
+        std::string encoded_again;
+        codec.encode(&encoded_again, long_id_msg);
+        assert(encoded_again == encoded);
+        try
+        {
+            codec.decode(encoded_user_id, &long_id_msg);
+            assert(false);
+        }
+        catch (dccl::Exception& e)
+        {
+        }
+
+        codec.unload<LongIDMsg>();
+        assert(codec.loaded().empty());
+        assert(codec.id<LongIDMsg>() == 10000);
+    }
+
     std::cout << "all tests passed" << std::endl;
 }
@@ -0,0 +1,145 @@
+// Copyright 2026:
+//   GobySoft, LLC (2013-)
+//   Community contributors (see AUTHORS file)
+// File authors:
+//   Toby Schneider <toby@gobysoft.org>
+//
+//
+// This file is part of the Dynamic Compact Control Language Library
+// ("DCCL").
+//
+// DCCL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 2.1 of the License, or
+// (at your option) any later version.
+//
+// DCCL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DCCL.  If not, see <http://www.gnu.org/licenses/>.
+// tests the difference (delta) codec for repeated numeric fields
+
+#include <cmath>
+
+#include "../../codec.h"
+#include "test.pb.h"
+using namespace dccl::test;
+
+// encodes both with the delta and default codecs, checking the decoded values are the same
+std::size_t check(dccl::Codec& codec, const DeltaProfile& delta_in)
+{
+    std::string delta_encoded;
+    codec.encode(&delta_encoded, delta_in);
+    assert(delta_encoded.size() == codec.size(delta_in));
+
+    DeltaProfile delta_out;
+    codec.decode(delta_encoded, &delta_out);
+
+    DefaultProfile default_in;
+    default_in.ParseFromString(delta_in.SerializeAsString());
+    std::string default_encoded;
+    codec.encode(&default_encoded, default_in);
+    DefaultProfile default_out;
+    codec.decode(default_encoded, &default_out);
+
+    std::cout << "delta: " << delta_encoded.size() << " bytes, default "
+              << default_encoded.size() << " bytes" << std::endl;
+
+    assert(delta_out.SerializeAsString() == default_out.SerializeAsString());
+    return delta_encoded.size();
+}
+
+int main(int /*argc*/, char* /*argv*/ [])
+{
+    dccl::dlog.connect(dccl::logger::WARN_PLUS, &std::cerr);
+
+    dccl::Codec codec;
+    codec.load<DeltaProfile>();
+    codec.load<DefaultProfile>();
+    codec.info<DeltaProfile>(&std::cout);
+
+    // slowly varying profile, with values that need rounding
+    DeltaProfile profile;
+    for (int i = 0; i < 100; ++i)
+    {
+        profile.add_depth(10 + i * 0.52);
+        profile.add_temperature(20 - i / 10 + (i % 3 == 0));
+    }
+    std::size_t profile_size = check(codec, profile);
+
+    DefaultProfile default_profile;
+    default_profile.ParseFromString(profile.SerializeAsString());
+    assert(profile_size * 2 < codec.size(default_profile));
+
+    // jumps escape to full width (one each)
+    DeltaProfile jumps = profile;
+    jumps.set_depth(50, 900);
+    jumps.set_temperature(60, -90);
+    assert(check(codec, jumps) > profile_size);
+
+    // differences at the bounds
+    DeltaProfile bounds;
+    for (int i = 0; i < 10; ++i)
+    {
+        bounds.add_depth(i * 1.5);
+        bounds.add_temperature(i % 2 ? 3 : 0);
+    }
+    check(codec, bounds);
+
+    // no, one or min_repeat values
+    DeltaProfile small;
+    small.add_temperature(4);
+    small.add_temperature(-100);
+    check(codec, small);
+    small.add_depth(1000);
+    check(codec, small);
+
+    // the largest message (the differences are all out of bounds) is exactly max_size
+    DeltaProfile largest;
+    for (int i = 0; i < 100; ++i)
+    {
+        largest.add_depth(i % 2 ? 0 : 1000);
+        largest.add_temperature(i % 2 ? -100 : 100);
+    }
+    // (Codec::max_size() allows for the two byte form of the id)
+    assert(check(codec, largest) + 1 == codec.max_size<DeltaProfile>());
+    assert(codec.size(largest) <= codec.size(default_profile) + 1);
+
+    // and the smallest is exactly min_size
+    DeltaProfile smallest;
+    smallest.add_temperature(0);
+    smallest.add_temperature(1);
+    assert(check(codec, smallest) == codec.min_size<DeltaProfile>());
+
+    // out of range values are sent as the minimum, as for the default codec
+    DeltaProfile out_of_range = profile;
+    out_of_range.set_temperature(5, 200);
+    check(codec, out_of_range);
+
+    // (dccl.field).delta_min and delta_max are required
+    try
+    {
+        codec.load<DeltaMissingBounds>();
+        assert(false);
+    }
+    catch (dccl::Exception& e)
+    {
+        std::cout << "expected exception: " << e.what() << std::endl;
+    }
+
+    // only for repeated fields
+    try
+    {
+        codec.load<DeltaSingular>();
+        assert(false);
+    }
+    catch (dccl::Exception& e)
+    {
+        std::cout << "expected exception: " << e.what() << std::endl;
+    }
+
+    std::cout << "all tests passed" << std::endl;
+}
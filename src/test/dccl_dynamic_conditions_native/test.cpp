@@ -0,0 +1,246 @@
+// Copyright 2026:
+//   GobySoft, LLC (2013-)
+//   Community contributors (see AUTHORS file)
+// File authors:
+//   Toby Schneider <toby@gobysoft.org>
+//
+//
+// This file is part of the Dynamic Compact Control Language Library
+// ("DCCL").
+//
+// DCCL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 2.1 of the License, or
+// (at your option) any later version.
+//
+// DCCL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// tests dynamic conditions using the built-in (Lua-free) expression evaluator
+
+#include "../../codec.h"
+#include "../../internal/condition_expression.h"
+#include "dccl/def.h"
+#include "test.pb.h"
+
+using namespace dccl::test;
+using dccl::internal::ConditionExpression;
+
+void test_expressions();
+void test_codec();
+void test_load();
+
+int main(int /*argc*/, char* /*argv*/ [])
+{
+    dccl::dlog.connect(dccl::logger::ALL, &std::cerr);
+    test_expressions();
+    test_codec();
+    test_load();
+    std::cout << "all tests passed" << std::endl;
+}
+
+bool eval(const std::string& script, const ConditionExpression::Context& context)
+{
+    return ConditionExpression(script).evaluate_bool(context);
+}
+
+template <typename F> bool throws(F f)
+{
+    try
+    {
+        f();
+    }
+    catch (dccl::Exception& e)
+    {
+        std::cout << "Caught (expected): " << e.what() << std::endl;
+        return true;
+    }
+    return false;
+}
+
+void test_expressions()
+{
+    NativeConditionsMsg msg;
+    msg.set_state(NativeConditionsMsg::STATE_2);
+    msg.set_a(5);
+    msg.add_d(10);
+    msg.add_d(20);
+    msg.add_child()->set_include_i(false);
+    msg.add_child()->set_include_i(true);
+
+    ConditionExpression::Context context;
+    context.this_msg = &msg;
+    context.root_msg = &msg;
+    context.this_index = 2;
+
+    // literals, arithmetic and precedence, as in Lua
+    assert(eval("1 + 2 * 3 == 7", context));
+    assert(eval("return (1 + 2) * 3 == 9;", context));
+    assert(eval("2 ^ 3 ^ 2 == 512", context));
+    assert(eval("-2 ^ 2 == -4", context));
+    assert(eval("7 // 2 == 3 and -7 // 2 == -4", context));
+    assert(eval("-7 % 3 == 2 and 7 % -3 == -2", context));
+    assert(eval("1 / 2 == 0.5 and 0x10 == 16 and 1e2 == 100", context));
+    assert(eval("'abc' < 'abd' and \"x\" == 'x'", context));
+    assert(eval("nil == nil and not nil and not false", context));
+    assert(eval("0", context)); // 0 is true in Lua
+    assert(eval("1 ~= '1'", context));
+    assert(ConditionExpression("false or 5").evaluate_number(context) == 5);
+    assert(eval("(1 and nil) == nil", context));
+
+    // field references
+    assert(eval("this.state == 'STATE_2' and root.state ~= 'STATE_1'", context));
+    assert(eval("this.a + 1 == 6", context));
+    assert(eval("this.b == 0", context)); // unset fields have their default value
+    assert(eval("this.unknown_field == nil", context));
+    assert(eval("#this.d == 2 and this.d[1] == 10 and this.d[2] == 20 and this.d[3] == nil",
+                context));
+    assert(eval("#root.child == 2 and root.child[this_index].include_i", context));
+    assert(eval("not root.child[this_index - 1].include_i", context));
+    assert(eval("this_index == 2", context));
+
+    // outside the supported subset (would use Lua)
+    assert(throws([]() { ConditionExpression("print(this.a); return true"); }));
+    assert(throws([]() { ConditionExpression("this.a .. 'x'"); }));
+    assert(throws([]() { ConditionExpression("math.abs(this.a)"); }));
+    assert(throws([]() { ConditionExpression("this.a -- comment"); }));
+    assert(throws([]() { ConditionExpression("this.a == "); }));
+    assert(throws([]() { ConditionExpression("(this.a == 1"); }));
+
+    // runtime errors
+    assert(throws([&]() { eval("this.state < 1", context); }));
+    assert(throws([&]() { eval("this.a.b", context); }));
+    assert(throws([&]() { eval("-this.state", context); }));
+    assert(throws([&]() { ConditionExpression("this.state").evaluate_number(context); }));
+}
+
+void check_round_trip(dccl::Codec& codec, const NativeConditionsMsg& msg_in,
+                      const NativeConditionsMsg& expected)
+{
+    std::string bytes;
+    codec.encode(&bytes, msg_in);
+    std::cout << "Encoded " << msg_in.ShortDebugString() << " to " << bytes.size() << " bytes"
+              << std::endl;
+
+    NativeConditionsMsg msg_out;
+    codec.decode(bytes, &msg_out);
+    std::cout << "Decoded " << msg_out.ShortDebugString() << std::endl;
+    assert(msg_out.SerializeAsString() == expected.SerializeAsString());
+}
+
+void test_codec()
+{
+    dccl::Codec codec;
+    codec.load<NativeConditionsMsg>();
+    codec.info<NativeConditionsMsg>();
+
+    {
+        NativeConditionsMsg msg_in;
+        msg_in.set_state(NativeConditionsMsg::STATE_1);
+        msg_in.set_a(150);
+        msg_in.set_b(10);
+        msg_in.set_c_center(200);
+        msg_in.set_c(250);
+        for (int d : {50, 100, 150, 200, 250, 300}) msg_in.add_d(d);
+        {
+            auto c = msg_in.add_child();
+            c->set_include_i(true);
+            c->set_i(1);
+            c->set_i2(2);
+        }
+        {
+            auto c = msg_in.add_child();
+            c->set_include_i(false);
+            c->set_i(3);
+            c->set_i2(4);
+        }
+
+        NativeConditionsMsg expected = msg_in;
+        // b is omitted (not STATE_2)
+        expected.clear_b();
+        // d[3] is omitted (this_index == 4)
+        expected.mutable_d()->erase(expected.mutable_d()->begin() + 3);
+        // child[1] i and i2 are omitted
+        expected.mutable_child(1)->clear_i();
+        expected.mutable_child(1)->clear_i2();
+        check_round_trip(codec, msg_in, expected);
+    }
+
+    {
+        NativeConditionsMsg msg_in;
+        msg_in.set_state(NativeConditionsMsg::STATE_2);
+        msg_in.set_a(15);
+        msg_in.set_b(20);
+        msg_in.set_c_center(200);
+        // out of the dynamic bounds [100, 300] (and omitted anyway)
+        msg_in.set_c(50);
+        for (int d : {50, 100, 200}) msg_in.add_d(d);
+
+        NativeConditionsMsg expected = msg_in;
+        expected.clear_a();
+        expected.clear_c();
+        check_round_trip(codec, msg_in, expected);
+    }
+
+    {
+        // the dynamic bounds are applied
+        NativeConditionsMsg msg_in;
+        msg_in.set_state(NativeConditionsMsg::STATE_1);
+        msg_in.set_a(15);
+        msg_in.set_c_center(150);
+        msg_in.set_c(300);
+        NativeConditionsMsg expected = msg_in;
+        // c is required (only_if is true) and out of range, so is encoded as the minimum
+        expected.set_c(50);
+        check_round_trip(codec, msg_in, expected);
+    }
+
+    {
+        // the same message, changed between encodes (results of conditions are not kept from
+        // the previous encode)
+        NativeConditionsMsg msg_in;
+        msg_in.set_state(NativeConditionsMsg::STATE_1);
+        msg_in.set_a(15);
+        msg_in.set_b(20);
+        msg_in.set_c_center(200);
+        msg_in.set_c(150);
+        NativeConditionsMsg expected = msg_in;
+        expected.clear_b();
+        check_round_trip(codec, msg_in, expected);
+
+        msg_in.set_state(NativeConditionsMsg::STATE_2);
+        expected = msg_in;
+        expected.clear_a();
+        expected.clear_c();
+        check_round_trip(codec, msg_in, expected);
+
+        msg_in.set_state(NativeConditionsMsg::STATE_1);
+        expected = msg_in;
+        expected.clear_b();
+        check_round_trip(codec, msg_in, expected);
+    }
+
+    {
+        // sessions use the conditions compiled when the message was loaded
+        dccl::CodecSession session(codec);
+        NativeConditionsMsg msg_in;
+        msg_in.set_state(NativeConditionsMsg::STATE_2);
+        msg_in.set_b(20);
+        for (int d : {50, 100}) msg_in.add_d(d);
+        check_round_trip(codec, msg_in, msg_in);
+    }
+}
+
+void test_load()
+{
+    dccl::Codec codec;
+#if DCCL_HAS_LUA
+    codec.load<LuaOnlyConditionsMsg>();
+#else
+    // conditions that need Lua are found when the message is loaded
+    assert(throws([&]() { codec.load<LuaOnlyConditionsMsg>(); }));
+#endif
+}
@@ -0,0 +1,136 @@
+// Copyright 2026:
+//   GobySoft, LLC (2013-)
+//   Community contributors (see AUTHORS file)
+// File authors:
+//   Toby Schneider <toby@gobysoft.org>
+//
+//
+// This file is part of the Dynamic Compact Control Language Library
+// ("DCCL").
+//
+// DCCL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 2.1 of the License, or
+// (at your option) any later version.
+//
+// DCCL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DCCL.  If not, see <http://www.gnu.org/licenses/>.
+// tests the per-message plan of resolved field codecs built by FieldCodecManagerLocal
+
+#include "../../codec.h"
+
+#include "test.pb.h"
+using namespace dccl::test;
+
+namespace dccl
+{
+namespace test
+{
+// encodes the value as a fixed 8 bits
+class ByteCodec : public dccl::TypedFixedFieldCodec<dccl::int32>
+{
+  private:
+    dccl::Bitset encode() override { return encode(0); }
+    dccl::Bitset encode(const dccl::int32& wire_value) override
+    {
+        return dccl::Bitset(size(), wire_value);
+    }
+    dccl::int32 decode(dccl::Bitset* bits) override { return bits->to_ulong(); }
+    unsigned size() override { return 8; }
+    void validate() override {}
+};
+
+// encodes the value as a fixed 16 bits
+class ShortCodec : public ByteCodec
+{
+  private:
+    unsigned size() override { return 16; }
+};
+} // namespace test
+} // namespace dccl
+
+int main(int /*argc*/, char* /*argv*/ [])
+{
+    dccl::dlog.connect(dccl::logger::ALL, &std::cerr);
+
+    dccl::Codec codec;
+    codec.manager().add<dccl::test::ByteCodec>("test.custom");
+    codec.load<PlanMsg>();
+
+    const google::protobuf::Descriptor* desc = PlanMsg::descriptor();
+    const dccl::internal::MessagePlan& plan = codec.manager().plan(desc, desc);
+
+    // omitted field is not part of the plan
+    assert(static_cast<int>(plan.fields.size()) == desc->field_count() - 1);
+    for (const dccl::internal::FieldPlan& field : plan.fields)
+    {
+        assert(field.field_desc != desc->FindFieldByName("skipped"));
+        assert(field.codec == codec.manager().find(field.field_desc, true, "dccl.default4").get());
+        assert(field.helper);
+        assert(field.in_head == (field.field_desc->name() == "header"));
+        assert(field.is_repeated == field.field_desc->is_repeated());
+        assert(field.is_message == (field.field_desc->message_type() != nullptr));
+        assert(field.oneof_index == (field.field_desc->containing_oneof() ? 0 : -1));
+    }
+    assert(plan.fields[2].max_repeat == 3);
+    assert(plan.oneof_sizes.size() == 1 && plan.oneof_sizes[0] == 2);
+
+    // the plan is built once
+    assert(&codec.manager().plan(desc, desc) == &plan);
+
+    // adding an unrelated codec rebuilds the plans in place
+    codec.manager().add<dccl::test::ShortCodec>("test.unused");
+    assert(&codec.manager().plan(desc, desc) == &plan);
+    assert(static_cast<int>(plan.fields.size()) == desc->field_count() - 1);
+
+    // sessions only read the plans built by load()
+    {
+        dccl::CodecSession session(codec);
+        assert(&codec.manager().plan(desc, desc) == &plan);
+        codec.manager().plan(Embedded::descriptor(), desc);
+        try
+        {
+            codec.manager().plan(Embedded::descriptor(), Embedded::descriptor());
+            assert(false);
+        }
+        catch (dccl::Exception& e)
+        {
+        }
+    }
+
+    PlanMsg msg_in;
+    msg_in.mutable_header()->set_seq(1);
+    msg_in.set_a(10);
+    msg_in.set_skipped(5);
+    msg_in.add_rep()->set_val(-5);
+    msg_in.add_rep();
+    msg_in.set_custom(99);
+    msg_in.set_choice_b(3);
+
+    std::string encoded;
+    codec.encode(&encoded, msg_in);
+    PlanMsg msg_out;
+    codec.decode(encoded, &msg_out);
+    msg_in.clear_skipped();
+    std::cout << msg_out.ShortDebugString() << std::endl;
+    assert(msg_in.SerializeAsString() == msg_out.SerializeAsString());
+
+    // replacing the codec invalidates the plan
+    codec.manager().remove<dccl::test::ByteCodec>("test.custom");
+    codec.manager().add<dccl::test::ShortCodec>("test.custom");
+    codec.load<PlanMsg>();
+
+    std::string encoded_short;
+    codec.encode(&encoded_short, msg_in);
+    assert(encoded_short.size() == encoded.size() + 1);
+    PlanMsg msg_out_short;
+    codec.decode(encoded_short, &msg_out_short);
+    assert(msg_in.SerializeAsString() == msg_out_short.SerializeAsString());
+
+    std::cout << "all tests passed" << std::endl;
+}
@@ -0,0 +1,173 @@
+// Copyright 2026:
+//   GobySoft, LLC (2013-)
+//   Community contributors (see AUTHORS file)
+// File authors:
+//   Toby Schneider <toby@gobysoft.org>
+//
+//
+// This file is part of the Dynamic Compact Control Language Library
+// ("DCCL").
+//
+// DCCL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 2.1 of the License, or
+// (at your option) any later version.
+//
+// DCCL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DCCL.  If not, see <http://www.gnu.org/licenses/>.
+// tests the message sizes computed once by Codec::load()
+
+#include "../../arithmetic/field_codec_arithmetic.h"
+#include "../../codec.h"
+
+#include "test.pb.h"
+using namespace dccl::test;
+
+namespace dccl
+{
+namespace test
+{
+// encodes the value as a fixed 8 bits
+class ByteCodec : public dccl::TypedFixedFieldCodec<dccl::int32>
+{
+  private:
+    dccl::Bitset encode() override { return encode(0); }
+    dccl::Bitset encode(const dccl::int32& wire_value) override
+    {
+        return dccl::Bitset(size(), wire_value);
+    }
+    dccl::int32 decode(dccl::Bitset* bits) override { return bits->to_ulong(); }
+    unsigned size() override { return 8; }
+    void validate() override {}
+};
+
+// encodes the value as a fixed 16 bits
+class ShortCodec : public ByteCodec
+{
+  private:
+    unsigned size() override { return 16; }
+};
+} // namespace test
+} // namespace dccl
+
+void check_roundtrip(dccl::Codec& codec, const SizesMsg& msg_in, int user_id = -1)
+{
+    std::string encoded;
+    codec.encode(&encoded, msg_in, false, user_id);
+    assert(encoded.size() <= codec.max_size(SizesMsg::descriptor()));
+    assert(encoded.size() >= codec.min_size(SizesMsg::descriptor()));
+
+    SizesMsg msg_out;
+    codec.decode(encoded, &msg_out);
+    std::cout << msg_out.ShortDebugString() << std::endl;
+    assert(msg_in.SerializeAsString() == msg_out.SerializeAsString());
+}
+
+int main(int /*argc*/, char* /*argv*/ [])
+{
+    dccl::dlog.connect(dccl::logger::ALL, &std::cerr);
+
+    const google::protobuf::Descriptor* desc = SizesMsg::descriptor();
+
+    dccl::Codec codec;
+    codec.manager().add<dccl::test::ByteCodec>("test.custom");
+
+    // sizes are available for messages that are not loaded
+    const unsigned max_bytes = codec.max_size(desc);
+    const unsigned min_bytes = codec.min_size(desc);
+    // head: id (16) + seq (8); body: a (7) + rep (3 + 4 * 4) + custom (8)
+    assert(max_bytes == 3 + 5);
+    // head: id (8) + seq (8); body: a (7) + rep (3) + custom (8)
+    assert(min_bytes == 2 + 3);
+
+    codec.load<SizesMsg>();
+    assert(codec.max_size(desc) == max_bytes);
+    assert(codec.min_size(desc) == min_bytes);
+
+    SizesMsg msg_in;
+    msg_in.mutable_header()->set_seq(200);
+    msg_in.set_a(42);
+    msg_in.add_rep(1);
+    msg_in.add_rep(15);
+    msg_in.set_custom(99);
+    check_roundtrip(codec, msg_in);
+
+    // replacing a codec after load() updates the sizes
+    codec.manager().remove<dccl::test::ByteCodec>("test.custom");
+    codec.manager().add<dccl::test::ShortCodec>("test.custom");
+    assert(codec.max_size(desc) == max_bytes + 1);
+    assert(codec.min_size(desc) == min_bytes + 1);
+    check_roundtrip(codec, msg_in);
+
+    codec.manager().remove<dccl::test::ShortCodec>("test.custom");
+    codec.manager().add<dccl::test::ByteCodec>("test.custom");
+    assert(codec.max_size(desc) == max_bytes);
+
+    // unloading one of several ids keeps the message loaded under the others
+    codec.unload(desc);
+    codec.load(desc, 10);
+    codec.load(desc, 11);
+    codec.unload(10);
+    check_roundtrip(codec, msg_in, 11);
+    codec.unload(11);
+    assert(codec.loaded().empty());
+
+    // setting the id codec unloads all messages
+    codec.load<SizesMsg>();
+    std::string encoded;
+    codec.encode(&encoded, msg_in);
+    codec.set_id_codec(dccl::Codec::default_id_codec_name());
+    assert(codec.loaded().empty());
+    try
+    {
+        SizesMsg msg_out;
+        codec.decode(encoded, &msg_out);
+        assert(false);
+    }
+    catch (dccl::Exception& e)
+    {
+    }
+    codec.load<SizesMsg>();
+    check_roundtrip(codec, msg_in);
+
+    // changing an arithmetic model after load() updates the sizes
+    {
+        dccl_arithmetic_load(&codec);
+
+        dccl::arith::protobuf::ArithmeticModel model;
+        model.set_name("sizes_model");
+        for (int value = 0; value < 4; ++value)
+        {
+            model.add_value_bound(value);
+            model.add_frequency(10);
+        }
+        model.add_value_bound(4);
+        model.set_eof_frequency(1);
+        model.set_out_of_range_frequency(1);
+        dccl::arith::ModelManager::set_model(codec, model);
+
+        const google::protobuf::Descriptor* arith_desc = ArithmeticSizesMsg::descriptor();
+        codec.load(arith_desc);
+        const unsigned arith_max_bytes = codec.max_size(arith_desc);
+
+        // rarer out of range values make the largest message larger
+        model.set_out_of_range_frequency(1);
+        for (int i = 0; i < model.frequency_size(); ++i) model.set_frequency(i, 1000);
+        dccl::arith::ModelManager::set_model(codec, model);
+        assert(codec.max_size(arith_desc) > arith_max_bytes);
+
+        dccl::Codec fresh_codec;
+        dccl_arithmetic_load(&fresh_codec);
+        dccl::arith::ModelManager::set_model(fresh_codec, model);
+        fresh_codec.load(arith_desc);
+        assert(codec.max_size(arith_desc) == fresh_codec.max_size(arith_desc));
+        assert(codec.min_size(arith_desc) == fresh_codec.min_size(arith_desc));
+    }
+
+    std::cout << "all tests passed" << std::endl;
+}
@@ -0,0 +1,85 @@
+// Copyright 2026:
+//   GobySoft, LLC (2013-)
+//   Community contributors (see AUTHORS file)
+// File authors:
+//   Toby Schneider <toby@gobysoft.org>
+//
+//
+// This file is part of the Dynamic Compact Control Language Library
+// ("DCCL").
+//
+// DCCL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 2.1 of the License, or
+// (at your option) any later version.
+//
+// DCCL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DCCL.  If not, see <http://www.gnu.org/licenses/>.
+// encode / decode throughput of ParallelCodec from one thread up to N threads (default: one per hardware thread)
+
+#include <chrono>
+
+#include "../../parallel_codec.h"
+#include "messages.h"
+
+using namespace dccl::test;
+
+template <typename Function> double time_ms(Function f)
+{
+    auto start = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+        .count();
+}
+
+int main(int argc, char* argv[])
+{
+    const unsigned max_threads =
+        (argc > 1) ? std::stoi(argv[1]) : std::max(std::thread::hardware_concurrency(), 1u);
+    const int count = (argc > 2) ? std::stoi(argv[2]) : 20000;
+
+    dccl::Codec codec;
+    codec.load<TestMsg>();
+
+    std::vector<TestMsg> msgs;
+    for (int k = 0; k < count; ++k) msgs.push_back(make_msg(k));
+    std::vector<const google::protobuf::Message*> msg_ptrs;
+    for (const auto& msg : msgs) msg_ptrs.push_back(&msg);
+
+    std::string bytes;
+    std::vector<dccl::Codec::BatchResult> results;
+    codec.encode_batch(msg_ptrs.data(), count, &bytes, &results);
+    std::vector<std::string> frames;
+    for (const auto& result : results) frames.push_back(bytes.substr(result.offset, result.size));
+
+    std::cout << count << " messages" << std::endl;
+    double encode_1_ms = 0, decode_1_ms = 0;
+    for (unsigned num_threads = 1; num_threads <= max_threads; ++num_threads)
+    {
+        dccl::ParallelCodec parallel(codec, num_threads);
+
+        double encode_ms = time_ms(
+            [&]()
+            {
+                std::string bytes;
+                parallel.encode_batch(msg_ptrs.data(), count, &bytes, &results);
+            });
+        double decode_ms =
+            time_ms([&]() { parallel.decode_batch(frames.data(), count, &results); });
+
+        if (num_threads == 1)
+        {
+            encode_1_ms = encode_ms;
+            decode_1_ms = decode_ms;
+        }
+
+        std::cout << num_threads << " thread(s): encode " << encode_ms << " ms (x"
+                  << encode_1_ms / encode_ms << "), decode " << decode_ms << " ms (x"
+                  << decode_1_ms / decode_ms << ")" << std::endl;
+    }
+}
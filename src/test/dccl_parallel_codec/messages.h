@@ -0,0 +1,80 @@
+// Copyright 2026:
+//   GobySoft, LLC (2013-)
+//   Community contributors (see AUTHORS file)
+// File authors:
+//   Toby Schneider <toby@gobysoft.org>
+//
+//
+// This file is part of the Dynamic Compact Control Language Library
+// ("DCCL").
+//
+// DCCL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 2.1 of the License, or
+// (at your option) any later version.
+//
+// DCCL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DCCL.  If not, see <http://www.gnu.org/licenses/>.
+#ifndef DCCLTESTPARALLELCODECMESSAGES20261018H
+#define DCCLTESTPARALLELCODECMESSAGES20261018H
+
+#include "../../binary.h"
+#include "test.pb.h"
+
+// messages of varying size using all the default field codecs
+inline dccl::test::TestMsg make_msg(int k)
+{
+    using namespace dccl::test;
+
+    TestMsg msg;
+    int i = k % 50;
+    msg.set_double_default_optional(++i + 0.1);
+    msg.set_int32_default_optional(++i);
+    msg.set_uint64_default_optional(++i);
+    msg.set_sint32_default_optional(-++i);
+    if (k % 2)
+        msg.set_bool_default_optional(true);
+    msg.set_string_default_optional("abc" + std::to_string(k % 1000));
+    msg.set_bytes_default_optional(dccl::hex_decode("00112233aabbcc1234"));
+    msg.set_enum_default_optional(static_cast<Enum1>((k % 3) + 1));
+    msg.mutable_msg_default_optional()->set_val(++i + 0.3);
+    msg.mutable_msg_default_optional()->mutable_msg()->set_val(++i);
+
+    msg.set_double_default_required(++i + 0.1);
+    msg.set_float_default_required(++i + 0.2);
+    msg.set_int32_default_required(++i);
+    msg.set_int64_default_required(-++i);
+    msg.set_uint32_default_required(++i);
+    msg.set_uint64_default_required(++i);
+    msg.set_sint32_default_required(-++i);
+    msg.set_sint64_default_required(++i);
+    msg.set_fixed32_default_required(++i);
+    msg.set_fixed64_default_required(++i);
+    msg.set_sfixed32_default_required(++i);
+    msg.set_sfixed64_default_required(-++i);
+    msg.set_bool_default_required(k % 3);
+    msg.set_string_default_required("abc123");
+    msg.set_bytes_default_required(dccl::hex_decode("00112233aabbcc1234"));
+    msg.set_enum_default_required(ENUM_C);
+    msg.mutable_msg_default_required()->set_val(++i + 0.3);
+    msg.mutable_msg_default_required()->mutable_msg()->set_val(++i);
+
+    for (int j = 0; j < k % 4; ++j)
+    {
+        msg.add_double_default_repeat(++i + 0.1);
+        msg.add_int32_default_repeat(++i);
+        msg.add_string_default_repeat("abc");
+        msg.add_enum_default_repeat(static_cast<Enum1>((++i % 3) + 1));
+        EmbeddedMsg1* em_msg = msg.add_msg_default_repeat();
+        em_msg->set_val(++i + 0.3);
+        em_msg->mutable_msg()->set_val(++i);
+    }
+    return msg;
+}
+
+#endif
@@ -0,0 +1,134 @@
+// Copyright 2026:
+//   GobySoft, LLC (2013-)
+//   Community contributors (see AUTHORS file)
+// File authors:
+//   Toby Schneider <toby@gobysoft.org>
+//
+//
+// This file is part of the Dynamic Compact Control Language Library
+// ("DCCL").
+//
+// DCCL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 2.1 of the License, or
+// (at your option) any later version.
+//
+// DCCL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DCCL.  If not, see <http://www.gnu.org/licenses/>.
+// tests that ParallelCodec gives the same results as Codec::encode_batch() / decode_batch()
+
+#include "../../parallel_codec.h"
+#include "messages.h"
+
+using namespace dccl::test;
+
+void check_same(const std::vector<dccl::Codec::BatchResult>& a,
+                const std::vector<dccl::Codec::BatchResult>& b)
+{
+    assert(a.size() == b.size());
+    for (std::size_t i = 0, n = a.size(); i < n; ++i)
+    {
+        assert(a[i].ok() == b[i].ok());
+        assert(a[i].id == b[i].id);
+        assert(a[i].offset == b[i].offset);
+        assert(a[i].size == b[i].size);
+        assert(bool(a[i].msg) == bool(b[i].msg));
+        if (a[i].msg)
+            assert(a[i].msg->SerializeAsString() == b[i].msg->SerializeAsString());
+    }
+}
+
+int main(int /*argc*/, char* /*argv*/ [])
+{
+    const int num_msgs = 500;
+
+    dccl::Codec codec;
+    codec.load<TestMsg>();
+
+    std::vector<TestMsg> msgs;
+    for (int k = 0; k < num_msgs; ++k)
+    {
+        // missing required fields, so fails to encode
+        if (k % 97 == 13)
+            msgs.push_back(TestMsg());
+        else
+            msgs.push_back(make_msg(k));
+    }
+    std::vector<const google::protobuf::Message*> msg_ptrs;
+    for (const auto& msg : msgs) msg_ptrs.push_back(&msg);
+
+    // expected results
+    std::string expected_bytes;
+    std::vector<dccl::Codec::BatchResult> expected_encode;
+    std::size_t expected_encoded =
+        codec.encode_batch(msg_ptrs.data(), num_msgs, &expected_bytes, &expected_encode);
+    assert(expected_encoded > 0 && expected_encoded < num_msgs);
+
+    std::vector<std::string> frames;
+    for (const auto& result : expected_encode)
+    {
+        if (result.ok())
+            frames.push_back(expected_bytes.substr(result.offset, result.size));
+        else // unknown id, so fails to decode
+            frames.push_back(std::string(1, '\x7f'));
+    }
+    std::vector<dccl::Codec::BatchResult> expected_decode;
+    std::size_t expected_decoded =
+        codec.decode_batch(frames.data(), frames.size(), &expected_decode);
+    assert(expected_decoded == expected_encoded);
+
+    for (unsigned num_threads : {1, 2, 3, 8})
+    {
+        for (std::size_t chunk_size : {1, 7, 64, 1000})
+        {
+            std::cout << "Threads: " << num_threads << ", chunk size: " << chunk_size
+                      << std::endl;
+            dccl::ParallelCodec parallel(codec, num_threads, chunk_size);
+            assert(parallel.num_threads() == num_threads);
+
+            // a ParallelCodec can be reused for many batches
+            for (int repeat = 0; repeat < 3; ++repeat)
+            {
+                std::string bytes;
+                std::vector<dccl::Codec::BatchResult> encode_results;
+                assert(parallel.encode_batch(msg_ptrs.data(), num_msgs, &bytes,
+                                             &encode_results) == expected_encoded);
+                assert(bytes == expected_bytes);
+                check_same(encode_results, expected_encode);
+
+                std::vector<dccl::Codec::BatchResult> decode_results;
+                assert(parallel.decode_batch(frames.data(), frames.size(), &decode_results) ==
+                       expected_decoded);
+                check_same(decode_results, expected_decode);
+            }
+
+            // empty batch
+            std::string bytes;
+            std::vector<dccl::Codec::BatchResult> results;
+            assert(parallel.encode_batch(msg_ptrs.data(), 0, &bytes, &results) == 0);
+            assert(bytes.empty() && results.empty());
+        }
+    }
+
+    // encode_batch() appends to the bytes given
+    {
+        dccl::ParallelCodec parallel(codec, 2, 16);
+        std::string bytes = "prefix";
+        std::vector<dccl::Codec::BatchResult> results;
+        parallel.encode_batch(msg_ptrs.data(), num_msgs, &bytes, &results);
+        assert(bytes == "prefix" + expected_bytes);
+        assert(results[0].offset == 6);
+    }
+
+    // the Codec is still usable directly afterwards
+    std::string bytes;
+    codec.encode(&bytes, msgs[0]);
+    assert(bytes == expected_bytes.substr(0, expected_encode[0].size));
+
+    std::cout << "all tests passed" << std::endl;
+}
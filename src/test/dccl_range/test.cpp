@@ -0,0 +1,183 @@
+// Copyright 2026:
+//   GobySoft, LLC (2013-)
+//   Community contributors (see AUTHORS file)
+// File authors:
+//   Toby Schneider <toby@gobysoft.org>
+//
+//
+// This file is part of the Dynamic Compact Control Language Library
+// ("DCCL").
+//
+// DCCL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 2.1 of the License, or
+// (at your option) any later version.
+//
+// DCCL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DCCL.  If not, see <http://www.gnu.org/licenses/>.
+// tests the range coder (dccl.range) against the arithmetic coder using the same models
+
+#include <dlfcn.h>
+
+#include <cassert>
+#include <iostream>
+#include <random>
+
+#include "../../arithmetic/field_codec_arithmetic.h"
+#include "../../codec.h"
+#include "test.pb.h"
+
+using namespace dccl::test::range;
+
+dccl::arith::protobuf::ArithmeticModel make_model(bool adaptive, unsigned eof_frequency,
+                                                  unsigned out_of_range_frequency)
+{
+    dccl::arith::protobuf::ArithmeticModel model;
+    model.set_name("model");
+    model.set_is_adaptive(adaptive);
+    model.set_eof_frequency(eof_frequency);
+    model.set_out_of_range_frequency(out_of_range_frequency);
+
+    // a skewed distribution over 0, 1, ..., 32
+    for (int i = 0; i < 32; ++i)
+    {
+        model.add_value_bound(i);
+        model.add_frequency(1 + 1000 / (1 + i * i));
+    }
+    model.add_value_bound(32);
+    return model;
+}
+
+void run_tests(const dccl::arith::protobuf::ArithmeticModel& model, int num_messages)
+{
+    dccl::Codec codec;
+    void* dl_handle = dlopen(DCCL_ARITHMETIC_NAME, RTLD_LAZY);
+    if (!dl_handle)
+    {
+        std::cerr << "Failed to open " << DCCL_ARITHMETIC_NAME << std::endl;
+        exit(1);
+    }
+    codec.load_library(dl_handle);
+
+    dccl::arith::protobuf::ArithmeticModel enum_model;
+    enum_model.set_name("enum_model");
+    enum_model.set_is_adaptive(model.is_adaptive());
+    for (int i = 1; i <= 3; ++i)
+    {
+        enum_model.add_value_bound(i);
+        enum_model.add_frequency(i * 10);
+    }
+    enum_model.add_value_bound(4);
+    dccl::arith::ModelManager::set_model(codec, enum_model);
+    dccl::arith::ModelManager::set_model(codec, model);
+
+    codec.load<RangeTestMsg>();
+    codec.load<RangeLastMsg>();
+    codec.load<ArithmeticTestMsg>();
+    codec.info<RangeTestMsg>(&std::cout);
+
+    std::mt19937 gen(model.eof_frequency() + 10 * model.out_of_range_frequency());
+    std::geometric_distribution<int> value_dist(0.3);
+    std::uniform_int_distribution<int> size_dist(0, 40);
+
+    std::size_t range_bytes = 0, arithmetic_bytes = 0;
+    for (int i = 0; i < num_messages; ++i)
+    {
+        RangeTestMsg msg_in;
+        for (int j = 0, n = size_dist(gen); j < n; ++j)
+        {
+            int value = value_dist(gen);
+            // out of range values are only kept if they have a frequency
+            if (value >= 32 && model.out_of_range_frequency() == 0)
+                break;
+            msg_in.add_value(value);
+        }
+        if (i % 3)
+            msg_in.set_e(static_cast<Enum1>(1 + i % 3));
+        msg_in.set_after(i);
+
+        ArithmeticTestMsg arithmetic_msg_in;
+        arithmetic_msg_in.ParseFromString(msg_in.SerializeAsString());
+
+        // size() neither encodes nor updates adaptive models, so is exact for fixed ones
+        std::size_t size = codec.size(msg_in);
+
+        std::string bytes;
+        codec.encode(&bytes, msg_in);
+        if (!model.is_adaptive())
+            assert(bytes.size() == size);
+        assert(bytes.size() <= codec.max_size<RangeTestMsg>());
+        assert(bytes.size() >= codec.min_size<RangeTestMsg>());
+
+        RangeTestMsg msg_out;
+        codec.decode(bytes, &msg_out);
+
+        RangeTestMsg expected = msg_in;
+        if (model.eof_frequency() == 0)
+        {
+            // filled with the most probable value
+            while (expected.value_size() < 40) expected.add_value(0);
+        }
+        for (auto& value : *expected.mutable_value())
+        {
+            if (value >= 32)
+                value = std::numeric_limits<double>::quiet_NaN();
+        }
+
+        if (msg_out.SerializeAsString() != expected.SerializeAsString())
+        {
+            std::cout << "in:  " << expected.ShortDebugString() << "\n"
+                      << "out: " << msg_out.ShortDebugString() << std::endl;
+            // NaN != NaN, so compare the printed values
+            assert(msg_out.ShortDebugString() == expected.ShortDebugString());
+        }
+
+        range_bytes += bytes.size();
+
+        RangeLastMsg last_in, last_out, last_expected;
+        last_in.mutable_value()->CopyFrom(msg_in.value());
+        last_expected.mutable_value()->CopyFrom(expected.value());
+        std::string last_bytes;
+        codec.encode(&last_bytes, last_in);
+        codec.decode(last_bytes, &last_out);
+        assert(last_out.ShortDebugString() == last_expected.ShortDebugString());
+
+        // the arithmetic coder doesn't fill in missing values when the EOF has no frequency
+        if (model.eof_frequency() != 0)
+        {
+            std::string arithmetic_bytes_out;
+            codec.encode(&arithmetic_bytes_out, arithmetic_msg_in);
+            ArithmeticTestMsg arithmetic_msg_out;
+            codec.decode(arithmetic_bytes_out, &arithmetic_msg_out);
+            arithmetic_bytes += arithmetic_bytes_out.size();
+        }
+    }
+
+    std::cout << "range coded: " << range_bytes << " bytes" << std::endl;
+
+    // the same compression, to within a few bits per message
+    if (model.eof_frequency() != 0)
+    {
+        std::cout << "arithmetic coded: " << arithmetic_bytes << " bytes" << std::endl;
+        assert(range_bytes <= arithmetic_bytes + num_messages / 2);
+    }
+}
+
+int main(int /*argc*/, char* /*argv*/[])
+{
+    dccl::dlog.connect(dccl::logger::WARN_PLUS, &std::cerr);
+
+    for (bool adaptive : {false, true})
+    {
+        run_tests(make_model(adaptive, 10, 0), 200);
+        run_tests(make_model(adaptive, 10, 5), 200);
+        run_tests(make_model(adaptive, 0, 5), 50);
+    }
+
+    std::cout << "all tests passed" << std::endl;
+}
@@ -0,0 +1,157 @@
+// Copyright 2026:
+//   GobySoft, LLC (2013-)
+//   Community contributors (see AUTHORS file)
+// File authors:
+//   Toby Schneider <toby@gobysoft.org>
+//
+//
+// This file is part of the Dynamic Compact Control Language Library
+// ("DCCL").
+//
+// DCCL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 2.1 of the License, or
+// (at your option) any later version.
+//
+// DCCL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DCCL.  If not, see <http://www.gnu.org/licenses/>.
+// tests one Codec shared by several threads, each with its own CodecSession
+
+#include <thread>
+
+#include "../../codec.h"
+#include "test.pb.h"
+
+using namespace dccl::test;
+
+TestMsg make_msg(int k)
+{
+    TestMsg msg;
+    int i = k % 50;
+    msg.set_double_default_optional(++i + 0.1);
+    msg.set_int32_default_optional(++i);
+    msg.set_uint64_default_optional(++i);
+    msg.set_sint32_default_optional(-++i);
+    if (k % 2)
+        msg.set_bool_default_optional(true);
+    msg.set_string_default_optional("abc" + std::to_string(k % 1000));
+    msg.set_bytes_default_optional(dccl::hex_decode("00112233aabbcc1234"));
+    msg.set_enum_default_optional(static_cast<Enum1>((k % 3) + 1));
+    msg.mutable_msg_default_optional()->set_val(++i + 0.3);
+    msg.mutable_msg_default_optional()->mutable_msg()->set_val(++i);
+
+    msg.set_double_default_required(++i + 0.1);
+    msg.set_float_default_required(++i + 0.2);
+    msg.set_int32_default_required(++i);
+    msg.set_int64_default_required(-++i);
+    msg.set_uint32_default_required(++i);
+    msg.set_uint64_default_required(++i);
+    msg.set_sint32_default_required(-++i);
+    msg.set_sint64_default_required(++i);
+    msg.set_fixed32_default_required(++i);
+    msg.set_fixed64_default_required(++i);
+    msg.set_sfixed32_default_required(++i);
+    msg.set_sfixed64_default_required(-++i);
+    msg.set_bool_default_required(k % 3);
+    msg.set_string_default_required("abc123");
+    msg.set_bytes_default_required(dccl::hex_decode("00112233aabbcc1234"));
+    msg.set_enum_default_required(ENUM_C);
+    msg.mutable_msg_default_required()->set_val(++i + 0.3);
+    msg.mutable_msg_default_required()->mutable_msg()->set_val(++i);
+
+    for (int j = 0; j < k % 4; ++j)
+    {
+        msg.add_double_default_repeat(++i + 0.1);
+        msg.add_int32_default_repeat(++i);
+        msg.add_string_default_repeat("abc");
+        msg.add_enum_default_repeat(static_cast<Enum1>((++i % 3) + 1));
+        EmbeddedMsg1* em_msg = msg.add_msg_default_repeat();
+        em_msg->set_val(++i + 0.3);
+        em_msg->mutable_msg()->set_val(++i);
+    }
+    return msg;
+}
+
+int main(int /*argc*/, char* /*argv*/ [])
+{
+    const int num_msgs = 200;
+    const int num_threads = 8;
+
+    dccl::Codec codec;
+    codec.load<TestMsg>();
+
+    // expected results, from the Codec used on this thread only
+    std::vector<TestMsg> msgs;
+    std::vector<std::string> expected_bytes;
+    std::vector<std::string> expected_decoded;
+    for (int k = 0; k < num_msgs; ++k)
+    {
+        msgs.push_back(make_msg(k));
+        std::string bytes;
+        codec.encode(&bytes, msgs.back());
+        expected_bytes.push_back(bytes);
+        TestMsg decoded;
+        codec.decode(bytes, &decoded);
+        expected_decoded.push_back(decoded.SerializeAsString());
+    }
+
+    std::vector<int> failures(num_threads, 0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; ++t)
+    {
+        threads.emplace_back(
+            [&, t]()
+            {
+                dccl::CodecSession session(codec);
+                for (int it = 0; it < num_msgs; ++it)
+                {
+                    // each thread works through the messages in a different order
+                    int k = (it * (t + 1) + t) % num_msgs;
+
+                    std::string bytes;
+                    codec.encode(&bytes, msgs[k]);
+                    if (bytes != expected_bytes[k])
+                        ++failures[t];
+
+                    TestMsg decoded;
+                    codec.decode(bytes, &decoded);
+                    if (decoded.SerializeAsString() != expected_decoded[k])
+                        ++failures[t];
+
+                    if (codec.size(msgs[k]) != expected_bytes[k].size())
+                        ++failures[t];
+                }
+            });
+    }
+    for (auto& thread : threads) thread.join();
+
+    for (int t = 0; t < num_threads; ++t)
+    {
+        std::cout << "Thread " << t << ": " << failures[t] << " failures" << std::endl;
+        assert(failures[t] == 0);
+    }
+
+    // sessions can be nested, and the Codec is usable without a session afterwards
+    {
+        dccl::CodecSession outer(codec);
+        {
+            dccl::CodecSession inner(codec);
+            std::string bytes;
+            codec.encode(&bytes, msgs[0]);
+            assert(bytes == expected_bytes[0]);
+        }
+        std::string bytes;
+        codec.encode(&bytes, msgs[1]);
+        assert(bytes == expected_bytes[1]);
+    }
+    std::string bytes;
+    codec.encode(&bytes, msgs[2]);
+    assert(bytes == expected_bytes[2]);
+
+    std::cout << "all tests passed" << std::endl;
+}
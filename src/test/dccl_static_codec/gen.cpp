@@ -0,0 +1,47 @@
+// Copyright 2026:
+//   GobySoft, LLC (2013-)
+//   Community contributors (see AUTHORS file)
+// File authors:
+//   Toby Schneider <toby@gobysoft.org>
+//
+//
+// This file is part of the Dynamic Compact Control Language Library
+// ("DCCL").
+//
+// DCCL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 2.1 of the License, or
+// (at your option) any later version.
+//
+// DCCL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DCCL.  If not, see <http://www.gnu.org/licenses/>.
+// writes the static codec header for test.proto
+
+#include <fstream>
+#include <iostream>
+
+#include "dccl/option_extensions.pb.h"
+
+#include "../../apps/pb_plugin/gen_static_codec_plugin.h"
+
+#include "test.pb.h"
+
+int main(int argc, char* argv[])
+{
+    if (argc != 2)
+    {
+        std::cerr << "Usage: " << argv[0] << " output.dccl.h" << std::endl;
+        return 1;
+    }
+
+    dccl::static_codec::Generator generator(dccl::test::StaticV2::descriptor()->file(),
+                                            "test.pb.h");
+    std::ofstream out(argv[1]);
+    out << generator.generate();
+    return out.good() ? 0 : 1;
+}
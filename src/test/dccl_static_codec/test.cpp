@@ -0,0 +1,291 @@
+// Copyright 2026:
+//   GobySoft, LLC (2013-)
+//   Community contributors (see AUTHORS file)
+// File authors:
+//   Toby Schneider <toby@gobysoft.org>
+//
+//
+// This file is part of the Dynamic Compact Control Language Library
+// ("DCCL").
+//
+// DCCL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 2.1 of the License, or
+// (at your option) any later version.
+//
+// DCCL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DCCL.  If not, see <http://www.gnu.org/licenses/>.
+// tests that the static (generated) encoders / decoders match dccl::Codec
+
+#include <random>
+
+#include "../../codec.h"
+
+#include "test.dccl.h"
+#include "test.pb.h"
+using namespace dccl::test;
+
+std::mt19937 gen(42);
+
+bool chance(double p = 0.5) { return std::uniform_real_distribution<double>(0, 1)(gen) < p; }
+
+// mostly within [min, max], occasionally outside
+double value(double min, double max)
+{
+    double span = max - min;
+    return std::uniform_real_distribution<double>(min - 0.1 * span, max + 0.1 * span)(gen);
+}
+
+int count(int max) { return std::uniform_int_distribution<int>(0, max)(gen); }
+
+Colour colour()
+{
+    static const Colour colours[] = {RED, GREEN, BLUE};
+    return colours[count(2)];
+}
+
+// occasionally longer than max_length (truncated when encoded)
+std::string text(int max_length, bool printable = true)
+{
+    std::string s(count(max_length + 2), 0);
+    for (char& c : s)
+        c = static_cast<char>(printable ? 'a' + count(25) : count(255));
+    return s;
+}
+
+void fill(Header* header)
+{
+    header->set_seq(static_cast<int>(value(0, 1000)));
+    if (chance())
+        header->set_urgent(chance());
+}
+
+void fill(Position* pos)
+{
+    if (chance(0.8))
+        pos->set_lat(value(-90, 90));
+    if (chance(0.8))
+        pos->set_lon(value(-180, 180));
+    if (chance())
+        pos->set_depth(value(0, 500));
+    if (chance())
+        pos->set_colour(colour());
+    if (chance())
+        fill(pos->mutable_tag());
+}
+
+void fill(Choice* choice)
+{
+    if (chance())
+        choice->set_id(static_cast<int>(value(0, 15)));
+    switch (count(3))
+    {
+        case 0: choice->set_range(value(0, 1000)); break;
+        case 1: choice->set_colour(colour()); break;
+        case 2: fill(choice->mutable_fix()); break;
+        default: break;
+    }
+}
+
+void fill(StaticV2* msg)
+{
+    fill(msg->mutable_header());
+    if (chance())
+        msg->set_head_value(static_cast<int>(value(-5, 5)));
+    msg->set_d(value(-100, 100));
+    if (chance())
+        msg->set_i64(static_cast<dccl::int64>(value(-1000000, 1000000)));
+    if (chance())
+        msg->set_u32(static_cast<dccl::uint32>(value(0, 255)));
+    if (chance())
+        msg->set_u64(static_cast<dccl::uint64>(value(10, 100000)));
+    if (chance())
+        msg->set_f(value(-10, 10));
+    msg->set_b_req(chance());
+    if (chance())
+        msg->set_b_opt(chance());
+    if (chance())
+        msg->set_colour(colour());
+    for (int i = 0, n = count(4); i < n; ++i) msg->add_values(static_cast<int>(value(-50, 50)));
+    for (int i = 0, n = count(3); i < n; ++i) msg->add_colours(colour());
+    if (chance())
+        fill(msg->mutable_pos());
+    for (int i = 0, n = count(3); i < n; ++i)
+    {
+        Position* pos = msg->add_track();
+        if (chance(0.8))
+            fill(pos);
+    }
+    if (chance())
+        msg->set_skipped(1);
+    if (chance())
+        msg->set_name(text(10));
+    if (chance())
+        msg->set_raw(text(4, false));
+    msg->set_raw_req(text(2, false));
+    for (int i = 0, n = count(3); i < n; ++i) msg->add_tags(text(5));
+}
+
+void fill(StaticV3* msg)
+{
+    fill(msg->mutable_header());
+    if (chance())
+        msg->set_head_value(static_cast<int>(value(-5, 5)));
+    msg->set_d(value(-100, 100));
+    if (chance())
+        msg->set_u64(static_cast<dccl::uint64>(value(10, 100000)));
+    if (chance())
+        msg->set_b_opt(chance());
+    if (chance())
+        msg->set_packed(colour());
+    if (chance())
+        msg->set_unpacked(colour());
+    for (int i = 0, n = count(5); i < n; ++i) msg->add_values(static_cast<int>(value(-50, 50)));
+    for (int i = 0, n = count(4); i < n; ++i) msg->add_flags(chance());
+    for (int i = 0, n = count(3); i < n; ++i) msg->add_colours(colour());
+    if (chance())
+        fill(msg->mutable_pos());
+    fill(msg->mutable_required_pos());
+    for (int i = 0, n = count(4); i < n; ++i) fill(msg->add_track());
+    msg->set_head_raw(text(2, false));
+    if (chance())
+        msg->set_name(text(10));
+    if (chance())
+        msg->set_raw(text(3, false));
+    for (int i = 0, n = count(3); i < n; ++i) msg->add_blobs(text(2, false));
+}
+
+void fill(StaticV4* msg)
+{
+    fill(msg->mutable_header());
+    if (chance())
+        msg->set_a(static_cast<int>(value(0, 100)));
+    switch (count(3))
+    {
+        case 0: msg->set_speed(static_cast<int>(value(0, 20))); break;
+        case 1: msg->set_stop(chance()); break;
+        case 2: fill(msg->mutable_choice()); break;
+        default: break;
+    }
+    switch (count(3))
+    {
+        case 0: msg->set_colour(colour()); break;
+        case 1: msg->set_heading(value(0, 360)); break;
+        case 2: msg->set_label(text(6)); break;
+        default: break;
+    }
+    if (chance())
+        fill(msg->mutable_other());
+    for (int i = 0, n = count(3); i < n; ++i) fill(msg->add_choices());
+    if (chance())
+        msg->set_raw(text(5, false));
+    msg->set_name(text(8));
+    for (int i = 0, n = count(3); i < n; ++i) msg->add_names(text(3));
+}
+
+template <typename Msg> void check(dccl::Codec& codec, const Msg& msg_in)
+{
+    std::string dynamic_bytes;
+    codec.encode(&dynamic_bytes, msg_in);
+
+    // encode
+    std::string static_bytes = dccl_encode(msg_in);
+    assert(static_bytes == dynamic_bytes);
+    assert(dccl_size(msg_in) == static_bytes.size());
+
+    char buf[256];
+    std::size_t len = dccl_encode(msg_in, buf, sizeof(buf));
+    assert(std::string(buf, len) == dynamic_bytes);
+
+    // decode into an empty message
+    Msg dynamic_out, static_out;
+    codec.decode(dynamic_bytes, &dynamic_out);
+    assert(dccl_decode(&static_out, dynamic_bytes) == dynamic_bytes.size());
+    assert(static_out.SerializeAsString() == dynamic_out.SerializeAsString());
+
+    // decode into a message that already has values (decoding does not clear the message)
+    Msg dynamic_merged(msg_in), static_merged(msg_in);
+    codec.decode(dynamic_bytes, &dynamic_merged);
+    dccl_decode(&static_merged, dynamic_bytes);
+    assert(static_merged.SerializeAsString() == dynamic_merged.SerializeAsString());
+
+    // concatenated messages: decoding returns the bytes consumed
+    std::string two = dynamic_bytes + dynamic_bytes;
+    Msg first;
+    assert(dccl_decode(&first, reinterpret_cast<const std::uint8_t*>(two.data()), two.size()) ==
+           dynamic_bytes.size());
+}
+
+int main(int /*argc*/, char* /*argv*/ [])
+{
+    dccl::dlog.connect(dccl::logger::WARN_PLUS, &std::cerr);
+
+    dccl::Codec codec;
+    codec.load<StaticV2>();
+    codec.load<StaticV3>();
+    codec.load<StaticV4>();
+
+    for (int i = 0; i < 2000; ++i)
+    {
+        StaticV2 v2;
+        fill(&v2);
+        check(codec, v2);
+
+        StaticV3 v3;
+        fill(&v3);
+        check(codec, v3);
+
+        StaticV4 v4;
+        fill(&v4);
+        check(codec, v4);
+    }
+
+    // errors
+    {
+        StaticV2 msg;
+        bool caught = false;
+        try
+        {
+            // missing required fields
+            dccl_encode(msg);
+        }
+        catch (dccl::Exception& e)
+        {
+            caught = true;
+        }
+        assert(caught);
+
+        fill(&msg);
+        char buf[1];
+        caught = false;
+        try
+        {
+            dccl_encode(msg, buf, sizeof(buf));
+        }
+        catch (std::length_error& e)
+        {
+            caught = true;
+        }
+        assert(caught);
+
+        std::string bytes = dccl_encode(msg);
+        StaticV3 wrong_type;
+        caught = false;
+        try
+        {
+            dccl_decode(&wrong_type, bytes);
+        }
+        catch (dccl::Exception& e)
+        {
+            caught = true;
+        }
+        assert(caught);
+    }
+
+    std::cout << "all tests passed" << std::endl;
+}
@@ -97,5 +97,16 @@ int main(int /*argc*/, char* /*argv*/ [])
     dlog.is(WARN) && dlog << "warn ok" << std::endl;
     dlog.disconnect(ALL);
 
+    std::cout << "attaching info() to DEBUG3+, using the compile-time DCCL_MIN_LOG_LEVEL"
+              << std::endl;
+    dlog.connect(DEBUG3_PLUS, &info);
+    assert(DCCL_LOG_CHECK(WARN) == (WARN <= DCCL_MIN_LOG_LEVEL));
+    assert(DCCL_LOG_CHECK(DEBUG3) == (DEBUG3 <= DCCL_MIN_LOG_LEVEL));
+    DCCL_LOG_IS(WARN, GENERAL) && dlog << "warn ok" << std::endl;
+    DCCL_LOG_IS(DEBUG3, ENCODE) && dlog << "debug3 ok" << std::endl;
+    dlog.disconnect(ALL);
+    DCCL_LOG_IS(WARN, GENERAL) && dlog << stream_assert << std::endl;
+    assert(!DCCL_LOG_CHECK(WARN));
+
     std::cout << "All tests passed." << std::endl;
 }
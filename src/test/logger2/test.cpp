@@ -0,0 +1,101 @@
+// Copyright 2026:
+//   GobySoft, LLC (2013-)
+//   Community contributors (see AUTHORS file)
+// File authors:
+//   Toby Schneider <toby@gobysoft.org>
+//
+//
+// This file is part of the Dynamic Compact Control Language Library
+// ("DCCL").
+//
+// DCCL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 2.1 of the License, or
+// (at your option) any later version.
+//
+// DCCL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DCCL.  If not, see <http://www.gnu.org/licenses/>.
+
+// tests logging from several threads at once
+
+#include <cassert>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "../../logger.h"
+
+std::mutex lines_mutex;
+std::map<std::string, int> lines;
+std::map<dccl::logger::Group, int> groups;
+
+void collect(const std::string& log_message, dccl::logger::Verbosity /*verbosity*/,
+             dccl::logger::Group group)
+{
+    std::lock_guard<std::mutex> lock(lines_mutex);
+    ++lines[log_message];
+    ++groups[group];
+}
+
+int main(int /*argc*/, char* /*argv*/ [])
+{
+    using dccl::dlog;
+    using namespace dccl::logger;
+
+    const int num_threads = 8;
+    const int num_lines = 500;
+
+    dlog.connect(INFO_PLUS, &collect);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; ++t)
+    {
+        threads.emplace_back(
+            [t]()
+            {
+                for (int i = 0; i < num_lines; ++i)
+                {
+                    // formatting state is per thread
+                    dlog.is(INFO, t % 2 ? ENCODE : DECODE) &&
+                        dlog << "thread " << t << " line " << std::hex << i << std::dec
+                             << std::endl;
+                    // not enabled, so not written
+                    dlog.is(DEBUG1) && dlog << "debug " << t << std::endl;
+                    // multi-line message is split into separate lines
+                    dlog.is(WARN) && dlog << "warn " << t << "\nsecond " << i << std::endl;
+                }
+            });
+    }
+    for (auto& thread : threads) thread.join();
+
+    dlog.disconnect(ALL);
+    dlog.is(INFO) && dlog << "not written" << std::endl;
+
+    // every line arrives whole, once
+    assert(lines.size() == num_threads * num_lines + num_threads + num_lines);
+    for (int t = 0; t < num_threads; ++t)
+    {
+        for (int i = 0; i < num_lines; ++i)
+        {
+            std::stringstream ss;
+            ss << "thread " << t << " line " << std::hex << i;
+            assert(lines[ss.str()] == 1);
+        }
+        assert(lines["warn " + std::to_string(t)] == num_lines);
+        assert(lines.count("debug " + std::to_string(t)) == 0);
+    }
+    for (int i = 0; i < num_lines; ++i) assert(lines["second " + std::to_string(i)] == num_threads);
+    assert(!lines.count("not written"));
+
+    assert(groups[ENCODE] == num_threads / 2 * num_lines);
+    assert(groups[DECODE] == num_threads / 2 * num_lines);
+    assert(groups[GENERAL] == 2 * num_threads * num_lines);
+
+    std::cout << "All tests passed." << std::endl;
+}
@@ -0,0 +1,154 @@
+// Copyright 2026:
+//   GobySoft, LLC (2013-)
+//   Community contributors (see AUTHORS file)
+// File authors:
+//   Toby Schneider <toby@gobysoft.org>
+//
+//
+// This file is part of the Dynamic Compact Control Language Library
+// ("DCCL").
+//
+// DCCL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 2.1 of the License, or
+// (at your option) any later version.
+//
+// DCCL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DCCL.  If not, see <http://www.gnu.org/licenses/>.
+
+// tests dccl::AsyncLogSink
+
+#include <cassert>
+#include <condition_variable>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include "../../async_log_sink.h"
+
+using dccl::AsyncLogSink;
+using dccl::dlog;
+using namespace dccl::logger;
+
+// collects log messages, optionally waiting until release() is called for each message
+class Collector
+{
+  public:
+    explicit Collector(bool hold = false) : hold_(hold) {}
+
+    void operator()(const std::string& msg, Verbosity /*vrb*/, Group /*grp*/)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        released_.wait(lock, [this]() { return !hold_; });
+        lines_.push_back(msg);
+    }
+
+    void release()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            hold_ = false;
+        }
+        released_.notify_all();
+    }
+
+    std::vector<std::string> lines()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return lines_;
+    }
+
+  private:
+    std::mutex mutex_;
+    std::condition_variable released_;
+    bool hold_;
+    std::vector<std::string> lines_;
+};
+
+int main(int /*argc*/, char* /*argv*/ [])
+{
+    // messages are dropped (and counted) when the ring buffer is full
+    {
+        Collector collector(true);
+        AsyncLogSink sink(std::ref(collector), 4, AsyncLogSink::Overflow::DROP);
+        assert(sink.capacity() == 4);
+        dlog.connect(DEBUG2_PLUS, sink.slot());
+
+        const int num_lines = 100;
+        for (int i = 0; i < num_lines; ++i)
+            dlog.is(DEBUG2, ENCODE) && dlog << "line " << i << std::endl;
+        dlog.disconnect(ALL);
+
+        collector.release();
+        sink.flush();
+
+        std::vector<std::string> lines = collector.lines();
+        std::cout << "Delivered: " << lines.size() << ", dropped: " << sink.dropped()
+                  << std::endl;
+        // at most one message being written and four queued
+        assert(lines.size() <= 5);
+        assert(lines.size() + sink.dropped() == num_lines);
+        assert(lines[0] == "line 0");
+    }
+
+    // logging threads wait for space when the ring buffer is full
+    {
+        Collector collector;
+        AsyncLogSink sink(std::ref(collector), 8, AsyncLogSink::Overflow::BLOCK);
+        dlog.connect(DEBUG2_PLUS, sink.slot());
+
+        const int num_threads = 4;
+        const int num_lines = 2000;
+        std::vector<std::thread> threads;
+        for (int t = 0; t < num_threads; ++t)
+        {
+            threads.emplace_back(
+                [t]()
+                {
+                    for (int i = 0; i < num_lines; ++i)
+                        dlog.is(DEBUG2, DECODE) && dlog << t << " " << i << std::endl;
+                });
+        }
+        for (auto& thread : threads) thread.join();
+        dlog.disconnect(ALL);
+        sink.flush();
+
+        std::vector<std::string> lines = collector.lines();
+        assert(sink.dropped() == 0);
+        assert(lines.size() == num_threads * num_lines);
+
+        // in order for each thread
+        std::vector<int> next(num_threads, 0);
+        for (const auto& line : lines)
+        {
+            std::stringstream ss(line);
+            int t, i;
+            ss >> t >> i;
+            assert(i == next[t]);
+            ++next[t];
+        }
+    }
+
+    // to a std::ostream, and remaining messages are written on destruction
+    {
+        std::stringstream os;
+        {
+            AsyncLogSink sink(&os, false);
+            dlog.connect(WARN_PLUS, sink.slot());
+            for (int i = 0; i < 10; ++i) dlog.is(WARN) && dlog << "warning " << i << std::endl;
+            dlog.is(INFO) && dlog << "not written" << std::endl;
+            dlog.disconnect(ALL);
+        }
+        std::string expected;
+        for (int i = 0; i < 10; ++i) expected += "warning " + std::to_string(i) + "\n";
+        assert(os.str() == expected);
+    }
+
+    std::cout << "All tests passed." << std::endl;
+}